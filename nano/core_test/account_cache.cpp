@@ -0,0 +1,115 @@
+#include <nano/core_test/testutil.hpp>
+#include <nano/lib/logger_mt.hpp>
+#include <nano/lib/stats.hpp>
+#include <nano/secure/account_cache.hpp>
+#include <nano/secure/blockstore.hpp>
+#include <nano/secure/utility.hpp>
+
+#include <gtest/gtest.h>
+
+TEST (account_cache, disabled)
+{
+	nano::account_cache cache;
+	ASSERT_FALSE (cache.enabled ());
+	cache.account_put (1, nano::account_info ());
+	boost::optional<nano::account_info> info;
+	ASSERT_FALSE (cache.account_find (1, info));
+	ASSERT_EQ (0, cache.account_size ());
+	ASSERT_EQ (0, cache.miss_count ());
+}
+
+TEST (account_cache, unit)
+{
+	nano::stat stats;
+	nano::account_cache cache;
+	cache.reset (2, &stats);
+	ASSERT_TRUE (cache.enabled ());
+	nano::account_info info1;
+	info1.block_count = 1;
+	nano::account_info info2;
+	info2.block_count = 2;
+	boost::optional<nano::account_info> info;
+	ASSERT_FALSE (cache.account_find (1, info));
+	cache.account_insert (1, info1);
+	ASSERT_TRUE (cache.account_find (1, info));
+	ASSERT_EQ (info1, *info);
+	// Values read after a miss don't replace ones written meanwhile
+	cache.account_put (1, info2);
+	cache.account_insert (1, info1);
+	ASSERT_TRUE (cache.account_find (1, info));
+	ASSERT_EQ (info2, *info);
+	// Accounts which aren't stored are cached as well
+	cache.account_put (2, boost::none);
+	ASSERT_TRUE (cache.account_find (2, info));
+	ASSERT_FALSE (info);
+	// The least recently used account is evicted once full, account 1 was used after account 2
+	ASSERT_TRUE (cache.account_find (1, info));
+	cache.account_insert (3, info1);
+	ASSERT_EQ (2, cache.account_size ());
+	ASSERT_FALSE (cache.account_find (2, info));
+	ASSERT_TRUE (cache.account_find (1, info));
+	ASSERT_TRUE (cache.account_find (3, info));
+	// Tables are separate
+	boost::optional<nano::confirmation_height_info> confirmation_height;
+	ASSERT_FALSE (cache.confirmation_height_find (1, confirmation_height));
+	cache.confirmation_height_put (1, nano::confirmation_height_info (1, 2));
+	ASSERT_TRUE (cache.confirmation_height_find (1, confirmation_height));
+	ASSERT_EQ (1, confirmation_height->height);
+	ASSERT_EQ (1, cache.confirmation_height_size ());
+	ASSERT_EQ (7, cache.hit_count ());
+	ASSERT_EQ (3, cache.miss_count ());
+	ASSERT_EQ (6, stats.count (nano::stat::type::account_cache, nano::stat::detail::account_info_hit));
+	ASSERT_EQ (2, stats.count (nano::stat::type::account_cache, nano::stat::detail::account_info_miss));
+	ASSERT_EQ (1, stats.count (nano::stat::type::account_cache, nano::stat::detail::confirmation_height_hit));
+	ASSERT_EQ (1, stats.count (nano::stat::type::account_cache, nano::stat::detail::confirmation_height_miss));
+	cache.reset (0);
+	ASSERT_FALSE (cache.enabled ());
+	ASSERT_EQ (0, cache.account_size ());
+}
+
+TEST (account_cache, store)
+{
+	nano::logger_mt logger;
+	auto store = nano::make_store (logger, nano::unique_path ());
+	ASSERT_TRUE (!store->init_error ());
+	nano::genesis genesis;
+	auto & cache (store->get_account_cache ());
+	cache.reset (16);
+	nano::account account (1);
+	nano::account_info info;
+	nano::confirmation_height_info confirmation_height;
+	{
+		auto transaction (store->tx_begin_write ());
+		nano::ledger_cache ledger_cache;
+		store->initialize (transaction, genesis, ledger_cache);
+		// Written through by initialize
+		ASSERT_EQ (1, cache.account_size ());
+		ASSERT_FALSE (store->account_get (transaction, nano::genesis_account, info));
+		ASSERT_EQ (1, cache.hit_count ());
+		// Missing accounts are cached as missing
+		ASSERT_TRUE (store->account_get (transaction, account, info));
+		ASSERT_TRUE (store->account_get (transaction, account, info));
+		ASSERT_EQ (1, cache.miss_count ());
+		ASSERT_EQ (2, cache.hit_count ());
+		store->confirmation_height_put (transaction, account, { 1, genesis.hash () });
+		store->account_put (transaction, account, { genesis.hash (), account, genesis.hash (), 1, 2, 1, nano::epoch::epoch_0 });
+		ASSERT_FALSE (store->account_get (transaction, account, info));
+		ASSERT_EQ (1, info.block_count);
+		ASSERT_FALSE (store->confirmation_height_get (transaction, account, confirmation_height));
+		ASSERT_EQ (1, confirmation_height.height);
+	}
+	{
+		// Read transactions don't use the cache
+		auto transaction (store->tx_begin_read ());
+		auto hits (cache.hit_count ());
+		ASSERT_FALSE (store->account_get (transaction, account, info));
+		ASSERT_EQ (hits, cache.hit_count ());
+	}
+	auto transaction (store->tx_begin_write ());
+	store->account_del (transaction, account);
+	store->confirmation_height_del (transaction, account);
+	ASSERT_TRUE (store->account_get (transaction, account, info));
+	ASSERT_TRUE (store->confirmation_height_get (transaction, account, confirmation_height));
+	// Deletes are written through, the store isn't read again
+	ASSERT_EQ (1, cache.miss_count ());
+}
@@ -772,3 +772,28 @@ TEST (active_transactions, activate_dependencies)
 	ASSERT_TRUE (node1->ledger.block_confirmed (node1->store.tx_begin_read (), block2->hash ()));
 	ASSERT_TRUE (node2->ledger.block_confirmed (node2->store.tx_begin_read (), block2->hash ()));
 }
+
+TEST (active_transactions, snapshot)
+{
+	nano::system system;
+	nano::node_flags node_flags;
+	node_flags.disable_request_loop = true;
+	auto & node (*system.add_node (node_flags));
+	nano::genesis genesis;
+	auto send (std::make_shared<nano::send_block> (genesis.hash (), nano::public_key (), nano::genesis_amount - 100, nano::test_genesis_key.prv, nano::test_genesis_key.pub, *system.work.generate (genesis.hash ())));
+	auto snapshot1 (node.active.snapshot ());
+	ASSERT_TRUE (snapshot1->elections.empty ());
+	// Unchanged container reuses the snapshot
+	ASSERT_EQ (snapshot1, node.active.snapshot ());
+	ASSERT_TRUE (node.active.insert (send).second);
+	auto snapshot2 (node.active.snapshot ());
+	ASSERT_NE (snapshot1, snapshot2);
+	ASSERT_EQ (1, snapshot2->elections.size ());
+	ASSERT_EQ (send->qualified_root (), snapshot2->elections.front ().root);
+	ASSERT_EQ (send, snapshot2->elections.front ().winner);
+	ASSERT_EQ (1, node.active.list_blocks ().size ());
+	node.active.erase (*send);
+	ASSERT_TRUE (node.active.snapshot ()->elections.empty ());
+	// Earlier snapshots are not modified
+	ASSERT_EQ (1, snapshot2->elections.size ());
+}
@@ -0,0 +1,107 @@
+#include <nano/core_test/testutil.hpp>
+#include <nano/lib/logger_mt.hpp>
+#include <nano/secure/block_filter.hpp>
+#include <nano/secure/blockstore.hpp>
+#include <nano/secure/utility.hpp>
+
+#include <gtest/gtest.h>
+
+TEST (block_filter, disabled)
+{
+	nano::block_filter filter;
+	ASSERT_FALSE (filter.enabled ());
+	ASSERT_TRUE (filter.may_contain (nano::block_hash (1)));
+	filter.reset (0);
+	filter.enable ();
+	ASSERT_FALSE (filter.enabled ());
+	ASSERT_TRUE (filter.may_contain (nano::block_hash (1)));
+	ASSERT_EQ (0, filter.size_bytes ());
+}
+
+TEST (block_filter, unit)
+{
+	nano::block_filter filter;
+	filter.reset (1024);
+	ASSERT_EQ (1024, filter.size_bytes ());
+	std::vector<nano::block_hash> hashes (100);
+	for (auto & hash : hashes)
+	{
+		nano::random_pool::generate_block (hash.bytes.data (), hash.bytes.size ());
+		filter.insert (hash);
+	}
+	// Lookups are not answered until enabled
+	nano::block_hash missing;
+	nano::random_pool::generate_block (missing.bytes.data (), missing.bytes.size ());
+	ASSERT_TRUE (filter.may_contain (missing));
+	filter.enable ();
+	ASSERT_TRUE (filter.enabled ());
+	ASSERT_EQ (hashes.size (), filter.element_count ());
+	// There are no false negatives
+	for (auto const & hash : hashes)
+	{
+		ASSERT_TRUE (filter.may_contain (hash));
+	}
+	ASSERT_EQ (0, filter.negative_count ());
+	// Most random hashes are rejected with 80 bits per element
+	auto rejected (0);
+	for (auto i (0); i < 1000; ++i)
+	{
+		nano::random_pool::generate_block (missing.bytes.data (), missing.bytes.size ());
+		if (!filter.may_contain (missing))
+		{
+			++rejected;
+		}
+		else
+		{
+			filter.false_positive ();
+		}
+	}
+	ASSERT_GT (rejected, 900);
+	ASSERT_EQ (rejected, filter.negative_count ());
+	ASSERT_EQ (1000 - rejected, filter.false_positive_count ());
+	ASSERT_DOUBLE_EQ ((1000 - rejected) / 1000., filter.false_positive_rate ());
+	// Removing elements leaves their bits set
+	filter.erase (hashes[0]);
+	ASSERT_TRUE (filter.may_contain (hashes[0]));
+	ASSERT_EQ (hashes.size () - 1, filter.element_count ());
+}
+
+TEST (block_filter, store)
+{
+	nano::logger_mt logger;
+	auto store = nano::make_store (logger, nano::unique_path ());
+	ASSERT_TRUE (!store->init_error ());
+	nano::genesis genesis;
+	nano::open_block block1 (0, 1, 0, nano::keypair ().prv, 0, 0);
+	block1.sideband_set ({});
+	nano::open_block block2 (1, 1, 0, nano::keypair ().prv, 0, 0);
+	block2.sideband_set ({});
+	{
+		auto transaction (store->tx_begin_write ());
+		nano::ledger_cache ledger_cache;
+		store->initialize (transaction, genesis, ledger_cache);
+		store->block_put (transaction, block1.hash (), block1);
+	}
+	{
+		auto transaction (store->tx_begin_read ());
+		store->block_filter_build (transaction, 64 * 1024);
+	}
+	auto & filter (store->get_block_filter ());
+	ASSERT_TRUE (filter.enabled ());
+	ASSERT_EQ (2, filter.element_count ());
+	auto transaction (store->tx_begin_write ());
+	ASSERT_TRUE (store->block_exists (transaction, genesis.hash ()));
+	ASSERT_TRUE (store->block_exists (transaction, block1.hash ()));
+	ASSERT_TRUE (store->block_exists (transaction, nano::block_type::open, block1.hash ()));
+	ASSERT_FALSE (store->block_exists (transaction, nano::block_type::state, block1.hash ()));
+	ASSERT_TRUE (store->root_exists (transaction, block1.hash ()));
+	// Blocks added after the filter is built are inserted
+	ASSERT_FALSE (store->block_exists (transaction, block2.hash ()));
+	store->block_put (transaction, block2.hash (), block2);
+	ASSERT_TRUE (store->block_exists (transaction, block2.hash ()));
+	ASSERT_EQ (3, filter.element_count ());
+	store->block_del (transaction, block2.hash ());
+	ASSERT_FALSE (store->block_exists (transaction, block2.hash ()));
+	ASSERT_EQ (2, filter.element_count ());
+	ASSERT_EQ (filter.negative_count () + filter.false_positive_count (), 2);
+}
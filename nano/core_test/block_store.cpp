@@ -12,6 +12,7 @@
 #include <boost/filesystem.hpp>
 
 #if NANO_ROCKSDB
+#include <nano/lib/rocksdbconfig.hpp>
 #include <nano/node/rocksdb/rocksdb.hpp>
 #endif
 
@@ -29,11 +30,13 @@ namespace
 {
 void modify_account_info_to_v13 (nano::mdb_store & store, nano::transaction const & transaction_a, nano::account const & account_a, nano::block_hash const & rep_block);
 void modify_account_info_to_v14 (nano::mdb_store & store, nano::transaction const & transaction_a, nano::account const & account_a, uint64_t confirmation_height, nano::block_hash const & rep_block);
-void modify_genesis_account_info_to_v5 (nano::mdb_store & store, nano::transaction const & transaction_a);
 void modify_confirmation_height_to_v15 (nano::mdb_store & store, nano::transaction const & transaction, nano::account const & account, uint64_t confirmation_height);
-void write_sideband_v12 (nano::mdb_store & store_a, nano::transaction & transaction_a, nano::block & block_a, nano::block_hash const & successor_a, MDB_dbi db_a);
+void modify_genesis_account_info_to_v5 (nano::mdb_store & store, nano::transaction const & transaction_a);
+void open_block_tables_v14 (nano::mdb_store & store_a, nano::transaction const & transaction_a);
+void write_sideband_v12 (nano::mdb_store & store_a, nano::write_transaction & transaction_a, nano::block & block_a, nano::block_hash const & successor_a, MDB_dbi db_a);
 void write_sideband_v14 (nano::mdb_store & store_a, nano::transaction & transaction_a, nano::block const & block_a, MDB_dbi db_a);
-void write_sideband_v15 (nano::mdb_store & store_a, nano::transaction & transaction_a, nano::block const & block_a);
+void write_sideband_v15 (nano::mdb_store & store_a, nano::write_transaction & transaction_a, nano::block const & block_a);
+void write_block_w_sideband_v18 (nano::mdb_store & store_a, MDB_dbi database, nano::write_transaction & transaction_a, nano::block const & block_a);
 }
 
 TEST (block_store, construction)
@@ -129,7 +132,7 @@ TEST (block_store, add_item)
 	ASSERT_EQ (block, *latest2);
 	ASSERT_TRUE (store->block_exists (transaction, hash1));
 	ASSERT_FALSE (store->block_exists (transaction, hash1.number () - 1));
-	store->block_del (transaction, hash1, block.type ());
+	store->block_del (transaction, hash1);
 	auto latest3 (store->block_get (transaction, hash1));
 	ASSERT_EQ (nullptr, latest3);
 }
@@ -782,14 +785,58 @@ TEST (block_store, block_count)
 	ASSERT_TRUE (!store->init_error ());
 	{
 		auto transaction (store->tx_begin_write ());
-		ASSERT_EQ (0, store->block_count (transaction).sum ());
+		ASSERT_EQ (0, store->block_count (transaction));
 		nano::open_block block (0, 1, 0, nano::keypair ().prv, 0, 0);
 		block.sideband_set ({});
 		auto hash1 (block.hash ());
 		store->block_put (transaction, hash1, block);
 	}
 	auto transaction (store->tx_begin_read ());
-	ASSERT_EQ (1, store->block_count (transaction).sum ());
+	ASSERT_EQ (1, store->block_count (transaction));
+}
+
+TEST (block_store, block_height_index)
+{
+	nano::logger_mt logger;
+	auto store = nano::make_store (logger, nano::unique_path ());
+	ASSERT_TRUE (!store->init_error ());
+	nano::stat stats;
+	nano::ledger ledger (*store, stats);
+	nano::genesis genesis;
+	nano::work_pool pool (std::numeric_limits<unsigned>::max ());
+	auto transaction (store->tx_begin_write ());
+	store->initialize (transaction, genesis, ledger.cache);
+	nano::send_block send (genesis.hash (), nano::test_genesis_key.pub, nano::genesis_amount - nano::Gxrb_ratio, nano::test_genesis_key.prv, nano::test_genesis_key.pub, *pool.generate (genesis.hash ()));
+	ASSERT_EQ (nano::process_result::progress, ledger.process (transaction, send).code);
+	ASSERT_TRUE (store->block_hash_at_height (transaction, nano::test_genesis_key.pub, 2).is_zero ());
+	// Existing blocks are indexed when it's enabled
+	store->block_height_index_set (transaction, true);
+	ASSERT_TRUE (store->block_height_index_enabled ());
+	ASSERT_EQ (genesis.hash (), store->block_hash_at_height (transaction, nano::test_genesis_key.pub, 1));
+	ASSERT_EQ (send.hash (), store->block_hash_at_height (transaction, nano::test_genesis_key.pub, 2));
+	ASSERT_TRUE (store->block_hash_at_height (transaction, nano::test_genesis_key.pub, 3).is_zero ());
+	ASSERT_TRUE (store->block_hash_at_height (transaction, nano::account (1), 1).is_zero ());
+	// New blocks are added and rolled back blocks removed
+	nano::state_block state (nano::test_genesis_key.pub, send.hash (), nano::test_genesis_key.pub, nano::genesis_amount - 2 * nano::Gxrb_ratio, nano::test_genesis_key.pub, nano::test_genesis_key.prv, nano::test_genesis_key.pub, *pool.generate (send.hash ()));
+	ASSERT_EQ (nano::process_result::progress, ledger.process (transaction, state).code);
+	ASSERT_EQ (state.hash (), store->block_hash_at_height (transaction, nano::test_genesis_key.pub, 3));
+	ASSERT_FALSE (ledger.rollback (transaction, state.hash ()));
+	ASSERT_TRUE (store->block_hash_at_height (transaction, nano::test_genesis_key.pub, 3).is_zero ());
+	ASSERT_EQ (send.hash (), store->block_hash_at_height (transaction, nano::test_genesis_key.pub, 2));
+	// Disabling drops the index, so blocks written meanwhile are picked up when it's enabled again
+	store->block_height_index_set (transaction, false);
+	ASSERT_FALSE (store->block_height_index_enabled ());
+	ASSERT_TRUE (store->block_hash_at_height (transaction, nano::test_genesis_key.pub, 2).is_zero ());
+	ASSERT_EQ (nano::process_result::progress, ledger.process (transaction, state).code);
+	store->block_height_index_set (transaction, true);
+	ASSERT_EQ (state.hash (), store->block_hash_at_height (transaction, nano::test_genesis_key.pub, 3));
+	// Loading only uses an index which was completely filled
+	store->block_height_index_load (transaction);
+	ASSERT_TRUE (store->block_height_index_enabled ());
+	store->block_height_index_set (transaction, false);
+	store->block_height_index_load (transaction);
+	ASSERT_FALSE (store->block_height_index_enabled ());
+	ASSERT_TRUE (store->block_hash_at_height (transaction, nano::test_genesis_key.pub, 3).is_zero ());
 }
 
 TEST (block_store, account_count)
@@ -884,6 +931,9 @@ TEST (mdb_block_store, upgrade_v2_v3)
 		auto status (mdb_put (store.env.tx (transaction), store.accounts_v0, nano::mdb_val (nano::test_genesis_key.pub), nano::mdb_val (sizeof (info_old), &info_old), 0));
 		ASSERT_EQ (status, 0);
 		store.confirmation_height_del (transaction, nano::genesis_account);
+		open_block_tables_v14 (store, transaction);
+		write_block_w_sideband_v18 (store, store.open_blocks, transaction, *genesis.open);
+		write_block_w_sideband_v18 (store, store.change_blocks, transaction, change);
 	}
 	nano::logger_mt logger;
 	nano::mdb_store store (logger, path);
@@ -962,6 +1012,9 @@ TEST (mdb_block_store, upgrade_v4_v5)
 		auto status (mdb_put (store.env.tx (transaction), store.pending_v0, nano::mdb_val (nano::pending_key (key0.pub, block0.hash ())), nano::mdb_val (nano::pending_info_v14 (nano::genesis_account, nano::Gxrb_ratio, nano::epoch::epoch_0)), 0));
 		ASSERT_EQ (status, MDB_SUCCESS);
 		store.confirmation_height_del (transaction, nano::genesis_account);
+		open_block_tables_v14 (store, transaction);
+		write_block_w_sideband_v18 (store, store.open_blocks, transaction, *genesis.open);
+		write_block_w_sideband_v18 (store, store.send_blocks, transaction, block0);
 	}
 	nano::logger_mt logger;
 	nano::mdb_store store (logger, path);
@@ -1001,6 +1054,8 @@ TEST (mdb_block_store, upgrade_v5_v6)
 		store.version_put (transaction, 5);
 		modify_genesis_account_info_to_v5 (store, transaction);
 		store.confirmation_height_del (transaction, nano::genesis_account);
+		open_block_tables_v14 (store, transaction);
+		write_block_w_sideband_v18 (store, store.open_blocks, transaction, *genesis.open);
 	}
 	nano::logger_mt logger;
 	nano::mdb_store store (logger, path);
@@ -1029,6 +1084,8 @@ TEST (mdb_block_store, upgrade_v6_v7)
 		store.flush (transaction);
 		ASSERT_NE (store.unchecked_end (), store.unchecked_begin (transaction));
 		store.confirmation_height_del (transaction, nano::genesis_account);
+		open_block_tables_v14 (store, transaction);
+		write_block_w_sideband_v18 (store, store.open_blocks, transaction, *genesis.open);
 	}
 	nano::logger_mt logger;
 	nano::mdb_store store (logger, path);
@@ -1195,14 +1252,12 @@ TEST (block_store, state_block)
 	}
 	{
 		auto transaction (store->tx_begin_write ());
-		auto count (store->block_count (transaction));
-		ASSERT_EQ (1, count.state);
-		store->block_del (transaction, block1.hash (), block1.type ());
+		ASSERT_EQ (2, store->block_count (transaction));
+		store->block_del (transaction, block1.hash ());
 		ASSERT_FALSE (store->block_exists (transaction, block1.hash ()));
 	}
 	auto transaction (store->tx_begin_read ());
-	auto count2 (store->block_count (transaction));
-	ASSERT_EQ (0, count2.state);
+	ASSERT_EQ (1, store->block_count (transaction));
 }
 
 TEST (mdb_block_store, upgrade_sideband_genesis)
@@ -1221,7 +1276,7 @@ TEST (mdb_block_store, upgrade_sideband_genesis)
 		auto genesis_block (store.block_get (transaction, genesis.hash ()));
 		ASSERT_NE (nullptr, genesis_block);
 		ASSERT_EQ (1, genesis_block->sideband ().height);
-		ASSERT_FALSE (mdb_dbi_open (store.env.tx (transaction), "state_v1", MDB_CREATE, &store.state_blocks_v1));
+		open_block_tables_v14 (store, transaction);
 		write_sideband_v12 (store, transaction, *genesis_block, 0, store.open_blocks);
 		nano::block_sideband_v14 sideband1;
 		auto genesis_block2 (store.block_get_v14 (transaction, genesis.hash (), &sideband1));
@@ -1257,9 +1312,7 @@ TEST (mdb_block_store, upgrade_sideband_two_blocks)
 		nano::state_block block (nano::test_genesis_key.pub, genesis.hash (), nano::test_genesis_key.pub, nano::genesis_amount - nano::Gxrb_ratio, nano::test_genesis_key.pub, nano::test_genesis_key.prv, nano::test_genesis_key.pub, *pool.generate (genesis.hash ()));
 		hash2 = block.hash ();
 		ASSERT_EQ (nano::process_result::progress, ledger.process (transaction, block).code);
-		store.block_del (transaction, hash2, block.type ());
-		mdb_dbi_open (store.env.tx (transaction), "state_v1", MDB_CREATE, &store.state_blocks_v1);
-		mdb_dbi_open (store.env.tx (transaction), "state", MDB_CREATE, &store.state_blocks_v0);
+		open_block_tables_v14 (store, transaction);
 		write_sideband_v12 (store, transaction, *genesis.open, hash2, store.open_blocks);
 		write_sideband_v12 (store, transaction, block, 0, store.state_blocks_v0);
 		modify_account_info_to_v13 (store, transaction, nano::genesis_account, hash2);
@@ -1302,10 +1355,7 @@ TEST (mdb_block_store, upgrade_sideband_two_accounts)
 		nano::state_block block2 (key.pub, 0, nano::test_genesis_key.pub, nano::Gxrb_ratio, hash2, key.prv, key.pub, *pool.generate (key.pub));
 		hash3 = block2.hash ();
 		ASSERT_EQ (nano::process_result::progress, ledger.process (transaction, block2).code);
-		store.block_del (transaction, hash2, block1.type ());
-		store.block_del (transaction, hash3, block2.type ());
-		mdb_dbi_open (store.env.tx (transaction), "state_v1", MDB_CREATE, &store.state_blocks_v1);
-		mdb_dbi_open (store.env.tx (transaction), "state", MDB_CREATE, &store.state_blocks_v0);
+		open_block_tables_v14 (store, transaction);
 		write_sideband_v12 (store, transaction, *genesis.open, hash2, store.open_blocks);
 		write_sideband_v12 (store, transaction, block1, 0, store.state_blocks_v0);
 		write_sideband_v12 (store, transaction, block2, 0, store.state_blocks_v0);
@@ -1330,24 +1380,6 @@ TEST (mdb_block_store, upgrade_sideband_two_accounts)
 	ASSERT_EQ (1, block3->sideband ().height);
 }
 
-TEST (mdb_block_store, insert_after_legacy)
-{
-	nano::logger_mt logger;
-	nano::genesis genesis;
-	nano::mdb_store store (logger, nano::unique_path ());
-	ASSERT_FALSE (store.init_error ());
-	nano::stat stat;
-	nano::ledger ledger (store, stat);
-	auto transaction (store.tx_begin_write ());
-	store.version_put (transaction, 11);
-	store.initialize (transaction, genesis, ledger.cache);
-	mdb_dbi_open (store.env.tx (transaction), "state_v1", MDB_CREATE, &store.state_blocks_v1);
-	write_sideband_v12 (store, transaction, *genesis.open, 0, store.open_blocks);
-	nano::work_pool pool (std::numeric_limits<unsigned>::max ());
-	nano::state_block block (nano::test_genesis_key.pub, genesis.hash (), nano::test_genesis_key.pub, nano::genesis_amount - nano::Gxrb_ratio, nano::test_genesis_key.pub, nano::test_genesis_key.prv, nano::test_genesis_key.pub, *pool.generate (genesis.hash ()));
-	ASSERT_EQ (nano::process_result::progress, ledger.process (transaction, block).code);
-}
-
 // Account for an open block should be retrievable
 TEST (mdb_block_store, legacy_account_computed)
 {
@@ -1360,9 +1392,9 @@ TEST (mdb_block_store, legacy_account_computed)
 	auto transaction (store.tx_begin_write ());
 	store.initialize (transaction, genesis, ledger.cache);
 	store.version_put (transaction, 11);
-	mdb_dbi_open (store.env.tx (transaction), "state_v1", MDB_CREATE, &store.state_blocks_v1);
+	open_block_tables_v14 (store, transaction);
 	write_sideband_v12 (store, transaction, *genesis.open, 0, store.open_blocks);
-	ASSERT_EQ (nano::genesis_account, ledger.account (transaction, genesis.hash ()));
+	ASSERT_EQ (nano::genesis_account, store.block_account_computed_v14 (transaction, genesis.hash ()));
 }
 
 TEST (mdb_block_store, upgrade_sideband_epoch)
@@ -1383,11 +1415,9 @@ TEST (mdb_block_store, upgrade_sideband_epoch)
 		store.initialize (transaction, genesis, ledger.cache);
 		nano::state_block block1 (nano::test_genesis_key.pub, genesis.hash (), nano::test_genesis_key.pub, nano::genesis_amount, ledger.epoch_link (nano::epoch::epoch_1), nano::test_genesis_key.prv, nano::test_genesis_key.pub, *pool.generate (genesis.hash ()));
 		hash2 = block1.hash ();
-		ASSERT_FALSE (mdb_dbi_open (store.env.tx (transaction), "state_v1", MDB_CREATE, &store.state_blocks_v1));
 		ASSERT_EQ (nano::process_result::progress, ledger.process (transaction, block1).code);
 		ASSERT_EQ (nano::epoch::epoch_1, store.block_version (transaction, hash2));
-		store.block_del (transaction, hash2, block1.type ());
-		store.block_del (transaction, genesis.open->hash (), genesis.open->type ());
+		open_block_tables_v14 (store, transaction);
 		write_sideband_v12 (store, transaction, *genesis.open, hash2, store.open_blocks);
 		write_sideband_v12 (store, transaction, block1, 0, store.state_blocks_v1);
 
@@ -1624,6 +1654,8 @@ TEST (mdb_block_store, upgrade_v13_v14)
 		nano::account_info_v14 info;
 		ASSERT_NE (value.size (), info.db_size ());
 		store.confirmation_height_del (transaction, nano::genesis_account);
+		open_block_tables_v14 (store, transaction);
+		write_block_w_sideband_v18 (store, store.open_blocks, transaction, *genesis.open);
 	}
 
 	// Now do the upgrade
@@ -1680,6 +1712,8 @@ TEST (mdb_block_store, upgrade_v14_v15)
 		ASSERT_FALSE (mdb_dbi_open (store.env.tx (transaction), "state_v1", MDB_CREATE, &store.state_blocks_v1));
 		ASSERT_FALSE (mdb_dbi_open (store.env.tx (transaction), "accounts_v1", MDB_CREATE, &store.accounts_v1));
 		ASSERT_FALSE (mdb_dbi_open (store.env.tx (transaction), "pending_v1", MDB_CREATE, &store.pending_v1));
+		ASSERT_FALSE (mdb_dbi_open (store.env.tx (transaction), "open", MDB_CREATE, &store.open_blocks));
+		ASSERT_FALSE (mdb_dbi_open (store.env.tx (transaction), "send", MDB_CREATE, &store.send_blocks));
 		ASSERT_EQ (nano::process_result::progress, ledger.process (transaction, send).code);
 		ASSERT_EQ (nano::process_result::progress, ledger.process (transaction, epoch).code);
 		ASSERT_EQ (nano::process_result::progress, ledger.process (transaction, state_send).code);
@@ -1694,8 +1728,12 @@ TEST (mdb_block_store, upgrade_v14_v15)
 		write_sideband_v14 (store, transaction, epoch, store.state_blocks_v1);
 
 		// Remove from state table
-		store.block_del (transaction, state_send.hash (), state_send.type ());
-		store.block_del (transaction, epoch.hash (), epoch.type ());
+		store.block_del (transaction, state_send.hash ());
+		store.block_del (transaction, epoch.hash ());
+
+		// Move the remaining blocks back to their per-type tables
+		write_block_w_sideband_v18 (store, store.open_blocks, transaction, *genesis.open);
+		write_block_w_sideband_v18 (store, store.send_blocks, transaction, send);
 
 		// Turn pending into v14
 		ASSERT_FALSE (mdb_put (store.env.tx (transaction), store.pending_v0, nano::mdb_val (nano::pending_key (nano::test_genesis_key.pub, send.hash ())), nano::mdb_val (nano::pending_info_v14 (nano::genesis_account, nano::Gxrb_ratio, nano::epoch::epoch_0)), 0));
@@ -1821,6 +1859,13 @@ TEST (mdb_block_store, upgrade_v16_v17)
 			ASSERT_EQ (nano::process_result::progress, ledger.process (transaction, block3).code);
 			modify_confirmation_height_to_v15 (store, transaction, nano::genesis_account, confirmation_height);
 
+			ASSERT_FALSE (mdb_dbi_open (store.env.tx (transaction), "open", MDB_CREATE, &store.open_blocks));
+			write_block_w_sideband_v18 (store, store.open_blocks, transaction, *genesis.open);
+			ASSERT_FALSE (mdb_dbi_open (store.env.tx (transaction), "state_blocks", MDB_CREATE, &store.state_blocks));
+			write_block_w_sideband_v18 (store, store.state_blocks, transaction, block1);
+			write_block_w_sideband_v18 (store, store.state_blocks, transaction, block2);
+			write_block_w_sideband_v18 (store, store.state_blocks, transaction, block3);
+
 			// Lower the database to the previous version
 			store.version_put (transaction, 16);
 		}
@@ -1893,20 +1938,25 @@ TEST (mdb_block_store, upgrade_v17_v18)
 
 		// Downgrade the store
 		store.version_put (transaction, 17);
+		ASSERT_FALSE (mdb_dbi_open (store.env.tx (transaction), "open", MDB_CREATE, &store.open_blocks));
+		ASSERT_FALSE (mdb_dbi_open (store.env.tx (transaction), "send", MDB_CREATE, &store.send_blocks));
+		ASSERT_FALSE (mdb_dbi_open (store.env.tx (transaction), "state_blocks", MDB_CREATE, &store.state_blocks));
+		write_block_w_sideband_v18 (store, store.open_blocks, transaction, *genesis.open);
+		write_block_w_sideband_v18 (store, store.send_blocks, transaction, send_zero);
 
 		// Replace with the previous sideband version for state blocks
 		// The upgrade can resume after upgrading some blocks, test this by only downgrading some of them
 		write_sideband_v15 (store, transaction, state_receive_zero);
 		write_sideband_v15 (store, transaction, epoch);
 		write_sideband_v15 (store, transaction, state_send);
-		// DISABLED write_sideband_v15 (store, transaction, state_receive);
+		write_block_w_sideband_v18 (store, store.state_blocks, transaction, state_receive);
 		write_sideband_v15 (store, transaction, state_change);
 		write_sideband_v15 (store, transaction, state_send_change);
-		// DISABLED write_sideband_v15 (store, transaction, epoch_first);
+		write_block_w_sideband_v18 (store, store.state_blocks, transaction, epoch_first);
 		write_sideband_v15 (store, transaction, state_receive2);
-		// DISABLED write_sideband_v15 (store, transaction, state_send2);
+		write_block_w_sideband_v18 (store, store.state_blocks, transaction, state_send2);
 		write_sideband_v15 (store, transaction, state_open);
-		// DISABLED write_sideband_v15 (store, transaction, state_send_epoch_link);
+		write_block_w_sideband_v18 (store, store.state_blocks, transaction, state_send_epoch_link);
 	}
 
 	// Now do the upgrade
@@ -1916,10 +1966,10 @@ TEST (mdb_block_store, upgrade_v17_v18)
 	ASSERT_FALSE (error);
 	auto transaction (store.tx_begin_read ());
 
-	// Size of state block should equal that set in db (no change)
+	// Size of state block should equal that set in db, with the block type prefix added in v19
 	nano::mdb_val value;
-	ASSERT_FALSE (mdb_get (store.env.tx (transaction), store.state_blocks, nano::mdb_val (state_send.hash ()), value));
-	ASSERT_EQ (value.size (), nano::state_block::size + nano::block_sideband::size (nano::block_type::state));
+	ASSERT_FALSE (mdb_get (store.env.tx (transaction), store.blocks, nano::mdb_val (state_send.hash ()), value));
+	ASSERT_EQ (value.size (), 1 + nano::state_block::size + nano::block_sideband::size (nano::block_type::state));
 
 	// Check that sidebands are correctly populated
 	{
@@ -2035,6 +2085,81 @@ TEST (mdb_block_store, upgrade_v17_v18)
 	ASSERT_LT (17, store.version_get (transaction));
 }
 
+TEST (mdb_block_store, upgrade_v18_v19)
+{
+	auto path (nano::unique_path ());
+	nano::genesis genesis;
+	nano::keypair key1;
+	nano::work_pool pool (std::numeric_limits<unsigned>::max ());
+	nano::send_block send (genesis.hash (), nano::test_genesis_key.pub, nano::genesis_amount - nano::Gxrb_ratio, nano::test_genesis_key.prv, nano::test_genesis_key.pub, *pool.generate (genesis.hash ()));
+	nano::receive_block receive (send.hash (), send.hash (), nano::test_genesis_key.prv, nano::test_genesis_key.pub, *pool.generate (send.hash ()));
+	nano::change_block change (receive.hash (), 0, nano::test_genesis_key.prv, nano::test_genesis_key.pub, *pool.generate (receive.hash ()));
+	nano::state_block state_send (nano::test_genesis_key.pub, change.hash (), 0, nano::genesis_amount - nano::Gxrb_ratio, key1.pub, nano::test_genesis_key.prv, nano::test_genesis_key.pub, *pool.generate (change.hash ()));
+	nano::open_block open (state_send.hash (), key1.pub, key1.pub, key1.prv, key1.pub, *pool.generate (key1.pub));
+	{
+		nano::logger_mt logger;
+		nano::mdb_store store (logger, path);
+		nano::stat stats;
+		nano::ledger ledger (store, stats);
+		auto transaction (store.tx_begin_write ());
+		store.initialize (transaction, genesis, ledger.cache);
+		ASSERT_EQ (nano::process_result::progress, ledger.process (transaction, send).code);
+		ASSERT_EQ (nano::process_result::progress, ledger.process (transaction, receive).code);
+		ASSERT_EQ (nano::process_result::progress, ledger.process (transaction, change).code);
+		ASSERT_EQ (nano::process_result::progress, ledger.process (transaction, state_send).code);
+		ASSERT_EQ (nano::process_result::progress, ledger.process (transaction, open).code);
+
+		// Split the blocks back into the per-type tables
+		ASSERT_FALSE (mdb_dbi_open (store.env.tx (transaction), "send", MDB_CREATE, &store.send_blocks));
+		ASSERT_FALSE (mdb_dbi_open (store.env.tx (transaction), "receive", MDB_CREATE, &store.receive_blocks));
+		ASSERT_FALSE (mdb_dbi_open (store.env.tx (transaction), "open", MDB_CREATE, &store.open_blocks));
+		ASSERT_FALSE (mdb_dbi_open (store.env.tx (transaction), "change", MDB_CREATE, &store.change_blocks));
+		ASSERT_FALSE (mdb_dbi_open (store.env.tx (transaction), "state_blocks", MDB_CREATE, &store.state_blocks));
+		write_block_w_sideband_v18 (store, store.open_blocks, transaction, *genesis.open);
+		write_block_w_sideband_v18 (store, store.send_blocks, transaction, send);
+		write_block_w_sideband_v18 (store, store.receive_blocks, transaction, receive);
+		write_block_w_sideband_v18 (store, store.change_blocks, transaction, change);
+		write_block_w_sideband_v18 (store, store.state_blocks, transaction, state_send);
+		write_block_w_sideband_v18 (store, store.open_blocks, transaction, open);
+		ASSERT_EQ (0, store.block_count (transaction));
+
+		// Lower the database to the previous version
+		store.version_put (transaction, 18);
+	}
+
+	// Now do the upgrade
+	nano::logger_mt logger;
+	nano::mdb_store store (logger, path);
+	ASSERT_FALSE (store.init_error ());
+	auto transaction (store.tx_begin_read ());
+
+	// The per-type tables should be removed
+	ASSERT_EQ (0, store.send_blocks);
+	ASSERT_EQ (0, store.receive_blocks);
+	ASSERT_EQ (0, store.open_blocks);
+	ASSERT_EQ (0, store.change_blocks);
+	ASSERT_EQ (0, store.state_blocks);
+
+	// All blocks should be in the blocks table with their sideband intact
+	ASSERT_EQ (6, store.block_count (transaction));
+	for (auto block : std::initializer_list<nano::block const *>{ genesis.open.get (), &send, &receive, &change, &state_send, &open })
+	{
+		auto block_l (store.block_get (transaction, block->hash ()));
+		ASSERT_NE (nullptr, block_l);
+		ASSERT_EQ (*block, *block_l);
+		ASSERT_EQ (block->type (), block_l->type ());
+		ASSERT_TRUE (store.block_exists (transaction, block->type (), block->hash ()));
+	}
+	auto state_send_l (store.block_get (transaction, state_send.hash ()));
+	ASSERT_EQ (nano::genesis_account, state_send_l->sideband ().account);
+	ASSERT_EQ (4, state_send_l->sideband ().height);
+	ASSERT_TRUE (store.block_successor (transaction, state_send.hash ()).is_zero ());
+	ASSERT_EQ (state_send.hash (), store.block_successor (transaction, change.hash ()));
+
+	// Version should be correct
+	ASSERT_EQ (19, store.version_get (transaction));
+}
+
 TEST (mdb_block_store, upgrade_backup)
 {
 	auto dir (nano::unique_path ());
@@ -2135,6 +2260,8 @@ TEST (mdb_block_store, upgrade_confirmation_height_many)
 		nano::ledger_cache ledger_cache;
 		store.initialize (transaction, genesis, ledger_cache);
 		modify_account_info_to_v13 (store, transaction, nano::genesis_account, nano::genesis_hash);
+		open_block_tables_v14 (store, transaction);
+		write_block_w_sideband_v18 (store, store.open_blocks, transaction, *genesis.open);
 
 		// Add many accounts
 		for (auto i = 0; i < total_num_accounts - 1; ++i)
@@ -2143,6 +2270,7 @@ TEST (mdb_block_store, upgrade_confirmation_height_many)
 			nano::open_block open (1, nano::genesis_account, 3, nullptr);
 			open.sideband_set ({});
 			store.block_put (transaction, open.hash (), open);
+			write_block_w_sideband_v18 (store, store.open_blocks, transaction, open);
 			nano::account_info_v13 account_info_v13 (open.hash (), open.hash (), open.hash (), 3, 4, 1, nano::epoch::epoch_0);
 			auto status (mdb_put (store.env.tx (transaction), store.accounts_v0, nano::mdb_val (account), nano::mdb_val (account_info_v13), 0));
 			ASSERT_EQ (status, 0);
@@ -2250,9 +2378,72 @@ TEST (block_store, rocksdb_force_test_env_variable)
 #endif
 }
 
+#if NANO_ROCKSDB
+/** Pending and unchecked have a prefix extractor, iterating must still carry on past the prefix which was seeked to */
+TEST (block_store, rocksdb_prefix_iteration)
+{
+	nano::logger_mt logger;
+	auto path (nano::unique_path ());
+	nano::rocksdb_config config;
+	ASSERT_LT (0, config.prefix_bloom_filter_bits);
+	nano::genesis genesis;
+	{
+		nano::rocksdb_store store (logger, path, config);
+		ASSERT_FALSE (store.init_error ());
+		auto transaction (store.tx_begin_write ());
+		store.pending_put (transaction, nano::pending_key (1, 1), nano::pending_info (1, 1, nano::epoch::epoch_0));
+		store.pending_put (transaction, nano::pending_key (3, 1), nano::pending_info (3, 1, nano::epoch::epoch_0));
+		store.unchecked_put (transaction, nano::block_hash (1), genesis.open);
+		store.unchecked_put (transaction, nano::block_hash (3), genesis.open);
+	}
+	// Reopening writes the entries out to table files with prefix filters
+	nano::rocksdb_store store (logger, path, config);
+	ASSERT_FALSE (store.init_error ());
+	auto transaction (store.tx_begin_read ());
+	nano::pending_info pending;
+	ASSERT_FALSE (store.pending_get (transaction, nano::pending_key (3, 1), pending));
+	ASSERT_TRUE (store.pending_get (transaction, nano::pending_key (2, 1), pending));
+	auto pending_i (store.pending_begin (transaction, nano::pending_key (2, 0)));
+	ASSERT_NE (store.pending_end (), pending_i);
+	ASSERT_EQ (nano::account (3), pending_i->first.account);
+	pending_i = store.pending_begin (transaction, nano::pending_key (1, 0));
+	ASSERT_EQ (nano::account (1), pending_i->first.account);
+	++pending_i;
+	ASSERT_NE (store.pending_end (), pending_i);
+	ASSERT_EQ (nano::account (3), pending_i->first.account);
+	// Seeks within one account go through the prefix filter and end after the account's entries
+	auto account_i (store.pending_account_begin (transaction, nano::pending_key (1, 0)));
+	ASSERT_NE (store.pending_end (), account_i);
+	ASSERT_EQ (nano::account (1), account_i->first.account);
+	++account_i;
+	ASSERT_EQ (store.pending_end (), account_i);
+	ASSERT_EQ (store.pending_end (), store.pending_account_begin (transaction, nano::pending_key (2, 0)));
+	ASSERT_TRUE (store.pending_exists (transaction, nano::pending_key (3, 1)));
+	ASSERT_FALSE (store.pending_exists (transaction, nano::pending_key (2, 1)));
+	auto unchecked_i (store.unchecked_begin (transaction, nano::unchecked_key (2, 0)));
+	ASSERT_NE (store.unchecked_end (), unchecked_i);
+	ASSERT_EQ (nano::block_hash (3), unchecked_i->first.key ());
+	ASSERT_EQ (2, store.unchecked_count (transaction));
+	ASSERT_EQ (1, store.unchecked_get (transaction, nano::block_hash (3)).size ());
+	ASSERT_TRUE (store.unchecked_get (transaction, nano::block_hash (2)).empty ());
+}
+#endif
+
 namespace
 {
-void write_sideband_v12 (nano::mdb_store & store_a, nano::transaction & transaction_a, nano::block & block_a, nano::block_hash const & successor_a, MDB_dbi db_a)
+// Opens the per-type block tables as they were named before v15, which are not created for new ledgers
+void open_block_tables_v14 (nano::mdb_store & store_a, nano::transaction const & transaction_a)
+{
+	ASSERT_FALSE (mdb_dbi_open (store_a.env.tx (transaction_a), "send", MDB_CREATE, &store_a.send_blocks));
+	ASSERT_FALSE (mdb_dbi_open (store_a.env.tx (transaction_a), "receive", MDB_CREATE, &store_a.receive_blocks));
+	ASSERT_FALSE (mdb_dbi_open (store_a.env.tx (transaction_a), "open", MDB_CREATE, &store_a.open_blocks));
+	ASSERT_FALSE (mdb_dbi_open (store_a.env.tx (transaction_a), "change", MDB_CREATE, &store_a.change_blocks));
+	ASSERT_FALSE (mdb_dbi_open (store_a.env.tx (transaction_a), "state", MDB_CREATE, &store_a.state_blocks_v0));
+	ASSERT_FALSE (mdb_dbi_open (store_a.env.tx (transaction_a), "state_v1", MDB_CREATE, &store_a.state_blocks_v1));
+}
+
+// Moves a block from the blocks table to a per-type table with only its successor as sideband, as written before v13
+void write_sideband_v12 (nano::mdb_store & store_a, nano::write_transaction & transaction_a, nano::block & block_a, nano::block_hash const & successor_a, MDB_dbi db_a)
 {
 	std::vector<uint8_t> vector;
 	{
@@ -2264,6 +2455,7 @@ void write_sideband_v12 (nano::mdb_store & store_a, nano::transaction & transact
 	auto hash (block_a.hash ());
 	auto status (mdb_put (store_a.env.tx (transaction_a), db_a, nano::mdb_val (hash), &val, 0));
 	ASSERT_EQ (0, status);
+	store_a.block_del (transaction_a, hash);
 	nano::block_sideband_v14 sideband_v14;
 	auto block (store_a.block_get_v14 (transaction_a, hash, &sideband_v14));
 	ASSERT_NE (nullptr, block);
@@ -2287,7 +2479,7 @@ void write_sideband_v14 (nano::mdb_store & store_a, nano::transaction & transact
 	ASSERT_FALSE (mdb_put (store_a.env.tx (transaction_a), block->sideband ().details.epoch == nano::epoch::epoch_0 ? store_a.state_blocks_v0 : store_a.state_blocks_v1, nano::mdb_val (block_a.hash ()), &val, 0));
 }
 
-void write_sideband_v15 (nano::mdb_store & store_a, nano::transaction & transaction_a, nano::block const & block_a)
+void write_sideband_v15 (nano::mdb_store & store_a, nano::write_transaction & transaction_a, nano::block const & block_a)
 {
 	auto block = store_a.block_get (transaction_a, block_a.hash ());
 	ASSERT_NE (block, nullptr);
@@ -2304,6 +2496,25 @@ void write_sideband_v15 (nano::mdb_store & store_a, nano::transaction & transact
 
 	MDB_val val{ data.size (), data.data () };
 	ASSERT_FALSE (mdb_put (store_a.env.tx (transaction_a), store_a.state_blocks, nano::mdb_val (block_a.hash ()), &val, 0));
+	store_a.block_del (transaction_a, block_a.hash ());
+}
+
+// Moves a block from the blocks table to one of the per-type tables used before v19, which are not prefixed with the block type
+void write_block_w_sideband_v18 (nano::mdb_store & store_a, MDB_dbi database, nano::write_transaction & transaction_a, nano::block const & block_a)
+{
+	auto block = store_a.block_get (transaction_a, block_a.hash ());
+	ASSERT_NE (block, nullptr);
+
+	std::vector<uint8_t> data;
+	{
+		nano::vectorstream stream (data);
+		block->serialize (stream);
+		block->sideband ().serialize (stream, block->type ());
+	}
+
+	MDB_val val{ data.size (), data.data () };
+	ASSERT_FALSE (mdb_put (store_a.env.tx (transaction_a), database, nano::mdb_val (block_a.hash ()), &val, 0));
+	store_a.block_del (transaction_a, block_a.hash ());
 }
 
 // These functions take the latest account_info and create a legacy one so that upgrade tests can be emulated more easily.
@@ -2341,4 +2552,5 @@ void modify_genesis_account_info_to_v5 (nano::mdb_store & store, nano::transacti
 	auto status (mdb_put (store.env.tx (transaction), store.accounts_v0, nano::mdb_val (nano::test_genesis_key.pub), nano::mdb_val (sizeof (info_old), &info_old), 0));
 	ASSERT_EQ (status, 0);
 }
+
 }
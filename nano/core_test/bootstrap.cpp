@@ -170,6 +170,41 @@ TEST (bulk_pull, count_limit)
 	ASSERT_EQ (nullptr, block);
 }
 
+TEST (bulk_pull, burst)
+{
+	nano::system system (1);
+	auto send1 (std::make_shared<nano::send_block> (system.nodes[0]->latest (nano::test_genesis_key.pub), nano::test_genesis_key.pub, 1, nano::test_genesis_key.prv, nano::test_genesis_key.pub, *system.work.generate (system.nodes[0]->latest (nano::test_genesis_key.pub))));
+	ASSERT_EQ (nano::process_result::progress, system.nodes[0]->process (*send1).code);
+	auto receive1 (std::make_shared<nano::receive_block> (send1->hash (), send1->hash (), nano::test_genesis_key.prv, nano::test_genesis_key.pub, *system.work.generate (send1->hash ())));
+	ASSERT_EQ (nano::process_result::progress, system.nodes[0]->process (*receive1).code);
+
+	auto connection (std::make_shared<nano::bootstrap_server> (nullptr, system.nodes[0]));
+	auto req = std::make_unique<nano::bulk_pull> ();
+	req->start = nano::test_genesis_key.pub;
+	req->end.clear ();
+	connection->requests.push (std::unique_ptr<nano::message>{});
+	auto request (std::make_shared<nano::bulk_pull_server> (connection, std::move (req)));
+
+	// The whole chain and the terminator fit in a single burst
+	std::vector<uint8_t> buffer;
+	ASSERT_TRUE (request->fill_burst (buffer));
+	nano::bufferstream stream (buffer.data (), buffer.size ());
+	auto block (nano::deserialize_block (stream));
+	ASSERT_NE (nullptr, block);
+	ASSERT_EQ (receive1->hash (), block->hash ());
+	block = nano::deserialize_block (stream);
+	ASSERT_NE (nullptr, block);
+	ASSERT_EQ (send1->hash (), block->hash ());
+	block = nano::deserialize_block (stream);
+	ASSERT_NE (nullptr, block);
+	ASSERT_EQ (nano::genesis_hash, block->hash ());
+	nano::block_type type;
+	ASSERT_FALSE (nano::try_read (stream, type));
+	ASSERT_EQ (nano::block_type::not_a_block, type);
+	uint8_t extra;
+	ASSERT_TRUE (nano::try_read (stream, extra));
+}
+
 TEST (bootstrap_processor, DISABLED_process_none)
 {
 	nano::system system (1);
@@ -793,7 +793,7 @@ TEST (confirmation_height, modified_chain)
 				ASSERT_NO_ERROR (system.poll ());
 			}
 
-			store.block_del (store.tx_begin_write (), send->hash (), send->type ());
+			store.block_del (store.tx_begin_write (), send->hash ());
 		}
 
 		system.deadline_set (10s);
@@ -878,6 +878,68 @@ TEST (confirmation_height, pending_observer_callbacks)
 	test_mode (nano::confirmation_height_mode::unbounded);
 }
 
+TEST (confirmation_height, prefetch)
+{
+	auto test_mode = [](nano::confirmation_height_mode mode_a) {
+		nano::system system;
+		nano::node_flags node_flags;
+		node_flags.confirmation_height_processor_mode = mode_a;
+		nano::node_config node_config (nano::get_available_port (), system.logging);
+		node_config.frontiers_confirmation = nano::frontiers_confirmation_mode::disabled;
+		node_config.conf_height_processor_prefetch_threads = 4;
+		auto node = system.add_node (node_config, node_flags);
+
+		// Opens of unrelated accounts, each depending on a send from genesis
+		size_t const count (20);
+		std::vector<nano::block_hash> opens;
+		{
+			auto transaction = node->store.tx_begin_write ();
+			nano::block_hash latest (node->latest (nano::test_genesis_key.pub));
+			for (size_t i (0); i < count; ++i)
+			{
+				nano::keypair key;
+				nano::send_block send (latest, key.pub, nano::genesis_amount - (i + 1) * nano::Gxrb_ratio, nano::test_genesis_key.prv, nano::test_genesis_key.pub, *system.work.generate (latest));
+				ASSERT_EQ (nano::process_result::progress, node->ledger.process (transaction, send).code);
+				nano::open_block open (send.hash (), key.pub, key.pub, key.prv, key.pub, *system.work.generate (key.pub));
+				ASSERT_EQ (nano::process_result::progress, node->ledger.process (transaction, open).code);
+				latest = send.hash ();
+				opens.push_back (open.hash ());
+			}
+		}
+
+		// Dependencies are read ahead as soon as hashes are queued, even while paused. Each open reads its send and the uncemented sends below it
+		node->confirmation_height_processor.pause ();
+		uint64_t prefetched (0);
+		for (size_t i (0); i < count; ++i)
+		{
+			node->confirmation_height_processor.add (opens[i]);
+			prefetched += 1 + (i + 1);
+		}
+		system.deadline_set (10s);
+		while (node->stats.count (nano::stat::type::confirmation_height, nano::stat::detail::blocks_prefetched, nano::stat::dir::in) < prefetched)
+		{
+			ASSERT_NO_ERROR (system.poll ());
+		}
+		ASSERT_EQ (prefetched, node->stats.count (nano::stat::type::confirmation_height, nano::stat::detail::blocks_prefetched, nano::stat::dir::in));
+		ASSERT_EQ (1, node->ledger.cache.cemented_count);
+		node->confirmation_height_processor.unpause ();
+
+		system.deadline_set (10s);
+		while (node->ledger.cache.cemented_count != 1 + 2 * count)
+		{
+			ASSERT_NO_ERROR (system.poll ());
+		}
+		ASSERT_EQ (2 * count, node->stats.count (nano::stat::type::confirmation_height, get_stats_detail (mode_a), nano::stat::dir::in));
+		auto transaction (node->store.tx_begin_read ());
+		nano::confirmation_height_info confirmation_height_info;
+		ASSERT_FALSE (node->store.confirmation_height_get (transaction, nano::test_genesis_key.pub, confirmation_height_info));
+		ASSERT_EQ (1 + count, confirmation_height_info.height);
+	};
+
+	test_mode (nano::confirmation_height_mode::bounded);
+	test_mode (nano::confirmation_height_mode::unbounded);
+}
+
 TEST (confirmation_height, prioritize_frontiers)
 {
 	auto test_mode = [](nano::confirmation_height_mode mode_a) {
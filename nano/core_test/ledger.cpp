@@ -1,7 +1,10 @@
 #include <nano/core_test/testutil.hpp>
+#include <nano/crypto/blake2/blake2.h>
 #include <nano/lib/stats.hpp>
 #include <nano/lib/threading.hpp>
 #include <nano/node/election.hpp>
+#include <nano/node/ledger_snapshot.hpp>
+#include <nano/node/signatures.hpp>
 #include <nano/node/testing.hpp>
 
 #include <gtest/gtest.h>
@@ -2969,3 +2972,161 @@ TEST (ledger, zero_rep)
 	ASSERT_EQ (nano::genesis_amount, node1.ledger.cache.rep_weights.representation_get (nano::test_genesis_key.pub));
 	ASSERT_EQ (0, node1.ledger.cache.rep_weights.representation_get (0));
 }
+
+TEST (ledger, snapshot)
+{
+	nano::logger_mt logger;
+	nano::stat stats;
+	nano::genesis genesis;
+	nano::work_pool pool (std::numeric_limits<unsigned>::max ());
+	auto store1 = nano::make_store (logger, nano::unique_path ());
+	ASSERT_TRUE (!store1->init_error ());
+	nano::ledger ledger1 (*store1, stats);
+	nano::keypair key1;
+	nano::keypair key2;
+	nano::send_block send1 (genesis.hash (), key1.pub, nano::genesis_amount - 100, nano::test_genesis_key.prv, nano::test_genesis_key.pub, *pool.generate (genesis.hash ()));
+	nano::state_block open1 (key1.pub, 0, key1.pub, 100, send1.hash (), key1.prv, key1.pub, *pool.generate (key1.pub));
+	nano::send_block send2 (send1.hash (), key2.pub, nano::genesis_amount - 150, nano::test_genesis_key.prv, nano::test_genesis_key.pub, *pool.generate (send1.hash ()));
+	{
+		auto transaction (store1->tx_begin_write ());
+		store1->initialize (transaction, genesis, ledger1.cache);
+		ASSERT_EQ (nano::process_result::progress, ledger1.process (transaction, send1).code);
+		ASSERT_EQ (nano::process_result::progress, ledger1.process (transaction, open1).code);
+		ASSERT_EQ (nano::process_result::progress, ledger1.process (transaction, send2).code);
+	}
+	nano::keypair signer;
+	auto path (nano::unique_path ());
+	ASSERT_FALSE (nano::ledger_snapshot::write (ledger1, path, signer.prv));
+
+	auto store2 = nano::make_store (logger, nano::unique_path ());
+	ASSERT_TRUE (!store2->init_error ());
+	nano::ledger ledger2 (*store2, stats);
+	{
+		auto transaction (store2->tx_begin_write ());
+		store2->initialize (transaction, genesis, ledger2.cache);
+	}
+	// Only the expected signer is accepted
+	nano::account other (key1.pub);
+	ASSERT_TRUE (nano::ledger_snapshot::read (ledger2, path, nullptr, other));
+	ASSERT_EQ (signer.pub, other);
+	nano::signature_checker checker (0);
+	nano::account expected (signer.pub);
+	ASSERT_FALSE (nano::ledger_snapshot::read (ledger2, path, &checker, expected));
+	{
+		auto transaction1 (store1->tx_begin_read ());
+		auto transaction2 (store2->tx_begin_read ());
+		ASSERT_EQ (4, store2->block_count (transaction2));
+		for (auto const & account : { nano::genesis_account, key1.pub })
+		{
+			nano::account_info info1;
+			nano::account_info info2;
+			ASSERT_FALSE (store1->account_get (transaction1, account, info1));
+			ASSERT_FALSE (store2->account_get (transaction2, account, info2));
+			ASSERT_EQ (info1, info2);
+		}
+		ASSERT_EQ (send1.hash (), store2->block_successor (transaction2, genesis.hash ()));
+		ASSERT_EQ (send2.hash (), store2->block_successor (transaction2, send1.hash ()));
+		ASSERT_TRUE (store2->block_successor (transaction2, send2.hash ()).is_zero ());
+		ASSERT_TRUE (store2->pending_exists (transaction2, nano::pending_key (key2.pub, send2.hash ())));
+		ASSERT_FALSE (store2->pending_exists (transaction2, nano::pending_key (key1.pub, send1.hash ())));
+		ASSERT_EQ (nano::genesis_account, store2->frontier_get (transaction2, send2.hash ()));
+		ASSERT_TRUE (store2->frontier_get (transaction2, genesis.hash ()).is_zero ());
+		nano::confirmation_height_info confirmation_height_info;
+		ASSERT_FALSE (store2->confirmation_height_get (transaction2, nano::genesis_account, confirmation_height_info));
+		ASSERT_EQ (1, confirmation_height_info.height);
+	}
+	// The ledger isn't empty anymore
+	ASSERT_TRUE (nano::ledger_snapshot::read (ledger2, path, nullptr, expected));
+}
+
+// Send, receive and change blocks have to belong to the chain they're imported in, whatever their sideband says
+TEST (ledger, snapshot_sideband_account)
+{
+	nano::logger_mt logger;
+	nano::stat stats;
+	nano::genesis genesis;
+	nano::work_pool pool (std::numeric_limits<unsigned>::max ());
+	auto store1 = nano::make_store (logger, nano::unique_path ());
+	ASSERT_TRUE (!store1->init_error ());
+	nano::ledger ledger1 (*store1, stats);
+	nano::keypair key1;
+	nano::send_block send1 (genesis.hash (), key1.pub, nano::genesis_amount - 100, nano::test_genesis_key.prv, nano::test_genesis_key.pub, *pool.generate (genesis.hash ()));
+	{
+		auto transaction (store1->tx_begin_write ());
+		store1->initialize (transaction, genesis, ledger1.cache);
+		ASSERT_EQ (nano::process_result::progress, ledger1.process (transaction, send1).code);
+	}
+	// Snapshot of the genesis chain with the sideband of send1 claiming it belongs to key1, signed by key1
+	nano::keypair signer;
+	auto write_snapshot = [&](boost::filesystem::path const & path_a, nano::account const & sideband_account_a, nano::raw_key const & block_key_a) {
+		auto transaction (store1->tx_begin_read ());
+		auto open (store1->block_get (transaction, genesis.hash ()));
+		auto send (store1->block_get (transaction, send1.hash ()));
+		auto sideband (send->sideband ());
+		sideband.account = sideband_account_a;
+		send->sideband_set (sideband);
+		send->signature_set (nano::sign_message (block_key_a, nano::pub_key (block_key_a.as_private_key ()), send->hash ()));
+		nano::account_info info;
+		ASSERT_FALSE (store1->account_get (transaction, nano::genesis_account, info));
+		std::vector<uint8_t> body;
+		{
+			nano::vectorstream stream (body);
+			nano::write (stream, nano::ledger_snapshot::magic);
+			nano::write (stream, nano::ledger_snapshot::version);
+			nano::write (stream, ledger1.network_params.header_magic_number);
+			for (auto const & block : { open, send })
+			{
+				nano::write (stream, nano::snapshot_record::block);
+				nano::serialize_block (stream, *block);
+				block->sideband ().serialize (stream, block->type ());
+			}
+			nano::write (stream, nano::snapshot_record::account);
+			nano::write (stream, nano::genesis_account);
+			nano::write (stream, info.head);
+			nano::write (stream, info.representative);
+			nano::write (stream, info.open_block);
+			nano::write (stream, info.balance);
+			nano::write (stream, info.modified);
+			nano::write (stream, info.block_count);
+			nano::write (stream, info.epoch_m);
+			nano::write (stream, nano::snapshot_record::end);
+		}
+		nano::block_hash checksum;
+		blake2b_state state;
+		blake2b_init (&state, sizeof (checksum.bytes));
+		blake2b_update (&state, body.data (), body.size ());
+		blake2b_final (&state, checksum.bytes.data (), sizeof (checksum.bytes));
+		auto signature (nano::sign_message (signer.prv, signer.pub, checksum));
+		std::ofstream file (path_a.string (), std::ios::binary | std::ios::trunc);
+		file.write (reinterpret_cast<char const *> (body.data ()), body.size ());
+		file.write (reinterpret_cast<char const *> (checksum.bytes.data ()), sizeof (checksum.bytes));
+		file.write (reinterpret_cast<char const *> (signer.pub.bytes.data ()), sizeof (signer.pub.bytes));
+		file.write (reinterpret_cast<char const *> (signature.bytes.data ()), sizeof (signature.bytes));
+	};
+	auto invalid_path (nano::unique_path ());
+	write_snapshot (invalid_path, key1.pub, key1.prv);
+	auto valid_path (nano::unique_path ());
+	write_snapshot (valid_path, nano::genesis_account, nano::test_genesis_key.prv);
+
+	auto store2 = nano::make_store (logger, nano::unique_path ());
+	ASSERT_TRUE (!store2->init_error ());
+	nano::ledger ledger2 (*store2, stats);
+	{
+		auto transaction (store2->tx_begin_write ());
+		store2->initialize (transaction, genesis, ledger2.cache);
+	}
+	nano::signature_checker checker (0);
+	nano::account expected (signer.pub);
+	ASSERT_TRUE (nano::ledger_snapshot::read (ledger2, invalid_path, &checker, expected));
+	ASSERT_TRUE (nano::ledger_snapshot::read (ledger2, invalid_path, nullptr, expected));
+	{
+		// Nothing was written, so the import can be retried with a valid snapshot
+		auto transaction (store2->tx_begin_read ());
+		ASSERT_EQ (1, store2->block_count (transaction));
+		ASSERT_EQ (nano::genesis_account, store2->frontier_get (transaction, genesis.hash ()));
+	}
+	ASSERT_FALSE (nano::ledger_snapshot::read (ledger2, valid_path, &checker, expected));
+	auto transaction (store2->tx_begin_read ());
+	ASSERT_EQ (2, store2->block_count (transaction));
+	ASSERT_EQ (send1.hash (), store2->block_successor (transaction, genesis.hash ()));
+}
@@ -6,6 +6,8 @@
 
 #include <boost/variant/get.hpp>
 
+#include <cstring>
+
 TEST (message, keepalive_serialization)
 {
 	nano::keepalive request1;
@@ -202,3 +204,31 @@ TEST (message, confirm_req_hash_batch_serialization)
 	ASSERT_EQ (header.block_type (), nano::block_type::not_a_block);
 	ASSERT_EQ (header.count_get (), req.roots_hashes.size ());
 }
+
+TEST (message, pooled_buffer)
+{
+	nano::buffer_pool pool;
+	nano::keepalive message;
+	message.peers[0] = nano::endpoint (boost::asio::ip::address_v6::loopback (), 10000);
+	auto bytes (message.to_bytes ());
+	{
+		auto buffer (message.to_shared_const_buffer (pool));
+		ASSERT_EQ (bytes->size (), buffer.size ());
+		ASSERT_EQ (0, std::memcmp (bytes->data (), buffer.begin ()->data (), bytes->size ()));
+		// Storage is returned once the last copy is released
+		auto copy (buffer);
+		ASSERT_EQ (0, pool.size ());
+	}
+	ASSERT_EQ (1, pool.size ());
+	// The storage and the node referencing it, which shares one allocation with its control block
+	ASSERT_EQ (2, pool.allocations ());
+	// Serializing again reuses both
+	auto buffer (message.to_shared_const_buffer (pool));
+	ASSERT_EQ (0, pool.size ());
+	ASSERT_EQ (2, pool.allocations ());
+	ASSERT_EQ (0, std::memcmp (bytes->data (), buffer.begin ()->data (), bytes->size ()));
+	ASSERT_EQ (0, nano::buffer_pool::class_index (1));
+	ASSERT_EQ (0, nano::buffer_pool::class_index (nano::buffer_pool::class_size_min));
+	ASSERT_EQ (1, nano::buffer_pool::class_index (nano::buffer_pool::class_size_min + 1));
+	ASSERT_EQ (nano::buffer_pool::class_count - 1, nano::buffer_pool::class_index (nano::buffer_pool::class_size_max));
+}
@@ -218,3 +218,55 @@ TEST (message_parser, exact_keepalive_size)
 	ASSERT_EQ (1, visitor.keepalive_count);
 	ASSERT_NE (parser.status, nano::message_parser::parse_status::success);
 }
+
+TEST (message_parser, deserialize_buffers)
+{
+	nano::system system (1);
+	nano::block_uniquer block_uniquer;
+	nano::vote_uniquer vote_uniquer (block_uniquer);
+	auto block (std::make_shared<nano::send_block> (1, 1, 2, nano::keypair ().prv, 4, *system.work.generate (nano::root (1))));
+	auto bad_block (std::make_shared<nano::send_block> (1, 1, 3, nano::keypair ().prv, 4, 0));
+	auto vote (std::make_shared<nano::vote> (0, nano::keypair ().prv, 0, bad_block));
+	std::vector<std::vector<uint8_t>> messages (5);
+	{
+		nano::vectorstream stream (messages[0]);
+		nano::publish (block).serialize (stream);
+	}
+	{
+		nano::vectorstream stream (messages[1]);
+		nano::publish (bad_block).serialize (stream);
+	}
+	{
+		nano::vectorstream stream (messages[2]);
+		nano::confirm_ack (vote).serialize (stream);
+	}
+	{
+		nano::vectorstream stream (messages[3]);
+		nano::keepalive ().serialize (stream);
+	}
+	{
+		nano::vectorstream stream (messages[4]);
+		nano::keepalive ().serialize (stream);
+		// Trailing byte
+		messages[4].push_back (0);
+	}
+	std::vector<std::pair<uint8_t const *, size_t>> buffers;
+	for (auto const & message : messages)
+	{
+		buffers.emplace_back (message.data (), message.size ());
+	}
+	auto parsed (nano::message_parser::deserialize_buffers (buffers, block_uniquer, vote_uniquer));
+	ASSERT_EQ (5, parsed.size ());
+	ASSERT_EQ (nano::message_parser::parse_status::success, parsed[0].status);
+	ASSERT_NE (nullptr, parsed[0].message);
+	ASSERT_EQ (nano::message_type::publish, parsed[0].message->header.type);
+	ASSERT_EQ (block->hash (), static_cast<nano::publish const &> (*parsed[0].message).block->hash ());
+	ASSERT_EQ (nano::message_parser::parse_status::insufficient_work, parsed[1].status);
+	ASSERT_EQ (nullptr, parsed[1].message);
+	ASSERT_EQ (nano::message_parser::parse_status::insufficient_work, parsed[2].status);
+	ASSERT_EQ (nullptr, parsed[2].message);
+	ASSERT_EQ (nano::message_parser::parse_status::success, parsed[3].status);
+	ASSERT_EQ (nano::message_type::keepalive, parsed[3].message->header.type);
+	ASSERT_EQ (nano::message_parser::parse_status::invalid_keepalive_message, parsed[4].status);
+	ASSERT_EQ (nullptr, parsed[4].message);
+}
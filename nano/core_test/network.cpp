@@ -71,6 +71,30 @@ TEST (network, self_discard)
 	ASSERT_EQ (1, system.nodes[0]->stats.count (nano::stat::type::error, nano::stat::detail::bad_sender));
 }
 
+TEST (network, udp_batch_io)
+{
+	nano::node_flags node_flags;
+	node_flags.disable_udp = false;
+	nano::system system;
+	nano::node_config node_config (nano::get_available_port (), system.logging);
+	node_config.udp_batch_io = true;
+	auto node0 = system.add_node (node_config, node_flags, nano::transport::transport_type::udp);
+	node_config.peering_port = nano::get_available_port ();
+	auto node1 = system.add_node (node_config, node_flags, nano::transport::transport_type::udp);
+	auto initial (node1->stats.count (nano::stat::type::message, nano::stat::detail::keepalive, nano::stat::dir::in));
+	auto channel (std::make_shared<nano::transport::channel_udp> (node0->network.udp_channels, node1->network.endpoint (), node1->network_params.protocol.protocol_version));
+	// Several datagrams queued in the same strand invocation are sent and received together
+	for (auto i (0); i < 8; ++i)
+	{
+		node0->network.send_keepalive (channel);
+	}
+	system.deadline_set (10s);
+	while (node1->stats.count (nano::stat::type::message, nano::stat::detail::keepalive, nano::stat::dir::in) < initial + 8)
+	{
+		ASSERT_NO_ERROR (system.poll ());
+	}
+}
+
 TEST (network, send_node_id_handshake)
 {
 	nano::node_flags node_flags;
@@ -817,6 +841,34 @@ TEST (tcp_listener, tcp_node_id_handshake)
 	}
 }
 
+TEST (tcp_listener, coalesced_messages)
+{
+	nano::system system (1);
+	auto node0 (system.nodes[0]);
+	auto socket (std::make_shared<nano::socket> (node0));
+	nano::frontier_req request;
+	request.start.clear ();
+	request.age = std::numeric_limits<decltype (request.age)>::max ();
+	request.count = std::numeric_limits<decltype (request.count)>::max ();
+	// Both requests arrive in a single segment and are parsed from the same read
+	auto bytes (request.to_bytes ());
+	auto input (std::make_shared<std::vector<uint8_t>> (*bytes));
+	input->insert (input->end (), bytes->begin (), bytes->end ());
+	std::atomic<bool> write_done (false);
+	socket->async_connect (node0->bootstrap.endpoint (), [input, socket, &write_done](boost::system::error_code const & ec) {
+		ASSERT_FALSE (ec);
+		socket->async_write (nano::shared_const_buffer (std::move (*input)), [&write_done](boost::system::error_code const & ec, size_t size_a) {
+			ASSERT_FALSE (ec);
+			write_done = true;
+		});
+	});
+	system.deadline_set (std::chrono::seconds (5));
+	while (!write_done || node0->stats.count (nano::stat::type::bootstrap, nano::stat::detail::frontier_req, nano::stat::dir::in) < 2)
+	{
+		ASSERT_NO_ERROR (system.poll ());
+	}
+}
+
 TEST (tcp_listener, tcp_listener_timeout_empty)
 {
 	nano::system system (1);
@@ -971,3 +1023,54 @@ TEST (bandwidth_limiter, validate)
 	ASSERT_EQ (limiter_3.get_rate (), limiter_3.get_limit () + message_size);
 	ASSERT_LT (std::chrono::steady_clock::now () - 1s, start);
 }
+
+// The test must be completed in less than 1 second
+TEST (bandwidth_limiter, classes)
+{
+	nano::system system;
+	size_t const message_size (1024);
+	nano::bandwidth_limiter limiter (10 * message_size, { 0.3, 0., 0., 0., 0. }, 0.5);
+	auto start (std::chrono::steady_clock::now ());
+	for (unsigned i = 0; i < 5; ++i)
+	{
+		ASSERT_FALSE (limiter.should_drop (message_size, nano::bandwidth_class::bulk));
+		limiter.add (message_size, nano::bandwidth_class::bulk);
+	}
+	system.deadline_set (300ms);
+	while (limiter.get_rate () < 5 * message_size)
+	{
+		// Force an update
+		limiter.add (0);
+		ASSERT_NO_ERROR (system.poll (10ms));
+	}
+	ASSERT_EQ (5 * message_size, limiter.get_rate (nano::bandwidth_class::bulk));
+	// Bulk traffic backs off at half of the limit while other traffic can still be sent
+	ASSERT_TRUE (limiter.should_drop (message_size, nano::bandwidth_class::bulk));
+	ASSERT_FALSE (limiter.should_drop (message_size, nano::bandwidth_class::block));
+	for (unsigned i = 0; i < 5; ++i)
+	{
+		limiter.add (message_size, nano::bandwidth_class::block);
+	}
+	system.deadline_set (300ms);
+	while (limiter.get_rate () < limiter.get_limit ())
+	{
+		// Force an update
+		limiter.add (0);
+		ASSERT_NO_ERROR (system.poll (10ms));
+	}
+	ASSERT_TRUE (limiter.should_drop (message_size, nano::bandwidth_class::block));
+	// Votes from local representatives still have their reserved share
+	ASSERT_FALSE (limiter.should_drop (message_size, nano::bandwidth_class::local_vote));
+	limiter.add (message_size, nano::bandwidth_class::local_vote);
+	system.deadline_set (300ms);
+	while (limiter.get_rate (nano::bandwidth_class::local_vote) < message_size)
+	{
+		// Force an update
+		limiter.add (0);
+		ASSERT_NO_ERROR (system.poll (10ms));
+	}
+	// Up to the reserved share, but not beyond it
+	ASSERT_FALSE (limiter.should_drop (2 * message_size, nano::bandwidth_class::local_vote));
+	ASSERT_TRUE (limiter.should_drop (3 * message_size, nano::bandwidth_class::local_vote));
+	ASSERT_LT (std::chrono::steady_clock::now () - 1s, start);
+}
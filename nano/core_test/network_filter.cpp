@@ -109,3 +109,25 @@ TEST (network_filter, optional_digest)
 	filter.clear (digest);
 	ASSERT_FALSE (filter.apply (bytes1.data (), bytes1.size ()));
 }
+
+TEST (network_filter, apply_many)
+{
+	nano::network_filter filter (1024);
+	std::vector<uint8_t> bytes1{ 1, 2, 3 };
+	std::vector<uint8_t> bytes2{ 1 };
+	ASSERT_FALSE (filter.apply (bytes1.data (), bytes1.size ()));
+	std::vector<std::pair<uint8_t const *, size_t>> buffers{ { bytes1.data (), bytes1.size () }, { bytes2.data (), bytes2.size () }, { bytes2.data (), bytes2.size () } };
+	std::vector<nano::uint128_t> digests;
+	auto existed (filter.apply_many (buffers, &digests));
+	ASSERT_EQ (3, existed.size ());
+	ASSERT_TRUE (existed[0]);
+	ASSERT_FALSE (existed[1]);
+	ASSERT_TRUE (existed[2]);
+	ASSERT_EQ (3, digests.size ());
+	ASSERT_EQ (digests[1], digests[2]);
+	nano::uint128_t digest{ 0 };
+	ASSERT_TRUE (filter.apply (bytes1.data (), bytes1.size (), &digest));
+	ASSERT_EQ (digest, digests[0]);
+	filter.clear (digests[1]);
+	ASSERT_FALSE (filter.apply (bytes2.data (), bytes2.size ()));
+}
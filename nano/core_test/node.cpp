@@ -2450,6 +2450,48 @@ TEST (node, stat_counting)
 	ASSERT_EQ (1, node1.stats.count (nano::stat::type::ledger, nano::stat::detail::receive, nano::stat::dir::in));
 }
 
+TEST (node, stat_counting_threads)
+{
+	nano::stat stats;
+	std::vector<std::pair<uint64_t, uint64_t>> observed;
+	stats.observe_count (nano::stat::type::ledger, nano::stat::detail::receive, nano::stat::dir::in, [&observed](uint64_t old_a, uint64_t new_a) {
+		observed.emplace_back (old_a, new_a);
+	});
+	std::vector<std::thread> threads;
+	for (auto i (0); i < 4; ++i)
+	{
+		threads.emplace_back ([&stats]() {
+			for (auto j (0); j < 1000; ++j)
+			{
+				stats.inc (nano::stat::type::ledger, nano::stat::detail::send, nano::stat::dir::in);
+			}
+		});
+	}
+	for (auto & thread : threads)
+	{
+		thread.join ();
+	}
+	stats.add (nano::stat::type::ledger, nano::stat::detail::receive, nano::stat::dir::in, 3);
+	stats.inc (nano::stat::type::ledger, nano::stat::detail::receive, nano::stat::dir::in);
+	ASSERT_EQ (4000, stats.count (nano::stat::type::ledger, nano::stat::detail::send, nano::stat::dir::in));
+	ASSERT_EQ (4004, stats.count (nano::stat::type::ledger, nano::stat::dir::in));
+	ASSERT_EQ (4, stats.count (nano::stat::type::ledger, nano::stat::detail::receive, nano::stat::dir::in));
+	ASSERT_EQ (2, observed.size ());
+	ASSERT_EQ (0, observed[0].first);
+	ASSERT_EQ (3, observed[0].second);
+	ASSERT_EQ (3, observed[1].first);
+	ASSERT_EQ (4, observed[1].second);
+	stats.clear ();
+	ASSERT_EQ (0, stats.count (nano::stat::type::ledger, nano::stat::detail::send, nano::stat::dir::in));
+	stats.inc (nano::stat::type::ledger, nano::stat::detail::send, nano::stat::dir::in);
+	ASSERT_EQ (1, stats.count (nano::stat::type::ledger, nano::stat::detail::send, nano::stat::dir::in));
+	// Entries are reset in place, observers keep being notified
+	stats.inc (nano::stat::type::ledger, nano::stat::detail::receive, nano::stat::dir::in);
+	ASSERT_EQ (3, observed.size ());
+	ASSERT_EQ (0, observed[2].first);
+	ASSERT_EQ (1, observed[2].second);
+}
+
 TEST (node, online_reps)
 {
 	nano::system system (1);
@@ -3270,6 +3312,125 @@ TEST (node, block_processor_half_full)
 	ASSERT_FALSE (node.block_processor.full ());
 }
 
+/*
+ * Live blocks are announced after the write transaction commits, flushing must wait for these notifications
+ */
+TEST (node, block_processor_post_events)
+{
+	nano::system system (1);
+	auto & node (*system.nodes[0]);
+	nano::genesis genesis;
+	std::vector<std::shared_ptr<nano::block>> blocks;
+	auto previous (genesis.hash ());
+	for (auto i (1); i <= 4; ++i)
+	{
+		auto send (std::make_shared<nano::state_block> (nano::test_genesis_key.pub, previous, nano::test_genesis_key.pub, nano::genesis_amount - i * nano::Gxrb_ratio, nano::test_genesis_key.pub, nano::test_genesis_key.prv, nano::test_genesis_key.pub, *system.work.generate (previous)));
+		previous = send->hash ();
+		blocks.push_back (send);
+	}
+	for (auto & block : blocks)
+	{
+		node.process_active (block);
+	}
+	node.block_processor.flush ();
+	for (auto & block : blocks)
+	{
+		ASSERT_TRUE (node.ledger.block_exists (block->hash ()));
+		ASSERT_TRUE (node.active.active (*block));
+	}
+}
+
+TEST (write_batcher, commit)
+{
+	nano::system system (1);
+	auto & node (*system.nodes[0]);
+	nano::endpoint_key endpoint_key1{ boost::asio::ip::address_v6::loopback ().to_bytes (), 10000 };
+	nano::endpoint_key endpoint_key2{ boost::asio::ip::address_v6::loopback ().to_bytes (), 10001 };
+	nano::endpoint_key endpoint_key3{ boost::asio::ip::address_v6::loopback ().to_bytes (), 10002 };
+	// Committed by the batching thread once max_latency has passed
+	node.write_batcher.add (nano::writer::peers, [&node, endpoint_key1](nano::write_transaction const & transaction_a) {
+		node.store.peer_put (transaction_a, endpoint_key1);
+	});
+	system.deadline_set (10s);
+	while (!node.store.peer_exists (node.store.tx_begin_read (), endpoint_key1))
+	{
+		ASSERT_NO_ERROR (system.poll ());
+	}
+	ASSERT_EQ (0, node.write_batcher.size ());
+	ASSERT_LE (1, node.stats.count (nano::stat::type::write_batch, nano::stat::detail::write_batch_commit));
+	// Merged into another writer's transaction, the batching thread is held back by the write guard
+	{
+		auto write_guard = node.write_database_queue.wait (nano::writer::testing);
+		node.write_batcher.add (nano::writer::peers, [&node, endpoint_key2](nano::write_transaction const & transaction_a) {
+			node.store.peer_put (transaction_a, endpoint_key2);
+		});
+		ASSERT_EQ (1, node.write_batcher.size ());
+		std::deque<std::function<void()>> committed;
+		{
+			auto transaction (node.store.tx_begin_write ({ nano::tables::peers, nano::tables::vote }));
+			node.write_batcher.apply (transaction, committed);
+		}
+		ASSERT_EQ (0, node.write_batcher.size ());
+		ASSERT_EQ (1, committed.size ());
+		ASSERT_TRUE (node.store.peer_exists (node.store.tx_begin_read (), endpoint_key2));
+	}
+	// Blocking writes are released once another writer has committed them, the batching thread then doesn't open an empty transaction
+	nano::endpoint_key endpoint_key4{ boost::asio::ip::address_v6::loopback ().to_bytes (), 10003 };
+	auto commits (node.stats.count (nano::stat::type::write_batch, nano::stat::detail::write_batch_commit));
+	{
+		auto write_guard = node.write_database_queue.wait (nano::writer::testing);
+		std::atomic<bool> released{ false };
+		std::thread thread ([&node, &released, endpoint_key4]() {
+			auto stopped (node.write_batcher.apply_sync (nano::writer::confirmation_height, [&node, endpoint_key4](nano::write_transaction const & transaction_a) {
+				node.store.peer_put (transaction_a, endpoint_key4);
+			}));
+			ASSERT_FALSE (stopped);
+			released = true;
+		});
+		// The batching thread waits for the write lock as the blocking writer
+		system.deadline_set (10s);
+		while (!node.write_database_queue.contains (nano::writer::confirmation_height))
+		{
+			ASSERT_NO_ERROR (system.poll ());
+		}
+		// Releasing blocked writers is kept apart from the other callbacks, which the committing thread may defer
+		std::deque<std::function<void()>> release;
+		std::deque<std::function<void()>> committed;
+		{
+			auto transaction (node.store.tx_begin_write ({ nano::tables::peers, nano::tables::vote }, { nano::tables::confirmation_height }));
+			node.write_batcher.apply (transaction, release, committed);
+		}
+		ASSERT_TRUE (node.store.peer_exists (node.store.tx_begin_read (), endpoint_key4));
+		ASSERT_FALSE (released);
+		ASSERT_EQ (1, release.size ());
+		ASSERT_EQ (1, committed.size ());
+		for (auto & callback : release)
+		{
+			callback ();
+		}
+		thread.join ();
+		ASSERT_TRUE (released);
+		for (auto & callback : committed)
+		{
+			callback ();
+		}
+	}
+	system.deadline_set (10s);
+	while (node.write_database_queue.contains (nano::writer::confirmation_height))
+	{
+		ASSERT_NO_ERROR (system.poll ());
+	}
+	ASSERT_EQ (commits, node.stats.count (nano::stat::type::write_batch, nano::stat::detail::write_batch_commit));
+	// Anything still queued is committed when stopping
+	node.write_batcher.add (nano::writer::peers, [&node, endpoint_key3](nano::write_transaction const & transaction_a) {
+		node.store.peer_put (transaction_a, endpoint_key3);
+	});
+	node.write_batcher.stop ();
+	ASSERT_EQ (0, node.write_batcher.size ());
+	ASSERT_TRUE (node.store.peer_exists (node.store.tx_begin_read (), endpoint_key3));
+	ASSERT_EQ (4, node.store.peer_count (node.store.tx_begin_read ()));
+}
+
 TEST (node, confirm_back)
 {
 	nano::system system (1);
@@ -147,3 +147,40 @@ TEST (signature_checker, one)
 	block.signature.bytes[31] ^= 0x1;
 	verify_block (block, 1);
 }
+
+TEST (signature_checker, backends)
+{
+	nano::keypair key;
+	size_t size (1000);
+	std::vector<nano::uint256_union> hashes;
+	std::vector<nano::signature> block_signatures;
+	for (size_t i (0); i < size; ++i)
+	{
+		hashes.emplace_back (i);
+		block_signatures.push_back (nano::sign_message (key.prv, key.pub, hashes.back ()));
+		if (i % 97 == 0)
+		{
+			block_signatures.back ().bytes[31] ^= 0x1;
+		}
+	}
+	std::vector<unsigned char const *> messages;
+	std::vector<size_t> lengths (size, sizeof (nano::uint256_union));
+	std::vector<unsigned char const *> pub_keys (size, key.pub.bytes.data ());
+	std::vector<unsigned char const *> signatures;
+	for (size_t i (0); i < size; ++i)
+	{
+		messages.push_back (hashes[i].bytes.data ());
+		signatures.push_back (block_signatures[i].bytes.data ());
+	}
+	for (auto backend : { nano::signature_backend::batch, nano::signature_backend::single })
+	{
+		nano::signature_checker checker (2, backend);
+		std::vector<int> verifications (size, -1);
+		nano::signature_check_set check = { size, messages.data (), lengths.data (), pub_keys.data (), signatures.data (), verifications.data () };
+		checker.verify (check);
+		for (size_t i (0); i < size; ++i)
+		{
+			ASSERT_EQ (i % 97 == 0 ? 0 : 1, verifications[i]);
+		}
+	}
+}
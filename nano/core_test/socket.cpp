@@ -7,6 +7,27 @@
 
 using namespace std::chrono_literals;
 
+namespace
+{
+/** Queues several messages from a single strand handler so they are gathered into one write */
+class batch_socket final : public nano::socket
+{
+public:
+	using nano::socket::socket;
+	void async_write_batch (std::vector<nano::shared_const_buffer> const & buffers_a, std::function<void(size_t, boost::system::error_code const &, size_t)> const & callback_a)
+	{
+		auto this_l (std::static_pointer_cast<batch_socket> (shared_from_this ()));
+		boost::asio::post (strand, [this_l, buffers_a, callback_a]() {
+			for (size_t i (0); i < buffers_a.size (); ++i)
+			{
+				this_l->send_queue.push_back (nano::socket::queue_item{ buffers_a[i], [callback_a, i](boost::system::error_code const & ec_a, size_t size_a) { callback_a (i, ec_a, size_a); } });
+			}
+			this_l->write_queued_messages ();
+		});
+	}
+};
+}
+
 TEST (socket, drop_policy)
 {
 	auto node_flags = nano::inactive_node_flag_defaults ();
@@ -189,3 +210,128 @@ TEST (socket, concurrent_writes)
 		t.join ();
 	}
 }
+
+TEST (socket, write_batch)
+{
+	auto node_flags = nano::inactive_node_flag_defaults ();
+	node_flags.read_only = false;
+	nano::inactive_node inactivenode (nano::unique_path (), nano::get_available_port (), node_flags);
+	auto node = inactivenode.node;
+
+	nano::thread_runner runner (node->io_ctx, 1);
+	auto server_port (nano::get_available_port ());
+	boost::asio::ip::tcp::endpoint endpoint (boost::asio::ip::address_v4::any (), server_port);
+
+	// Message i is i + 1 bytes long and filled with i
+	constexpr size_t message_count = 4;
+	std::vector<nano::shared_const_buffer> buffers;
+	std::vector<uint8_t> expected;
+	for (size_t i (0); i < message_count; ++i)
+	{
+		std::vector<uint8_t> message (i + 1, static_cast<uint8_t> (i));
+		expected.insert (expected.end (), message.begin (), message.end ());
+		buffers.emplace_back (std::move (message));
+	}
+
+	auto server_socket (std::make_shared<nano::server_socket> (node, endpoint, 1, nano::socket::concurrency::multi_writer));
+	boost::system::error_code ec;
+	server_socket->start (ec);
+	ASSERT_FALSE (ec);
+	std::vector<std::shared_ptr<nano::socket>> connections;
+	auto received (std::make_shared<std::vector<uint8_t>> (expected.size ()));
+	nano::util::counted_completion read_completion (1);
+	server_socket->on_connection ([&connections, &read_completion, received](std::shared_ptr<nano::socket> new_connection, boost::system::error_code const & ec_a) {
+		connections.push_back (new_connection);
+		new_connection->async_read (received, received->size (), [&read_completion](boost::system::error_code const & ec, size_t size_a) {
+			if (!ec)
+			{
+				read_completion.increment ();
+			}
+		});
+		return true;
+	});
+
+	auto client (std::make_shared<batch_socket> (node, boost::none, nano::socket::concurrency::multi_writer));
+	nano::util::counted_completion connect_completion (1);
+	client->async_connect (boost::asio::ip::tcp::endpoint (boost::asio::ip::address_v4::loopback (), server_port), [&connect_completion](boost::system::error_code const & ec_a) {
+		if (!ec_a)
+		{
+			connect_completion.increment ();
+		}
+	});
+	ASSERT_FALSE (connect_completion.await_count_for (10s));
+
+	std::mutex mutex;
+	std::vector<std::pair<size_t, size_t>> written;
+	nano::util::counted_completion write_completion (message_count);
+	client->async_write_batch (buffers, [&mutex, &written, &write_completion](size_t index_a, boost::system::error_code const & ec_a, size_t size_a) {
+		ASSERT_FALSE (ec_a);
+		{
+			nano::lock_guard<std::mutex> guard (mutex);
+			written.emplace_back (index_a, size_a);
+		}
+		write_completion.increment ();
+	});
+	ASSERT_FALSE (write_completion.await_count_for (10s));
+	ASSERT_FALSE (read_completion.await_count_for (10s));
+
+	// All messages went out in a single write and each callback was passed the size of its own message, in queue order
+	ASSERT_EQ (1, node->stats.count (nano::stat::type::tcp, nano::stat::detail::tcp_write_batch, nano::stat::dir::out));
+	ASSERT_EQ (message_count, node->stats.count (nano::stat::type::tcp, nano::stat::detail::tcp_write_batch_messages, nano::stat::dir::out));
+	{
+		nano::lock_guard<std::mutex> guard (mutex);
+		ASSERT_EQ (message_count, written.size ());
+		for (size_t i (0); i < message_count; ++i)
+		{
+			ASSERT_EQ (i, written[i].first);
+			ASSERT_EQ (i + 1, written[i].second);
+		}
+	}
+	ASSERT_EQ (expected, *received);
+
+	node->stop ();
+	runner.stop_event_processing ();
+	runner.join ();
+}
+
+TEST (socket, write_batch_failure)
+{
+	auto node_flags = nano::inactive_node_flag_defaults ();
+	node_flags.read_only = false;
+	nano::inactive_node inactivenode (nano::unique_path (), nano::get_available_port (), node_flags);
+	auto node = inactivenode.node;
+
+	nano::thread_runner runner (node->io_ctx, 1);
+
+	// The socket is never connected, so the gathered write fails without writing anything
+	constexpr size_t message_count = 3;
+	std::vector<nano::shared_const_buffer> buffers;
+	for (size_t i (0); i < message_count; ++i)
+	{
+		buffers.emplace_back (std::vector<uint8_t> (i + 1, static_cast<uint8_t> (i)));
+	}
+	auto client (std::make_shared<batch_socket> (node, boost::none, nano::socket::concurrency::multi_writer));
+	std::mutex mutex;
+	std::vector<size_t> failed;
+	nano::util::counted_completion write_completion (message_count);
+	client->async_write_batch (buffers, [&mutex, &failed, &write_completion](size_t index_a, boost::system::error_code const & ec_a, size_t size_a) {
+		if (ec_a && size_a == 0)
+		{
+			nano::lock_guard<std::mutex> guard (mutex);
+			failed.push_back (index_a);
+		}
+		write_completion.increment ();
+	});
+	ASSERT_FALSE (write_completion.await_count_for (10s));
+
+	// Every message of the failed write has its callback called with the error
+	ASSERT_EQ (1, node->stats.count (nano::stat::type::tcp, nano::stat::detail::tcp_write_batch, nano::stat::dir::out));
+	{
+		nano::lock_guard<std::mutex> guard (mutex);
+		ASSERT_EQ ((std::vector<size_t>{ 0, 1, 2 }), failed);
+	}
+
+	node->stop ();
+	runner.stop_event_processing ();
+	runner.join ();
+}
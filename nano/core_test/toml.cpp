@@ -154,6 +154,7 @@ TEST (toml, daemon_config_deserialize_defaults)
 	ASSERT_EQ (conf.node.bootstrap_initiator_threads, defaults.node.bootstrap_initiator_threads);
 	ASSERT_EQ (conf.node.bootstrap_fraction_numerator, defaults.node.bootstrap_fraction_numerator);
 	ASSERT_EQ (conf.node.conf_height_processor_batch_min_time, defaults.node.conf_height_processor_batch_min_time);
+	ASSERT_EQ (conf.node.conf_height_processor_prefetch_threads, defaults.node.conf_height_processor_prefetch_threads);
 	ASSERT_EQ (conf.node.confirmation_history_size, defaults.node.confirmation_history_size);
 	ASSERT_EQ (conf.node.enable_voting, defaults.node.enable_voting);
 	ASSERT_EQ (conf.node.external_address, defaults.node.external_address);
@@ -183,6 +184,16 @@ TEST (toml, daemon_config_deserialize_defaults)
 	ASSERT_EQ (conf.node.work_peers, defaults.node.work_peers);
 	ASSERT_EQ (conf.node.work_threads, defaults.node.work_threads);
 	ASSERT_EQ (conf.node.max_queued_requests, defaults.node.max_queued_requests);
+	ASSERT_EQ (conf.node.block_filter_memory_mb, defaults.node.block_filter_memory_mb);
+	ASSERT_EQ (conf.node.account_cache_size, defaults.node.account_cache_size);
+	ASSERT_EQ (conf.node.block_height_index, defaults.node.block_height_index);
+	ASSERT_EQ (conf.node.write_batch_max_latency, defaults.node.write_batch_max_latency);
+	ASSERT_EQ (conf.node.write_batch_size, defaults.node.write_batch_size);
+	ASSERT_EQ (conf.node.udp_batch_io, defaults.node.udp_batch_io);
+	ASSERT_EQ (conf.node.bandwidth_local_vote_share, defaults.node.bandwidth_local_vote_share);
+	ASSERT_EQ (conf.node.bandwidth_vote_share, defaults.node.bandwidth_vote_share);
+	ASSERT_EQ (conf.node.bandwidth_block_share, defaults.node.bandwidth_block_share);
+	ASSERT_EQ (conf.node.bandwidth_bulk_share, defaults.node.bandwidth_bulk_share);
 
 	ASSERT_EQ (conf.node.logging.bulk_pull_logging_value, defaults.node.logging.bulk_pull_logging_value);
 	ASSERT_EQ (conf.node.logging.flush, defaults.node.logging.flush);
@@ -260,6 +271,10 @@ TEST (toml, daemon_config_deserialize_defaults)
 	ASSERT_EQ (conf.node.rocksdb_config.memtable_size, defaults.node.rocksdb_config.memtable_size);
 	ASSERT_EQ (conf.node.rocksdb_config.num_memtables, defaults.node.rocksdb_config.num_memtables);
 	ASSERT_EQ (conf.node.rocksdb_config.total_memtable_size, defaults.node.rocksdb_config.total_memtable_size);
+	ASSERT_EQ (conf.node.rocksdb_config.blocks_bloom_filter_bits, defaults.node.rocksdb_config.blocks_bloom_filter_bits);
+	ASSERT_EQ (conf.node.rocksdb_config.prefix_bloom_filter_bits, defaults.node.rocksdb_config.prefix_bloom_filter_bits);
+	ASSERT_EQ (conf.node.rocksdb_config.unchecked_universal_compaction, defaults.node.rocksdb_config.unchecked_universal_compaction);
+	ASSERT_EQ (conf.node.rocksdb_config.confirmation_height_cache, defaults.node.rocksdb_config.confirmation_height_cache);
 }
 
 TEST (toml, optional_child)
@@ -397,6 +412,7 @@ TEST (toml, daemon_config_deserialize_no_defaults)
 	bootstrap_initiator_threads = 999
 	bootstrap_fraction_numerator = 999
 	conf_height_processor_batch_min_time = 999
+	conf_height_processor_prefetch_threads = 7
 	confirmation_history_size = 999
 	enable_voting = false
 	external_address = "0:0:0:0:0:ffff:7f01:101"
@@ -425,6 +441,16 @@ TEST (toml, daemon_config_deserialize_no_defaults)
 	work_watcher_period = 999
 	max_work_generate_multiplier = 1.0
 	max_queued_requests = 999
+	block_filter_memory_mb = 999
+	account_cache_size = 999
+	block_height_index = true
+	write_batch_max_latency = 999
+	write_batch_size = 999
+	udp_batch_io = true
+	bandwidth_local_vote_share = 0.3
+	bandwidth_vote_share = 0.2
+	bandwidth_block_share = 0.05
+	bandwidth_bulk_share = 0.25
 	frontiers_confirmation = "always"
 	[node.diagnostics.txn_tracking]
 	enable = true
@@ -516,6 +542,10 @@ TEST (toml, daemon_config_deserialize_no_defaults)
 	memtable_size = 128
 	num_memtables = 3
 	total_memtable_size = 0
+	blocks_bloom_filter_bits = 12
+	prefix_bloom_filter_bits = 0
+	unchecked_universal_compaction = false
+	confirmation_height_cache = 0
 
 	[node.experimental]
 	secondary_work_peers = ["test.org:998"]
@@ -562,6 +592,7 @@ TEST (toml, daemon_config_deserialize_no_defaults)
 	ASSERT_NE (conf.node.bootstrap_initiator_threads, defaults.node.bootstrap_initiator_threads);
 	ASSERT_NE (conf.node.bootstrap_fraction_numerator, defaults.node.bootstrap_fraction_numerator);
 	ASSERT_NE (conf.node.conf_height_processor_batch_min_time, defaults.node.conf_height_processor_batch_min_time);
+	ASSERT_NE (conf.node.conf_height_processor_prefetch_threads, defaults.node.conf_height_processor_prefetch_threads);
 	ASSERT_NE (conf.node.confirmation_history_size, defaults.node.confirmation_history_size);
 	ASSERT_NE (conf.node.enable_voting, defaults.node.enable_voting);
 	ASSERT_NE (conf.node.external_address, defaults.node.external_address);
@@ -592,6 +623,16 @@ TEST (toml, daemon_config_deserialize_no_defaults)
 	ASSERT_NE (conf.node.work_peers, defaults.node.work_peers);
 	ASSERT_NE (conf.node.work_threads, defaults.node.work_threads);
 	ASSERT_NE (conf.node.max_queued_requests, defaults.node.max_queued_requests);
+	ASSERT_NE (conf.node.block_filter_memory_mb, defaults.node.block_filter_memory_mb);
+	ASSERT_NE (conf.node.account_cache_size, defaults.node.account_cache_size);
+	ASSERT_NE (conf.node.block_height_index, defaults.node.block_height_index);
+	ASSERT_NE (conf.node.write_batch_max_latency, defaults.node.write_batch_max_latency);
+	ASSERT_NE (conf.node.write_batch_size, defaults.node.write_batch_size);
+	ASSERT_NE (conf.node.udp_batch_io, defaults.node.udp_batch_io);
+	ASSERT_NE (conf.node.bandwidth_local_vote_share, defaults.node.bandwidth_local_vote_share);
+	ASSERT_NE (conf.node.bandwidth_vote_share, defaults.node.bandwidth_vote_share);
+	ASSERT_NE (conf.node.bandwidth_block_share, defaults.node.bandwidth_block_share);
+	ASSERT_NE (conf.node.bandwidth_bulk_share, defaults.node.bandwidth_bulk_share);
 
 	ASSERT_NE (conf.node.logging.bulk_pull_logging_value, defaults.node.logging.bulk_pull_logging_value);
 	ASSERT_NE (conf.node.logging.flush, defaults.node.logging.flush);
@@ -669,6 +710,10 @@ TEST (toml, daemon_config_deserialize_no_defaults)
 	ASSERT_NE (conf.node.rocksdb_config.memtable_size, defaults.node.rocksdb_config.memtable_size);
 	ASSERT_NE (conf.node.rocksdb_config.num_memtables, defaults.node.rocksdb_config.num_memtables);
 	ASSERT_NE (conf.node.rocksdb_config.total_memtable_size, defaults.node.rocksdb_config.total_memtable_size);
+	ASSERT_NE (conf.node.rocksdb_config.blocks_bloom_filter_bits, defaults.node.rocksdb_config.blocks_bloom_filter_bits);
+	ASSERT_NE (conf.node.rocksdb_config.prefix_bloom_filter_bits, defaults.node.rocksdb_config.prefix_bloom_filter_bits);
+	ASSERT_NE (conf.node.rocksdb_config.unchecked_universal_compaction, defaults.node.rocksdb_config.unchecked_universal_compaction);
+	ASSERT_NE (conf.node.rocksdb_config.confirmation_height_cache, defaults.node.rocksdb_config.confirmation_height_cache);
 }
 
 /** There should be no required values **/
@@ -6,6 +6,22 @@
 
 #include <gtest/gtest.h>
 
+namespace
+{
+// Ledgers before v19 store open blocks in their own table, without a block type prefix
+void put_open_block_v18 (nano::mdb_store & store_a, nano::write_transaction const & transaction_a, nano::open_block const & open_a)
+{
+	ASSERT_FALSE (mdb_dbi_open (store_a.env.tx (transaction_a), "open", MDB_CREATE, &store_a.open_blocks));
+	std::vector<uint8_t> data;
+	{
+		nano::vectorstream stream (data);
+		open_a.serialize (stream);
+		open_a.sideband ().serialize (stream, open_a.type ());
+	}
+	ASSERT_FALSE (mdb_put (store_a.env.tx (transaction_a), store_a.open_blocks, nano::mdb_val (open_a.hash ()), nano::mdb_val (data.size (), data.data ()), 0));
+}
+}
+
 TEST (versioning, account_info_v1)
 {
 	auto file (nano::unique_path ());
@@ -18,7 +34,7 @@ TEST (versioning, account_info_v1)
 		nano::mdb_store store (logger, file);
 		ASSERT_FALSE (store.init_error ());
 		auto transaction (store.tx_begin_write ());
-		store.block_put (transaction, open.hash (), open);
+		put_open_block_v18 (store, transaction, open);
 		auto status (mdb_put (store.env.tx (transaction), store.accounts_v0, nano::mdb_val (account), nano::mdb_val (sizeof (v1), &v1), 0));
 		ASSERT_EQ (0, status);
 		store.version_put (transaction, 1);
@@ -54,7 +70,7 @@ TEST (versioning, account_info_v5)
 		nano::mdb_store store (logger, file);
 		ASSERT_FALSE (store.init_error ());
 		auto transaction (store.tx_begin_write ());
-		store.block_put (transaction, open.hash (), open);
+		put_open_block_v18 (store, transaction, open);
 		auto status (mdb_put (store.env.tx (transaction), store.accounts_v0, nano::mdb_val (account), nano::mdb_val (sizeof (v5), &v5), 0));
 		ASSERT_EQ (0, status);
 		store.version_put (transaction, 5);
@@ -90,7 +106,7 @@ TEST (versioning, account_info_v13)
 		nano::mdb_store store (logger, file);
 		ASSERT_FALSE (store.init_error ());
 		auto transaction (store.tx_begin_write ());
-		store.block_put (transaction, open.hash (), open);
+		put_open_block_v18 (store, transaction, open);
 		auto status (mdb_put (store.env.tx (transaction), store.accounts_v0, nano::mdb_val (account), nano::mdb_val (v13), 0));
 		ASSERT_EQ (0, status);
 		store.version_put (transaction, 13);
@@ -87,6 +87,83 @@ TEST (vote_processor, invalid_signature)
 	ASSERT_EQ (2, election.first->last_votes.size ());
 }
 
+TEST (vote_processor, replay_filter)
+{
+	nano::system system (1);
+	auto & node (*system.nodes[0]);
+	nano::genesis genesis;
+	nano::keypair key;
+	auto vote (std::make_shared<nano::vote> (key.pub, key.prv, 1, std::vector<nano::block_hash>{ genesis.open->hash () }));
+	auto channel (std::make_shared<nano::transport::channel_udp> (node.network.udp_channels, node.network.endpoint (), node.network_params.protocol.protocol_version));
+	std::atomic<unsigned> observed_replays{ 0 };
+	node.observers.vote.add ([&observed_replays](std::shared_ptr<nano::vote>, std::shared_ptr<nano::transport::channel>, nano::vote_code code_a) {
+		if (code_a == nano::vote_code::replay)
+		{
+			++observed_replays;
+		}
+	});
+	ASSERT_TRUE (node.active.insert (genesis.open).second);
+	// First arrival is applied, the second is verified and reported as a replay by the election
+	node.vote_processor.vote (vote, channel);
+	node.vote_processor.flush ();
+	ASSERT_EQ (1, node.stats.count (nano::stat::type::vote, nano::stat::detail::vote_valid));
+	node.vote_processor.vote (vote, channel);
+	node.vote_processor.flush ();
+	ASSERT_EQ (1, node.stats.count (nano::stat::type::vote, nano::stat::detail::vote_replay));
+	ASSERT_EQ (0, node.stats.count (nano::stat::type::vote, nano::stat::detail::vote_replay_filtered));
+	ASSERT_EQ (1, observed_replays);
+	// Further copies, and older sequences, skip the election but are still reported to the observers
+	node.vote_processor.vote (vote, channel);
+	auto vote_old (std::make_shared<nano::vote> (key.pub, key.prv, 0, std::vector<nano::block_hash>{ genesis.open->hash () }));
+	node.vote_processor.vote (vote_old, channel);
+	node.vote_processor.flush ();
+	ASSERT_EQ (2, node.stats.count (nano::stat::type::vote, nano::stat::detail::vote_replay_filtered));
+	ASSERT_EQ (3, node.stats.count (nano::stat::type::vote, nano::stat::detail::vote_replay));
+	ASSERT_EQ (3, observed_replays);
+	// Filtered replays with an invalid signature aren't reported
+	auto vote_invalid (std::make_shared<nano::vote> (*vote_old));
+	vote_invalid->signature.bytes[63] ^= 1;
+	node.vote_processor.vote (vote_invalid, channel);
+	node.vote_processor.flush ();
+	ASSERT_EQ (3, node.stats.count (nano::stat::type::vote, nano::stat::detail::vote_replay_filtered));
+	ASSERT_EQ (3, node.stats.count (nano::stat::type::vote, nano::stat::detail::vote_replay));
+	ASSERT_EQ (3, observed_replays);
+	// A higher sequence must still reach the election
+	auto vote_new (std::make_shared<nano::vote> (key.pub, key.prv, 2, std::vector<nano::block_hash>{ genesis.open->hash () }));
+	node.vote_processor.vote (vote_new, channel);
+	node.vote_processor.flush ();
+	ASSERT_EQ (3, node.stats.count (nano::stat::type::vote, nano::stat::detail::vote_replay_filtered));
+	ASSERT_EQ (3, node.stats.count (nano::stat::type::vote, nano::stat::detail::vote_replay));
+}
+
+TEST (vote_processor, verified_cache)
+{
+	nano::system system (1);
+	auto & node (*system.nodes[0]);
+	nano::genesis genesis;
+	nano::keypair key;
+	auto vote (std::make_shared<nano::vote> (key.pub, key.prv, 1, std::vector<nano::block_hash>{ genesis.open->hash () }));
+	auto channel (std::make_shared<nano::transport::channel_udp> (node.network.udp_channels, node.network.endpoint (), node.network_params.protocol.protocol_version));
+	ASSERT_TRUE (node.active.insert (genesis.open).second);
+	node.vote_processor.vote (vote, channel);
+	node.vote_processor.flush ();
+	ASSERT_EQ (0, node.stats.count (nano::stat::type::vote, nano::stat::detail::vote_verified_hit));
+	ASSERT_EQ (1, node.stats.count (nano::stat::type::vote, nano::stat::detail::vote_verified_miss));
+	// A copy with a different signature is verified and rejected
+	auto vote_invalid (std::make_shared<nano::vote> (*vote));
+	vote_invalid->signature.bytes[63] ^= 1;
+	node.vote_processor.vote (vote_invalid, channel);
+	node.vote_processor.flush ();
+	ASSERT_EQ (0, node.stats.count (nano::stat::type::vote, nano::stat::detail::vote_verified_hit));
+	ASSERT_EQ (2, node.stats.count (nano::stat::type::vote, nano::stat::detail::vote_verified_miss));
+	// A relayed copy skips signature verification but is still applied
+	node.vote_processor.vote (std::make_shared<nano::vote> (*vote), channel);
+	node.vote_processor.flush ();
+	ASSERT_EQ (1, node.stats.count (nano::stat::type::vote, nano::stat::detail::vote_verified_hit));
+	ASSERT_EQ (2, node.stats.count (nano::stat::type::vote, nano::stat::detail::vote_verified_miss));
+	ASSERT_EQ (1, node.stats.count (nano::stat::type::vote, nano::stat::detail::vote_replay));
+}
+
 TEST (vote_processor, no_capacity)
 {
 	nano::system system;
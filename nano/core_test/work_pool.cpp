@@ -41,6 +41,47 @@ TEST (work, validate)
 	ASSERT_LT (nano::work_threshold (send_block.work_version ()), send_block.difficulty ());
 }
 
+TEST (work, value_reference)
+{
+	// Compare the specialised hashing kernels against the generic blake2b implementation
+	nano::root root;
+	nano::random_pool::generate_block (root.bytes.data (), root.bytes.size ());
+	std::vector<uint64_t> works (19);
+	nano::random_pool::generate_block (reinterpret_cast<uint8_t *> (works.data ()), works.size () * sizeof (uint64_t));
+	std::vector<uint64_t> values (works.size ());
+	nano::work_v1::value_many (root, works.data (), values.data (), works.size ());
+	for (size_t i (0); i < works.size (); ++i)
+	{
+		uint64_t expected;
+		blake2b_state hash;
+		blake2b_init (&hash, sizeof (expected));
+		blake2b_update (&hash, reinterpret_cast<uint8_t *> (&works[i]), sizeof (works[i]));
+		blake2b_update (&hash, root.bytes.data (), root.bytes.size ());
+		blake2b_final (&hash, reinterpret_cast<uint8_t *> (&expected), sizeof (expected));
+		ASSERT_EQ (expected, values[i]);
+		ASSERT_EQ (expected, nano::work_v1::value (root, works[i]));
+	}
+}
+
+TEST (work, validate_many)
+{
+	nano::work_pool pool (std::numeric_limits<unsigned>::max ());
+	std::vector<std::shared_ptr<nano::block>> blocks;
+	std::vector<bool> expected;
+	for (auto i (0); i < 11; ++i)
+	{
+		auto block (std::make_shared<nano::send_block> (i + 1, 1, 2, nano::keypair ().prv, 4, 0));
+		if (i % 3 != 0)
+		{
+			block->block_work_set (*pool.generate (block->root ()));
+		}
+		expected.push_back (nano::work_validate (*block));
+		blocks.push_back (block);
+	}
+	ASSERT_FALSE (expected[1]);
+	ASSERT_EQ (expected, nano::work_validate_many (blocks));
+}
+
 TEST (work, cancel)
 {
 	nano::work_pool pool (std::numeric_limits<unsigned>::max ());
@@ -1,11 +1,15 @@
 #include <nano/crypto/blake2/blake2.h>
-#include <nano/crypto_lib/random_pool.hpp>
+
+#include <crypto/cryptopp/osrng.h>
 
 extern "C" {
 #include <crypto/ed25519-donna/ed25519-hash-custom.h>
 void ed25519_randombytes_unsafe (void * out, size_t outlen)
 {
-	nano::random_pool::generate_block (reinterpret_cast<uint8_t *> (out), outlen);
+	// Used for batch verification coefficients and for the randomness ed25519_sign hashes into its nonce along with the secret key and message.
+	// Each thread has its own OS seeded pool, of the same generator type as random_pool, which avoids contention on the shared random_pool mutex between signature checker threads
+	thread_local CryptoPP::AutoSeededRandomPool pool;
+	pool.GenerateBlock (reinterpret_cast<uint8_t *> (out), outlen);
 }
 void ed25519_hash_init (ed25519_hash_context * ctx)
 {
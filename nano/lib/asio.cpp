@@ -1,4 +1,6 @@
 #include <nano/lib/asio.hpp>
+#include <nano/lib/locks.hpp>
+#include <nano/lib/utility.hpp>
 
 nano::shared_const_buffer::shared_const_buffer (const std::vector<uint8_t> & data) :
 m_data (std::make_shared<std::vector<uint8_t>> (data)),
@@ -43,3 +45,137 @@ size_t nano::shared_const_buffer::size () const
 {
 	return m_buffer.size ();
 }
+
+static_assert ((nano::buffer_pool::class_size_min << (nano::buffer_pool::class_count - 1)) == nano::buffer_pool::class_size_max, "Size classes must cover class_size_max");
+
+nano::buffer_pool::buffer_pool (size_t max_per_class_a) :
+storage_m (std::make_shared<storage> (max_per_class_a))
+{
+}
+
+size_t nano::buffer_pool::class_index (size_t size_a)
+{
+	size_t result (0);
+	for (auto class_size (class_size_min); class_size < size_a; class_size <<= 1)
+	{
+		++result;
+	}
+	return result;
+}
+
+nano::shared_const_buffer nano::buffer_pool::make_buffer (uint8_t const * data_a, size_t size_a)
+{
+	if (size_a > class_size_max)
+	{
+		return nano::shared_const_buffer (std::vector<uint8_t> (data_a, data_a + size_a));
+	}
+	auto index (class_index (size_a));
+	debug_assert (index < storage_m->free.size ());
+	std::vector<uint8_t> data;
+	{
+		nano::lock_guard<std::mutex> lock (storage_m->mutex);
+		auto & free (storage_m->free[index]);
+		if (!free.empty ())
+		{
+			data = std::move (free.back ());
+			free.pop_back ();
+		}
+	}
+	if (data.capacity () == 0)
+	{
+		data.reserve (class_size_min << index);
+		++storage_m->allocations;
+	}
+	data.assign (data_a, data_a + size_a);
+	auto node_l (std::allocate_shared<node> (node_allocator<node> (storage_m), storage_m, index, std::move (data)));
+	// Aliasing the node shares its control block, the buffer doesn't need an allocation of its own
+	return nano::shared_const_buffer (std::shared_ptr<std::vector<uint8_t>> (node_l, &node_l->data));
+}
+
+size_t nano::buffer_pool::allocations () const
+{
+	return storage_m->allocations;
+}
+
+size_t nano::buffer_pool::size () const
+{
+	nano::lock_guard<std::mutex> lock (storage_m->mutex);
+	size_t result (0);
+	for (auto const & i : storage_m->free)
+	{
+		result += i.size ();
+	}
+	return result;
+}
+
+nano::buffer_pool::storage::storage (size_t max_per_class_a) :
+max_per_class (max_per_class_a)
+{
+}
+
+nano::buffer_pool::storage::~storage ()
+{
+	for (auto node : free_nodes)
+	{
+		::operator delete (node);
+	}
+}
+
+void nano::buffer_pool::storage::release (size_t index_a, std::vector<uint8_t> && data_a)
+{
+	nano::lock_guard<std::mutex> lock (mutex);
+	auto & free_l (free[index_a]);
+	if (free_l.size () < max_per_class)
+	{
+		free_l.push_back (std::move (data_a));
+	}
+}
+
+void * nano::buffer_pool::storage::allocate_node (size_t size_a)
+{
+	void * result (nullptr);
+	{
+		nano::lock_guard<std::mutex> lock (mutex);
+		if (size_a == node_size && !free_nodes.empty ())
+		{
+			result = free_nodes.back ();
+			free_nodes.pop_back ();
+		}
+	}
+	if (result == nullptr)
+	{
+		result = ::operator new (size_a);
+		++allocations;
+	}
+	return result;
+}
+
+void nano::buffer_pool::storage::release_node (void * node_a, size_t size_a)
+{
+	{
+		nano::lock_guard<std::mutex> lock (mutex);
+		// Every node is allocated with the same size, anything else isn't kept
+		if (node_size == 0)
+		{
+			node_size = size_a;
+		}
+		if (size_a == node_size && free_nodes.size () < max_per_class * class_count)
+		{
+			free_nodes.push_back (node_a);
+			node_a = nullptr;
+		}
+	}
+	::operator delete (node_a);
+}
+
+nano::buffer_pool::node::node (std::shared_ptr<storage> const & storage_a, size_t index_a, std::vector<uint8_t> && data_a) :
+storage_m (storage_a),
+index (index_a),
+data (std::move (data_a))
+{
+}
+
+nano::buffer_pool::node::~node ()
+{
+	storage_m->release (index, std::move (data));
+}
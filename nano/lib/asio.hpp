@@ -2,6 +2,12 @@
 
 #include <nano/boost/asio/write.hpp>
 
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
 namespace nano
 {
 class shared_const_buffer
@@ -28,6 +34,92 @@ private:
 
 static_assert (boost::asio::is_const_buffer_sequence<shared_const_buffer>::value, "Not ConstBufferSequence compliant");
 
+/**
+ * Recycles the storage behind shared_const_buffer in power of two size classes.
+ * Storage returns to the pool when the last shared_const_buffer referencing it is destroyed, which may outlive the pool itself.
+ */
+class buffer_pool final
+{
+public:
+	explicit buffer_pool (size_t max_per_class_a = 64);
+	/** Returns a buffer holding a copy of \p size_a bytes at \p data_a */
+	nano::shared_const_buffer make_buffer (uint8_t const * data_a, size_t size_a);
+	/** Number of times memory had to be allocated because nothing was free to reuse, either storage of a size class or a node referencing it */
+	size_t allocations () const;
+	/** Number of buffers ready to be reused */
+	size_t size () const;
+
+	static size_t constexpr class_size_min{ 64 };
+	/** Buffers larger than this are allocated and freed without pooling */
+	static size_t constexpr class_size_max{ 64 * 1024 };
+	static size_t constexpr class_count{ 11 };
+	static size_t class_index (size_t);
+
+private:
+	class storage final
+	{
+	public:
+		explicit storage (size_t max_per_class_a);
+		~storage ();
+		void release (size_t, std::vector<uint8_t> &&);
+		void * allocate_node (size_t);
+		void release_node (void *, size_t);
+		size_t const max_per_class;
+		mutable std::mutex mutex;
+		std::array<std::vector<std::vector<uint8_t>>, class_count> free;
+		/** Memory of released nodes, all of node_size bytes */
+		std::vector<void *> free_nodes;
+		size_t node_size{ 0 };
+		std::atomic<size_t> allocations{ 0 };
+	};
+	/** References pooled storage, which is returned to the pool when the node is destroyed */
+	class node final
+	{
+	public:
+		node (std::shared_ptr<storage> const &, size_t, std::vector<uint8_t> &&);
+		~node ();
+		std::shared_ptr<storage> storage_m;
+		size_t index;
+		std::vector<uint8_t> data;
+	};
+	/** Recycles the single block std::allocate_shared makes for a node and its control block */
+	template <typename T>
+	class node_allocator final
+	{
+	public:
+		using value_type = T;
+		explicit node_allocator (std::shared_ptr<storage> const & storage_a) :
+		storage_m (storage_a)
+		{
+		}
+		template <typename U>
+		node_allocator (node_allocator<U> const & other_a) :
+		storage_m (other_a.storage_m)
+		{
+		}
+		T * allocate (size_t count_a)
+		{
+			return static_cast<T *> (storage_m->allocate_node (count_a * sizeof (T)));
+		}
+		void deallocate (T * node_a, size_t count_a)
+		{
+			storage_m->release_node (node_a, count_a * sizeof (T));
+		}
+		template <typename U>
+		bool operator== (node_allocator<U> const & other_a) const
+		{
+			return storage_m == other_a.storage_m;
+		}
+		template <typename U>
+		bool operator!= (node_allocator<U> const & other_a) const
+		{
+			return storage_m != other_a.storage_m;
+		}
+		std::shared_ptr<storage> storage_m;
+	};
+	std::shared_ptr<storage> storage_m;
+};
+
 template <typename AsyncWriteStream, typename WriteHandler>
 BOOST_ASIO_INITFN_RESULT_TYPE (WriteHandler, void(boost::system::error_code, std::size_t))
 async_write (AsyncWriteStream & s, nano::shared_const_buffer const & buffer, WriteHandler && handler)
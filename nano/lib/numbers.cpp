@@ -428,9 +428,37 @@ bool nano::validate_message (nano::public_key const & public_key, nano::uint256_
 	return result;
 }
 
-bool nano::validate_message_batch (const unsigned char ** m, size_t * mlen, const unsigned char ** pk, const unsigned char ** RS, size_t num, int * valid)
+std::string nano::to_string (nano::signature_backend backend_a)
 {
-	bool result (0 == ed25519_sign_open_batch (m, mlen, pk, RS, num, valid));
+	std::string result;
+	switch (backend_a)
+	{
+		case nano::signature_backend::batch:
+			result = "batch";
+			break;
+		case nano::signature_backend::single:
+			result = "single";
+			break;
+	}
+	return result;
+}
+
+bool nano::validate_message_batch (const unsigned char ** m, size_t * mlen, const unsigned char ** pk, const unsigned char ** RS, size_t num, int * valid, nano::signature_backend backend_a)
+{
+	bool result (true);
+	switch (backend_a)
+	{
+		case nano::signature_backend::batch:
+			result = 0 == ed25519_sign_open_batch (m, mlen, pk, RS, num, valid);
+			break;
+		case nano::signature_backend::single:
+			for (size_t i (0); i < num; ++i)
+			{
+				valid[i] = (0 == ed25519_sign_open (m[i], mlen[i], pk[i], RS[i])) ? 1 : 0;
+				result = result && valid[i] == 1;
+			}
+			break;
+	}
 	return result;
 }
 
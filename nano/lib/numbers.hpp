@@ -244,7 +244,17 @@ public:
 
 nano::signature sign_message (nano::raw_key const &, nano::public_key const &, nano::uint256_union const &);
 bool validate_message (nano::public_key const &, nano::uint256_union const &, nano::signature const &);
-bool validate_message_batch (const unsigned char **, size_t *, const unsigned char **, const unsigned char **, size_t, int *);
+/** Algorithm used to check a set of signatures */
+enum class signature_backend
+{
+	/** Multi-scalar batch verification, falls back to single checks to find the invalid signatures in a failed batch */
+	batch,
+	/** Every signature checked on its own */
+	single
+};
+std::string to_string (nano::signature_backend);
+/** Returns true if all signatures are valid, each entry of the last argument is set to 1 if the signature is valid, 0 otherwise */
+bool validate_message_batch (const unsigned char **, size_t *, const unsigned char **, const unsigned char **, size_t, int *, nano::signature_backend = nano::signature_backend::batch);
 nano::private_key deterministic_key (nano::raw_key const &, uint32_t);
 nano::public_key pub_key (nano::private_key const &);
 
@@ -13,6 +13,10 @@ nano::error nano::rocksdb_config::serialize_toml (nano::tomlconfig & toml) const
 	toml.put ("num_memtables", num_memtables, "Number of memtables to keep in memory per column family. 2 is the minimum, 3 is recommended.\ntype:uint32");
 	toml.put ("memtable_size", memtable_size, "Amount of memory (MB) to build up before flushing to disk for an individual column family. Large values increase performance. 64 or 128 is recommended.\ntype:uint32");
 	toml.put ("total_memtable_size", total_memtable_size, "Total memory (MB) which can be used across all memtables, set to 0 for unconstrained.\ntype:uint32");
+	toml.put ("blocks_bloom_filter_bits", blocks_bloom_filter_bits, "Number of bits to use with a whole key bloom filter for the blocks column family, which is only read by hash. 0 uses bloom_filter_bits instead.\ntype:uint32");
+	toml.put ("prefix_bloom_filter_bits", prefix_bloom_filter_bits, "Number of bits to use with a bloom filter on the account prefix of pending keys and the previous hash prefix of unchecked keys. 0 disables the prefix extractor and uses bloom_filter_bits instead.\ntype:uint32");
+	toml.put ("unchecked_universal_compaction", unchecked_universal_compaction, "Whether to use universal compaction for the unchecked column family, which reduces write amplification of its short lived entries.\ntype:bool");
+	toml.put ("confirmation_height_cache", confirmation_height_cache, "Size (MB) of a block cache dedicated to the confirmation_height column family, so reads of it aren't evicted by block reads. 0 uses block_cache instead.\ntype:uint64");
 	return toml.get_error ();
 }
 
@@ -28,12 +32,24 @@ nano::error nano::rocksdb_config::deserialize_toml (nano::tomlconfig & toml)
 	toml.get_optional<unsigned> ("num_memtables", num_memtables);
 	toml.get_optional<unsigned> ("memtable_size", memtable_size);
 	toml.get_optional<unsigned> ("total_memtable_size", total_memtable_size);
+	toml.get_optional<unsigned> ("blocks_bloom_filter_bits", blocks_bloom_filter_bits);
+	toml.get_optional<unsigned> ("prefix_bloom_filter_bits", prefix_bloom_filter_bits);
+	toml.get_optional<bool> ("unchecked_universal_compaction", unchecked_universal_compaction);
+	toml.get_optional<uint64_t> ("confirmation_height_cache", confirmation_height_cache);
 
 	// Validate ranges
 	if (bloom_filter_bits > 100)
 	{
 		toml.get_error ().set ("bloom_filter_bits is too high");
 	}
+	if (blocks_bloom_filter_bits > 100)
+	{
+		toml.get_error ().set ("blocks_bloom_filter_bits is too high");
+	}
+	if (prefix_bloom_filter_bits > 100)
+	{
+		toml.get_error ().set ("prefix_bloom_filter_bits is too high");
+	}
 	if (num_memtables < 2)
 	{
 		toml.get_error ().set ("num_memtables must be at least 2");
@@ -25,5 +25,9 @@ public:
 	unsigned memtable_size{ 32 }; // MB
 	unsigned num_memtables{ 2 }; // Need a minimum of 2
 	unsigned total_memtable_size{ 512 }; // MB
+	unsigned blocks_bloom_filter_bits{ 10 };
+	unsigned prefix_bloom_filter_bits{ 10 };
+	bool unchecked_universal_compaction{ true };
+	uint64_t confirmation_height_cache{ 16 }; // MB
 };
 }
@@ -6,6 +6,7 @@
 #include <boost/format.hpp>
 #include <boost/property_tree/json_parser.hpp>
 
+#include <algorithm>
 #include <ctime>
 #include <fstream>
 #include <sstream>
@@ -191,9 +192,18 @@ public:
 	}
 };
 
+nano::stat::stat () :
+stat (nano::stat_config ())
+{
+}
+
 nano::stat::stat (nano::stat_config config) :
 config (config)
 {
+	for (auto & slot : lookup)
+	{
+		slot.store (nullptr, std::memory_order_relaxed);
+	}
 }
 
 std::shared_ptr<nano::stat_entry> nano::stat::get_entry (uint32_t key)
@@ -213,7 +223,8 @@ std::shared_ptr<nano::stat_entry> nano::stat::get_entry_impl (uint32_t key, size
 	auto entry = entries.find (key);
 	if (entry == entries.end ())
 	{
-		res = entries.emplace (key, std::make_shared<nano::stat_entry> (capacity, interval)).first->second;
+		res = entries.emplace (key, std::make_shared<nano::stat_entry> (key, capacity, interval)).first->second;
+		publish_entry (*res);
 	}
 	else
 	{
@@ -223,6 +234,47 @@ std::shared_ptr<nano::stat_entry> nano::stat::get_entry_impl (uint32_t key, size
 	return res;
 }
 
+namespace
+{
+size_t lookup_index (uint32_t key_a, size_t size_a)
+{
+	// Keys are packed enum values, spread them over the table with a multiplicative hash
+	return (key_a * 2654435761u) % size_a;
+}
+}
+
+nano::stat_entry * nano::stat::find_entry (uint32_t key_a) const
+{
+	nano::stat_entry * result (nullptr);
+	auto index (lookup_index (key_a, lookup_size));
+	auto done (false);
+	for (size_t i (0); i < lookup_size && !done; ++i)
+	{
+		auto entry (lookup[(index + i) % lookup_size].load (std::memory_order_acquire));
+		if (entry == nullptr || entry->key == key_a)
+		{
+			result = entry;
+			done = true;
+		}
+	}
+	return result;
+}
+
+void nano::stat::publish_entry (nano::stat_entry & entry_a)
+{
+	auto index (lookup_index (entry_a.key, lookup_size));
+	auto done (false);
+	for (size_t i (0); i < lookup_size && !done; ++i)
+	{
+		auto & slot (lookup[(index + i) % lookup_size]);
+		if (slot.load (std::memory_order_relaxed) == nullptr)
+		{
+			slot.store (&entry_a, std::memory_order_release);
+			done = true;
+		}
+	}
+}
+
 std::unique_ptr<nano::stat_log_sink> nano::stat::log_sink_json () const
 {
 	return std::make_unique<json_writer> ();
@@ -242,17 +294,17 @@ void nano::stat::log_counters_impl (stat_log_sink & sink)
 		sink.rotate ();
 	}
 
+	// Counters don't track the time of each update, entries are written with the time they are read
+	auto walltime (std::chrono::system_clock::now ());
 	if (config.log_headers)
 	{
-		auto walltime (std::chrono::system_clock::now ());
 		sink.write_header ("counters", walltime);
 	}
 
+	std::time_t time = std::chrono::system_clock::to_time_t (walltime);
+	tm local_tm = *localtime (&time);
 	for (auto & it : entries)
 	{
-		std::time_t time = std::chrono::system_clock::to_time_t (it.second->counter.get_timestamp ());
-		tm local_tm = *localtime (&time);
-
 		auto key = it.first;
 		std::string type = type_to_string (key);
 		std::string detail = detail_to_string (key);
@@ -301,7 +353,33 @@ void nano::stat::log_samples_impl (stat_log_sink & sink)
 	sink.finalize ();
 }
 
+void nano::stat::observe_count (stat::type type, stat::detail detail, stat::dir dir, std::function<void(uint64_t, uint64_t)> observer)
+{
+	// Set under stat_mutex like the locked counter updates, so the flag never changes partway through one of them
+	nano::lock_guard<std::mutex> lock (stat_mutex);
+	auto entry (get_entry_impl (key_of (type, detail, dir), config.interval, config.capacity));
+	entry->count_observers.add (observer);
+	entry->count_observed = true;
+}
+
 void nano::stat::update (uint32_t key_a, uint64_t value)
+{
+	auto entry (find_entry (key_a));
+	if (entry != nullptr && !entry->count_observed && !(config.sampling_enabled && entry->sample_interval > 0) && config.log_interval_counters == 0)
+	{
+		// Nothing else depends on this update, so the counter is added to without taking stat_mutex
+		if (!stopped)
+		{
+			entry->counter.add (value);
+		}
+	}
+	else
+	{
+		update_locked (key_a, value);
+	}
+}
+
+void nano::stat::update_locked (uint32_t key_a, uint64_t value)
 {
 	static file_writer log_count (config.log_counters_filename);
 	static file_writer log_sample (config.log_samples_filename);
@@ -374,8 +452,16 @@ void nano::stat::stop ()
 void nano::stat::clear ()
 {
 	nano::unique_lock<std::mutex> lock (stat_mutex);
-	entries.clear ();
-	timestamp = std::chrono::steady_clock::now ();
+	// Entries are reset in place rather than removed, lock free updates may still hold a pointer to them
+	auto now (std::chrono::steady_clock::now ());
+	for (auto & entry : entries)
+	{
+		entry.second->counter.reset ();
+		entry.second->samples.clear ();
+		entry.second->sample_current.set_value (0);
+		entry.second->sample_start_time = now;
+	}
+	timestamp = now;
 }
 
 std::string nano::stat::type_to_string (uint32_t key)
@@ -444,6 +530,18 @@ std::string nano::stat::type_to_string (uint32_t key)
 		case nano::stat::type::requests:
 			res = "requests";
 			break;
+		case nano::stat::type::bandwidth:
+			res = "bandwidth";
+			break;
+		case nano::stat::type::bandwidth_drop:
+			res = "bandwidth_drop";
+			break;
+		case nano::stat::type::write_batch:
+			res = "write_batch";
+			break;
+		case nano::stat::type::account_cache:
+			res = "account_cache";
+			break;
 	}
 	return res;
 }
@@ -586,6 +684,15 @@ std::string nano::stat::detail_to_string (uint32_t key)
 		case nano::stat::detail::vote_replay:
 			res = "vote_replay";
 			break;
+		case nano::stat::detail::vote_replay_filtered:
+			res = "vote_replay_filtered";
+			break;
+		case nano::stat::detail::vote_verified_hit:
+			res = "vote_verified_hit";
+			break;
+		case nano::stat::detail::vote_verified_miss:
+			res = "vote_verified_miss";
+			break;
 		case nano::stat::detail::vote_indeterminate:
 			res = "vote_indeterminate";
 			break;
@@ -622,6 +729,12 @@ std::string nano::stat::detail_to_string (uint32_t key)
 		case nano::stat::detail::tcp_write_drop:
 			res = "tcp_write_drop";
 			break;
+		case nano::stat::detail::tcp_write_batch:
+			res = "tcp_write_batch";
+			break;
+		case nano::stat::detail::tcp_write_batch_messages:
+			res = "tcp_write_batch_messages";
+			break;
 		case nano::stat::detail::unreachable_host:
 			res = "unreachable_host";
 			break;
@@ -673,6 +786,9 @@ std::string nano::stat::detail_to_string (uint32_t key)
 		case nano::stat::detail::blocks_confirmed_bounded:
 			res = "blocks_confirmed_bounded";
 			break;
+		case nano::stat::detail::blocks_prefetched:
+			res = "blocks_prefetched";
+			break;
 		case nano::stat::detail::aggregator_accepted:
 			res = "aggregator_accepted";
 			break;
@@ -694,6 +810,54 @@ std::string nano::stat::detail_to_string (uint32_t key)
 		case nano::stat::detail::requests_unknown:
 			res = "requests_unknown";
 			break;
+		case nano::stat::detail::bandwidth_local_vote:
+			res = "bandwidth_local_vote";
+			break;
+		case nano::stat::detail::bandwidth_vote:
+			res = "bandwidth_vote";
+			break;
+		case nano::stat::detail::bandwidth_block:
+			res = "bandwidth_block";
+			break;
+		case nano::stat::detail::bandwidth_control:
+			res = "bandwidth_control";
+			break;
+		case nano::stat::detail::bandwidth_bulk:
+			res = "bandwidth_bulk";
+			break;
+		case nano::stat::detail::write_batch_commit:
+			res = "write_batch_commit";
+			break;
+		case nano::stat::detail::write_batch_merged:
+			res = "write_batch_merged";
+			break;
+		case nano::stat::detail::write_batch_latency_1ms:
+			res = "write_batch_latency_1ms";
+			break;
+		case nano::stat::detail::write_batch_latency_10ms:
+			res = "write_batch_latency_10ms";
+			break;
+		case nano::stat::detail::write_batch_latency_100ms:
+			res = "write_batch_latency_100ms";
+			break;
+		case nano::stat::detail::write_batch_latency_1s:
+			res = "write_batch_latency_1s";
+			break;
+		case nano::stat::detail::write_batch_latency_max:
+			res = "write_batch_latency_max";
+			break;
+		case nano::stat::detail::account_info_hit:
+			res = "account_info_hit";
+			break;
+		case nano::stat::detail::account_info_miss:
+			res = "account_info_miss";
+			break;
+		case nano::stat::detail::confirmation_height_hit:
+			res = "confirmation_height_hit";
+			break;
+		case nano::stat::detail::confirmation_height_miss:
+			res = "confirmation_height_miss";
+			break;
 	}
 	return res;
 }
@@ -763,3 +927,37 @@ void nano::stat_datapoint::add (uint64_t addend, bool update_timestamp)
 		timestamp = std::chrono::system_clock::now ();
 	}
 }
+
+namespace
+{
+/** Threads are assigned counter shards round robin on their first update */
+size_t counter_shard ()
+{
+	static std::atomic<size_t> next_shard{ 0 };
+	thread_local size_t shard (next_shard.fetch_add (1, std::memory_order_relaxed) % nano::stat_counter::shard_count);
+	return shard;
+}
+}
+
+void nano::stat_counter::add (uint64_t addend)
+{
+	shards[counter_shard ()].value.fetch_add (addend, std::memory_order_relaxed);
+}
+
+uint64_t nano::stat_counter::get_value () const
+{
+	uint64_t result (0);
+	for (auto const & shard : shards)
+	{
+		result += shard.value.load (std::memory_order_relaxed);
+	}
+	return result;
+}
+
+void nano::stat_counter::reset ()
+{
+	for (auto & shard : shards)
+	{
+		shard.value.store (0, std::memory_order_relaxed);
+	}
+}
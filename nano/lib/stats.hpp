@@ -5,11 +5,14 @@
 
 #include <boost/circular_buffer.hpp>
 
+#include <array>
+#include <atomic>
 #include <chrono>
 #include <map>
 #include <memory>
 #include <mutex>
 #include <string>
+#include <vector>
 
 namespace nano
 {
@@ -78,15 +81,41 @@ private:
 	std::chrono::system_clock::time_point timestamp{ std::chrono::system_clock::now () };
 };
 
+/**
+ * Counter split over shards padded to a cache line, each thread adds to its own shard so concurrent updates of
+ * the same counter don't contend. Reading the value sums the shards.
+ */
+class stat_counter final
+{
+public:
+	void add (uint64_t addend);
+	uint64_t get_value () const;
+	/** Sets the value to zero, updates racing with the reset may or may not be counted */
+	void reset ();
+
+	static size_t constexpr shard_count{ 16 };
+
+private:
+	class alignas (64) shard final
+	{
+	public:
+		std::atomic<uint64_t> value{ 0 };
+	};
+	std::array<shard, shard_count> shards;
+};
+
 /** Bookkeeping of statistics for a specific type/detail/direction combination */
 class stat_entry final
 {
 public:
-	stat_entry (size_t capacity, size_t interval) :
-	samples (capacity), sample_interval (interval)
+	stat_entry (uint32_t key, size_t capacity, size_t interval) :
+	key (key), samples (capacity), sample_interval (interval)
 	{
 	}
 
+	/** Key constructed from stat::type, stat::detail and stat::dir */
+	uint32_t const key;
+
 	/** Optional samples. Note that this doesn't allocate any memory unless sampling is configured, which sets the capacity. */
 	boost::circular_buffer<stat_datapoint> samples;
 
@@ -94,19 +123,22 @@ public:
 	std::chrono::steady_clock::time_point sample_start_time{ std::chrono::steady_clock::now () };
 
 	/** Sample interval in milliseconds. If 0, sampling is disabled. */
-	size_t sample_interval;
+	std::atomic<size_t> sample_interval;
 
 	/** Value within the current sample interval */
 	stat_datapoint sample_current;
 
-	/** Counting value for this entry, including the time of last update. This is never reset and only increases. */
-	stat_datapoint counter;
+	/** Counting value for this entry. This only increases until stat::clear() resets it. */
+	stat_counter counter;
 
 	/** Zero or more observers for samples. Called at the end of the sample interval. */
 	nano::observer_set<boost::circular_buffer<stat_datapoint> &> sample_observers;
 
 	/** Observers for count. Called on each update. */
 	nano::observer_set<uint64_t, uint64_t> count_observers;
+
+	/** Set with stat_mutex held once a count observer is added, updates then take the locked path so observers see consistent old and new values */
+	std::atomic<bool> count_observed{ false };
 };
 
 /** Log sink interface */
@@ -199,7 +231,11 @@ public:
 		confirmation_height,
 		drop,
 		aggregator,
-		requests
+		requests,
+		bandwidth,
+		bandwidth_drop,
+		write_batch,
+		account_cache
 	};
 
 	/** Optional detail type */
@@ -262,6 +298,9 @@ public:
 		// vote specific
 		vote_valid,
 		vote_replay,
+		vote_replay_filtered,
+		vote_verified_hit,
+		vote_verified_miss,
 		vote_indeterminate,
 		vote_invalid,
 		vote_overflow,
@@ -292,6 +331,8 @@ public:
 		tcp_accept_success,
 		tcp_accept_failure,
 		tcp_write_drop,
+		tcp_write_batch,
+		tcp_write_batch_messages,
 
 		// ipc
 		invocations,
@@ -303,6 +344,7 @@ public:
 		blocks_confirmed,
 		blocks_confirmed_unbounded,
 		blocks_confirmed_bounded,
+		blocks_prefetched,
 		invalid_block,
 
 		// [request] aggregator
@@ -314,7 +356,29 @@ public:
 		requests_generated_hashes,
 		requests_cached_votes,
 		requests_generated_votes,
-		requests_unknown
+		requests_unknown,
+
+		// bandwidth classes
+		bandwidth_local_vote,
+		bandwidth_vote,
+		bandwidth_block,
+		bandwidth_control,
+		bandwidth_bulk,
+
+		// write batch, commit latencies are counted in buckets of up to 1ms, 10ms, 100ms, 1s and above
+		write_batch_commit,
+		write_batch_merged,
+		write_batch_latency_1ms,
+		write_batch_latency_10ms,
+		write_batch_latency_100ms,
+		write_batch_latency_1s,
+		write_batch_latency_max,
+
+		// account cache
+		account_info_hit,
+		account_info_miss,
+		confirmation_height_hit,
+		confirmation_height_miss
 	};
 
 	/** Direction of the stat. If the direction is irrelevant, use in */
@@ -325,7 +389,7 @@ public:
 	};
 
 	/** Constructor using the default config values */
-	stat () = default;
+	stat ();
 
 	/**
 	 * Initialize stats with a config.
@@ -420,10 +484,7 @@ public:
 	 * To avoid recursion, the observer callback must only use the received counts, not query the stat object.
 	 * @param observer The observer receives the old and the new count.
 	 */
-	void observe_count (stat::type type, stat::detail detail, stat::dir dir, std::function<void(uint64_t, uint64_t)> observer)
-	{
-		get_entry (key_of (type, detail, dir))->count_observers.add (observer);
-	}
+	void observe_count (stat::type type, stat::detail detail, stat::dir dir, std::function<void(uint64_t, uint64_t)> observer);
 
 	/** Returns a potentially empty list of the last N samples, where N is determined by the 'capacity' configuration */
 	boost::circular_buffer<stat_datapoint> * samples (stat::type type, stat::detail detail, stat::dir dir)
@@ -440,7 +501,9 @@ public:
 	/** Returns current value for the given counter at the detail level */
 	uint64_t count (stat::type type, stat::detail detail, stat::dir dir = stat::dir::in)
 	{
-		return get_entry (key_of (type, detail, dir))->counter.get_value ();
+		auto key (key_of (type, detail, dir));
+		auto entry (find_entry (key));
+		return entry != nullptr ? entry->counter.get_value () : get_entry (key)->counter.get_value ();
 	}
 
 	/** Returns the number of seconds since clear() was last called, or node startup if it's never called. */
@@ -483,6 +546,12 @@ private:
 	/** Unlocked implementation of get_entry() */
 	std::shared_ptr<nano::stat_entry> get_entry_impl (uint32_t key, size_t sample_interval, size_t max_samples);
 
+	/** Lock free search for an entry in the lookup table, returns nullptr if the entry hasn't been published yet */
+	nano::stat_entry * find_entry (uint32_t key) const;
+
+	/** Makes a new entry visible to find_entry(). Requires stat_mutex to be held */
+	void publish_entry (nano::stat_entry & entry);
+
 	/**
 	 * Update count and sample and call any observers on the key
 	 * @param key a key constructor from stat::type, stat::detail and stat::direction
@@ -490,6 +559,9 @@ private:
 	 */
 	void update (uint32_t key, uint64_t value);
 
+	/** Implementation of update() for entries with sampling, count observers or counter logging, which needs stat_mutex */
+	void update_locked (uint32_t key, uint64_t value);
+
 	/** Unlocked implementation of log_counters() to avoid using recursive locking */
 	void log_counters_impl (stat_log_sink & sink);
 
@@ -504,11 +576,19 @@ private:
 
 	/** Stat entries are sorted by key to simplify processing of log output */
 	std::map<uint32_t, std::shared_ptr<nano::stat_entry>> entries;
+
+	/**
+	 * Open addressing table of the entries, read without stat_mutex by update() and count().
+	 * Slots are only written with stat_mutex held, if the table is full the remaining entries are updated through the locked path.
+	 */
+	static size_t constexpr lookup_size{ 1024 };
+	std::array<std::atomic<nano::stat_entry *>, lookup_size> lookup;
+
 	std::chrono::steady_clock::time_point log_last_count_writeout{ std::chrono::steady_clock::now () };
 	std::chrono::steady_clock::time_point log_last_sample_writeout{ std::chrono::steady_clock::now () };
 
 	/** Whether stats should be output */
-	bool stopped{ false };
+	std::atomic<bool> stopped{ false };
 
 	/** All access to stat is thread safe, including calls from observers on the same thread */
 	std::mutex stat_mutex;
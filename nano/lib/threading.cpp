@@ -39,6 +39,9 @@ std::string nano::thread_role::get_string (nano::thread_role::name role)
 		case nano::thread_role::name::block_processing:
 			thread_role_name_string = "Blck processing";
 			break;
+		case nano::thread_role::name::block_verification:
+			thread_role_name_string = "Blck verifying";
+			break;
 		case nano::thread_role::name::request_loop:
 			thread_role_name_string = "Request loop";
 			break;
@@ -69,12 +72,21 @@ std::string nano::thread_role::get_string (nano::thread_role::name role)
 		case nano::thread_role::name::confirmation_height_processing:
 			thread_role_name_string = "Conf height";
 			break;
+		case nano::thread_role::name::confirmation_height_prefetch:
+			thread_role_name_string = "Conf prefetch";
+			break;
 		case nano::thread_role::name::worker:
 			thread_role_name_string = "Worker";
 			break;
 		case nano::thread_role::name::request_aggregator:
 			thread_role_name_string = "Req aggregator";
 			break;
+		case nano::thread_role::name::write_batch:
+			thread_role_name_string = "Write batch";
+			break;
+		case nano::thread_role::name::block_post_events:
+			thread_role_name_string = "Blck events";
+			break;
 	}
 
 	/*
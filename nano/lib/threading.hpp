@@ -22,6 +22,7 @@ namespace thread_role
 		alarm,
 		vote_processing,
 		block_processing,
+		block_verification,
 		request_loop,
 		wallet_actions,
 		bootstrap_initiator,
@@ -32,8 +33,11 @@ namespace thread_role
 		rpc_process_container,
 		work_watcher,
 		confirmation_height_processing,
+		confirmation_height_prefetch,
 		worker,
-		request_aggregator
+		request_aggregator,
+		write_batch,
+		block_post_events
 	};
 	/*
 	 * Get/Set the identifier for the current thread
@@ -4,6 +4,8 @@
 #include <nano/lib/work.hpp>
 #include <nano/node/xorshift.hpp>
 
+#include <algorithm>
+#include <array>
 #include <future>
 
 std::string nano::to_string (nano::work_version const version_a)
@@ -65,17 +67,255 @@ uint64_t nano::work_v1::threshold ()
 	return network_constants.publish_threshold;
 }
 
+namespace
+{
+uint64_t constexpr blake2b_iv[8] = {
+	0x6a09e667f3bcc908ULL, 0xbb67ae8584caa73bULL, 0x3c6ef372fe94f82bULL, 0xa54ff53a5f1d36f1ULL,
+	0x510e527fade682d1ULL, 0x9b05688c2b3e6c1fULL, 0x1f83d9abfb41bd6bULL, 0x5be0cd19137e2179ULL
+};
+
+uint8_t constexpr blake2b_sigma[12][16] = {
+	{ 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 },
+	{ 14, 10, 4, 8, 9, 15, 13, 6, 1, 12, 0, 2, 11, 7, 5, 3 },
+	{ 11, 8, 12, 0, 5, 2, 15, 13, 10, 14, 3, 6, 7, 1, 9, 4 },
+	{ 7, 9, 3, 1, 13, 12, 11, 14, 2, 6, 5, 10, 4, 0, 15, 8 },
+	{ 9, 0, 5, 7, 2, 4, 10, 15, 14, 1, 11, 12, 6, 8, 3, 13 },
+	{ 2, 12, 6, 10, 0, 11, 8, 3, 4, 13, 7, 5, 15, 14, 1, 9 },
+	{ 12, 5, 1, 15, 14, 13, 4, 10, 0, 7, 6, 3, 9, 2, 8, 11 },
+	{ 13, 11, 7, 14, 12, 1, 3, 9, 5, 0, 15, 4, 8, 6, 2, 10 },
+	{ 6, 15, 14, 9, 11, 3, 0, 8, 12, 2, 13, 7, 1, 4, 10, 5 },
+	{ 10, 2, 8, 4, 7, 6, 1, 5, 15, 11, 9, 14, 3, 12, 13, 0 },
+	{ 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 },
+	{ 14, 10, 4, 8, 9, 15, 13, 6, 1, 12, 0, 2, 11, 7, 5, 3 }
+};
+
+/** Number of messages hashed together by the batched kernels */
+size_t constexpr work_lanes{ 8 };
+
+#if defined(__GNUC__)
+#define NANO_WORK_INLINE inline __attribute__ ((always_inline))
+#else
+#define NANO_WORK_INLINE inline
+#endif
+
+NANO_WORK_INLINE uint64_t rotr64 (uint64_t word_a, unsigned bits_a)
+{
+	return (word_a >> bits_a) | (word_a << (64 - bits_a));
+}
+
+/** Loads the root as the four little endian message words following the nonce */
+void load_root (nano::root const & root_a, uint64_t (&words_a)[4])
+{
+	for (auto i (0); i < 4; ++i)
+	{
+		uint64_t word (0);
+		for (auto j (7); j >= 0; --j)
+		{
+			word = (word << 8) | root_a.bytes[i * 8 + j];
+		}
+		words_a[i] = word;
+	}
+}
+
+template <size_t Lanes>
+NANO_WORK_INLINE void work_g (uint64_t (&v_a)[16][Lanes], uint64_t const (&m_a)[16][Lanes], unsigned a, unsigned b, unsigned c, unsigned d, unsigned x, unsigned y)
+{
+	for (size_t i (0); i < Lanes; ++i)
+	{
+		v_a[a][i] = v_a[a][i] + v_a[b][i] + m_a[x][i];
+		v_a[d][i] = rotr64 (v_a[d][i] ^ v_a[a][i], 32);
+		v_a[c][i] = v_a[c][i] + v_a[d][i];
+		v_a[b][i] = rotr64 (v_a[b][i] ^ v_a[c][i], 24);
+		v_a[a][i] = v_a[a][i] + v_a[b][i] + m_a[y][i];
+		v_a[d][i] = rotr64 (v_a[d][i] ^ v_a[a][i], 16);
+		v_a[c][i] = v_a[c][i] + v_a[d][i];
+		v_a[b][i] = rotr64 (v_a[b][i] ^ v_a[c][i], 63);
+	}
+}
+
+/**
+ * Blake2b specialised for work values: an 8 byte unkeyed digest of a single 40 byte message, the nonce followed by the root.
+ * This needs one compression and none of the buffering in blake2b_update. Message words 5 to 15 are zero padding.
+ * Each lane is an independent message and lanes are processed in lockstep, letting the compiler keep them in vector registers.
+ */
+template <size_t Lanes>
+NANO_WORK_INLINE void work_kernel (uint64_t const (&m_a)[16][Lanes], uint64_t (&values_a)[Lanes])
+{
+	// Parameter block: digest length 8, key length 0, fanout 1, depth 1
+	auto const h0 (blake2b_iv[0] ^ 0x01010008ULL);
+	uint64_t v[16][Lanes];
+	for (size_t i (0); i < Lanes; ++i)
+	{
+		v[0][i] = h0;
+		for (auto j (1); j < 8; ++j)
+		{
+			v[j][i] = blake2b_iv[j];
+		}
+		for (auto j (0); j < 8; ++j)
+		{
+			v[8 + j][i] = blake2b_iv[j];
+		}
+		// Message length in bytes and the final block flag
+		v[12][i] ^= 40;
+		v[14][i] = ~v[14][i];
+	}
+	for (auto r (0); r < 12; ++r)
+	{
+		auto const & s (blake2b_sigma[r]);
+		work_g (v, m_a, 0, 4, 8, 12, s[0], s[1]);
+		work_g (v, m_a, 1, 5, 9, 13, s[2], s[3]);
+		work_g (v, m_a, 2, 6, 10, 14, s[4], s[5]);
+		work_g (v, m_a, 3, 7, 11, 15, s[6], s[7]);
+		work_g (v, m_a, 0, 5, 10, 15, s[8], s[9]);
+		work_g (v, m_a, 1, 6, 11, 12, s[10], s[11]);
+		work_g (v, m_a, 2, 7, 8, 13, s[12], s[13]);
+		work_g (v, m_a, 3, 4, 9, 14, s[14], s[15]);
+	}
+	for (size_t i (0); i < Lanes; ++i)
+	{
+		values_a[i] = h0 ^ v[0][i] ^ v[8][i];
+	}
+}
+
+using work_values_function = void (*) (uint64_t const (&)[16][work_lanes], uint64_t (&)[work_lanes]);
+
+void work_values_generic (uint64_t const (&m_a)[16][work_lanes], uint64_t (&values_a)[work_lanes])
+{
+	work_kernel<work_lanes> (m_a, values_a);
+}
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define NANO_WORK_RUNTIME_DISPATCH
+// The same kernel compiled for wider vector units, only called when the CPU reports support
+__attribute__ ((target ("avx2"))) void work_values_avx2 (uint64_t const (&m_a)[16][work_lanes], uint64_t (&values_a)[work_lanes])
+{
+	work_kernel<work_lanes> (m_a, values_a);
+}
+
+__attribute__ ((target ("avx512f"))) void work_values_avx512 (uint64_t const (&m_a)[16][work_lanes], uint64_t (&values_a)[work_lanes])
+{
+	work_kernel<work_lanes> (m_a, values_a);
+}
+#endif
+
+std::pair<work_values_function, char const *> select_work_values ()
+{
+	std::pair<work_values_function, char const *> result (work_values_generic, "generic");
+#ifdef NANO_WORK_RUNTIME_DISPATCH
+	__builtin_cpu_init ();
+	if (__builtin_cpu_supports ("avx512f"))
+	{
+		result = std::make_pair (work_values_avx512, "avx512");
+	}
+	else if (__builtin_cpu_supports ("avx2"))
+	{
+		result = std::make_pair (work_values_avx2, "avx2");
+	}
+#endif
+	return result;
+}
+
+std::pair<work_values_function, char const *> const & work_values ()
+{
+	static auto const result (select_work_values ());
+	return result;
+}
+
+/** Hashes up to work_lanes messages, \p m_a must be zero beyond the first five words of each lane */
+void work_values_batch (uint64_t const (&m_a)[16][work_lanes], uint64_t (&values_a)[work_lanes])
+{
+	work_values ().first (m_a, values_a);
+}
+}
+
 #ifndef NANO_FUZZER_TEST
 uint64_t nano::work_v1::value (nano::root const & root_a, uint64_t work_a)
 {
-	uint64_t result;
-	blake2b_state hash;
-	blake2b_init (&hash, sizeof (result));
-	blake2b_update (&hash, reinterpret_cast<uint8_t *> (&work_a), sizeof (work_a));
-	blake2b_update (&hash, root_a.bytes.data (), root_a.bytes.size ());
-	blake2b_final (&hash, reinterpret_cast<uint8_t *> (&result), sizeof (result));
+	uint64_t m[16][1] = {};
+	m[0][0] = work_a;
+	uint64_t root[4];
+	load_root (root_a, root);
+	for (auto i (0); i < 4; ++i)
+	{
+		m[1 + i][0] = root[i];
+	}
+	uint64_t result[1];
+	work_kernel<1> (m, result);
+	return result[0];
+}
+
+void nano::work_v1::value_many (nano::root const & root_a, uint64_t const * work_a, uint64_t * values_a, size_t count_a)
+{
+	uint64_t m[16][work_lanes] = {};
+	uint64_t root[4];
+	load_root (root_a, root);
+	for (auto i (0); i < 4; ++i)
+	{
+		for (size_t j (0); j < work_lanes; ++j)
+		{
+			m[1 + i][j] = root[i];
+		}
+	}
+	uint64_t values[work_lanes];
+	for (size_t i (0); i < count_a; i += work_lanes)
+	{
+		auto lanes (std::min (work_lanes, count_a - i));
+		std::copy (work_a + i, work_a + i + lanes, m[0]);
+		work_values_batch (m, values);
+		std::copy (values, values + lanes, values_a + i);
+	}
+}
+
+std::vector<bool> nano::work_validate_many (std::vector<std::shared_ptr<nano::block>> const & blocks_a)
+{
+	std::vector<bool> result (blocks_a.size (), false);
+	uint64_t m[16][work_lanes] = {};
+	uint64_t values[work_lanes];
+	std::array<size_t, work_lanes> indices;
+	size_t lanes (0);
+	auto const threshold (nano::work_threshold (nano::work_version::work_1));
+	auto flush = [&]() {
+		work_values_batch (m, values);
+		for (size_t i (0); i < lanes; ++i)
+		{
+			result[indices[i]] = values[i] < threshold;
+		}
+		lanes = 0;
+	};
+	for (size_t i (0), n (blocks_a.size ()); i < n; ++i)
+	{
+		auto const & block (*blocks_a[i]);
+		if (block.work_version () == nano::work_version::work_1)
+		{
+			uint64_t root[4];
+			load_root (block.root (), root);
+			m[0][lanes] = block.block_work ();
+			for (auto j (0); j < 4; ++j)
+			{
+				m[1 + j][lanes] = root[j];
+			}
+			indices[lanes++] = i;
+			if (lanes == work_lanes)
+			{
+				flush ();
+			}
+		}
+		else
+		{
+			result[i] = nano::work_validate (block);
+		}
+	}
+	if (lanes > 0)
+	{
+		flush ();
+	}
 	return result;
 }
+
+char const * nano::work_v1::kernel_name ()
+{
+	return work_values ().second;
+}
 #else
 uint64_t nano::work_v1::value (nano::root const & root_a, uint64_t work_a)
 {
@@ -87,6 +327,30 @@ uint64_t nano::work_v1::value (nano::root const & root_a, uint64_t work_a)
 	}
 	return network_constants.publish_threshold + 1;
 }
+
+void nano::work_v1::value_many (nano::root const & root_a, uint64_t const * work_a, uint64_t * values_a, size_t count_a)
+{
+	for (size_t i (0); i < count_a; ++i)
+	{
+		values_a[i] = value (root_a, work_a[i]);
+	}
+}
+
+std::vector<bool> nano::work_validate_many (std::vector<std::shared_ptr<nano::block>> const & blocks_a)
+{
+	std::vector<bool> result;
+	result.reserve (blocks_a.size ());
+	for (auto const & block : blocks_a)
+	{
+		result.push_back (nano::work_validate (*block));
+	}
+	return result;
+}
+
+char const * nano::work_v1::kernel_name ()
+{
+	return "fuzzer";
+}
 #endif
 
 nano::work_pool::work_pool (unsigned max_threads_a, std::chrono::nanoseconds pow_rate_limiter_a, std::function<boost::optional<uint64_t> (nano::work_version const, nano::root const &, uint64_t, std::atomic<int> &)> opencl_a) :
@@ -130,8 +394,9 @@ void nano::work_pool::loop (uint64_t thread)
 	nano::random_pool::generate_block (reinterpret_cast<uint8_t *> (rng.s.data ()), rng.s.size () * sizeof (decltype (rng.s)::value_type));
 	uint64_t work;
 	uint64_t output;
-	blake2b_state hash;
-	blake2b_init (&hash, sizeof (output));
+	// Nonces are hashed in batches by the multi-lane kernel
+	std::array<uint64_t, 8> works;
+	std::array<uint64_t, 8> outputs;
 	nano::unique_lock<std::mutex> lock (mutex);
 	auto pow_sleep = pow_rate_limiter;
 	while (!done)
@@ -166,14 +431,19 @@ void nano::work_pool::loop (uint64_t thread)
 					// Don't query main memory every iteration in order to reduce memory bus traffic
 					// All operations here operate on stack memory
 					// Count iterations down to zero since comparing to zero is easier than comparing to another number
-					unsigned iteration (256);
+					unsigned iteration (256 / works.size ());
 					while (iteration && output < current_l.difficulty)
 					{
-						work = rng.next ();
-						blake2b_update (&hash, reinterpret_cast<uint8_t *> (&work), sizeof (work));
-						blake2b_update (&hash, current_l.item.bytes.data (), current_l.item.bytes.size ());
-						blake2b_final (&hash, reinterpret_cast<uint8_t *> (&output), sizeof (output));
-						blake2b_init (&hash, sizeof (output));
+						for (auto & work_l : works)
+						{
+							work_l = rng.next ();
+						}
+						nano::work_v1::value_many (current_l.item, works.data (), outputs.data (), works.size ());
+						for (size_t i (0); i < works.size () && output < current_l.difficulty; ++i)
+						{
+							work = works[i];
+							output = outputs[i];
+						}
 						iteration -= 1;
 					}
 
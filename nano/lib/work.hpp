@@ -10,6 +10,7 @@
 
 #include <atomic>
 #include <memory>
+#include <vector>
 
 namespace nano
 {
@@ -23,6 +24,8 @@ std::string to_string (nano::work_version const version_a);
 class block;
 bool work_validate (nano::block const &);
 bool work_validate (nano::work_version const, nano::root const &, uint64_t const);
+/** Batched work_validate, the result at each index is true if the corresponding block has insufficient work */
+std::vector<bool> work_validate_many (std::vector<std::shared_ptr<nano::block>> const &);
 
 uint64_t work_difficulty (nano::work_version const, nano::root const &, uint64_t const);
 uint64_t work_threshold (nano::work_version const);
@@ -30,6 +33,10 @@ uint64_t work_threshold (nano::work_version const);
 namespace work_v1
 {
 	uint64_t value (nano::root const & root_a, uint64_t work_a);
+	/** Writes the work value of each of \p count_a nonces against \p root_a to \p values_a, several nonces are hashed per call */
+	void value_many (nano::root const & root_a, uint64_t const * work_a, uint64_t * values_a, size_t count_a);
+	/** Name of the batched hashing kernel selected for this CPU */
+	char const * kernel_name ();
 	uint64_t threshold ();
 }
 class opencl_work;
@@ -1,9 +1,9 @@
 #include <nano/lib/threading.hpp>
 #include <nano/lib/worker.hpp>
 
-nano::worker::worker () :
-thread ([this]() {
-	nano::thread_role::set (nano::thread_role::name::worker);
+nano::worker::worker (nano::thread_role::name role_a) :
+thread ([this, role_a]() {
+	nano::thread_role::set (role_a);
 	this->run ();
 })
 {
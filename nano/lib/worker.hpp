@@ -1,6 +1,7 @@
 #pragma once
 
 #include <nano/lib/locks.hpp>
+#include <nano/lib/threading.hpp>
 #include <nano/lib/utility.hpp>
 
 #include <deque>
@@ -13,7 +14,7 @@ namespace nano
 class worker final
 {
 public:
-	worker ();
+	explicit worker (nano::thread_role::name = nano::thread_role::name::worker);
 	~worker ();
 	void run ();
 	void push_task (std::function<void()> func);
@@ -14,6 +14,9 @@
 #include <boost/program_options.hpp>
 #include <boost/range/adaptor/reversed.hpp>
 
+#include <cstdlib>
+#include <fstream>
+#include <new>
 #include <sstream>
 
 #include <argon2.h>
@@ -56,6 +59,85 @@ public:
 	bool operator< (const address_library_pair & other) const;
 	bool operator== (const address_library_pair & other) const;
 };
+
+/**
+ * Validates the account chains of the ledger over multiple threads. The account key space is split into ranges by the first byte,
+ * each range is validated with its own read transaction. Ranges completed without errors are appended to an optional checkpoint file so an interrupted run can resume.
+ */
+class ledger_validator final
+{
+public:
+	ledger_validator (nano::node & node_a, unsigned threads_a, boost::filesystem::path const & checkpoint_a);
+	void validate_accounts ();
+	void validate_pending ();
+
+	static unsigned constexpr range_count{ 256 };
+	/** Signatures and work are verified in batches of this size */
+	static size_t constexpr batch_size{ 4096 };
+
+private:
+	/** Blocks waiting for signature and work verification */
+	class block_batch final
+	{
+	public:
+		std::vector<std::shared_ptr<nano::block>> blocks;
+		std::vector<nano::block_hash> hashes;
+		std::vector<nano::account> accounts;
+		/** Set for state blocks which look like epoch blocks, these are checked against it when the account signature doesn't validate */
+		std::vector<nano::account> epoch_signers;
+		/** Errors found so far in the range the batch belongs to */
+		uint64_t errors{ 0 };
+	};
+	void validate_range (unsigned);
+	/** Returns the number of blocks in the account chain */
+	uint64_t validate_account (nano::transaction const &, nano::account const &, nano::account_info const &, block_batch &);
+	void verify (block_batch &);
+	void error (std::string const &);
+	/** Also counts the error against the range \p batch_a belongs to */
+	void error (block_batch & batch_a, std::string const &);
+	void checkpoint_load ();
+	void checkpoint_save (unsigned, uint64_t, uint64_t);
+
+	nano::node & node;
+	unsigned threads;
+	boost::filesystem::path checkpoint;
+	std::vector<bool> completed;
+	std::atomic<unsigned> next_range{ 0 };
+	std::atomic<uint64_t> account_count{ 0 };
+	std::atomic<uint64_t> block_count{ 0 };
+	/** Blocks counted in ranges completed by an earlier run */
+	uint64_t resumed_block_count{ 0 };
+	/** Serializes error output and checkpoint writes */
+	std::mutex mutex;
+};
+
+/** Heap allocations are counted while this is set, debug_profile_flood uses it to count every allocation of a flood */
+std::atomic<bool> count_heap_allocations{ false };
+std::atomic<size_t> heap_allocations{ 0 };
+}
+
+void * operator new (std::size_t size_a)
+{
+	if (count_heap_allocations.load (std::memory_order_relaxed))
+	{
+		heap_allocations.fetch_add (1, std::memory_order_relaxed);
+	}
+	auto result (std::malloc (size_a == 0 ? 1 : size_a));
+	if (result == nullptr)
+	{
+		throw std::bad_alloc ();
+	}
+	return result;
+}
+
+void operator delete (void * ptr_a) noexcept
+{
+	std::free (ptr_a);
+}
+
+void operator delete (void * ptr_a, std::size_t) noexcept
+{
+	std::free (ptr_a);
 }
 
 int main (int argc, char * const * argv)
@@ -87,18 +169,20 @@ int main (int argc, char * const * argv)
 		("debug_verify_profile_batch", "Profile batch signature verification")
 		("debug_profile_bootstrap", "Profile bootstrap style blocks processing (at least 10GB of free storage space required)")
 		("debug_profile_sign", "Profile signature generation")
+		("debug_profile_flood", "Profile serializing a vote for each channel of a flood against serializing it once into a pooled buffer")
 		("debug_profile_process", "Profile active blocks processing (only for nano_test_network)")
+		("debug_profile_rocksdb", "Profile RocksDB access to the blocks, pending, unchecked and confirmation_height tables with shared column family options against per table profiles")
 		("debug_profile_votes", "Profile votes processing (only for nano_test_network)")
 		("debug_random_feed", "Generates output to RNG test suites")
 		("debug_rpc", "Read an RPC command from stdin and invoke it. Network operations will have no effect.")
-		("debug_validate_blocks", "Check all blocks for correct hash, signature, work value")
+		("debug_validate_blocks", "Check all blocks for correct hash, signature, work value. Optionally uses <threads> threads and resumes from or records progress in the checkpoint <file>")
 		("debug_peers", "Display peer IPv6:port connections")
 		("debug_cemented_block_count", "Displays the number of cemented (confirmed) blocks")
 		("debug_stacktrace", "Display an example stacktrace")
 		("debug_account_versions", "Display the total counts of each version for all accounts (including unpocketed)")
 		("platform", boost::program_options::value<std::string> (), "Defines the <platform> for OpenCL commands")
 		("device", boost::program_options::value<std::string> (), "Defines <device> for OpenCL command")
-		("threads", boost::program_options::value<std::string> (), "Defines <threads> count for OpenCL command")
+		("threads", boost::program_options::value<std::string> (), "Defines <threads> count for OpenCL and debug_validate_blocks commands")
 		("difficulty", boost::program_options::value<std::string> (), "Defines <difficulty> for OpenCL command, HEX")
 		("pow_sleep_interval", boost::program_options::value<std::string> (), "Defines the amount to sleep inbetween each pow calculation attempt")
 		("address_column", boost::program_options::value<std::string> (), "Defines which column the addresses are located, 0 indexed (check --debug_output_last_backtrace_dump output)");
@@ -161,7 +245,7 @@ int main (int argc, char * const * argv)
 		{
 			nano::inactive_node node (data_path);
 			auto transaction (node.node->store.tx_begin_read ());
-			std::cout << boost::str (boost::format ("Block count: %1%\n") % node.node->store.block_count (transaction).sum ());
+			std::cout << boost::str (boost::format ("Block count: %1%\n") % node.node->store.block_count (transaction));
 		}
 		else if (vm.count ("debug_bootstrap_generate"))
 		{
@@ -664,20 +748,39 @@ int main (int argc, char * const * argv)
 		}
 		else if (vm.count ("debug_verify_profile_batch"))
 		{
-			nano::keypair key;
 			size_t batch_count (1000);
-			nano::uint256_union message;
-			nano::uint512_union signature (nano::sign_message (key.prv, key.pub, message));
-			std::vector<unsigned char const *> messages (batch_count, message.bytes.data ());
-			std::vector<size_t> lengths (batch_count, sizeof (message));
-			std::vector<unsigned char const *> pub_keys (batch_count, key.pub.bytes.data ());
-			std::vector<unsigned char const *> signatures (batch_count, signature.bytes.data ());
-			std::vector<int> verifications;
-			verifications.resize (batch_count);
-			auto begin (std::chrono::high_resolution_clock::now ());
-			nano::validate_message_batch (messages.data (), lengths.data (), pub_keys.data (), signatures.data (), batch_count, verifications.data ());
-			auto end (std::chrono::high_resolution_clock::now ());
-			std::cerr << "Batch signature verifications " << std::chrono::duration_cast<std::chrono::microseconds> (end - begin).count () << std::endl;
+			std::vector<nano::keypair> keys (batch_count);
+			std::vector<nano::uint256_union> hashes (batch_count);
+			std::vector<nano::signature> signatures_l;
+			signatures_l.reserve (batch_count);
+			for (size_t i (0); i < batch_count; ++i)
+			{
+				hashes[i] = i;
+				signatures_l.push_back (nano::sign_message (keys[i].prv, keys[i].pub, hashes[i]));
+			}
+			std::vector<unsigned char const *> messages;
+			std::vector<size_t> lengths (batch_count, sizeof (nano::uint256_union));
+			std::vector<unsigned char const *> pub_keys;
+			std::vector<unsigned char const *> signatures;
+			for (size_t i (0); i < batch_count; ++i)
+			{
+				messages.push_back (hashes[i].bytes.data ());
+				pub_keys.push_back (keys[i].pub.bytes.data ());
+				signatures.push_back (signatures_l[i].bytes.data ());
+			}
+			std::vector<int> verifications (batch_count);
+			auto threads (std::max (1u, std::thread::hardware_concurrency ()) - 1);
+			for (auto backend : { nano::signature_backend::batch, nano::signature_backend::single })
+			{
+				nano::signature_checker checker (threads, backend);
+				nano::signature_check_set check (batch_count, messages.data (), lengths.data (), pub_keys.data (), signatures.data (), verifications.data ());
+				auto begin (std::chrono::high_resolution_clock::now ());
+				checker.verify (check);
+				auto end (std::chrono::high_resolution_clock::now ());
+				auto us (std::max<long long> (1, std::chrono::duration_cast<std::chrono::microseconds> (end - begin).count ()));
+				std::cerr << boost::str (boost::format ("%1% signature verifications (%2% threads) %3% us, %4% sigs/sec\n") % nano::to_string (backend) % (threads + 1) % us % (batch_count * 1000000 / us));
+				release_assert (std::all_of (verifications.begin (), verifications.end (), [](int verification) { return verification == 1; }));
+			}
 		}
 		else if (vm.count ("debug_profile_sign"))
 		{
@@ -696,6 +799,186 @@ int main (int argc, char * const * argv)
 				std::cerr << boost::str (boost::format ("%|1$ 12d|\n") % std::chrono::duration_cast<std::chrono::microseconds> (end1 - begin1).count ());
 			}
 		}
+		else if (vm.count ("debug_profile_flood"))
+		{
+			size_t const fanout (20);
+			size_t const floods (100000);
+			// Sends still in flight when the next flood is serialized
+			size_t const in_flight (64);
+			nano::keypair key;
+			std::vector<nano::block_hash> hashes (12);
+			for (auto & hash : hashes)
+			{
+				nano::random_pool::generate_block (hash.bytes.data (), hash.bytes.size ());
+			}
+			nano::confirm_ack message (std::make_shared<nano::vote> (key.pub, key.prv, 1, hashes));
+			std::deque<nano::shared_const_buffer> sent;
+			auto send = [&](nano::shared_const_buffer const & buffer_a) {
+				sent.push_back (buffer_a);
+				if (sent.size () > in_flight)
+				{
+					sent.pop_front ();
+				}
+			};
+			std::cout << boost::str (boost::format ("Serializing a %1% byte vote for %2% floods to %3% channels\n") % message.to_bytes ()->size () % floods % fanout);
+			// Serialized the way message::to_shared_const_buffer () does
+			heap_allocations = 0;
+			count_heap_allocations = true;
+			auto begin1 (std::chrono::steady_clock::now ());
+			for (size_t i (0); i < floods; ++i)
+			{
+				for (size_t j (0); j < fanout; ++j)
+				{
+					send (nano::shared_const_buffer (message.to_bytes ()));
+				}
+			}
+			auto end1 (std::chrono::steady_clock::now ());
+			count_heap_allocations = false;
+			size_t allocations1 (heap_allocations);
+			sent.clear ();
+			nano::buffer_pool pool;
+			heap_allocations = 0;
+			count_heap_allocations = true;
+			auto begin2 (std::chrono::steady_clock::now ());
+			for (size_t i (0); i < floods; ++i)
+			{
+				auto buffer (message.to_shared_const_buffer (pool));
+				for (size_t j (0); j < fanout; ++j)
+				{
+					send (buffer);
+				}
+			}
+			auto end2 (std::chrono::steady_clock::now ());
+			count_heap_allocations = false;
+			size_t allocations2 (heap_allocations);
+			auto time1 (std::chrono::duration_cast<std::chrono::nanoseconds> (end1 - begin1).count ());
+			auto time2 (std::chrono::duration_cast<std::chrono::nanoseconds> (end2 - begin2).count ());
+			std::cout << boost::str (boost::format ("Per channel serialization: %1% ns per flood, %2% heap allocations per flood (%3% in total)\n") % (time1 / floods) % (static_cast<double> (allocations1) / floods) % allocations1);
+			std::cout << boost::str (boost::format ("Pooled serialization: %1% ns per flood, %2% heap allocations per flood (%3% in total, %4% by the pool)\n") % (time2 / floods) % (static_cast<double> (allocations2) / floods) % allocations2 % pool.allocations ());
+		}
+		else if (vm.count ("debug_profile_rocksdb"))
+		{
+#if NANO_ROCKSDB
+			size_t const count (250000);
+			size_t const per_commit (10000);
+			std::vector<nano::account> accounts (count);
+			std::vector<nano::block_hash> hashes (count);
+			std::vector<nano::block_hash> missing (count);
+			for (size_t i (0); i < count; ++i)
+			{
+				nano::random_pool::generate_block (accounts[i].bytes.data (), accounts[i].bytes.size ());
+				nano::random_pool::generate_block (hashes[i].bytes.data (), hashes[i].bytes.size ());
+				nano::random_pool::generate_block (missing[i].bytes.data (), missing[i].bytes.size ());
+			}
+			std::vector<std::shared_ptr<nano::block>> blocks;
+			blocks.reserve (count);
+			nano::block_builder builder;
+			for (size_t i (0); i < count; ++i)
+			{
+				std::shared_ptr<nano::block> block (builder.state ().account (accounts[i]).previous (0).representative (accounts[i]).balance (1).link (hashes[i]).sign_zero ().work (0).build ());
+				block->sideband_set (nano::block_sideband (accounts[i], 0, 1, 1, nano::seconds_since_epoch (), nano::epoch::epoch_0, false, true, false));
+				blocks.push_back (block);
+			}
+			auto profile = [&](std::string const & name_a, nano::rocksdb_config const & config_a) {
+				nano::logger_mt logger;
+				auto path (nano::unique_path ());
+				auto begin_write (std::chrono::steady_clock::now ());
+				{
+					auto store (nano::make_store (logger, path, false, false, config_a, nano::txn_tracking_config{}, std::chrono::milliseconds (5000), nano::lmdb_config{}, 512, false, true));
+					release_assert (!store->init_error ());
+					for (size_t i (0); i < count; i += per_commit)
+					{
+						auto transaction (store->tx_begin_write ({ nano::tables::blocks, nano::tables::cached_counts, nano::tables::confirmation_height, nano::tables::pending }));
+						for (size_t j (i), n (std::min (i + per_commit, count)); j < n; ++j)
+						{
+							store->block_put (transaction, blocks[j]->hash (), *blocks[j]);
+							store->pending_put (transaction, nano::pending_key (accounts[j], hashes[j]), nano::pending_info (accounts[j], 1, nano::epoch::epoch_0));
+							store->confirmation_height_put (transaction, accounts[j], { 1, blocks[j]->hash () });
+						}
+					}
+				}
+				auto end_write (std::chrono::steady_clock::now ());
+				// Reopening writes the memtables out as table files, so reads below go through the table filters and caches
+				auto store (nano::make_store (logger, path, false, false, config_a, nano::txn_tracking_config{}, std::chrono::milliseconds (5000), nano::lmdb_config{}, 512, false, true));
+				release_assert (!store->init_error ());
+				size_t found (0);
+				auto begin_blocks (std::chrono::steady_clock::now ());
+				{
+					auto transaction (store->tx_begin_read ());
+					for (size_t i (0); i < count; ++i)
+					{
+						found += store->block_exists (transaction, blocks[i]->hash ());
+						found += store->block_exists (transaction, missing[i]);
+					}
+				}
+				auto begin_pending (std::chrono::steady_clock::now ());
+				{
+					auto transaction (store->tx_begin_read ());
+					for (size_t i (0); i < count; ++i)
+					{
+						for (auto const & account : { accounts[i], nano::account (missing[i].number ()) })
+						{
+							auto existing (store->pending_account_begin (transaction, nano::pending_key (account, 0)));
+							found += existing != store->pending_end () && existing->first.account == account;
+						}
+					}
+				}
+				auto begin_confirmation_height (std::chrono::steady_clock::now ());
+				{
+					auto transaction (store->tx_begin_read ());
+					for (size_t i (0); i < count; ++i)
+					{
+						nano::confirmation_height_info info;
+						found += !store->confirmation_height_get (transaction, accounts[i], info);
+					}
+				}
+				auto begin_unchecked (std::chrono::steady_clock::now ());
+				// Unchecked entries are added and deleted soon after, emulating blocks arriving ahead of their dependencies
+				for (size_t i (0); i < count; i += per_commit)
+				{
+					auto n (std::min (i + per_commit, count));
+					{
+						auto transaction (store->tx_begin_write ({ nano::tables::unchecked }));
+						for (size_t j (i); j < n; ++j)
+						{
+							store->unchecked_put (transaction, nano::unchecked_key (missing[j], blocks[j]->hash ()), nano::unchecked_info (blocks[j], accounts[j], 0, nano::signature_verification::unknown));
+						}
+					}
+					{
+						auto transaction (store->tx_begin_write ({ nano::tables::unchecked }));
+						for (size_t j (i); j < n; ++j)
+						{
+							found += store->unchecked_exists (transaction, nano::unchecked_key (missing[j], blocks[j]->hash ()));
+							store->unchecked_del (transaction, nano::unchecked_key (missing[j], blocks[j]->hash ()));
+						}
+					}
+				}
+				auto end (std::chrono::steady_clock::now ());
+				release_assert (found == 4 * count);
+				auto per_operation = [](auto begin_a, auto end_a, size_t operations_a) {
+					return std::chrono::duration_cast<std::chrono::nanoseconds> (end_a - begin_a).count () / operations_a;
+				};
+				std::cout << boost::str (boost::format ("%1%:\n") % name_a);
+				std::cout << boost::str (boost::format ("\twrite: %1% ns per account\n") % per_operation (begin_write, end_write, count));
+				std::cout << boost::str (boost::format ("\tblocks point reads: %1% ns per read, half of them missing\n") % per_operation (begin_blocks, begin_pending, 2 * count));
+				std::cout << boost::str (boost::format ("\tpending account seeks: %1% ns per seek, half of them missing\n") % per_operation (begin_pending, begin_confirmation_height, 2 * count));
+				std::cout << boost::str (boost::format ("\tconfirmation_height point reads: %1% ns per read\n") % per_operation (begin_confirmation_height, begin_unchecked, count));
+				std::cout << boost::str (boost::format ("\tunchecked put and delete: %1% ns per entry\n") % per_operation (begin_unchecked, end, count));
+			};
+			nano::rocksdb_config shared;
+			shared.blocks_bloom_filter_bits = 0;
+			shared.prefix_bloom_filter_bits = 0;
+			shared.unchecked_universal_compaction = false;
+			shared.confirmation_height_cache = 0;
+			std::cout << boost::str (boost::format ("Profiling RocksDB tables with %1% accounts\n") % count);
+			profile ("Shared column family options", shared);
+			profile ("Per table profiles", nano::rocksdb_config{});
+			nano::remove_temporary_directories ();
+#else
+			std::cerr << std::error_code (nano::error_config::rocksdb_enabled_but_not_supported).message () << std::endl;
+			result = -1;
+#endif
+		}
 		else if (vm.count ("debug_profile_process"))
 		{
 			nano::network_constants::set_active_network (nano::nano_networks::nano_test_network);
@@ -814,12 +1097,37 @@ int main (int argc, char * const * argv)
 			{
 				std::this_thread::sleep_for (std::chrono::milliseconds (10));
 				auto transaction (node->store.tx_begin_read ());
-				block_count = node->store.block_count (transaction).sum ();
+				block_count = node->store.block_count (transaction);
 			}
 			auto end (std::chrono::high_resolution_clock::now ());
 			auto time (std::chrono::duration_cast<std::chrono::microseconds> (end - begin).count ());
 			node->stop ();
 			std::cout << boost::str (boost::format ("%|1$ 12d| us \n%2% blocks per second\n") % time % (max_blocks * 1000000 / time));
+			// Compare lookups for blocks which are not in the ledger with and without the block filter
+			size_t num_lookups (1000000);
+			std::vector<nano::block_hash> missing (num_lookups);
+			for (auto & hash : missing)
+			{
+				nano::random_pool::generate_block (hash.bytes.data (), hash.bytes.size ());
+			}
+			auto profile_lookups = [&node, &missing]() {
+				auto transaction (node->store.tx_begin_read ());
+				auto begin (std::chrono::high_resolution_clock::now ());
+				for (auto const & hash : missing)
+				{
+					release_assert (!node->store.block_exists (transaction, hash));
+				}
+				return std::chrono::duration_cast<std::chrono::microseconds> (std::chrono::high_resolution_clock::now () - begin).count ();
+			};
+			auto & filter (node->store.get_block_filter ());
+			auto time_filtered (profile_lookups ());
+			std::cout << boost::str (boost::format ("%1% missing block lookups with the block filter (%2% bytes): %|3$ 12d| us, false positive rate %4%\n") % num_lookups % filter.size_bytes () % time_filtered % filter.false_positive_rate ());
+			{
+				auto transaction (node->store.tx_begin_read ());
+				node->store.block_filter_build (transaction, 0);
+			}
+			auto time_unfiltered (profile_lookups ());
+			std::cout << boost::str (boost::format ("%1% missing block lookups without the block filter: %|2$ 12d| us\n") % num_lookups % time_unfiltered);
 		}
 		else if (vm.count ("debug_profile_votes"))
 		{
@@ -971,245 +1279,33 @@ int main (int argc, char * const * argv)
 		else if (vm.count ("debug_validate_blocks"))
 		{
 			nano::inactive_node node (data_path);
-			auto transaction (node.node->store.tx_begin_read ());
-			std::cout << boost::str (boost::format ("Performing blocks hash, signature, work validation...\n"));
-			size_t count (0);
-			uint64_t block_count (0);
-			for (auto i (node.node->store.latest_begin (transaction)), n (node.node->store.latest_end ()); i != n; ++i)
+			auto threads (std::max (1u, std::thread::hardware_concurrency ()));
+			auto threads_it = vm.find ("threads");
+			if (threads_it != vm.end ())
 			{
-				++count;
-				if ((count % 20000) == 0)
+				try
 				{
-					std::cout << boost::str (boost::format ("%1% accounts validated\n") % count);
+					threads = std::max (1u, boost::lexical_cast<unsigned> (threads_it->second.as<std::string> ()));
 				}
-				nano::account_info const & info (i->second);
-				nano::account const & account (i->first);
-				nano::confirmation_height_info confirmation_height_info;
-				node.node->store.confirmation_height_get (transaction, account, confirmation_height_info);
-
-				if (confirmation_height_info.height > info.block_count)
+				catch (boost::bad_lexical_cast &)
 				{
-					std::cerr << "Confirmation height " << confirmation_height_info.height << " greater than block count " << info.block_count << " for account: " << account.to_account () << std::endl;
-				}
-
-				auto hash (info.open_block);
-				nano::block_hash calculated_hash (0);
-				auto block (node.node->store.block_get (transaction, hash)); // Block data
-				uint64_t height (0);
-				uint64_t previous_timestamp (0);
-				nano::account calculated_representative (0);
-				while (!hash.is_zero () && block != nullptr)
-				{
-					++block_count;
-					auto const & sideband (block->sideband ());
-					// Check for state & open blocks if account field is correct
-					if (block->type () == nano::block_type::open || block->type () == nano::block_type::state)
-					{
-						if (block->account () != account)
-						{
-							std::cerr << boost::str (boost::format ("Incorrect account field for block %1%\n") % hash.to_string ());
-						}
-					}
-					// Check if sideband account is correct
-					else if (sideband.account != account)
-					{
-						std::cerr << boost::str (boost::format ("Incorrect sideband account for block %1%\n") % hash.to_string ());
-					}
-					// Check if previous field is correct
-					if (calculated_hash != block->previous ())
-					{
-						std::cerr << boost::str (boost::format ("Incorrect previous field for block %1%\n") % hash.to_string ());
-					}
-					// Check if previous & type for open blocks are correct
-					if (height == 0 && !block->previous ().is_zero ())
-					{
-						std::cerr << boost::str (boost::format ("Incorrect previous for open block %1%\n") % hash.to_string ());
-					}
-					if (height == 0 && block->type () != nano::block_type::open && block->type () != nano::block_type::state)
-					{
-						std::cerr << boost::str (boost::format ("Incorrect type for open block %1%\n") % hash.to_string ());
-					}
-					// Check if block data is correct (calculating hash)
-					calculated_hash = block->hash ();
-					if (calculated_hash != hash)
-					{
-						std::cerr << boost::str (boost::format ("Invalid data inside block %1% calculated hash: %2%\n") % hash.to_string () % calculated_hash.to_string ());
-					}
-					// Check if block signature is correct
-					if (validate_message (account, hash, block->block_signature ()))
-					{
-						bool invalid (true);
-						// Epoch blocks
-						if (block->type () == nano::block_type::state)
-						{
-							auto & state_block (static_cast<nano::state_block &> (*block.get ()));
-							nano::amount prev_balance (0);
-							if (!state_block.hashables.previous.is_zero ())
-							{
-								prev_balance = node.node->ledger.balance (transaction, state_block.hashables.previous);
-							}
-							if (node.node->ledger.is_epoch_link (state_block.hashables.link) && state_block.hashables.balance == prev_balance)
-							{
-								invalid = validate_message (node.node->ledger.epoch_signer (block->link ()), hash, block->block_signature ());
-							}
-						}
-						if (invalid)
-						{
-							std::cerr << boost::str (boost::format ("Invalid signature for block %1%\n") % hash.to_string ());
-						}
-					}
-					// Validate block details set in the sideband
-					bool block_details_error = false;
-					if (block->type () != nano::block_type::state)
-					{
-						// Not state
-						block_details_error = sideband.details.is_send || sideband.details.is_receive || sideband.details.is_epoch;
-					}
-					else
-					{
-						auto prev_balance (node.node->ledger.balance (transaction, block->previous ()));
-						if (block->balance () < prev_balance)
-						{
-							// State send
-							block_details_error = !sideband.details.is_send || sideband.details.is_receive || sideband.details.is_epoch;
-						}
-						else
-						{
-							if (block->link ().is_zero ())
-							{
-								// State change
-								block_details_error = sideband.details.is_send || sideband.details.is_receive || sideband.details.is_epoch;
-							}
-							else if (block->balance () == prev_balance && node.node->ledger.is_epoch_link (block->link ()))
-							{
-								// State epoch
-								block_details_error = !sideband.details.is_epoch || sideband.details.is_send || sideband.details.is_receive;
-							}
-							else
-							{
-								// State receive
-								block_details_error = !sideband.details.is_receive || sideband.details.is_send || sideband.details.is_epoch;
-								block_details_error |= !node.node->store.source_exists (transaction, block->link ());
-							}
-						}
-					}
-					if (block_details_error)
-					{
-						std::cerr << boost::str (boost::format ("Incorrect sideband block details for block %1%\n") % hash.to_string ());
-					}
-					// Check if block work value is correct
-					if (nano::work_validate (*block))
-					{
-						std::cerr << boost::str (boost::format ("Invalid work for block %1% value: %2%\n") % hash.to_string () % nano::to_string_hex (block->block_work ()));
-					}
-					// Check if sideband height is correct
-					++height;
-					if (sideband.height != height)
-					{
-						std::cerr << boost::str (boost::format ("Incorrect sideband height for block %1%. Sideband: %2%. Expected: %3%\n") % hash.to_string () % sideband.height % height);
-					}
-					// Check if sideband timestamp is after previous timestamp
-					if (sideband.timestamp < previous_timestamp)
-					{
-						std::cerr << boost::str (boost::format ("Incorrect sideband timestamp for block %1%\n") % hash.to_string ());
-					}
-					previous_timestamp = sideband.timestamp;
-					// Calculate representative block
-					if (block->type () == nano::block_type::open || block->type () == nano::block_type::change || block->type () == nano::block_type::state)
-					{
-						calculated_representative = block->representative ();
-					}
-					// Retrieving successor block hash
-					hash = node.node->store.block_successor (transaction, hash);
-					// Retrieving block data
-					if (!hash.is_zero ())
-					{
-						block = node.node->store.block_get (transaction, hash);
-					}
-				}
-				// Check if required block exists
-				if (!hash.is_zero () && block == nullptr)
-				{
-					std::cerr << boost::str (boost::format ("Required block in account %1% chain was not found in ledger: %2%\n") % account.to_account () % hash.to_string ());
-				}
-				// Check account block count
-				if (info.block_count != height)
-				{
-					std::cerr << boost::str (boost::format ("Incorrect block count for account %1%. Actual: %2%. Expected: %3%\n") % account.to_account () % height % info.block_count);
-				}
-				// Check account head block (frontier)
-				if (info.head != calculated_hash)
-				{
-					std::cerr << boost::str (boost::format ("Incorrect frontier for account %1%. Actual: %2%. Expected: %3%\n") % account.to_account () % calculated_hash.to_string () % info.head.to_string ());
-				}
-				// Check account representative block
-				if (info.representative != calculated_representative)
-				{
-					std::cerr << boost::str (boost::format ("Incorrect representative for account %1%. Actual: %2%. Expected: %3%\n") % account.to_account () % calculated_representative.to_string () % info.representative.to_string ());
+					std::cerr << "Invalid threads count\n";
+					result = -1;
 				}
 			}
-			std::cout << boost::str (boost::format ("%1% accounts validated\n") % count);
-			// Validate total block count
-			auto ledger_block_count (node.node->store.block_count (transaction).sum ());
-			if (block_count != ledger_block_count)
+			boost::filesystem::path checkpoint;
+			auto file_it = vm.find ("file");
+			if (file_it != vm.end ())
 			{
-				std::cerr << boost::str (boost::format ("Incorrect total block count. Blocks validated %1%. Block count in database: %2%\n") % block_count % ledger_block_count);
+				checkpoint = file_it->second.as<std::string> ();
 			}
-			// Validate pending blocks
-			count = 0;
-			for (auto i (node.node->store.pending_begin (transaction)), n (node.node->store.pending_end ()); i != n; ++i)
+			if (result == 0)
 			{
-				++count;
-				if ((count % 200000) == 0)
-				{
-					std::cout << boost::str (boost::format ("%1% pending blocks validated\n") % count);
-				}
-				nano::pending_key const & key (i->first);
-				nano::pending_info const & info (i->second);
-				// Check block existance
-				auto block (node.node->store.block_get_no_sideband (transaction, key.hash));
-				if (block == nullptr)
-				{
-					std::cerr << boost::str (boost::format ("Pending block does not exist %1%\n") % key.hash.to_string ());
-				}
-				else
-				{
-					// Check if pending destination is correct
-					nano::account destination (0);
-					if (auto state = dynamic_cast<nano::state_block *> (block.get ()))
-					{
-						if (node.node->ledger.is_send (transaction, *state))
-						{
-							destination = state->hashables.link;
-						}
-					}
-					else if (auto send = dynamic_cast<nano::send_block *> (block.get ()))
-					{
-						destination = send->hashables.destination;
-					}
-					else
-					{
-						std::cerr << boost::str (boost::format ("Incorrect type for pending block %1%\n") % key.hash.to_string ());
-					}
-					if (key.account != destination)
-					{
-						std::cerr << boost::str (boost::format ("Incorrect destination for pending block %1%\n") % key.hash.to_string ());
-					}
-					// Check if pending source is correct
-					auto account (node.node->ledger.account (transaction, key.hash));
-					if (info.source != account)
-					{
-						std::cerr << boost::str (boost::format ("Incorrect source for pending block %1%\n") % key.hash.to_string ());
-					}
-					// Check if pending amount is correct
-					auto amount (node.node->ledger.amount (transaction, key.hash));
-					if (info.amount != amount)
-					{
-						std::cerr << boost::str (boost::format ("Incorrect amount for pending block %1%\n") % key.hash.to_string ());
-					}
-				}
+				std::cout << boost::str (boost::format ("Performing blocks hash, signature, work validation with %1% threads...\n") % threads);
+				ledger_validator validator (*node.node, threads, checkpoint);
+				validator.validate_accounts ();
+				validator.validate_pending ();
 			}
-			std::cout << boost::str (boost::format ("%1% pending blocks validated\n") % count);
 		}
 		else if (vm.count ("debug_profile_bootstrap"))
 		{
@@ -1224,7 +1320,7 @@ int main (int argc, char * const * argv)
 			{
 				nano::inactive_node node (data_path, 24000);
 				auto transaction (node.node->store.tx_begin_read ());
-				block_count = node.node->store.block_count (transaction).sum ();
+				block_count = node.node->store.block_count (transaction);
 				std::cout << boost::str (boost::format ("Performing bootstrap emulation, %1% blocks in ledger...") % block_count) << std::endl;
 				for (auto i (node.node->store.latest_begin (transaction)), n (node.node->store.latest_end ()); i != n; ++i)
 				{
@@ -1267,7 +1363,7 @@ int main (int argc, char * const * argv)
 			{
 				std::this_thread::sleep_for (std::chrono::milliseconds (50));
 				auto transaction_2 (node2.node->store.tx_begin_read ());
-				block_count_2 = node2.node->store.block_count (transaction_2).sum ();
+				block_count_2 = node2.node->store.block_count (transaction_2);
 			}
 			auto end (std::chrono::high_resolution_clock::now ());
 			auto time (std::chrono::duration_cast<std::chrono::microseconds> (end - begin).count ());
@@ -1419,4 +1515,390 @@ bool address_library_pair::operator== (const address_library_pair & other) const
 {
 	return address == other.address;
 }
+
+ledger_validator::ledger_validator (nano::node & node_a, unsigned threads_a, boost::filesystem::path const & checkpoint_a) :
+node (node_a),
+threads (threads_a),
+checkpoint (checkpoint_a),
+completed (range_count, false)
+{
+	if (!checkpoint.empty ())
+	{
+		checkpoint_load ();
+	}
+}
+
+void ledger_validator::validate_accounts ()
+{
+	std::atomic<unsigned> running (threads);
+	std::vector<std::thread> workers;
+	for (unsigned i (0); i < threads; ++i)
+	{
+		workers.emplace_back ([this, &running]() {
+			for (auto range (next_range++); range < range_count; range = next_range++)
+			{
+				if (!completed[range])
+				{
+					validate_range (range);
+				}
+			}
+			--running;
+		});
+	}
+	auto begin (std::chrono::steady_clock::now ());
+	nano::timer<std::chrono::seconds> timer_l (nano::timer_state::started);
+	while (running > 0)
+	{
+		std::this_thread::sleep_for (std::chrono::milliseconds (100));
+		if (timer_l.after_deadline (std::chrono::seconds (15)))
+		{
+			timer_l.restart ();
+			auto seconds (std::max<int64_t> (1, std::chrono::duration_cast<std::chrono::seconds> (std::chrono::steady_clock::now () - begin).count ()));
+			std::cout << boost::str (boost::format ("%1% accounts, %2% blocks validated (%3% blocks/sec), %4% of %5% ranges started\n") % account_count % block_count % ((block_count - resumed_block_count) / seconds) % std::min<unsigned> (next_range, range_count) % range_count);
+		}
+	}
+	for (auto & worker : workers)
+	{
+		worker.join ();
+	}
+	std::cout << boost::str (boost::format ("%1% accounts validated\n") % account_count);
+	// Validate total block count
+	auto transaction (node.store.tx_begin_read ());
+	auto ledger_block_count (node.store.block_count (transaction));
+	if (block_count != ledger_block_count)
+	{
+		error (boost::str (boost::format ("Incorrect total block count. Blocks validated %1%. Block count in database: %2%\n") % block_count % ledger_block_count));
+	}
+}
+
+void ledger_validator::validate_range (unsigned range_a)
+{
+	nano::account start (0);
+	start.bytes[0] = static_cast<uint8_t> (range_a);
+	uint64_t accounts (0);
+	uint64_t blocks (0);
+	block_batch batch;
+	auto transaction (node.store.tx_begin_read ());
+	for (auto i (node.store.latest_begin (transaction, start)), n (node.store.latest_end ()); i != n && i->first.bytes[0] == range_a; ++i)
+	{
+		blocks += validate_account (transaction, i->first, i->second, batch);
+		++accounts;
+		++account_count;
+	}
+	verify (batch);
+	// Ranges with errors aren't recorded, so that a resumed run validates them again
+	if (!checkpoint.empty () && batch.errors == 0)
+	{
+		checkpoint_save (range_a, accounts, blocks);
+	}
+}
+
+uint64_t ledger_validator::validate_account (nano::transaction const & transaction, nano::account const & account, nano::account_info const & info, block_batch & batch_a)
+{
+	nano::confirmation_height_info confirmation_height_info;
+	node.store.confirmation_height_get (transaction, account, confirmation_height_info);
+
+	if (confirmation_height_info.height > info.block_count)
+	{
+		error (batch_a, boost::str (boost::format ("Confirmation height %1% greater than block count %2% for account: %3%\n") % confirmation_height_info.height % info.block_count % account.to_account ()));
+	}
+
+	auto hash (info.open_block);
+	nano::block_hash calculated_hash (0);
+	auto block (node.store.block_get (transaction, hash)); // Block data
+	uint64_t height (0);
+	uint64_t previous_timestamp (0);
+	nano::account calculated_representative (0);
+	while (!hash.is_zero () && block != nullptr)
+	{
+		++block_count;
+		auto const & sideband (block->sideband ());
+		// Check for state & open blocks if account field is correct
+		if (block->type () == nano::block_type::open || block->type () == nano::block_type::state)
+		{
+			if (block->account () != account)
+			{
+				error (batch_a, boost::str (boost::format ("Incorrect account field for block %1%\n") % hash.to_string ()));
+			}
+		}
+		// Check if sideband account is correct
+		else if (sideband.account != account)
+		{
+			error (batch_a, boost::str (boost::format ("Incorrect sideband account for block %1%\n") % hash.to_string ()));
+		}
+		// Check if previous field is correct
+		if (calculated_hash != block->previous ())
+		{
+			error (batch_a, boost::str (boost::format ("Incorrect previous field for block %1%\n") % hash.to_string ()));
+		}
+		// Check if previous & type for open blocks are correct
+		if (height == 0 && !block->previous ().is_zero ())
+		{
+			error (batch_a, boost::str (boost::format ("Incorrect previous for open block %1%\n") % hash.to_string ()));
+		}
+		if (height == 0 && block->type () != nano::block_type::open && block->type () != nano::block_type::state)
+		{
+			error (batch_a, boost::str (boost::format ("Incorrect type for open block %1%\n") % hash.to_string ()));
+		}
+		// Check if block data is correct (calculating hash)
+		calculated_hash = block->hash ();
+		if (calculated_hash != hash)
+		{
+			error (batch_a, boost::str (boost::format ("Invalid data inside block %1% calculated hash: %2%\n") % hash.to_string () % calculated_hash.to_string ()));
+		}
+		// Block signature and work are checked in batches
+		nano::account epoch_signer (0);
+		if (block->type () == nano::block_type::state && node.ledger.is_epoch_link (block->link ()))
+		{
+			nano::amount prev_balance (0);
+			if (!block->previous ().is_zero ())
+			{
+				prev_balance = node.ledger.balance (transaction, block->previous ());
+			}
+			if (block->balance () == prev_balance)
+			{
+				epoch_signer = node.ledger.epoch_signer (block->link ());
+			}
+		}
+		batch_a.blocks.push_back (block);
+		batch_a.hashes.push_back (hash);
+		batch_a.accounts.push_back (account);
+		batch_a.epoch_signers.push_back (epoch_signer);
+		if (batch_a.blocks.size () >= batch_size)
+		{
+			verify (batch_a);
+		}
+		// Validate block details set in the sideband
+		bool block_details_error = false;
+		if (block->type () != nano::block_type::state)
+		{
+			// Not state
+			block_details_error = sideband.details.is_send || sideband.details.is_receive || sideband.details.is_epoch;
+		}
+		else
+		{
+			auto prev_balance (node.ledger.balance (transaction, block->previous ()));
+			if (block->balance () < prev_balance)
+			{
+				// State send
+				block_details_error = !sideband.details.is_send || sideband.details.is_receive || sideband.details.is_epoch;
+			}
+			else
+			{
+				if (block->link ().is_zero ())
+				{
+					// State change
+					block_details_error = sideband.details.is_send || sideband.details.is_receive || sideband.details.is_epoch;
+				}
+				else if (block->balance () == prev_balance && node.ledger.is_epoch_link (block->link ()))
+				{
+					// State epoch
+					block_details_error = !sideband.details.is_epoch || sideband.details.is_send || sideband.details.is_receive;
+				}
+				else
+				{
+					// State receive
+					block_details_error = !sideband.details.is_receive || sideband.details.is_send || sideband.details.is_epoch;
+					block_details_error |= !node.store.source_exists (transaction, block->link ());
+				}
+			}
+		}
+		if (block_details_error)
+		{
+			error (batch_a, boost::str (boost::format ("Incorrect sideband block details for block %1%\n") % hash.to_string ()));
+		}
+		// Check if sideband height is correct
+		++height;
+		if (sideband.height != height)
+		{
+			error (batch_a, boost::str (boost::format ("Incorrect sideband height for block %1%. Sideband: %2%. Expected: %3%\n") % hash.to_string () % sideband.height % height));
+		}
+		// Check if sideband timestamp is after previous timestamp
+		if (sideband.timestamp < previous_timestamp)
+		{
+			error (batch_a, boost::str (boost::format ("Incorrect sideband timestamp for block %1%\n") % hash.to_string ()));
+		}
+		previous_timestamp = sideband.timestamp;
+		// Calculate representative block
+		if (block->type () == nano::block_type::open || block->type () == nano::block_type::change || block->type () == nano::block_type::state)
+		{
+			calculated_representative = block->representative ();
+		}
+		// Retrieving successor block hash
+		hash = node.store.block_successor (transaction, hash);
+		// Retrieving block data
+		if (!hash.is_zero ())
+		{
+			block = node.store.block_get (transaction, hash);
+		}
+	}
+	// Check if required block exists
+	if (!hash.is_zero () && block == nullptr)
+	{
+		error (batch_a, boost::str (boost::format ("Required block in account %1% chain was not found in ledger: %2%\n") % account.to_account () % hash.to_string ()));
+	}
+	// Check account block count
+	if (info.block_count != height)
+	{
+		error (batch_a, boost::str (boost::format ("Incorrect block count for account %1%. Actual: %2%. Expected: %3%\n") % account.to_account () % height % info.block_count));
+	}
+	// Check account head block (frontier)
+	if (info.head != calculated_hash)
+	{
+		error (batch_a, boost::str (boost::format ("Incorrect frontier for account %1%. Actual: %2%. Expected: %3%\n") % account.to_account () % calculated_hash.to_string () % info.head.to_string ()));
+	}
+	// Check account representative block
+	if (info.representative != calculated_representative)
+	{
+		error (batch_a, boost::str (boost::format ("Incorrect representative for account %1%. Actual: %2%. Expected: %3%\n") % account.to_account () % calculated_representative.to_string () % info.representative.to_string ()));
+	}
+	return height;
+}
+
+void ledger_validator::verify (block_batch & batch_a)
+{
+	auto size (batch_a.blocks.size ());
+	if (size > 0)
+	{
+		std::vector<unsigned char const *> messages;
+		std::vector<size_t> lengths (size, sizeof (nano::block_hash));
+		std::vector<unsigned char const *> pub_keys;
+		std::vector<unsigned char const *> signatures;
+		std::vector<int> verifications (size);
+		messages.reserve (size);
+		pub_keys.reserve (size);
+		signatures.reserve (size);
+		for (size_t i (0); i < size; ++i)
+		{
+			messages.push_back (batch_a.hashes[i].bytes.data ());
+			pub_keys.push_back (batch_a.accounts[i].bytes.data ());
+			signatures.push_back (batch_a.blocks[i]->block_signature ().bytes.data ());
+		}
+		nano::signature_check_set check (size, messages.data (), lengths.data (), pub_keys.data (), signatures.data (), verifications.data ());
+		node.checker.verify (check);
+		auto work_errors (nano::work_validate_many (batch_a.blocks));
+		for (size_t i (0); i < size; ++i)
+		{
+			auto const & block (*batch_a.blocks[i]);
+			auto const & hash (batch_a.hashes[i]);
+			// Epoch blocks
+			if (verifications[i] != 1 && (batch_a.epoch_signers[i].is_zero () || nano::validate_message (batch_a.epoch_signers[i], hash, block.block_signature ())))
+			{
+				error (batch_a, boost::str (boost::format ("Invalid signature for block %1%\n") % hash.to_string ()));
+			}
+			// Check if block work value is correct
+			if (work_errors[i])
+			{
+				error (batch_a, boost::str (boost::format ("Invalid work for block %1% value: %2%\n") % hash.to_string () % nano::to_string_hex (block.block_work ())));
+			}
+		}
+		batch_a.blocks.clear ();
+		batch_a.hashes.clear ();
+		batch_a.accounts.clear ();
+		batch_a.epoch_signers.clear ();
+	}
+}
+
+void ledger_validator::validate_pending ()
+{
+	auto transaction (node.store.tx_begin_read ());
+	size_t count (0);
+	for (auto i (node.store.pending_begin (transaction)), n (node.store.pending_end ()); i != n; ++i)
+	{
+		++count;
+		if ((count % 200000) == 0)
+		{
+			std::cout << boost::str (boost::format ("%1% pending blocks validated\n") % count);
+		}
+		nano::pending_key const & key (i->first);
+		nano::pending_info const & info (i->second);
+		// Check block existance
+		auto block (node.store.block_get_no_sideband (transaction, key.hash));
+		if (block == nullptr)
+		{
+			error (boost::str (boost::format ("Pending block does not exist %1%\n") % key.hash.to_string ()));
+		}
+		else
+		{
+			// Check if pending destination is correct
+			nano::account destination (0);
+			if (auto state = dynamic_cast<nano::state_block *> (block.get ()))
+			{
+				if (node.ledger.is_send (transaction, *state))
+				{
+					destination = state->hashables.link;
+				}
+			}
+			else if (auto send = dynamic_cast<nano::send_block *> (block.get ()))
+			{
+				destination = send->hashables.destination;
+			}
+			else
+			{
+				error (boost::str (boost::format ("Incorrect type for pending block %1%\n") % key.hash.to_string ()));
+			}
+			if (key.account != destination)
+			{
+				error (boost::str (boost::format ("Incorrect destination for pending block %1%\n") % key.hash.to_string ()));
+			}
+			// Check if pending source is correct
+			auto account (node.ledger.account (transaction, key.hash));
+			if (info.source != account)
+			{
+				error (boost::str (boost::format ("Incorrect source for pending block %1%\n") % key.hash.to_string ()));
+			}
+			// Check if pending amount is correct
+			auto amount (node.ledger.amount (transaction, key.hash));
+			if (info.amount != amount)
+			{
+				error (boost::str (boost::format ("Incorrect amount for pending block %1%\n") % key.hash.to_string ()));
+			}
+		}
+	}
+	std::cout << boost::str (boost::format ("%1% pending blocks validated\n") % count);
+}
+
+void ledger_validator::error (std::string const & message_a)
+{
+	nano::lock_guard<std::mutex> guard (mutex);
+	std::cerr << message_a;
+}
+
+void ledger_validator::error (block_batch & batch_a, std::string const & message_a)
+{
+	++batch_a.errors;
+	error (message_a);
+}
+
+/** Each line of the checkpoint file is a completed range followed by its account and block count */
+void ledger_validator::checkpoint_load ()
+{
+	std::ifstream file (checkpoint.string ());
+	unsigned range;
+	uint64_t accounts;
+	uint64_t blocks;
+	unsigned resumed (0);
+	while (file >> range >> accounts >> blocks)
+	{
+		if (range < range_count && !completed[range])
+		{
+			completed[range] = true;
+			account_count += accounts;
+			block_count += blocks;
+			++resumed;
+		}
+	}
+	resumed_block_count = block_count;
+	if (resumed > 0)
+	{
+		std::cout << boost::str (boost::format ("Resuming from %1%, %2% of %3% ranges already validated\n") % checkpoint.string () % resumed % range_count);
+	}
+}
+
+void ledger_validator::checkpoint_save (unsigned range_a, uint64_t accounts_a, uint64_t blocks_a)
+{
+	nano::lock_guard<std::mutex> guard (mutex);
+	std::ofstream file (checkpoint.string (), std::ios::app);
+	file << range_a << ' ' << accounts_a << ' ' << blocks_a << std::endl;
+}
 }
@@ -250,6 +250,7 @@ void nano::active_transactions::request_confirm (nano::unique_lock<std::mutex> &
 		{
 			election_l->clear_blocks ();
 			i = sorted_roots_l.erase (i);
+			++generation;
 		}
 		else
 		{
@@ -464,6 +465,7 @@ void nano::active_transactions::stop ()
 	}
 	lock.lock ();
 	roots.clear ();
+	++generation;
 }
 
 std::pair<std::shared_ptr<nano::election>, bool> nano::active_transactions::insert_impl (std::shared_ptr<nano::block> block_a, std::function<void(std::shared_ptr<nano::block>)> const & confirmation_action_a)
@@ -482,6 +484,7 @@ std::pair<std::shared_ptr<nano::election>, bool> nano::active_transactions::inse
 				result.first = nano::make_shared<nano::election> (node, block_a, confirmation_action_a);
 				auto difficulty (block_a->difficulty ());
 				roots.get<tag_root> ().emplace (nano::conflict_info{ root, difficulty, difficulty, result.first });
+				++generation;
 				blocks.emplace (hash, result.first);
 				add_adjust_difficulty (hash);
 				result.first->insert_inactive_votes_cache (hash);
@@ -504,60 +507,90 @@ std::pair<std::shared_ptr<nano::election>, bool> nano::active_transactions::inse
 // Validate a vote and apply it to the current election if one exists
 nano::vote_code nano::active_transactions::vote (std::shared_ptr<nano::vote> vote_a)
 {
-	// If none of the hashes are active, it is unknown whether it's a replay
-	// In this case, votes are also not republished
-	bool at_least_one (false);
-	bool replay (false);
-	bool processed (false);
+	return vote (std::vector<std::shared_ptr<nano::vote>>{ vote_a }).front ();
+}
+
+std::vector<nano::vote_code> nano::active_transactions::vote (std::vector<std::shared_ptr<nano::vote>> const & votes_a, std::vector<std::vector<nano::block_hash>> * replays_a)
+{
+	std::vector<nano::vote_code> result;
+	result.reserve (votes_a.size ());
+	if (replays_a != nullptr)
+	{
+		replays_a->assign (votes_a.size (), {});
+	}
+	std::vector<std::shared_ptr<nano::vote>> republish;
 	{
 		nano::lock_guard<std::mutex> lock (mutex);
-		for (auto vote_block : vote_a->blocks)
+		for (size_t i (0), n (votes_a.size ()); i < n; ++i)
 		{
-			nano::election_vote_result result;
-			if (vote_block.which ())
+			auto const & vote_a (votes_a[i]);
+			// If none of the hashes are active, it is unknown whether it's a replay
+			// In this case, votes are also not republished
+			bool at_least_one (false);
+			bool replay (false);
+			bool processed (false);
+			for (auto vote_block : vote_a->blocks)
 			{
-				auto block_hash (boost::get<nano::block_hash> (vote_block));
-				auto existing (blocks.find (block_hash));
-				if (existing != blocks.end ())
+				nano::election_vote_result vote_result;
+				nano::block_hash block_hash;
+				if (vote_block.which ())
 				{
-					at_least_one = true;
-					result = existing->second->vote (vote_a->account, vote_a->sequence, block_hash);
+					block_hash = boost::get<nano::block_hash> (vote_block);
+					auto existing (blocks.find (block_hash));
+					if (existing != blocks.end ())
+					{
+						at_least_one = true;
+						vote_result = existing->second->vote (vote_a->account, vote_a->sequence, block_hash);
+					}
+					else // possibly a vote for a recently confirmed election
+					{
+						add_inactive_votes_cache (block_hash, vote_a->account);
+					}
 				}
-				else // possibly a vote for a recently confirmed election
+				else
 				{
-					add_inactive_votes_cache (block_hash, vote_a->account);
+					auto block (boost::get<std::shared_ptr<nano::block>> (vote_block));
+					block_hash = block->hash ();
+					auto existing (roots.get<tag_root> ().find (block->qualified_root ()));
+					if (existing != roots.get<tag_root> ().end ())
+					{
+						at_least_one = true;
+						vote_result = existing->election->vote (vote_a->account, vote_a->sequence, block_hash);
+					}
+					else
+					{
+						add_inactive_votes_cache (block_hash, vote_a->account);
+					}
 				}
-			}
-			else
-			{
-				auto block (boost::get<std::shared_ptr<nano::block>> (vote_block));
-				auto existing (roots.get<tag_root> ().find (block->qualified_root ()));
-				if (existing != roots.get<tag_root> ().end ())
+				processed = processed || vote_result.processed;
+				replay = replay || vote_result.replay;
+				if (vote_result.replay && replays_a != nullptr)
 				{
-					at_least_one = true;
-					result = existing->election->vote (vote_a->account, vote_a->sequence, block->hash ());
+					(*replays_a)[i].push_back (block_hash);
 				}
-				else
+			}
+			if (at_least_one)
+			{
+				if (processed)
 				{
-					add_inactive_votes_cache (block->hash (), vote_a->account);
+					republish.push_back (vote_a);
 				}
+				result.push_back (replay ? nano::vote_code::replay : nano::vote_code::vote);
+			}
+			else
+			{
+				result.push_back (nano::vote_code::indeterminate);
 			}
-			processed = processed || result.processed;
-			replay = replay || result.replay;
 		}
 	}
-	if (at_least_one)
+	if (!republish.empty () && !node.wallets.rep_counts ().have_half_rep ())
 	{
-		if (processed && !node.wallets.rep_counts ().have_half_rep ())
+		for (auto const & vote_l : republish)
 		{
-			node.network.flood_vote (vote_a, 0.5f);
+			node.network.flood_vote (vote_l, 0.5f);
 		}
-		return replay ? nano::vote_code::replay : nano::vote_code::vote;
-	}
-	else
-	{
-		return nano::vote_code::indeterminate;
 	}
+	return result;
 }
 
 bool nano::active_transactions::active (nano::qualified_root const & root_a)
@@ -756,10 +789,29 @@ uint64_t nano::active_transactions::limited_active_difficulty ()
 std::deque<std::shared_ptr<nano::block>> nano::active_transactions::list_blocks ()
 {
 	std::deque<std::shared_ptr<nano::block>> result;
-	nano::lock_guard<std::mutex> lock (mutex);
-	for (auto & root : roots)
+	auto snapshot_l (snapshot ());
+	for (auto & election : snapshot_l->elections)
 	{
-		result.push_back (root.election->status.winner);
+		result.push_back (election.winner);
+	}
+	return result;
+}
+
+std::shared_ptr<nano::active_elections_snapshot const> nano::active_transactions::snapshot ()
+{
+	auto result (std::atomic_load (&snapshot_m));
+	if (result == nullptr || result->generation != generation)
+	{
+		auto snapshot_l (std::make_shared<nano::active_elections_snapshot> ());
+		nano::lock_guard<std::mutex> lock (mutex);
+		snapshot_l->generation = generation;
+		snapshot_l->elections.reserve (roots.size ());
+		for (auto & root : roots)
+		{
+			snapshot_l->elections.push_back (nano::election_snapshot{ root.root, root.election->status.winner, root.election });
+		}
+		result = snapshot_l;
+		std::atomic_store (&snapshot_m, result);
 	}
 	return result;
 }
@@ -793,6 +845,7 @@ void nano::active_transactions::erase (nano::block const & block_a)
 		root_it->election->clear_blocks ();
 		root_it->election->adjust_dependent_difficulty ();
 		roots.get<tag_root> ().erase (root_it);
+		++generation;
 		node.logger.try_log (boost::str (boost::format ("Election erased for block block %1% root %2%") % block_a.hash ().to_string () % block_a.root ().to_string ()));
 	}
 }
@@ -54,6 +54,22 @@ public:
 	nano::qualified_root root;
 };
 
+class election_snapshot final
+{
+public:
+	nano::qualified_root root;
+	std::shared_ptr<nano::block> winner;
+	std::shared_ptr<nano::election> election;
+};
+
+/** Copy of the active elections for read-only consumers, taken at the given generation of the container */
+class active_elections_snapshot final
+{
+public:
+	uint64_t generation{ 0 };
+	std::vector<nano::election_snapshot> elections;
+};
+
 class inactive_cache_information final
 {
 public:
@@ -90,6 +106,9 @@ public:
 	// clang-format on
 	// Distinguishes replay votes, cannot be determined if the block is not in any election
 	nano::vote_code vote (std::shared_ptr<nano::vote>);
+	// Applies a group of votes taking the mutex once, codes are in the same order as the votes
+	// Hashes which each vote was a replay for are written to replays_a if not null
+	std::vector<nano::vote_code> vote (std::vector<std::shared_ptr<nano::vote>> const &, std::vector<std::vector<nano::block_hash>> * replays_a = nullptr);
 	// Is the root of this block in the roots container
 	bool active (nano::block const &);
 	bool active (nano::qualified_root const &);
@@ -101,6 +120,9 @@ public:
 	uint64_t active_difficulty ();
 	uint64_t limited_active_difficulty ();
 	std::deque<std::shared_ptr<nano::block>> list_blocks ();
+	// Snapshot of the active elections which can be read without holding the mutex
+	// It is only rebuilt, under the mutex, if elections were added, removed or changed winner since the last call
+	std::shared_ptr<nano::active_elections_snapshot const> snapshot ();
 	void erase (nano::block const &);
 	bool empty ();
 	size_t size ();
@@ -139,6 +161,10 @@ public:
 	void add_election_winner_details (nano::block_hash const &, std::shared_ptr<nano::election> const &);
 
 private:
+	// Incremented with the mutex held whenever roots or an election winner changes
+	std::atomic<uint64_t> generation{ 0 };
+	// Only accessed through std::atomic_load and std::atomic_store
+	std::shared_ptr<nano::active_elections_snapshot const> snapshot_m;
 	std::mutex election_winner_details_mutex;
 	std::unordered_map<nano::block_hash, std::shared_ptr<nano::election>> election_winner_details;
 
@@ -1,3 +1,4 @@
+#include <nano/lib/threading.hpp>
 #include <nano/lib/timer.hpp>
 #include <nano/node/blockprocessor.hpp>
 #include <nano/node/election.hpp>
@@ -16,6 +17,10 @@ next_log (std::chrono::steady_clock::now ()),
 node (node_a),
 write_database_queue (write_database_queue_a)
 {
+	verification_thread = std::thread ([this]() {
+		nano::thread_role::set (nano::thread_role::name::block_verification);
+		process_verification ();
+	});
 }
 
 nano::block_processor::~block_processor ()
@@ -31,6 +36,11 @@ void nano::block_processor::stop ()
 		stopped = true;
 	}
 	condition.notify_all ();
+	if (verification_thread.joinable ())
+	{
+		verification_thread.join ();
+	}
+	post_events_worker.stop ();
 }
 
 void nano::block_processor::flush ()
@@ -38,7 +48,7 @@ void nano::block_processor::flush ()
 	node.checker.flush ();
 	flushing = true;
 	nano::unique_lock<std::mutex> lock (mutex);
-	while (!stopped && (have_blocks () || active))
+	while (!stopped && (have_blocks () || active || verifying || pending_post_events > 0))
 	{
 		condition.wait (lock);
 	}
@@ -111,7 +121,8 @@ void nano::block_processor::process_blocks ()
 	nano::unique_lock<std::mutex> lock (mutex);
 	while (!stopped)
 	{
-		if (have_blocks ())
+		// State blocks are left to the verification thread
+		if (!blocks.empty () || !forced.empty ())
 		{
 			active = true;
 			lock.unlock ();
@@ -127,6 +138,29 @@ void nano::block_processor::process_blocks ()
 	}
 }
 
+void nano::block_processor::process_verification ()
+{
+	size_t max_verification_batch (node.flags.block_processor_verification_size != 0 ? node.flags.block_processor_verification_size : 2048 * (node.config.signature_checker_threads + 1));
+	nano::unique_lock<std::mutex> lock (mutex);
+	while (!stopped)
+	{
+		if (!state_blocks.empty ())
+		{
+			// Verification runs concurrently with the write transaction, verified blocks are picked up by the next batch
+			verifying = true;
+			verify_state_blocks (lock, max_verification_batch);
+			verifying = false;
+			lock.unlock ();
+			condition.notify_all ();
+			lock.lock ();
+		}
+		else
+		{
+			condition.wait (lock);
+		}
+	}
+}
+
 bool nano::block_processor::should_log (bool first_time)
 {
 	auto result (false);
@@ -252,116 +286,146 @@ void nano::block_processor::verify_state_blocks (nano::unique_lock<std::mutex> &
 void nano::block_processor::process_batch (nano::unique_lock<std::mutex> & lock_a)
 {
 	nano::timer<std::chrono::milliseconds> timer_l;
-	lock_a.lock ();
-	timer_l.start ();
-	// Limit state blocks verification time
-
-	{
-		if (!state_blocks.empty ())
-		{
-			size_t max_verification_batch (node.flags.block_processor_verification_size != 0 ? node.flags.block_processor_verification_size : 2048 * (node.config.signature_checker_threads + 1));
-			while (!state_blocks.empty () && timer_l.before_deadline (std::chrono::seconds (2)))
-			{
-				verify_state_blocks (lock_a, max_verification_batch);
-			}
-		}
-	}
-	lock_a.unlock ();
-	auto scoped_write_guard = write_database_queue.wait (nano::writer::process_batch);
-	auto transaction (node.store.tx_begin_write ({ tables::accounts, nano::tables::cached_counts, nano::tables::change_blocks, tables::frontiers, tables::open_blocks, tables::pending, tables::receive_blocks, tables::representation, tables::send_blocks, tables::state_blocks, tables::unchecked }, { tables::confirmation_height }));
-	timer_l.restart ();
-	lock_a.lock ();
-	// Processing blocks
-	auto first_time (true);
 	unsigned number_of_blocks_processed (0), number_of_forced_processed (0);
-	while ((!blocks.empty () || !forced.empty ()) && (timer_l.before_deadline (node.config.block_processor_batch_max_time) || (number_of_blocks_processed < node.flags.block_processor_batch_size)) && !awaiting_write)
+	std::deque<std::function<void()>> post_events;
+	std::deque<std::function<void()>> released;
+	auto batch (++batch_sequence);
 	{
-		auto log_this_record (false);
-		if (node.config.logging.timing_logging ())
+		auto scoped_write_guard = write_database_queue.wait (nano::writer::process_batch);
+		auto transaction (node.store.tx_begin_write ({ tables::accounts, tables::blocks, tables::cached_counts, tables::frontiers, tables::peers, tables::pending, tables::representation, tables::unchecked, tables::vote }, { tables::confirmation_height }));
+		timer_l.start ();
+		lock_a.lock ();
+		// Processing blocks
+		auto first_time (true);
+		while ((!blocks.empty () || !forced.empty ()) && (timer_l.before_deadline (node.config.block_processor_batch_max_time) || (number_of_blocks_processed < node.flags.block_processor_batch_size)) && !awaiting_write)
 		{
-			if (should_log (first_time))
+			auto log_this_record (false);
+			if (node.config.logging.timing_logging ())
 			{
-				log_this_record = true;
+				if (should_log (first_time))
+				{
+					log_this_record = true;
+				}
 			}
-		}
-		else
-		{
-			if (((blocks.size () + state_blocks.size () + forced.size ()) > 64 && should_log (false)))
+			else
 			{
-				log_this_record = true;
+				if (((blocks.size () + state_blocks.size () + forced.size ()) > 64 && should_log (false)))
+				{
+					log_this_record = true;
+				}
 			}
-		}
 
-		if (log_this_record)
-		{
-			first_time = false;
-			node.logger.always_log (boost::str (boost::format ("%1% blocks (+ %2% state blocks) (+ %3% forced) in processing queue") % blocks.size () % state_blocks.size () % forced.size ()));
-		}
-		nano::unchecked_info info;
-		nano::block_hash hash (0);
-		bool force (false);
-		if (forced.empty ())
-		{
-			info = blocks.front ();
-			blocks.pop_front ();
-			hash = info.block->hash ();
-			blocks_filter.erase (filter_item (hash, info.block->block_signature ()));
-		}
-		else
-		{
-			info = nano::unchecked_info (forced.front (), 0, nano::seconds_since_epoch (), nano::signature_verification::unknown);
-			forced.pop_front ();
-			hash = info.block->hash ();
-			force = true;
-			number_of_forced_processed++;
-		}
-		lock_a.unlock ();
-		if (force)
-		{
-			auto successor (node.ledger.successor (transaction, info.block->qualified_root ()));
-			if (successor != nullptr && successor->hash () != hash)
+			if (log_this_record)
 			{
-				// Replace our block with the winner and roll back any dependent blocks
-				node.logger.always_log (boost::str (boost::format ("Rolling back %1% and replacing with %2%") % successor->hash ().to_string () % hash.to_string ()));
-				std::vector<std::shared_ptr<nano::block>> rollback_list;
-				if (node.ledger.rollback (transaction, successor->hash (), rollback_list))
-				{
-					node.logger.always_log (nano::severity_level::error, boost::str (boost::format ("Failed to roll back %1% because it or a successor was confirmed") % successor->hash ().to_string ()));
-				}
-				else
-				{
-					node.logger.always_log (boost::str (boost::format ("%1% blocks rolled back") % rollback_list.size ()));
-				}
-				// Deleting from votes cache & wallet work watcher, stop active transaction
-				for (auto & i : rollback_list)
+				first_time = false;
+				node.logger.always_log (boost::str (boost::format ("%1% blocks (+ %2% state blocks) (+ %3% forced) in processing queue") % blocks.size () % state_blocks.size () % forced.size ()));
+			}
+			nano::unchecked_info info;
+			nano::block_hash hash (0);
+			bool force (false);
+			if (forced.empty ())
+			{
+				info = blocks.front ();
+				blocks.pop_front ();
+				hash = info.block->hash ();
+				blocks_filter.erase (filter_item (hash, info.block->block_signature ()));
+			}
+			else
+			{
+				info = nano::unchecked_info (forced.front (), 0, nano::seconds_since_epoch (), nano::signature_verification::unknown);
+				forced.pop_front ();
+				hash = info.block->hash ();
+				force = true;
+				number_of_forced_processed++;
+			}
+			lock_a.unlock ();
+			if (force)
+			{
+				auto successor (node.ledger.successor (transaction, info.block->qualified_root ()));
+				if (successor != nullptr && successor->hash () != hash)
 				{
-					node.votes_cache.remove (i->hash ());
-					node.wallets.watcher->remove (i);
-					// Stop all rolled back active transactions except initial
-					if (i->hash () != successor->hash ())
+					// Replace our block with the winner and roll back any dependent blocks
+					node.logger.always_log (boost::str (boost::format ("Rolling back %1% and replacing with %2%") % successor->hash ().to_string () % hash.to_string ()));
+					std::vector<std::shared_ptr<nano::block>> rollback_list;
+					if (node.ledger.rollback (transaction, successor->hash (), rollback_list))
+					{
+						node.logger.always_log (nano::severity_level::error, boost::str (boost::format ("Failed to roll back %1% because it or a successor was confirmed") % successor->hash ().to_string ()));
+					}
+					else
+					{
+						node.logger.always_log (boost::str (boost::format ("%1% blocks rolled back") % rollback_list.size ()));
+					}
+					// Live notifications of rolled back blocks which haven't run yet are dropped, the lock keeps one from starting an election while they're erased
+					nano::lock_guard<std::mutex> rolled_back_guard (rolled_back_mutex);
+					// Deleting from votes cache & wallet work watcher, stop active transaction
+					for (auto & i : rollback_list)
 					{
-						node.active.erase (*i);
+						rolled_back[i->hash ()] = batch;
+						node.votes_cache.remove (i->hash ());
+						node.wallets.watcher->remove (i);
+						// Stop all rolled back active transactions except initial
+						if (i->hash () != successor->hash ())
+						{
+							node.active.erase (*i);
+						}
 					}
 				}
 			}
+			number_of_blocks_processed++;
+			process_one (transaction, post_events, info, false, false);
+			lock_a.lock ();
 		}
-		number_of_blocks_processed++;
-		process_one (transaction, info);
-		lock_a.lock ();
-		/* Verify more state blocks if blocks deque is empty
-		 Because verification is long process, avoid large deque verification inside of write transaction */
-		if (blocks.empty () && !state_blocks.empty ())
+		awaiting_write = false;
+		lock_a.unlock ();
+		// Writes queued meanwhile, such as cementing, share the commit of this batch. They're applied after releasing the lock so adding blocks isn't held up
+		node.write_batcher.apply (transaction, released, post_events);
+		if (!post_events.empty ())
 		{
-			verify_state_blocks (lock_a, 256 * (node.config.signature_checker_threads + 1));
+			lock_a.lock ();
+			++pending_post_events;
+			lock_a.unlock ();
 		}
 	}
-	awaiting_write = false;
-	lock_a.unlock ();
 
+	// Writers blocked on the write batcher, such as cementing, are released as soon as this batch is committed instead of waiting behind the post events
+	for (auto & release : released)
+	{
+		release ();
+	}
 	if (node.config.logging.timing_logging () && number_of_blocks_processed != 0)
 	{
 		node.logger.always_log (boost::str (boost::format ("Processed %1% blocks (%2% blocks were forced) in %3% %4%") % number_of_blocks_processed % number_of_forced_processed % timer_l.stop ().count () % timer_l.unit ()));
 	}
+	if (!post_events.empty ())
+	{
+		run_post_events (std::move (post_events), batch);
+	}
+}
+
+void nano::block_processor::run_post_events (std::deque<std::function<void()>> && post_events_a, uint64_t batch_a)
+{
+	// Notifications are moved off the block processing thread so the next batch can start writing straight away
+	auto post_events_l (std::make_shared<std::deque<std::function<void()>>> (std::move (post_events_a)));
+	post_events_worker.push_task ([this, post_events_l, batch_a]() {
+		for (auto & event : *post_events_l)
+		{
+			event ();
+		}
+		{
+			// Notifications up to this batch have run, so its rollbacks have nothing left to drop
+			nano::lock_guard<std::mutex> rolled_back_guard (rolled_back_mutex);
+			for (auto i (rolled_back.begin ()), n (rolled_back.end ()); i != n;)
+			{
+				i = i->second <= batch_a ? rolled_back.erase (i) : std::next (i);
+			}
+		}
+		{
+			nano::lock_guard<std::mutex> guard (mutex);
+			debug_assert (pending_post_events > 0);
+			--pending_post_events;
+		}
+		condition.notify_all ();
+	});
 }
 
 void nano::block_processor::process_live (nano::block_hash const & hash_a, std::shared_ptr<nano::block> block_a, const bool watch_work_a, const bool initial_publish_a)
@@ -396,6 +460,17 @@ void nano::block_processor::process_live (nano::block_hash const & hash_a, std::
 }
 
 nano::process_return nano::block_processor::process_one (nano::write_transaction const & transaction_a, nano::unchecked_info info_a, const bool watch_work_a, const bool first_publish_a)
+{
+	std::deque<std::function<void()>> post_events;
+	auto result (process_one (transaction_a, post_events, info_a, watch_work_a, first_publish_a));
+	for (auto & event : post_events)
+	{
+		event ();
+	}
+	return result;
+}
+
+nano::process_return nano::block_processor::process_one (nano::write_transaction const & transaction_a, std::deque<std::function<void()>> & post_events_a, nano::unchecked_info info_a, const bool watch_work_a, const bool first_publish_a)
 {
 	nano::process_return result;
 	auto hash (info_a.block->hash ());
@@ -411,9 +486,20 @@ nano::process_return nano::block_processor::process_one (nano::write_transaction
 				info_a.block->serialize_json (block, node.config.logging.single_line_record ());
 				node.logger.try_log (boost::str (boost::format ("Processing block %1%: %2%") % hash.to_string () % block));
 			}
+			{
+				// A block processed again after a rollback is live again
+				nano::lock_guard<std::mutex> rolled_back_guard (rolled_back_mutex);
+				rolled_back.erase (hash);
+			}
 			if (info_a.modified > nano::seconds_since_epoch () - 300 && node.block_arrival.recent (hash))
 			{
-				process_live (hash, info_a.block, watch_work_a, first_publish_a);
+				post_events_a.emplace_back ([this, hash, block = info_a.block, watch_work_a, first_publish_a]() {
+					nano::lock_guard<std::mutex> rolled_back_guard (rolled_back_mutex);
+					if (rolled_back.find (hash) == rolled_back.end ())
+					{
+						process_live (hash, block, watch_work_a, first_publish_a);
+					}
+				});
 			}
 			queue_unchecked (transaction_a, hash);
 			break;
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <nano/lib/blocks.hpp>
+#include <nano/lib/worker.hpp>
 #include <nano/node/voting.hpp>
 #include <nano/secure/common.hpp>
 
@@ -11,7 +12,11 @@
 #include <boost/multi_index_container.hpp>
 
 #include <chrono>
+#include <deque>
+#include <functional>
 #include <memory>
+#include <thread>
+#include <unordered_map>
 #include <unordered_set>
 
 namespace nano
@@ -24,6 +29,8 @@ class write_database_queue;
 /**
  * Processing blocks is a potentially long IO operation.
  * This class isolates block insertion from other operations like servicing network operations
+ * Blocks pass through a pipeline: hashing and work validation on the adding thread, batched signature verification on a dedicated thread,
+ * ledger insertion in a write transaction on the block processing thread and finally notification of live blocks on a dedicated thread once committed, in batch order
  */
 class block_processor final
 {
@@ -52,12 +59,24 @@ public:
 private:
 	void queue_unchecked (nano::write_transaction const &, nano::block_hash const &);
 	void verify_state_blocks (nano::unique_lock<std::mutex> &, size_t = std::numeric_limits<size_t>::max ());
+	void process_verification ();
 	void process_batch (nano::unique_lock<std::mutex> &);
+	/** Post events are actions which must not run inside the write transaction, they are queued to be run after committing */
+	nano::process_return process_one (nano::write_transaction const &, std::deque<std::function<void()>> &, nano::unchecked_info, const bool, const bool);
+	void run_post_events (std::deque<std::function<void()>> &&, uint64_t);
 	void process_live (nano::block_hash const &, std::shared_ptr<nano::block>, const bool = false, const bool = false);
 	void requeue_invalid (nano::block_hash const &, nano::unchecked_info const &);
 	bool stopped;
 	bool active;
+	bool verifying{ false };
 	bool awaiting_write{ false };
+	/** Number of committed batches whose post events have not finished running */
+	unsigned pending_post_events{ 0 };
+	/** Sequence number of the current batch, live notifications remember the batch which queued them */
+	uint64_t batch_sequence{ 0 };
+	/** Blocks rolled back by forced blocks and the batch doing so. Live notifications queued up to that batch are dropped for them */
+	std::unordered_map<nano::block_hash, uint64_t> rolled_back;
+	std::mutex rolled_back_mutex;
 	std::chrono::steady_clock::time_point next_log;
 	std::deque<nano::unchecked_info> state_blocks;
 	std::deque<nano::unchecked_info> blocks;
@@ -68,6 +87,9 @@ private:
 	nano::node & node;
 	nano::write_database_queue & write_database_queue;
 	std::mutex mutex;
+	std::thread verification_thread;
+	/** Runs post events of committed batches one batch after the other */
+	nano::worker post_events_worker{ nano::thread_role::name::block_post_events };
 
 	friend std::unique_ptr<container_info_component> collect_container_info (block_processor & block_processor, const std::string & name);
 };
@@ -480,32 +480,65 @@ void nano::bulk_pull_server::set_current_end ()
 	}
 }
 
+static_assert (nano::bulk_pull_server::burst_blocks_max * (1 + nano::state_block::size) + 1 <= nano::buffer_pool::class_size_max, "A full burst, of the largest blocks and the terminator, must fit a pooled buffer");
+
 void nano::bulk_pull_server::send_next ()
 {
-	auto block (get_next ());
-	if (block != nullptr)
+	// Serialized into storage reused for every burst of this request, then copied into a pooled buffer which is recycled once the write completes
+	burst.clear ();
+	auto finished (fill_burst (burst));
+	auto send_buffer (connection->node->network.message_buffers.make_buffer (burst.data (), burst.size ()));
+	auto this_l (shared_from_this ());
+	if (!finished)
+	{
+		connection->socket->async_write (send_buffer, [this_l](boost::system::error_code const & ec, size_t size_a) {
+			this_l->sent_action (ec, size_a);
+		});
+	}
+	else
 	{
-		std::vector<uint8_t> send_buffer;
-		{
-			nano::vectorstream stream (send_buffer);
-			nano::serialize_block (stream, *block);
-		}
-		auto this_l (shared_from_this ());
 		if (connection->node->config.logging.bulk_pull_logging ())
 		{
-			connection->node->logger.try_log (boost::str (boost::format ("Sending block: %1%") % block->hash ().to_string ()));
+			connection->node->logger.try_log ("Bulk sending finished");
 		}
-		connection->socket->async_write (nano::shared_const_buffer (std::move (send_buffer)), [this_l](boost::system::error_code const & ec, size_t size_a) {
-			this_l->sent_action (ec, size_a);
+		connection->socket->async_write (send_buffer, [this_l](boost::system::error_code const & ec, size_t size_a) {
+			this_l->no_block_sent (ec, size_a);
 		});
 	}
-	else
+}
+
+bool nano::bulk_pull_server::fill_burst (std::vector<uint8_t> & buffer_a)
+{
+	auto result (false);
+	nano::vectorstream stream (buffer_a);
+	auto transaction (connection->node->store.tx_begin_read ());
+	for (size_t count (0); !result && count < burst_blocks_max; ++count)
 	{
-		send_finished ();
+		auto block (get_next (transaction));
+		if (block != nullptr)
+		{
+			if (connection->node->config.logging.bulk_pull_logging ())
+			{
+				connection->node->logger.try_log (boost::str (boost::format ("Sending block: %1%") % block->hash ().to_string ()));
+			}
+			nano::serialize_block (stream, *block);
+		}
+		else
+		{
+			nano::write (stream, static_cast<uint8_t> (nano::block_type::not_a_block));
+			result = true;
+		}
 	}
+	return result;
 }
 
 std::shared_ptr<nano::block> nano::bulk_pull_server::get_next ()
+{
+	auto transaction (connection->node->store.tx_begin_read ());
+	return get_next (transaction);
+}
+
+std::shared_ptr<nano::block> nano::bulk_pull_server::get_next (nano::transaction const & transaction_a)
 {
 	std::shared_ptr<nano::block> result;
 	bool send_current = false, set_current_to_end = false;
@@ -546,7 +579,7 @@ std::shared_ptr<nano::block> nano::bulk_pull_server::get_next ()
 
 	if (send_current)
 	{
-		result = connection->node->block (current);
+		result = connection->node->store.block_get (transaction_a, current);
 		if (result != nullptr && set_current_to_end == false)
 		{
 			auto previous (result->previous ());
@@ -591,24 +624,11 @@ void nano::bulk_pull_server::sent_action (boost::system::error_code const & ec,
 	}
 }
 
-void nano::bulk_pull_server::send_finished ()
-{
-	nano::shared_const_buffer send_buffer (static_cast<uint8_t> (nano::block_type::not_a_block));
-	auto this_l (shared_from_this ());
-	if (connection->node->config.logging.bulk_pull_logging ())
-	{
-		connection->node->logger.try_log ("Bulk sending finished");
-	}
-	connection->socket->async_write (send_buffer, [this_l](boost::system::error_code const & ec, size_t size_a) {
-		this_l->no_block_sent (ec, size_a);
-	});
-}
-
 void nano::bulk_pull_server::no_block_sent (boost::system::error_code const & ec, size_t size_a)
 {
 	if (!ec)
 	{
-		debug_assert (size_a == 1);
+		debug_assert (size_a >= 1);
 		connection->finish_request ();
 	}
 	else
@@ -787,7 +807,7 @@ std::pair<std::unique_ptr<nano::pending_key>, std::unique_ptr<nano::pending_info
 		 * database for a prolonged period.
 		 */
 		auto stream_transaction (connection->node->store.tx_begin_read ());
-		auto stream (connection->node->store.pending_begin (stream_transaction, current_key));
+		auto stream (connection->node->store.pending_account_begin (stream_transaction, current_key));
 
 		if (stream == nano::store_iterator<nano::pending_key, nano::pending_info> (nullptr))
 		{
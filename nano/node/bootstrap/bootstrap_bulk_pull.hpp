@@ -65,9 +65,11 @@ public:
 	bulk_pull_server (std::shared_ptr<nano::bootstrap_server> const &, std::unique_ptr<nano::bulk_pull>);
 	void set_current_end ();
 	std::shared_ptr<nano::block> get_next ();
+	std::shared_ptr<nano::block> get_next (nano::transaction const &);
+	/** Serializes up to burst_blocks_max blocks down the chain into \p buffer_a with a single read transaction, returns true if the request has been completed and not_a_block was appended */
+	bool fill_burst (std::vector<uint8_t> & buffer_a);
 	void send_next ();
 	void sent_action (boost::system::error_code const &, size_t);
-	void send_finished ();
 	void no_block_sent (boost::system::error_code const &, size_t);
 	std::shared_ptr<nano::bootstrap_server> connection;
 	std::unique_ptr<nano::bulk_pull> request;
@@ -75,6 +77,9 @@ public:
 	bool include_start;
 	nano::bulk_pull::count_t max_count;
 	nano::bulk_pull::count_t sent_count;
+	/** Blocks read and written per socket write, only one burst is in flight at a time. A full burst fits the largest buffer_pool size class */
+	static size_t constexpr burst_blocks_max{ 256 };
+	std::vector<uint8_t> burst;
 };
 class bulk_pull_account;
 class bulk_pull_account_server final : public std::enable_shared_from_this<nano::bulk_pull_account_server>
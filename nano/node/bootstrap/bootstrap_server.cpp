@@ -1,3 +1,4 @@
+#include <nano/boost/asio/post.hpp>
 #include <nano/node/bootstrap/bootstrap_bulk_push.hpp>
 #include <nano/node/bootstrap/bootstrap_frontier.hpp>
 #include <nano/node/bootstrap/bootstrap_server.hpp>
@@ -6,6 +7,8 @@
 
 #include <boost/format.hpp>
 
+#include <cstring>
+
 nano::bootstrap_listener::bootstrap_listener (uint16_t port_a, nano::node & node_a) :
 node (node_a),
 port (port_a)
@@ -94,11 +97,10 @@ std::unique_ptr<nano::container_info_component> nano::collect_container_info (bo
 }
 
 nano::bootstrap_server::bootstrap_server (std::shared_ptr<nano::socket> socket_a, std::shared_ptr<nano::node> node_a) :
-receive_buffer (std::make_shared<std::vector<uint8_t>> ()),
+receive_buffer (std::make_shared<std::vector<uint8_t>> (receive_buffer_size)),
 socket (socket_a),
 node (node_a)
 {
-	receive_buffer->resize (1024);
 }
 
 nano::bootstrap_server::~bootstrap_server ()
@@ -140,10 +142,10 @@ void nano::bootstrap_server::stop ()
 
 void nano::bootstrap_server::receive ()
 {
-	// Increase timeout to receive TCP header (idle server socket)
-	socket->set_timeout (node->network_params.node.idle_timeout);
+	// Increase timeout to receive TCP header (idle server socket), keep the default if part of a message is buffered
+	socket->set_timeout (receive_end == 0 ? node->network_params.node.idle_timeout : node->config.tcp_io_timeout);
 	auto this_l (shared_from_this ());
-	socket->async_read (receive_buffer, 8, [this_l](boost::system::error_code const & ec, size_t size_a) {
+	socket->async_read_some (receive_buffer, receive_end, receive_buffer->size () - receive_end, [this_l](boost::system::error_code const & ec, size_t size_a) {
 		// Set remote_endpoint
 		if (this_l->remote_endpoint.port () == 0)
 		{
@@ -151,347 +153,334 @@ void nano::bootstrap_server::receive ()
 		}
 		// Decrease timeout to default
 		this_l->socket->set_timeout (this_l->node->config.tcp_io_timeout);
-		// Receive header
-		this_l->receive_header_action (ec, size_a);
+		if (!ec)
+		{
+			this_l->receive_end += size_a;
+			if (this_l->receive_buffered ())
+			{
+				this_l->receive ();
+			}
+		}
+		else
+		{
+			if (this_l->node->config.logging.bulk_pull_logging ())
+			{
+				this_l->node->logger.try_log (boost::str (boost::format ("Error while receiving type: %1%") % ec.message ()));
+			}
+		}
 	});
 }
 
-void nano::bootstrap_server::receive_header_action (boost::system::error_code const & ec, size_t size_a)
+bool nano::bootstrap_server::receive_buffered ()
 {
-	if (!ec)
+	auto result (true);
+	auto incomplete (false);
+	while (result && !incomplete && receive_end - receive_begin >= nano::message_header::size)
 	{
-		debug_assert (size_a == 8);
-		nano::bufferstream type_stream (receive_buffer->data (), size_a);
+		nano::bufferstream header_stream (receive_buffer->data () + receive_begin, nano::message_header::size);
 		auto error (false);
-		nano::message_header header (error, type_stream);
+		nano::message_header header (error, header_stream);
 		if (!error)
 		{
-			auto this_l (shared_from_this ());
-			switch (header.type)
+			auto message_size (nano::message_header::size + header.payload_length_bytes ());
+			if (message_size > receive_buffer->size ())
 			{
-				case nano::message_type::bulk_pull:
+				if (node->config.logging.network_logging ())
 				{
-					node->stats.inc (nano::stat::type::bootstrap, nano::stat::detail::bulk_pull, nano::stat::dir::in);
-					socket->async_read (receive_buffer, header.payload_length_bytes (), [this_l, header](boost::system::error_code const & ec, size_t size_a) {
-						this_l->receive_bulk_pull_action (ec, size_a, header);
-					});
-					break;
-				}
-				case nano::message_type::bulk_pull_account:
-				{
-					node->stats.inc (nano::stat::type::bootstrap, nano::stat::detail::bulk_pull_account, nano::stat::dir::in);
-					socket->async_read (receive_buffer, header.payload_length_bytes (), [this_l, header](boost::system::error_code const & ec, size_t size_a) {
-						this_l->receive_bulk_pull_account_action (ec, size_a, header);
-					});
-					break;
-				}
-				case nano::message_type::frontier_req:
-				{
-					node->stats.inc (nano::stat::type::bootstrap, nano::stat::detail::frontier_req, nano::stat::dir::in);
-					socket->async_read (receive_buffer, header.payload_length_bytes (), [this_l, header](boost::system::error_code const & ec, size_t size_a) {
-						this_l->receive_frontier_req_action (ec, size_a, header);
-					});
-					break;
-				}
-				case nano::message_type::bulk_push:
-				{
-					node->stats.inc (nano::stat::type::bootstrap, nano::stat::detail::bulk_push, nano::stat::dir::in);
-					if (is_bootstrap_connection ())
-					{
-						add_request (std::make_unique<nano::bulk_push> (header));
-					}
-					break;
-				}
-				case nano::message_type::keepalive:
-				{
-					socket->async_read (receive_buffer, header.payload_length_bytes (), [this_l, header](boost::system::error_code const & ec, size_t size_a) {
-						this_l->receive_keepalive_action (ec, size_a, header);
-					});
-					break;
-				}
-				case nano::message_type::publish:
-				{
-					socket->async_read (receive_buffer, header.payload_length_bytes (), [this_l, header](boost::system::error_code const & ec, size_t size_a) {
-						this_l->receive_publish_action (ec, size_a, header);
-					});
-					break;
-				}
-				case nano::message_type::confirm_ack:
-				{
-					socket->async_read (receive_buffer, header.payload_length_bytes (), [this_l, header](boost::system::error_code const & ec, size_t size_a) {
-						this_l->receive_confirm_ack_action (ec, size_a, header);
-					});
-					break;
-				}
-				case nano::message_type::confirm_req:
-				{
-					socket->async_read (receive_buffer, header.payload_length_bytes (), [this_l, header](boost::system::error_code const & ec, size_t size_a) {
-						this_l->receive_confirm_req_action (ec, size_a, header);
-					});
-					break;
-				}
-				case nano::message_type::node_id_handshake:
-				{
-					socket->async_read (receive_buffer, header.payload_length_bytes (), [this_l, header](boost::system::error_code const & ec, size_t size_a) {
-						this_l->receive_node_id_handshake_action (ec, size_a, header);
-					});
-					break;
-				}
-				case nano::message_type::telemetry_req:
-				{
-					if (is_realtime_connection ())
-					{
-						// Only handle telemetry requests if they are outside of the cutoff time
-						auto is_very_first_message = last_telemetry_req == std::chrono::steady_clock::time_point{};
-						auto cache_exceeded = std::chrono::steady_clock::now () >= last_telemetry_req + nano::telemetry_cache_cutoffs::network_to_time (node->network_params.network);
-						if (is_very_first_message || cache_exceeded)
-						{
-							last_telemetry_req = std::chrono::steady_clock::now ();
-							add_request (std::make_unique<nano::telemetry_req> (header));
-						}
-					}
-					receive ();
-					break;
-				}
-				case nano::message_type::telemetry_ack:
-				{
-					socket->async_read (receive_buffer, header.payload_length_bytes (), [this_l, header](boost::system::error_code const & ec, size_t size_a) {
-						this_l->receive_telemetry_ack_action (ec, size_a, header);
-					});
-					break;
-				}
-				default:
-				{
-					if (node->config.logging.network_logging ())
-					{
-						node->logger.try_log (boost::str (boost::format ("Received invalid type from bootstrap connection %1%") % static_cast<uint8_t> (header.type)));
-					}
-					break;
+					node->logger.try_log (boost::str (boost::format ("Received oversized message from bootstrap connection %1%") % static_cast<uint8_t> (header.type)));
 				}
+				result = false;
+			}
+			else if (receive_end - receive_begin >= message_size)
+			{
+				nano::bufferstream stream (receive_buffer->data () + receive_begin + nano::message_header::size, header.payload_length_bytes ());
+				// Consumed before processing so handlers taking over the connection start reading after the header
+				receive_begin += message_size;
+				result = receive_message (header, stream);
+			}
+			else
+			{
+				incomplete = true;
 			}
 		}
-	}
-	else
-	{
-		if (node->config.logging.bulk_pull_logging ())
+		else
 		{
-			node->logger.try_log (boost::str (boost::format ("Error while receiving type: %1%") % ec.message ()));
+			result = false;
 		}
 	}
+	// Move a partially received message to the front so the remainder fits
+	if (receive_begin == receive_end)
+	{
+		receive_begin = 0;
+		receive_end = 0;
+	}
+	else if (receive_begin > 0)
+	{
+		std::memmove (receive_buffer->data (), receive_buffer->data () + receive_begin, receive_end - receive_begin);
+		receive_end -= receive_begin;
+		receive_begin = 0;
+	}
+	return result;
 }
 
-void nano::bootstrap_server::receive_bulk_pull_action (boost::system::error_code const & ec, size_t size_a, nano::message_header const & header_a)
+bool nano::bootstrap_server::receive_message (nano::message_header const & header_a, nano::stream & stream_a)
 {
-	if (!ec)
+	auto result (false);
+	switch (header_a.type)
 	{
-		auto error (false);
-		nano::bufferstream stream (receive_buffer->data (), size_a);
-		auto request (std::make_unique<nano::bulk_pull> (error, stream, header_a));
-		if (!error)
+		case nano::message_type::bulk_pull:
 		{
-			if (node->config.logging.bulk_pull_logging ())
+			node->stats.inc (nano::stat::type::bootstrap, nano::stat::detail::bulk_pull, nano::stat::dir::in);
+			result = receive_bulk_pull_action (header_a, stream_a);
+			break;
+		}
+		case nano::message_type::bulk_pull_account:
+		{
+			node->stats.inc (nano::stat::type::bootstrap, nano::stat::detail::bulk_pull_account, nano::stat::dir::in);
+			result = receive_bulk_pull_account_action (header_a, stream_a);
+			break;
+		}
+		case nano::message_type::frontier_req:
+		{
+			node->stats.inc (nano::stat::type::bootstrap, nano::stat::detail::frontier_req, nano::stat::dir::in);
+			result = receive_frontier_req_action (header_a, stream_a);
+			break;
+		}
+		case nano::message_type::bulk_push:
+		{
+			node->stats.inc (nano::stat::type::bootstrap, nano::stat::detail::bulk_push, nano::stat::dir::in);
+			if (is_bootstrap_connection ())
+			{
+				// The bulk_push_server reads the following blocks through async_read, bytes already received are handed over so it never shares receive_buffer
+				handover_buffer.assign (receive_buffer->begin () + receive_begin, receive_buffer->begin () + receive_end);
+				handover_begin = 0;
+				receive_end = receive_begin;
+				add_request (std::make_unique<nano::bulk_push> (header_a));
+			}
+			break;
+		}
+		case nano::message_type::keepalive:
+		{
+			result = receive_keepalive_action (header_a, stream_a);
+			break;
+		}
+		case nano::message_type::publish:
+		{
+			result = receive_publish_action (header_a, stream_a);
+			break;
+		}
+		case nano::message_type::confirm_ack:
+		{
+			result = receive_confirm_ack_action (header_a, stream_a);
+			break;
+		}
+		case nano::message_type::confirm_req:
+		{
+			result = receive_confirm_req_action (header_a, stream_a);
+			break;
+		}
+		case nano::message_type::node_id_handshake:
+		{
+			result = receive_node_id_handshake_action (header_a, stream_a);
+			break;
+		}
+		case nano::message_type::telemetry_req:
+		{
+			if (is_realtime_connection ())
 			{
-				node->logger.try_log (boost::str (boost::format ("Received bulk pull for %1% down to %2%, maximum of %3%") % request->start.to_string () % request->end.to_string () % (request->count ? request->count : std::numeric_limits<double>::infinity ())));
+				// Only handle telemetry requests if they are outside of the cutoff time
+				auto is_very_first_message = last_telemetry_req == std::chrono::steady_clock::time_point{};
+				auto cache_exceeded = std::chrono::steady_clock::now () >= last_telemetry_req + nano::telemetry_cache_cutoffs::network_to_time (node->network_params.network);
+				if (is_very_first_message || cache_exceeded)
+				{
+					last_telemetry_req = std::chrono::steady_clock::now ();
+					add_request (std::make_unique<nano::telemetry_req> (header_a));
+				}
 			}
-			if (is_bootstrap_connection () && !node->flags.disable_bootstrap_bulk_pull_server)
+			result = true;
+			break;
+		}
+		case nano::message_type::telemetry_ack:
+		{
+			result = receive_telemetry_ack_action (header_a, stream_a);
+			break;
+		}
+		default:
+		{
+			if (node->config.logging.network_logging ())
 			{
-				add_request (std::unique_ptr<nano::message> (request.release ()));
+				node->logger.try_log (boost::str (boost::format ("Received invalid type from bootstrap connection %1%") % static_cast<uint8_t> (header_a.type)));
 			}
-			receive ();
+			break;
 		}
 	}
+	return result;
 }
 
-void nano::bootstrap_server::receive_bulk_pull_account_action (boost::system::error_code const & ec, size_t size_a, nano::message_header const & header_a)
+bool nano::bootstrap_server::receive_bulk_pull_action (nano::message_header const & header_a, nano::stream & stream_a)
 {
-	if (!ec)
+	auto error (false);
+	auto request (std::make_unique<nano::bulk_pull> (error, stream_a, header_a));
+	if (!error)
 	{
-		auto error (false);
-		debug_assert (size_a == header_a.payload_length_bytes ());
-		nano::bufferstream stream (receive_buffer->data (), size_a);
-		auto request (std::make_unique<nano::bulk_pull_account> (error, stream, header_a));
-		if (!error)
+		if (node->config.logging.bulk_pull_logging ())
 		{
-			if (node->config.logging.bulk_pull_logging ())
-			{
-				node->logger.try_log (boost::str (boost::format ("Received bulk pull account for %1% with a minimum amount of %2%") % request->account.to_account () % nano::amount (request->minimum_amount).format_balance (nano::Mxrb_ratio, 10, true)));
-			}
-			if (is_bootstrap_connection () && !node->flags.disable_bootstrap_bulk_pull_server)
-			{
-				add_request (std::unique_ptr<nano::message> (request.release ()));
-			}
-			receive ();
+			node->logger.try_log (boost::str (boost::format ("Received bulk pull for %1% down to %2%, maximum of %3%") % request->start.to_string () % request->end.to_string () % (request->count ? request->count : std::numeric_limits<double>::infinity ())));
+		}
+		if (is_bootstrap_connection () && !node->flags.disable_bootstrap_bulk_pull_server)
+		{
+			add_request (std::unique_ptr<nano::message> (request.release ()));
 		}
 	}
+	return !error;
 }
 
-void nano::bootstrap_server::receive_frontier_req_action (boost::system::error_code const & ec, size_t size_a, nano::message_header const & header_a)
+bool nano::bootstrap_server::receive_bulk_pull_account_action (nano::message_header const & header_a, nano::stream & stream_a)
 {
-	if (!ec)
+	auto error (false);
+	auto request (std::make_unique<nano::bulk_pull_account> (error, stream_a, header_a));
+	if (!error)
 	{
-		auto error (false);
-		nano::bufferstream stream (receive_buffer->data (), size_a);
-		auto request (std::make_unique<nano::frontier_req> (error, stream, header_a));
-		if (!error)
+		if (node->config.logging.bulk_pull_logging ())
 		{
-			if (node->config.logging.bulk_pull_logging ())
-			{
-				node->logger.try_log (boost::str (boost::format ("Received frontier request for %1% with age %2%") % request->start.to_string () % request->age));
-			}
-			if (is_bootstrap_connection ())
-			{
-				add_request (std::unique_ptr<nano::message> (request.release ()));
-			}
-			receive ();
+			node->logger.try_log (boost::str (boost::format ("Received bulk pull account for %1% with a minimum amount of %2%") % request->account.to_account () % nano::amount (request->minimum_amount).format_balance (nano::Mxrb_ratio, 10, true)));
 		}
-	}
-	else
-	{
-		if (node->config.logging.network_logging ())
+		if (is_bootstrap_connection () && !node->flags.disable_bootstrap_bulk_pull_server)
 		{
-			node->logger.try_log (boost::str (boost::format ("Error sending receiving frontier request: %1%") % ec.message ()));
+			add_request (std::unique_ptr<nano::message> (request.release ()));
 		}
 	}
+	return !error;
 }
 
-void nano::bootstrap_server::receive_keepalive_action (boost::system::error_code const & ec, size_t size_a, nano::message_header const & header_a)
+bool nano::bootstrap_server::receive_frontier_req_action (nano::message_header const & header_a, nano::stream & stream_a)
 {
-	if (!ec)
+	auto error (false);
+	auto request (std::make_unique<nano::frontier_req> (error, stream_a, header_a));
+	if (!error)
 	{
-		auto error (false);
-		nano::bufferstream stream (receive_buffer->data (), size_a);
-		auto request (std::make_unique<nano::keepalive> (error, stream, header_a));
-		if (!error)
+		if (node->config.logging.bulk_pull_logging ())
 		{
-			if (is_realtime_connection ())
-			{
-				add_request (std::unique_ptr<nano::message> (request.release ()));
-			}
-			receive ();
+			node->logger.try_log (boost::str (boost::format ("Received frontier request for %1% with age %2%") % request->start.to_string () % request->age));
 		}
-	}
-	else
-	{
-		if (node->config.logging.network_keepalive_logging ())
+		if (is_bootstrap_connection ())
 		{
-			node->logger.try_log (boost::str (boost::format ("Error receiving keepalive: %1%") % ec.message ()));
+			add_request (std::unique_ptr<nano::message> (request.release ()));
 		}
 	}
+	return !error;
 }
 
-void nano::bootstrap_server::receive_telemetry_ack_action (boost::system::error_code const & ec, size_t size_a, nano::message_header const & header_a)
+bool nano::bootstrap_server::receive_keepalive_action (nano::message_header const & header_a, nano::stream & stream_a)
 {
-	if (!ec)
+	auto error (false);
+	auto request (std::make_unique<nano::keepalive> (error, stream_a, header_a));
+	if (!error)
 	{
-		auto error (false);
-		nano::bufferstream stream (receive_buffer->data (), size_a);
-		auto request (std::make_unique<nano::telemetry_ack> (error, stream, header_a));
-		if (!error)
+		if (is_realtime_connection ())
 		{
-			if (is_realtime_connection ())
-			{
-				add_request (std::unique_ptr<nano::message> (request.release ()));
-			}
-			receive ();
+			add_request (std::unique_ptr<nano::message> (request.release ()));
 		}
 	}
-	else
+	return !error;
+}
+
+bool nano::bootstrap_server::receive_telemetry_ack_action (nano::message_header const & header_a, nano::stream & stream_a)
+{
+	auto error (false);
+	auto request (std::make_unique<nano::telemetry_ack> (error, stream_a, header_a));
+	if (!error)
 	{
-		if (node->config.logging.network_telemetry_logging ())
+		if (is_realtime_connection ())
 		{
-			node->logger.try_log (boost::str (boost::format ("Error receiving telemetry ack: %1%") % ec.message ()));
+			add_request (std::unique_ptr<nano::message> (request.release ()));
 		}
 	}
+	return !error;
 }
 
-void nano::bootstrap_server::receive_publish_action (boost::system::error_code const & ec, size_t size_a, nano::message_header const & header_a)
+bool nano::bootstrap_server::receive_publish_action (nano::message_header const & header_a, nano::stream & stream_a)
 {
-	if (!ec)
+	auto error (false);
+	auto request (std::make_unique<nano::publish> (error, stream_a, header_a));
+	if (!error)
 	{
-		auto error (false);
-		nano::bufferstream stream (receive_buffer->data (), size_a);
-		auto request (std::make_unique<nano::publish> (error, stream, header_a));
-		if (!error)
+		if (is_realtime_connection ())
 		{
-			if (is_realtime_connection ())
-			{
-				add_request (std::unique_ptr<nano::message> (request.release ()));
-			}
-			receive ();
+			add_request (std::unique_ptr<nano::message> (request.release ()));
 		}
 	}
-	else
+	return !error;
+}
+
+bool nano::bootstrap_server::receive_confirm_req_action (nano::message_header const & header_a, nano::stream & stream_a)
+{
+	auto error (false);
+	auto request (std::make_unique<nano::confirm_req> (error, stream_a, header_a));
+	if (!error)
 	{
-		if (node->config.logging.network_message_logging ())
+		if (is_realtime_connection ())
 		{
-			node->logger.try_log (boost::str (boost::format ("Error receiving publish: %1%") % ec.message ()));
+			add_request (std::unique_ptr<nano::message> (request.release ()));
 		}
 	}
+	return !error;
 }
 
-void nano::bootstrap_server::receive_confirm_req_action (boost::system::error_code const & ec, size_t size_a, nano::message_header const & header_a)
+bool nano::bootstrap_server::receive_confirm_ack_action (nano::message_header const & header_a, nano::stream & stream_a)
 {
-	if (!ec)
+	auto error (false);
+	auto request (std::make_unique<nano::confirm_ack> (error, stream_a, header_a));
+	if (!error)
 	{
-		auto error (false);
-		nano::bufferstream stream (receive_buffer->data (), size_a);
-		auto request (std::make_unique<nano::confirm_req> (error, stream, header_a));
-		if (!error)
+		if (is_realtime_connection ())
 		{
-			if (is_realtime_connection ())
-			{
-				add_request (std::unique_ptr<nano::message> (request.release ()));
-			}
-			receive ();
+			add_request (std::unique_ptr<nano::message> (request.release ()));
 		}
 	}
-	else if (node->config.logging.network_message_logging ())
-	{
-		node->logger.try_log (boost::str (boost::format ("Error receiving confirm_req: %1%") % ec.message ()));
-	}
+	return !error;
 }
 
-void nano::bootstrap_server::receive_confirm_ack_action (boost::system::error_code const & ec, size_t size_a, nano::message_header const & header_a)
+bool nano::bootstrap_server::receive_node_id_handshake_action (nano::message_header const & header_a, nano::stream & stream_a)
 {
-	if (!ec)
+	auto error (false);
+	auto request (std::make_unique<nano::node_id_handshake> (error, stream_a, header_a));
+	if (!error)
 	{
-		auto error (false);
-		nano::bufferstream stream (receive_buffer->data (), size_a);
-		auto request (std::make_unique<nano::confirm_ack> (error, stream, header_a));
-		if (!error)
+		if (type == nano::bootstrap_server_type::undefined && !node->flags.disable_tcp_realtime)
 		{
-			if (is_realtime_connection ())
-			{
-				add_request (std::unique_ptr<nano::message> (request.release ()));
-			}
-			receive ();
+			add_request (std::unique_ptr<nano::message> (request.release ()));
 		}
 	}
-	else if (node->config.logging.network_message_logging ())
-	{
-		node->logger.try_log (boost::str (boost::format ("Error receiving confirm_ack: %1%") % ec.message ()));
-	}
+	return !error;
 }
 
-void nano::bootstrap_server::receive_node_id_handshake_action (boost::system::error_code const & ec, size_t size_a, nano::message_header const & header_a)
+void nano::bootstrap_server::async_read (std::shared_ptr<std::vector<uint8_t>> const & buffer_a, size_t size_a, std::function<void(boost::system::error_code const &, size_t)> callback_a)
 {
-	if (!ec)
+	debug_assert (size_a <= buffer_a->size ());
+	auto buffered (std::min (size_a, handover_buffer.size () - handover_begin));
+	if (buffered == 0)
 	{
-		auto error (false);
-		nano::bufferstream stream (receive_buffer->data (), size_a);
-		auto request (std::make_unique<nano::node_id_handshake> (error, stream, header_a));
-		if (!error)
-		{
-			if (type == nano::bootstrap_server_type::undefined && !node->flags.disable_tcp_realtime)
-			{
-				add_request (std::unique_ptr<nano::message> (request.release ()));
-			}
-			receive ();
-		}
+		socket->async_read (buffer_a, size_a, callback_a);
 	}
-	else if (node->config.logging.network_node_id_handshake_logging ())
+	else
 	{
-		node->logger.try_log (boost::str (boost::format ("Error receiving node_id_handshake: %1%") % ec.message ()));
+		std::copy_n (handover_buffer.data () + handover_begin, buffered, buffer_a->data ());
+		handover_begin += buffered;
+		if (buffered == size_a)
+		{
+			boost::asio::post (node->io_ctx, [callback_a, size_a]() {
+				callback_a (boost::system::error_code (), size_a);
+			});
+		}
+		else
+		{
+			auto remainder (std::make_shared<std::vector<uint8_t>> (size_a - buffered));
+			socket->async_read (remainder, remainder->size (), [buffer_a, buffered, remainder, callback_a](boost::system::error_code const & ec, size_t size_a) {
+				std::copy_n (remainder->data (), size_a, buffer_a->data () + buffered);
+				callback_a (ec, buffered + size_a);
+			});
+		}
 	}
 }
 
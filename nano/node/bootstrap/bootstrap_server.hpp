@@ -48,16 +48,20 @@ public:
 	~bootstrap_server ();
 	void stop ();
 	void receive ();
-	void receive_header_action (boost::system::error_code const &, size_t);
-	void receive_bulk_pull_action (boost::system::error_code const &, size_t, nano::message_header const &);
-	void receive_bulk_pull_account_action (boost::system::error_code const &, size_t, nano::message_header const &);
-	void receive_frontier_req_action (boost::system::error_code const &, size_t, nano::message_header const &);
-	void receive_keepalive_action (boost::system::error_code const &, size_t, nano::message_header const &);
-	void receive_publish_action (boost::system::error_code const &, size_t, nano::message_header const &);
-	void receive_confirm_req_action (boost::system::error_code const &, size_t, nano::message_header const &);
-	void receive_confirm_ack_action (boost::system::error_code const &, size_t, nano::message_header const &);
-	void receive_node_id_handshake_action (boost::system::error_code const &, size_t, nano::message_header const &);
-	void receive_telemetry_ack_action (boost::system::error_code const & ec, size_t size_a, nano::message_header const & header_a);
+	/** Processes every complete message in receive_buffer, returns false if the connection should stop reading */
+	bool receive_buffered ();
+	bool receive_message (nano::message_header const &, nano::stream &);
+	bool receive_bulk_pull_action (nano::message_header const &, nano::stream &);
+	bool receive_bulk_pull_account_action (nano::message_header const &, nano::stream &);
+	bool receive_frontier_req_action (nano::message_header const &, nano::stream &);
+	bool receive_keepalive_action (nano::message_header const &, nano::stream &);
+	bool receive_publish_action (nano::message_header const &, nano::stream &);
+	bool receive_confirm_req_action (nano::message_header const &, nano::stream &);
+	bool receive_confirm_ack_action (nano::message_header const &, nano::stream &);
+	bool receive_node_id_handshake_action (nano::message_header const &, nano::stream &);
+	bool receive_telemetry_ack_action (nano::message_header const &, nano::stream &);
+	/** Reads exactly \p size_a bytes for handlers taking over the connection, starting with the bytes handed over by receive () */
+	void async_read (std::shared_ptr<std::vector<uint8_t>> const &, size_t, std::function<void(boost::system::error_code const &, size_t)>);
 	void add_request (std::unique_ptr<nano::message>);
 	void finish_request ();
 	void finish_request_async ();
@@ -65,7 +69,14 @@ public:
 	void run_next ();
 	bool is_bootstrap_connection ();
 	bool is_realtime_connection ();
+	/** Messages are read in as large chunks as are available, unprocessed bytes are in [receive_begin, receive_end) */
 	std::shared_ptr<std::vector<uint8_t>> receive_buffer;
+	size_t receive_begin{ 0 };
+	size_t receive_end{ 0 };
+	static size_t constexpr receive_buffer_size{ 16 * 1024 };
+	/** Bytes received after a bulk_push header, only used by async_read once receive () stops reading */
+	std::vector<uint8_t> handover_buffer;
+	size_t handover_begin{ 0 };
 	std::shared_ptr<nano::socket> socket;
 	std::shared_ptr<nano::node> node;
 	std::mutex mutex;
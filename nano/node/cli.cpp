@@ -2,6 +2,7 @@
 #include <nano/node/cli.hpp>
 #include <nano/node/common.hpp>
 #include <nano/node/daemonconfig.hpp>
+#include <nano/node/ledger_snapshot.hpp>
 #include <nano/node/node.hpp>
 
 #include <boost/format.hpp>
@@ -46,6 +47,9 @@ void nano::add_node_options (boost::program_options::options_description & descr
 	("account_key", "Get the public key for <account>")
 	("vacuum", "Compact database. If data_path is missing, the database in data directory is compacted.")
 	("snapshot", "Compact database and create snapshot, functions similar to vacuum but does not replace the existing database")
+	("snapshot_export", "Write the ledger to a snapshot <file> signed with <key>, which can seed another node with snapshot_import")
+	("snapshot_import", "Load the ledger snapshot in <file> into an empty ledger. If <account> is given the snapshot must be signed by it")
+	("snapshot_verify_signatures", "Verify every block signature while running snapshot_import")
 	("data_path", boost::program_options::value<std::string> (), "Use the supplied path as the data directory")
 	("network", boost::program_options::value<std::string> (), "Use the supplied network (live, beta or test)")
 	("clear_send_ids", "Remove all send IDs from the database (dangerous: not intended for production use)")
@@ -102,6 +106,7 @@ void nano::add_node_flag_options (boost::program_options::options_description &
 		("block_processor_batch_size", boost::program_options::value<std::size_t>(), "Increase block processor transaction batch write size, default 0 (limited by config block_processor_batch_max_time), 256k for fast_bootstrap")
 		("block_processor_full_size", boost::program_options::value<std::size_t>(), "Increase block processor allowed blocks queue size before dropping live network packets and holding bootstrap download, default 65536, 1 million for fast_bootstrap")
 		("block_processor_verification_size", boost::program_options::value<std::size_t>(), "Increase batch signature verification size in block processor, default 0 (limited by config signature_checker_threads), unlimited for fast_bootstrap")
+		("signature_checker_backend", boost::program_options::value<std::string>(), "Signature verification algorithm, \"batch\" (multi-scalar batch verification) or \"single\" (one signature at a time), default batch")
 		("inactive_votes_cache_size", boost::program_options::value<std::size_t>(), "Increase cached votes without active elections size, default 16384")
 		("vote_processor_capacity", boost::program_options::value<std::size_t>(), "Vote processor queue size before dropping votes, default 144k")
 		;
@@ -159,6 +164,23 @@ std::error_code nano::update_flags (nano::node_flags & flags_a, boost::program_o
 	{
 		flags_a.block_processor_verification_size = block_processor_verification_size_it->second.as<size_t> ();
 	}
+	auto signature_checker_backend_it = vm.find ("signature_checker_backend");
+	if (signature_checker_backend_it != vm.end ())
+	{
+		auto const & backend_l (signature_checker_backend_it->second.as<std::string> ());
+		if (backend_l == nano::to_string (nano::signature_backend::batch))
+		{
+			flags_a.signature_checker_backend = nano::signature_backend::batch;
+		}
+		else if (backend_l == nano::to_string (nano::signature_backend::single))
+		{
+			flags_a.signature_checker_backend = nano::signature_backend::single;
+		}
+		else
+		{
+			ec = nano::error_cli::invalid_arguments;
+		}
+	}
 	auto inactive_votes_cache_size_it = vm.find ("inactive_votes_cache_size");
 	if (inactive_votes_cache_size_it != vm.end ())
 	{
@@ -433,6 +455,75 @@ std::error_code nano::handle_node_options (boost::program_options::variables_map
 			std::cerr << "Snapshot failed (unknown reason)" << std::endl;
 		}
 	}
+	else if (vm.count ("snapshot_export"))
+	{
+		nano::raw_key key;
+		if (vm.count ("file") == 1 && vm.count ("key") == 1 && !key.data.decode_hex (vm["key"].as<std::string> ()))
+		{
+			nano::inactive_node node (data_path, 24000, nano::inactive_node_flag_defaults ());
+			if (!node.node->init_error ())
+			{
+				boost::filesystem::path path (vm["file"].as<std::string> ());
+				std::cout << "Ledger snapshot to " << path << " in progress" << std::endl;
+				auto error (nano::ledger_snapshot::write (node.node->ledger, path, key));
+				if (!error)
+				{
+					std::cout << "Snapshot completed, signed by " << nano::pub_key (key.as_private_key ()).to_account () << std::endl;
+				}
+				else
+				{
+					std::cerr << "Snapshot failed: " << error.get_message () << std::endl;
+					ec = nano::error_cli::generic;
+				}
+			}
+			else
+			{
+				std::cerr << "Error initializing node\n";
+				ec = nano::error_cli::generic;
+			}
+		}
+		else
+		{
+			std::cerr << "snapshot_export command requires one <file> and one valid <key> option\n";
+			ec = nano::error_cli::invalid_arguments;
+		}
+	}
+	else if (vm.count ("snapshot_import"))
+	{
+		nano::account signer (0);
+		if (vm.count ("file") == 1 && (vm.count ("account") == 0 || !signer.decode_account (vm["account"].as<std::string> ())))
+		{
+			auto node_flags = nano::inactive_node_flag_defaults ();
+			node_flags.read_only = false;
+			nano::inactive_node node (data_path, 24000, node_flags);
+			if (!node.node->init_error ())
+			{
+				boost::filesystem::path path (vm["file"].as<std::string> ());
+				std::cout << "Importing ledger snapshot " << path << std::endl;
+				std::cout << "This may take a while..." << std::endl;
+				auto checker (vm.count ("snapshot_verify_signatures") > 0 ? &node.node->checker : nullptr);
+				auto error (nano::ledger_snapshot::read (node.node->ledger, path, checker, signer));
+				if (!error)
+				{
+					std::cout << "Snapshot signed by " << signer.to_account () << " imported" << std::endl;
+				}
+				else
+				{
+					std::cerr << "Snapshot import failed: " << error.get_message () << std::endl;
+					ec = nano::error_cli::generic;
+				}
+			}
+			else
+			{
+				database_write_lock_error (ec);
+			}
+		}
+		else
+		{
+			std::cerr << "snapshot_import command requires one <file> option and an optional valid <account>\n";
+			ec = nano::error_cli::invalid_arguments;
+		}
+	}
 	else if (vm.count ("unchecked_clear"))
 	{
 		boost::filesystem::path data_path = vm.count ("data_path") ? boost::filesystem::path (vm["data_path"].as<std::string> ()) : nano::working_path ();
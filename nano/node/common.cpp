@@ -126,6 +126,17 @@ nano::shared_const_buffer nano::message::to_shared_const_buffer () const
 	return shared_const_buffer (to_bytes ());
 }
 
+nano::shared_const_buffer nano::message::to_shared_const_buffer (nano::buffer_pool & pool_a) const
+{
+	static thread_local std::vector<uint8_t> bytes;
+	bytes.clear ();
+	{
+		nano::vectorstream stream (bytes);
+		serialize (stream);
+	}
+	return pool_a.make_buffer (bytes.data (), bytes.size ());
+}
+
 nano::block_type nano::message_header::block_type () const
 {
 	return static_cast<nano::block_type> (((extensions & block_type_mask) >> 8).to_ullong ());
@@ -330,8 +341,56 @@ status (parse_status::success)
 
 void nano::message_parser::deserialize_buffer (uint8_t const * buffer_a, size_t size_a)
 {
-	static nano::network_constants network_constants;
-	status = parse_status::success;
+	auto parsed (deserialize_message (buffer_a, size_a, block_uniquer, vote_uniquer));
+	status = parsed.status;
+	if (parsed.message != nullptr)
+	{
+		std::vector<std::shared_ptr<nano::block>> blocks;
+		append_blocks (*parsed.message, blocks);
+		if (std::none_of (blocks.begin (), blocks.end (), [](std::shared_ptr<nano::block> const & block_a) { return nano::work_validate (*block_a); }))
+		{
+			parsed.message->visit (visitor);
+		}
+		else
+		{
+			status = parse_status::insufficient_work;
+		}
+	}
+}
+
+std::vector<nano::message_parser::parsed_message> nano::message_parser::deserialize_buffers (std::vector<std::pair<uint8_t const *, size_t>> const & buffers_a, nano::block_uniquer & block_uniquer_a, nano::vote_uniquer & vote_uniquer_a)
+{
+	std::vector<parsed_message> result;
+	result.reserve (buffers_a.size ());
+	std::vector<std::shared_ptr<nano::block>> blocks;
+	// Index of the message each block belongs to
+	std::vector<size_t> owners;
+	for (auto const & buffer : buffers_a)
+	{
+		result.push_back (deserialize_message (buffer.first, buffer.second, block_uniquer_a, vote_uniquer_a));
+		auto const & message (result.back ().message);
+		if (message != nullptr)
+		{
+			append_blocks (*message, blocks);
+			owners.resize (blocks.size (), result.size () - 1);
+		}
+	}
+	auto insufficient (nano::work_validate_many (blocks));
+	for (size_t i (0), n (blocks.size ()); i < n; ++i)
+	{
+		if (insufficient[i])
+		{
+			auto & parsed (result[owners[i]]);
+			parsed.status = parse_status::insufficient_work;
+			parsed.message = nullptr;
+		}
+	}
+	return result;
+}
+
+nano::message_parser::parsed_message nano::message_parser::deserialize_message (uint8_t const * buffer_a, size_t size_a, nano::block_uniquer & block_uniquer_a, nano::vote_uniquer & vote_uniquer_a)
+{
+	parsed_message result;
 	auto error (false);
 	if (size_a <= max_safe_udp_message_size)
 	{
@@ -342,59 +401,110 @@ void nano::message_parser::deserialize_buffer (uint8_t const * buffer_a, size_t
 		{
 			if (header.version_using < get_protocol_constants ().protocol_version_min)
 			{
-				status = parse_status::outdated_version;
+				result.status = parse_status::outdated_version;
 			}
 			else
 			{
+				auto check_end (true);
+				auto invalid (parse_status::success);
 				switch (header.type)
 				{
 					case nano::message_type::keepalive:
 					{
-						deserialize_keepalive (stream, header);
+						result.message = std::make_unique<nano::keepalive> (error, stream, header);
+						invalid = parse_status::invalid_keepalive_message;
 						break;
 					}
 					case nano::message_type::publish:
 					{
-						deserialize_publish (stream, header);
+						result.message = std::make_unique<nano::publish> (error, stream, header, &block_uniquer_a);
+						invalid = parse_status::invalid_publish_message;
 						break;
 					}
 					case nano::message_type::confirm_req:
 					{
-						deserialize_confirm_req (stream, header);
+						result.message = std::make_unique<nano::confirm_req> (error, stream, header, &block_uniquer_a);
+						invalid = parse_status::invalid_confirm_req_message;
 						break;
 					}
 					case nano::message_type::confirm_ack:
 					{
-						deserialize_confirm_ack (stream, header);
+						result.message = std::make_unique<nano::confirm_ack> (error, stream, header, &vote_uniquer_a);
+						invalid = parse_status::invalid_confirm_ack_message;
 						break;
 					}
 					case nano::message_type::node_id_handshake:
 					{
-						deserialize_node_id_handshake (stream, header);
+						result.message = std::make_unique<nano::node_id_handshake> (error, stream, header);
+						invalid = parse_status::invalid_node_id_handshake_message;
 						break;
 					}
 					case nano::message_type::telemetry_req:
 					{
-						deserialize_telemetry_req (stream, header);
+						result.message = std::make_unique<nano::telemetry_req> (header);
+						invalid = parse_status::invalid_telemetry_req_message;
 						break;
 					}
 					case nano::message_type::telemetry_ack:
 					{
-						deserialize_telemetry_ack (stream, header);
+						result.message = std::make_unique<nano::telemetry_ack> (error, stream, header);
+						invalid = parse_status::invalid_telemetry_ack_message;
+						// Intentionally not checking if at the end of stream, because these messages support backwards/forwards compatibility
+						check_end = false;
 						break;
 					}
 					default:
 					{
-						status = parse_status::invalid_message_type;
+						result.status = parse_status::invalid_message_type;
 						break;
 					}
 				}
+				if (result.message != nullptr && (error || (check_end && !at_end (stream))))
+				{
+					result.status = invalid;
+					result.message = nullptr;
+				}
 			}
 		}
 		else
 		{
-			status = parse_status::invalid_header;
+			result.status = parse_status::invalid_header;
+		}
+	}
+	return result;
+}
+
+void nano::message_parser::append_blocks (nano::message const & message_a, std::vector<std::shared_ptr<nano::block>> & blocks_a)
+{
+	switch (message_a.header.type)
+	{
+		case nano::message_type::publish:
+		{
+			blocks_a.push_back (static_cast<nano::publish const &> (message_a).block);
+			break;
 		}
+		case nano::message_type::confirm_req:
+		{
+			auto const & block (static_cast<nano::confirm_req const &> (message_a).block);
+			if (block != nullptr)
+			{
+				blocks_a.push_back (block);
+			}
+			break;
+		}
+		case nano::message_type::confirm_ack:
+		{
+			for (auto const & vote_block : static_cast<nano::confirm_ack const &> (message_a).vote->blocks)
+			{
+				if (!vote_block.which ())
+				{
+					blocks_a.push_back (boost::get<std::shared_ptr<nano::block>> (vote_block));
+				}
+			}
+			break;
+		}
+		default:
+			break;
 	}
 }
 
@@ -225,6 +225,8 @@ public:
 	virtual void visit (nano::message_visitor &) const = 0;
 	std::shared_ptr<std::vector<uint8_t>> to_bytes () const;
 	nano::shared_const_buffer to_shared_const_buffer () const;
+	/** Serializes into a reused per-thread buffer and copies the result into storage from \p pool_a */
+	nano::shared_const_buffer to_shared_const_buffer (nano::buffer_pool & pool_a) const;
 
 	nano::message_header header;
 };
@@ -249,8 +251,20 @@ public:
 		invalid_magic,
 		invalid_network
 	};
+	/** Message and status of one buffer parsed by deserialize_buffers, message is set if status is success */
+	class parsed_message final
+	{
+	public:
+		parse_status status{ parse_status::success };
+		std::unique_ptr<nano::message> message;
+	};
 	message_parser (nano::block_uniquer &, nano::vote_uniquer &, nano::message_visitor &, nano::work_pool &);
 	void deserialize_buffer (uint8_t const *, size_t);
+	/**
+	 * Parses a batch of buffers, such as every packet from one receive wakeup, without visiting the messages.
+	 * The work of all blocks in the batch is validated together with work_validate_many.
+	 */
+	static std::vector<parsed_message> deserialize_buffers (std::vector<std::pair<uint8_t const *, size_t>> const &, nano::block_uniquer &, nano::vote_uniquer &);
 	void deserialize_keepalive (nano::stream &, nano::message_header const &);
 	void deserialize_publish (nano::stream &, nano::message_header const &);
 	void deserialize_confirm_req (nano::stream &, nano::message_header const &);
@@ -258,7 +272,7 @@ public:
 	void deserialize_node_id_handshake (nano::stream &, nano::message_header const &);
 	void deserialize_telemetry_req (nano::stream &, nano::message_header const &);
 	void deserialize_telemetry_ack (nano::stream &, nano::message_header const &);
-	bool at_end (nano::stream &);
+	static bool at_end (nano::stream &);
 	nano::block_uniquer & block_uniquer;
 	nano::vote_uniquer & vote_uniquer;
 	nano::message_visitor & visitor;
@@ -266,6 +280,11 @@ public:
 	parse_status status;
 	std::string status_string ();
 	static const size_t max_safe_udp_message_size;
+
+private:
+	static parsed_message deserialize_message (uint8_t const *, size_t, nano::block_uniquer &, nano::vote_uniquer &);
+	/** Appends the blocks of \p message_a whose work needs validating */
+	static void append_blocks (nano::message const & message_a, std::vector<std::shared_ptr<nano::block>> & blocks_a);
 };
 class keepalive final : public message
 {
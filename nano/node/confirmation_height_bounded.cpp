@@ -8,9 +8,10 @@
 
 #include <numeric>
 
-nano::confirmation_height_bounded::confirmation_height_bounded (nano::ledger & ledger_a, nano::write_database_queue & write_database_queue_a, std::chrono::milliseconds batch_separate_pending_min_time_a, nano::logger_mt & logger_a, std::atomic<bool> & stopped_a, nano::block_hash const & original_hash_a, std::function<void(std::vector<std::shared_ptr<nano::block>> const &)> const & notify_observers_callback_a, std::function<void(nano::block_hash const &)> const & notify_block_already_cemented_observers_callback_a, std::function<uint64_t ()> const & awaiting_processing_size_callback_a) :
+nano::confirmation_height_bounded::confirmation_height_bounded (nano::ledger & ledger_a, nano::write_database_queue & write_database_queue_a, nano::write_batcher & write_batcher_a, std::chrono::milliseconds batch_separate_pending_min_time_a, nano::logger_mt & logger_a, std::atomic<bool> & stopped_a, nano::block_hash const & original_hash_a, std::function<void(std::vector<std::shared_ptr<nano::block>> const &)> const & notify_observers_callback_a, std::function<void(nano::block_hash const &)> const & notify_block_already_cemented_observers_callback_a, std::function<uint64_t ()> const & awaiting_processing_size_callback_a) :
 ledger (ledger_a),
 write_database_queue (write_database_queue_a),
+write_batcher (write_batcher_a),
 batch_separate_pending_min_time (batch_separate_pending_min_time_a),
 logger (logger_a),
 stopped (stopped_a),
@@ -167,18 +168,7 @@ void nano::confirmation_height_bounded::process ()
 
 			if (((max_batch_write_size_reached || should_output) && !pending_writes.empty ()) || force_write)
 			{
-				bool error = false;
-				// If nothing is currently using the database write lock then write the cemented pending blocks otherwise continue iterating
-				if (write_database_queue.process (nano::writer::confirmation_height))
-				{
-					auto scoped_write_guard = write_database_queue.pop ();
-					error = cement_blocks ();
-				}
-				else if (force_write)
-				{
-					auto scoped_write_guard = write_database_queue.wait (nano::writer::confirmation_height);
-					error = cement_blocks ();
-				}
+				auto error (cement_blocks (force_write));
 				// Don't set any more cemented blocks from the original hash if an inconsistency is found
 				if (error)
 				{
@@ -202,10 +192,15 @@ nano::block_hash nano::confirmation_height_bounded::get_least_unconfirmed_hash_f
 	{
 		if (block_height_a > confirmation_height_info_a.height)
 		{
-			auto block (ledger.store.block_get (transaction_a, confirmation_height_info_a.frontier));
-			release_assert (block != nullptr);
-			least_unconfirmed_hash = block->sideband ().successor;
-			block_height_a = block->sideband ().height + 1;
+			// The height index has the successor of the cemented frontier without reading the frontier itself
+			least_unconfirmed_hash = ledger.store.block_hash_at_height (transaction_a, account_a, confirmation_height_info_a.height + 1);
+			if (least_unconfirmed_hash.is_zero ())
+			{
+				auto block (ledger.store.block_get (transaction_a, confirmation_height_info_a.frontier));
+				release_assert (block != nullptr);
+				least_unconfirmed_hash = block->sideband ().successor;
+			}
+			block_height_a = confirmation_height_info_a.height + 1;
 		}
 	}
 	else
@@ -332,125 +327,175 @@ void nano::confirmation_height_bounded::prepare_iterated_blocks_for_cementing (p
 	}
 }
 
-bool nano::confirmation_height_bounded::cement_blocks ()
+bool nano::confirmation_height_bounded::cement_blocks (bool wait_a)
 {
+	auto total_pending_write_block_count = std::accumulate (pending_writes.cbegin (), pending_writes.cend (), uint64_t (0), [](uint64_t total, auto const & write_details_a) {
+		return total += write_details_a.top_height - write_details_a.bottom_height + 1;
+	});
+
+	auto error (false);
+	auto written (false);
 	// Will contain all blocks that have been cemented (bounded by batch_write_size)
 	// and will get run through the cemented observer callback
 	std::vector<std::shared_ptr<nano::block>> cemented_blocks;
+	// A write lock request left queued by an earlier attempt without waiting is taken up below, the write batcher could be queued behind it
+	if (wait_a && total_pending_write_block_count <= confirmation_height::batch_write_size && !write_database_queue.contains (nano::writer::confirmation_height))
 	{
-		// This only writes to the confirmation_height table and is the only place to do so in a single process
-		auto transaction (ledger.store.tx_begin_write ({}, { nano::tables::confirmation_height }));
-
-		// Cement all pending entries, each entry is specific to an account and contains the least amount
-		// of blocks to retain consistent cementing across all account chains to genesis.
-		while (!pending_writes.empty ())
+		// Blocks until it shares the commit of the writer holding the write lock, or until the write batcher has committed it
+		std::vector<std::shared_ptr<nano::block>> flushed;
+		written = !write_batcher.apply_sync (nano::writer::confirmation_height, [this, &error, &flushed, &cemented_blocks](nano::write_transaction const & transaction_a) {
+			error = write_pending (transaction_a, [&flushed](auto const & cemented_blocks_a) {
+				flushed.insert (flushed.end (), cemented_blocks_a.begin (), cemented_blocks_a.end ());
+			},
+			cemented_blocks);
+		});
+		if (!flushed.empty ())
+		{
+			notify_observers_callback (flushed);
+		}
+	}
+	if (!written)
+	{
+		auto write = [this, &error, &cemented_blocks]() {
+			// This only writes to the confirmation_height table and is the only place to do so in a single process
+			auto transaction (ledger.store.tx_begin_write ({}, { nano::tables::confirmation_height }));
+			error = write_pending (transaction, [this, &transaction](auto const & cemented_blocks_a) {
+				transaction.commit ();
+				notify_observers_callback (cemented_blocks_a);
+				transaction.renew ();
+			},
+			cemented_blocks);
+		};
+		// If nothing is currently using the database write lock then write the cemented pending blocks otherwise continue iterating
+		if (write_database_queue.process (nano::writer::confirmation_height))
+		{
+			auto scoped_write_guard = write_database_queue.pop ();
+			write ();
+		}
+		else if (wait_a)
 		{
-			const auto & pending = pending_writes.front ();
-			const auto & account = pending.account;
+			auto scoped_write_guard = write_database_queue.wait (nano::writer::confirmation_height);
+			write ();
+		}
+	}
+	if (!error && !cemented_blocks.empty ())
+	{
+		notify_observers_callback (cemented_blocks);
+	}
+	return error;
+}
 
-			auto write_confirmation_height = [&account, &ledger = ledger, &transaction](uint64_t num_blocks_cemented, uint64_t confirmation_height, nano::block_hash const & confirmed_frontier) {
+bool nano::confirmation_height_bounded::write_pending (nano::write_transaction const & transaction_a, std::function<void(std::vector<std::shared_ptr<nano::block>> const &)> const & flush_a, std::vector<std::shared_ptr<nano::block>> & cemented_blocks)
+{
+	// Cement all pending entries, each entry is specific to an account and contains the least amount
+	// of blocks to retain consistent cementing across all account chains to genesis.
+	while (!pending_writes.empty ())
+	{
+		const auto & pending = pending_writes.front ();
+		const auto & account = pending.account;
+
+		auto write_confirmation_height = [&account, &ledger = ledger, &transaction_a](uint64_t num_blocks_cemented, uint64_t confirmation_height, nano::block_hash const & confirmed_frontier) {
 #ifndef NDEBUG
-				// Extra debug checks
-				nano::confirmation_height_info confirmation_height_info;
-				debug_assert (!ledger.store.confirmation_height_get (transaction, account, confirmation_height_info));
-				auto block (ledger.store.block_get (transaction, confirmed_frontier));
-				debug_assert (block != nullptr);
-				debug_assert (block->sideband ().height == confirmation_height_info.height + num_blocks_cemented);
+			// Extra debug checks
+			nano::confirmation_height_info confirmation_height_info;
+			debug_assert (!ledger.store.confirmation_height_get (transaction_a, account, confirmation_height_info));
+			auto block (ledger.store.block_get (transaction_a, confirmed_frontier));
+			debug_assert (block != nullptr);
+			debug_assert (block->sideband ().height == confirmation_height_info.height + num_blocks_cemented);
 #endif
-				ledger.store.confirmation_height_put (transaction, account, nano::confirmation_height_info{ confirmation_height, confirmed_frontier });
-				ledger.cache.cemented_count += num_blocks_cemented;
-				ledger.stats.add (nano::stat::type::confirmation_height, nano::stat::detail::blocks_confirmed, nano::stat::dir::in, num_blocks_cemented);
-				ledger.stats.add (nano::stat::type::confirmation_height, nano::stat::detail::blocks_confirmed_bounded, nano::stat::dir::in, num_blocks_cemented);
-			};
+			ledger.store.confirmation_height_put (transaction_a, account, nano::confirmation_height_info{ confirmation_height, confirmed_frontier });
+			ledger.cache.cemented_count += num_blocks_cemented;
+			ledger.stats.add (nano::stat::type::confirmation_height, nano::stat::detail::blocks_confirmed, nano::stat::dir::in, num_blocks_cemented);
+			ledger.stats.add (nano::stat::type::confirmation_height, nano::stat::detail::blocks_confirmed_bounded, nano::stat::dir::in, num_blocks_cemented);
+		};
 
-			nano::confirmation_height_info confirmation_height_info;
-			release_assert (!ledger.store.confirmation_height_get (transaction, pending.account, confirmation_height_info));
+		nano::confirmation_height_info confirmation_height_info;
+		release_assert (!ledger.store.confirmation_height_get (transaction_a, pending.account, confirmation_height_info));
 
-			// Some blocks need to be cemented at least
-			if (pending.top_height > confirmation_height_info.height)
+		// Some blocks need to be cemented at least
+		if (pending.top_height > confirmation_height_info.height)
+		{
+			// The highest hash which will be cemented
+			nano::block_hash new_cemented_frontier;
+			uint64_t num_blocks_confirmed = 0;
+			uint64_t start_height = 0;
+			if (pending.bottom_height > confirmation_height_info.height)
 			{
-				// The highest hash which will be cemented
-				nano::block_hash new_cemented_frontier;
-				uint64_t num_blocks_confirmed = 0;
-				uint64_t start_height = 0;
-				if (pending.bottom_height > confirmation_height_info.height)
-				{
-					new_cemented_frontier = pending.bottom_hash;
-					// If we are higher than the cemented frontier, we should be exactly 1 block above
-					debug_assert (pending.bottom_height == confirmation_height_info.height + 1);
-					num_blocks_confirmed = pending.top_height - pending.bottom_height + 1;
-					start_height = pending.bottom_height;
-				}
-				else
+				new_cemented_frontier = pending.bottom_hash;
+				// If we are higher than the cemented frontier, we should be exactly 1 block above
+				debug_assert (pending.bottom_height == confirmation_height_info.height + 1);
+				num_blocks_confirmed = pending.top_height - pending.bottom_height + 1;
+				start_height = pending.bottom_height;
+			}
+			else
+			{
+				new_cemented_frontier = ledger.store.block_hash_at_height (transaction_a, account, confirmation_height_info.height + 1);
+				if (new_cemented_frontier.is_zero ())
 				{
-					auto block = ledger.store.block_get (transaction, confirmation_height_info.frontier);
+					auto block = ledger.store.block_get (transaction_a, confirmation_height_info.frontier);
 					new_cemented_frontier = block->sideband ().successor;
-					num_blocks_confirmed = pending.top_height - confirmation_height_info.height;
-					start_height = confirmation_height_info.height + 1;
 				}
+				num_blocks_confirmed = pending.top_height - confirmation_height_info.height;
+				start_height = confirmation_height_info.height + 1;
+			}
 
-				auto total_blocks_cemented = 0;
-				auto num_blocks_iterated = 0;
+			auto total_blocks_cemented = 0;
+			auto num_blocks_iterated = 0;
 
-				auto block = ledger.store.block_get (transaction, new_cemented_frontier);
+			auto block = ledger.store.block_get (transaction_a, new_cemented_frontier);
 
-				// Cementing starts from the bottom of the chain and works upwards. This is because chains can have effectively
-				// an infinite number of send/change blocks in a row. We don't want to hold the write transaction open for too long.
-				for (; num_blocks_confirmed - num_blocks_iterated != 0; ++num_blocks_iterated)
+			// Cementing starts from the bottom of the chain and works upwards. This is because chains can have effectively
+			// an infinite number of send/change blocks in a row. We don't want to hold the write transaction open for too long.
+			for (; num_blocks_confirmed - num_blocks_iterated != 0; ++num_blocks_iterated)
+			{
+				if (!block)
 				{
-					if (!block)
-					{
-						logger.always_log ("Failed to write confirmation height for: ", new_cemented_frontier.to_string ());
-						ledger.stats.inc (nano::stat::type::confirmation_height, nano::stat::detail::invalid_block);
-						pending_writes.clear ();
-						pending_writes_size = 0;
-						return true;
-					}
-
-					cemented_blocks.emplace_back (block);
-
-					// We have likely hit a long chain, flush these callbacks and continue
-					if (cemented_blocks.size () == confirmation_height::batch_write_size)
-					{
-						auto num_blocks_cemented = num_blocks_iterated - total_blocks_cemented + 1;
-						total_blocks_cemented += num_blocks_cemented;
-						write_confirmation_height (num_blocks_cemented, start_height + total_blocks_cemented - 1, new_cemented_frontier);
-						transaction.commit ();
-						notify_observers_callback (cemented_blocks);
-						cemented_blocks.clear ();
-						transaction.renew ();
-					}
-
-					// Get the next block in the chain until we have reached the final desired one
-					auto last_iteration = (num_blocks_confirmed - num_blocks_iterated) == 1;
-					if (!last_iteration)
-					{
-						new_cemented_frontier = block->sideband ().successor;
-						block = ledger.store.block_get (transaction, new_cemented_frontier);
-					}
-					else
-					{
-						// Confirm it is indeed the last one
-						debug_assert (new_cemented_frontier == pending.top_hash);
-					}
+					logger.always_log ("Failed to write confirmation height for: ", new_cemented_frontier.to_string ());
+					ledger.stats.inc (nano::stat::type::confirmation_height, nano::stat::detail::invalid_block);
+					pending_writes.clear ();
+					pending_writes_size = 0;
+					return true;
 				}
 
-				auto num_blocks_cemented = num_blocks_confirmed - total_blocks_cemented;
-				write_confirmation_height (num_blocks_cemented, pending.top_height, new_cemented_frontier);
-			}
+				cemented_blocks.emplace_back (block);
 
-			auto it = accounts_confirmed_info.find (pending.account);
-			if (it != accounts_confirmed_info.cend () && it->second.confirmed_height == pending.top_height)
-			{
-				accounts_confirmed_info.erase (pending.account);
-				accounts_confirmed_info_size = accounts_confirmed_info.size ();
+				// We have likely hit a long chain, flush these callbacks and continue
+				if (cemented_blocks.size () == confirmation_height::batch_write_size)
+				{
+					auto num_blocks_cemented = num_blocks_iterated - total_blocks_cemented + 1;
+					total_blocks_cemented += num_blocks_cemented;
+					write_confirmation_height (num_blocks_cemented, start_height + total_blocks_cemented - 1, new_cemented_frontier);
+					flush_a (cemented_blocks);
+					cemented_blocks.clear ();
+				}
+
+				// Get the next block in the chain until we have reached the final desired one
+				auto last_iteration = (num_blocks_confirmed - num_blocks_iterated) == 1;
+				if (!last_iteration)
+				{
+					new_cemented_frontier = block->sideband ().successor;
+					block = ledger.store.block_get (transaction_a, new_cemented_frontier);
+				}
+				else
+				{
+					// Confirm it is indeed the last one
+					debug_assert (new_cemented_frontier == pending.top_hash);
+				}
 			}
-			pending_writes.pop_front ();
-			--pending_writes_size;
+
+			auto num_blocks_cemented = num_blocks_confirmed - total_blocks_cemented;
+			write_confirmation_height (num_blocks_cemented, pending.top_height, new_cemented_frontier);
 		}
-	}
 
-	notify_observers_callback (cemented_blocks);
+		auto it = accounts_confirmed_info.find (pending.account);
+		if (it != accounts_confirmed_info.cend () && it->second.confirmed_height == pending.top_height)
+		{
+			accounts_confirmed_info.erase (pending.account);
+			accounts_confirmed_info_size = accounts_confirmed_info.size ();
+		}
+		pending_writes.pop_front ();
+		--pending_writes_size;
+	}
 
 	debug_assert (pending_writes.empty ());
 	debug_assert (pending_writes_size == 0);
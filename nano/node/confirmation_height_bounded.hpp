@@ -11,15 +11,22 @@ class ledger;
 class read_transaction;
 class logger_mt;
 class write_database_queue;
+class write_batcher;
+class write_transaction;
 
 class confirmation_height_bounded final
 {
 public:
-	confirmation_height_bounded (nano::ledger &, nano::write_database_queue &, std::chrono::milliseconds, nano::logger_mt &, std::atomic<bool> &, nano::block_hash const &, std::function<void(std::vector<std::shared_ptr<nano::block>> const &)> const &, std::function<void(nano::block_hash const &)> const &, std::function<uint64_t ()> const &);
+	confirmation_height_bounded (nano::ledger &, nano::write_database_queue &, nano::write_batcher &, std::chrono::milliseconds, nano::logger_mt &, std::atomic<bool> &, nano::block_hash const &, std::function<void(std::vector<std::shared_ptr<nano::block>> const &)> const &, std::function<void(nano::block_hash const &)> const &, std::function<uint64_t ()> const &);
 	bool pending_empty () const;
 	void prepare_new ();
 	void process ();
-	bool cement_blocks ();
+	/**
+	 * Writes the pending confirmation heights, returns true if a block to cement wasn't found. With \p wait_a, writes of up to confirmation_height::batch_write_size blocks
+	 * block until they share a commit through the write batcher and larger ones wait for the write lock. Without \p wait_a nothing blocks: the writes are committed
+	 * in their own transaction if the write lock is free, otherwise they stay pending and iterating continues
+	 */
+	bool cement_blocks (bool wait_a);
 
 private:
 	class top_and_next_hash final
@@ -107,9 +114,15 @@ private:
 	nano::block_hash get_least_unconfirmed_hash_from_top_level (nano::transaction const &, nano::block_hash const &, nano::account const &, nano::confirmation_height_info const &, uint64_t &);
 	void prepare_iterated_blocks_for_cementing (preparation_data &);
 	bool iterate (nano::read_transaction const &, uint64_t, nano::block_hash const &, boost::circular_buffer_space_optimized<nano::block_hash> &, nano::block_hash &, nano::block_hash const &, boost::circular_buffer_space_optimized<receive_source_pair> &, nano::account const &);
+	/**
+	 * Writes the pending confirmation heights in \p transaction_a. Every confirmation_height::batch_write_size blocks \p flush_a is called with the blocks cemented so far,
+	 * the remaining ones are left in \p cemented_blocks_a
+	 */
+	bool write_pending (nano::write_transaction const & transaction_a, std::function<void(std::vector<std::shared_ptr<nano::block>> const &)> const & flush_a, std::vector<std::shared_ptr<nano::block>> & cemented_blocks_a);
 
 	nano::ledger & ledger;
 	nano::write_database_queue & write_database_queue;
+	nano::write_batcher & write_batcher;
 	std::chrono::milliseconds batch_separate_pending_min_time;
 	nano::logger_mt & logger;
 	std::atomic<bool> & stopped;
@@ -1,5 +1,6 @@
 #include <nano/lib/logger_mt.hpp>
 #include <nano/lib/numbers.hpp>
+#include <nano/lib/stats.hpp>
 #include <nano/lib/threading.hpp>
 #include <nano/lib/utility.hpp>
 #include <nano/node/confirmation_height_processor.hpp>
@@ -11,12 +12,15 @@
 
 #include <numeric>
 
-nano::confirmation_height_processor::confirmation_height_processor (nano::ledger & ledger_a, nano::write_database_queue & write_database_queue_a, std::chrono::milliseconds batch_separate_pending_min_time_a, nano::logger_mt & logger_a, boost::latch & latch, confirmation_height_mode mode_a) :
+size_t constexpr nano::confirmation_height_processor::prefetch_ahead;
+size_t constexpr nano::confirmation_height_processor::prefetch_blocks_max;
+
+nano::confirmation_height_processor::confirmation_height_processor (nano::ledger & ledger_a, nano::write_database_queue & write_database_queue_a, nano::write_batcher & write_batcher_a, std::chrono::milliseconds batch_separate_pending_min_time_a, nano::logger_mt & logger_a, boost::latch & latch, confirmation_height_mode mode_a, unsigned prefetch_threads_a) :
 ledger (ledger_a),
 write_database_queue (write_database_queue_a),
 // clang-format off
-confirmation_height_unbounded_processor (ledger_a, write_database_queue_a, batch_separate_pending_min_time_a, logger_a, stopped, original_hash, [this](auto & cemented_blocks) { this->notify_observers (cemented_blocks); }, [this](auto const & block_hash_a) { this->notify_observers (block_hash_a); }, [this]() { return this->awaiting_processing_size (); }),
-confirmation_height_bounded_processor (ledger_a, write_database_queue_a, batch_separate_pending_min_time_a, logger_a, stopped, original_hash, [this](auto & cemented_blocks) { this->notify_observers (cemented_blocks); }, [this](auto const & block_hash_a) { this->notify_observers (block_hash_a); }, [this]() { return this->awaiting_processing_size (); }),
+confirmation_height_unbounded_processor (ledger_a, write_database_queue_a, write_batcher_a, batch_separate_pending_min_time_a, logger_a, stopped, original_hash, [this](auto & cemented_blocks) { this->notify_observers (cemented_blocks); }, [this](auto const & block_hash_a) { this->notify_observers (block_hash_a); }, [this]() { return this->awaiting_processing_size (); }),
+confirmation_height_bounded_processor (ledger_a, write_database_queue_a, write_batcher_a, batch_separate_pending_min_time_a, logger_a, stopped, original_hash, [this](auto & cemented_blocks) { this->notify_observers (cemented_blocks); }, [this](auto const & block_hash_a) { this->notify_observers (block_hash_a); }, [this]() { return this->awaiting_processing_size (); }),
 // clang-format on
 thread ([this, &latch, mode_a]() {
 	nano::thread_role::set (nano::thread_role::name::confirmation_height_processing);
@@ -25,6 +29,13 @@ thread ([this, &latch, mode_a]() {
 	this->run (mode_a);
 })
 {
+	for (auto i (0u); i < prefetch_threads_a; ++i)
+	{
+		prefetch_threads.emplace_back ([this]() {
+			nano::thread_role::set (nano::thread_role::name::confirmation_height_prefetch);
+			this->prefetch_run ();
+		});
+	}
 }
 
 nano::confirmation_height_processor::~confirmation_height_processor ()
@@ -39,10 +50,18 @@ void nano::confirmation_height_processor::stop ()
 		stopped = true;
 	}
 	condition.notify_one ();
+	prefetch_condition.notify_all ();
 	if (thread.joinable ())
 	{
 		thread.join ();
 	}
+	for (auto & prefetch_thread : prefetch_threads)
+	{
+		if (prefetch_thread.joinable ())
+		{
+			prefetch_thread.join ();
+		}
+	}
 }
 
 void nano::confirmation_height_processor::run (confirmation_height_mode mode_a)
@@ -104,15 +123,13 @@ void nano::confirmation_height_processor::run (confirmation_height_mode mode_a)
 				if (!confirmation_height_bounded_processor.pending_empty ())
 				{
 					debug_assert (confirmation_height_unbounded_processor.pending_empty ());
-					auto scoped_write_guard = write_database_queue.wait (nano::writer::confirmation_height);
-					confirmation_height_bounded_processor.cement_blocks ();
+					confirmation_height_bounded_processor.cement_blocks (true);
 					lock_and_cleanup ();
 				}
 				else if (!confirmation_height_unbounded_processor.pending_empty ())
 				{
 					debug_assert (confirmation_height_bounded_processor.pending_empty ());
-					auto scoped_write_guard = write_database_queue.wait (nano::writer::confirmation_height);
-					confirmation_height_unbounded_processor.cement_blocks ();
+					confirmation_height_unbounded_processor.cement_blocks (true);
 					lock_and_cleanup ();
 				}
 				else
@@ -150,7 +167,13 @@ void nano::confirmation_height_processor::add (nano::block_hash const & hash_a)
 {
 	{
 		nano::lock_guard<std::mutex> lk (mutex);
-		awaiting_processing.insert (hash_a);
+		auto inserted (awaiting_processing.get<tag_sequence> ().push_back (hash_a).second);
+		// Reading ahead starts as soon as a hash is among the next ones to be processed, even while paused or busy with a long chain
+		if (inserted && !prefetch_threads.empty () && awaiting_processing.size () <= prefetch_ahead && prefetch_requested.insert (hash_a).second)
+		{
+			prefetch_queue.push_back (hash_a);
+			prefetch_condition.notify_one ();
+		}
 	}
 	condition.notify_one ();
 }
@@ -159,9 +182,97 @@ void nano::confirmation_height_processor::set_next_hash ()
 {
 	nano::lock_guard<std::mutex> guard (mutex);
 	debug_assert (!awaiting_processing.empty ());
-	original_hash = *awaiting_processing.begin ();
+	original_hash = awaiting_processing.get<tag_sequence> ().front ();
 	original_hashes_pending.insert (original_hash);
-	awaiting_processing.erase (original_hash);
+	awaiting_processing.get<tag_sequence> ().pop_front ();
+	prefetch_requested.erase (original_hash);
+	if (!prefetch_threads.empty () && request_prefetch ())
+	{
+		prefetch_condition.notify_all ();
+	}
+}
+
+bool nano::confirmation_height_processor::request_prefetch ()
+{
+	debug_assert (!mutex.try_lock ());
+	// Hashes are processed in the order they were added, so the front of awaiting_processing holds the next ones
+	auto result (false);
+	auto const & sequenced (awaiting_processing.get<tag_sequence> ());
+	size_t position (0);
+	for (auto i (sequenced.begin ()), n (sequenced.end ()); i != n && position < prefetch_ahead; ++i, ++position)
+	{
+		if (prefetch_requested.insert (*i).second)
+		{
+			prefetch_queue.push_back (*i);
+			result = true;
+		}
+	}
+	return result;
+}
+
+void nano::confirmation_height_processor::prefetch_run ()
+{
+	nano::unique_lock<std::mutex> lk (mutex);
+	while (!stopped)
+	{
+		if (!prefetch_queue.empty ())
+		{
+			auto hash (prefetch_queue.front ());
+			prefetch_queue.pop_front ();
+			// Skip hashes which have been taken for processing in the meantime
+			if (prefetch_requested.find (hash) != prefetch_requested.end ())
+			{
+				lk.unlock ();
+				prefetch (hash);
+				lk.lock ();
+			}
+		}
+		else
+		{
+			prefetch_condition.wait (lk);
+		}
+	}
+}
+
+void nano::confirmation_height_processor::prefetch (nano::block_hash const & hash_a)
+{
+	// Reads the same uncemented blocks that cementing hash_a will read: each account chain down to its confirmation height and the sources of its receives
+	auto transaction (ledger.store.tx_begin_read ());
+	std::vector<nano::block_hash> chains{ hash_a };
+	std::unordered_set<nano::block_hash> visited{ hash_a };
+	size_t count (0);
+	while (!chains.empty () && count < prefetch_blocks_max && !stopped)
+	{
+		auto block (ledger.store.block_get (transaction, chains.back ()));
+		chains.pop_back ();
+		if (block != nullptr)
+		{
+			nano::account account (block->account ());
+			if (account.is_zero ())
+			{
+				account = block->sideband ().account;
+			}
+			nano::confirmation_height_info confirmation_height_info;
+			ledger.store.confirmation_height_get (transaction, account, confirmation_height_info);
+			while (block != nullptr && block->sideband ().height > confirmation_height_info.height && count < prefetch_blocks_max)
+			{
+				++count;
+				// The link of a state send is an account, looking it up as a block only misses
+				auto source (block->source ());
+				if (source.is_zero () && block->type () == nano::block_type::state)
+				{
+					source = block->link ();
+				}
+				if (!source.is_zero () && !ledger.is_epoch_link (source) && visited.insert (source).second)
+				{
+					chains.push_back (source);
+				}
+				auto previous (block->previous ());
+				block = previous.is_zero () ? nullptr : ledger.store.block_get (transaction, previous);
+			}
+		}
+	}
+	ledger.stats.add (nano::stat::type::confirmation_height, nano::stat::detail::blocks_prefetched, nano::stat::dir::in, count);
 }
 
 // Not thread-safe, only call before this processor has begun cementing
@@ -204,6 +315,12 @@ std::unique_ptr<nano::container_info_component> nano::collect_container_info (co
 	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "cemented_observers", cemented_observers_count, sizeof (decltype (confirmation_height_processor_a.cemented_observers)::value_type) }));
 	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "block_already_cemented_observers", block_already_cemented_observers_count, sizeof (decltype (confirmation_height_processor_a.block_already_cemented_observers)::value_type) }));
 	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "awaiting_processing", confirmation_height_processor_a.awaiting_processing_size (), sizeof (decltype (confirmation_height_processor_a.awaiting_processing)::value_type) }));
+	size_t prefetch_queue_count;
+	{
+		nano::lock_guard<std::mutex> guard (confirmation_height_processor_a.mutex);
+		prefetch_queue_count = confirmation_height_processor_a.prefetch_queue.size ();
+	}
+	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "prefetch_queue", prefetch_queue_count, sizeof (decltype (confirmation_height_processor_a.prefetch_queue)::value_type) }));
 	composite->add_component (collect_container_info (confirmation_height_processor_a.confirmation_height_bounded_processor, "bounded_processor"));
 	composite->add_component (collect_container_info (confirmation_height_processor_a.confirmation_height_unbounded_processor, "unbounded_processor"));
 	return composite;
@@ -218,7 +335,7 @@ size_t nano::confirmation_height_processor::awaiting_processing_size ()
 bool nano::confirmation_height_processor::is_processing_block (nano::block_hash const & hash_a)
 {
 	nano::lock_guard<std::mutex> guard (mutex);
-	return original_hashes_pending.find (hash_a) != original_hashes_pending.cend () || awaiting_processing.find (hash_a) != awaiting_processing.cend ();
+	return original_hashes_pending.find (hash_a) != original_hashes_pending.cend () || awaiting_processing.get<tag_hash> ().find (hash_a) != awaiting_processing.get<tag_hash> ().cend ();
 }
 
 nano::block_hash nano::confirmation_height_processor::current ()
@@ -6,7 +6,13 @@
 #include <nano/secure/blockstore.hpp>
 #include <nano/secure/common.hpp>
 
+#include <boost/multi_index/hashed_index.hpp>
+#include <boost/multi_index/identity.hpp>
+#include <boost/multi_index/sequenced_index.hpp>
+#include <boost/multi_index_container.hpp>
+
 #include <condition_variable>
+#include <deque>
 #include <mutex>
 #include <thread>
 #include <unordered_set>
@@ -20,11 +26,12 @@ namespace nano
 class ledger;
 class logger_mt;
 class write_database_queue;
+class write_batcher;
 
 class confirmation_height_processor final
 {
 public:
-	confirmation_height_processor (nano::ledger &, nano::write_database_queue &, std::chrono::milliseconds, nano::logger_mt &, boost::latch & initialized_latch, confirmation_height_mode = confirmation_height_mode::automatic);
+	confirmation_height_processor (nano::ledger &, nano::write_database_queue &, nano::write_batcher &, std::chrono::milliseconds, nano::logger_mt &, boost::latch & initialized_latch, confirmation_height_mode = confirmation_height_mode::automatic, unsigned prefetch_threads = 0);
 	~confirmation_height_processor ();
 	void pause ();
 	void unpause ();
@@ -38,10 +45,26 @@ public:
 	void add_cemented_observer (std::function<void(std::shared_ptr<nano::block>)> const &);
 	void add_block_already_cemented_observer (std::function<void(nano::block_hash const &)> const &);
 
+	/** Number of awaiting hashes whose dependencies are read ahead of processing */
+	static size_t constexpr prefetch_ahead{ 64 };
+	/** Maximum number of uncemented blocks read for one hash */
+	static size_t constexpr prefetch_blocks_max{ 16 * 1024 };
+
 private:
 	std::mutex mutex;
-	// Hashes which have been added to the confirmation height processor, but not yet processed
-	std::unordered_set<nano::block_hash> awaiting_processing;
+	class tag_sequence
+	{
+	};
+	class tag_hash
+	{
+	};
+	// Hashes which have been added to the confirmation height processor, but not yet processed. They're processed in the order they were added
+	boost::multi_index_container<nano::block_hash,
+	boost::multi_index::indexed_by<
+	boost::multi_index::sequenced<boost::multi_index::tag<tag_sequence>>,
+	boost::multi_index::hashed_unique<boost::multi_index::tag<tag_hash>,
+	boost::multi_index::identity<nano::block_hash>>>>
+	awaiting_processing;
 	// Hashes which have been added and processed, but have not been cemented
 	std::unordered_set<nano::block_hash> original_hashes_pending;
 	bool paused{ false };
@@ -51,6 +74,11 @@ private:
 
 	nano::condition_variable condition;
 	std::atomic<bool> stopped{ false };
+	/** Awaiting hashes queued for the prefetch threads, which walk their uncemented dependencies with their own read transactions so the processing thread finds the blocks in memory */
+	std::deque<nano::block_hash> prefetch_queue;
+	/** Awaiting hashes which have been queued for prefetching, always among the first prefetch_ahead of awaiting_processing */
+	std::unordered_set<nano::block_hash> prefetch_requested;
+	nano::condition_variable prefetch_condition;
 	std::vector<std::function<void(std::shared_ptr<nano::block>)>> cemented_observers;
 	std::vector<std::function<void(nano::block_hash const &)>> block_already_cemented_observers;
 
@@ -59,8 +87,13 @@ private:
 	confirmation_height_unbounded confirmation_height_unbounded_processor;
 	confirmation_height_bounded confirmation_height_bounded_processor;
 	std::thread thread;
+	std::vector<std::thread> prefetch_threads;
 
 	void set_next_hash ();
+	/** Queues the first prefetch_ahead awaiting hashes which haven't been queued yet, returns true if any were. Requires mutex to be held */
+	bool request_prefetch ();
+	void prefetch_run ();
+	void prefetch (nano::block_hash const &);
 	void notify_observers (std::vector<std::shared_ptr<nano::block>> const &);
 	void notify_observers (nano::block_hash const &);
 
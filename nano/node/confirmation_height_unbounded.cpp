@@ -5,9 +5,10 @@
 
 #include <numeric>
 
-nano::confirmation_height_unbounded::confirmation_height_unbounded (nano::ledger & ledger_a, nano::write_database_queue & write_database_queue_a, std::chrono::milliseconds batch_separate_pending_min_time_a, nano::logger_mt & logger_a, std::atomic<bool> & stopped_a, nano::block_hash const & original_hash_a, std::function<void(std::vector<std::shared_ptr<nano::block>> const &)> const & notify_observers_callback_a, std::function<void(nano::block_hash const &)> const & notify_block_already_cemented_observers_callback_a, std::function<uint64_t ()> const & awaiting_processing_size_callback_a) :
+nano::confirmation_height_unbounded::confirmation_height_unbounded (nano::ledger & ledger_a, nano::write_database_queue & write_database_queue_a, nano::write_batcher & write_batcher_a, std::chrono::milliseconds batch_separate_pending_min_time_a, nano::logger_mt & logger_a, std::atomic<bool> & stopped_a, nano::block_hash const & original_hash_a, std::function<void(std::vector<std::shared_ptr<nano::block>> const &)> const & notify_observers_callback_a, std::function<void(nano::block_hash const &)> const & notify_block_already_cemented_observers_callback_a, std::function<uint64_t ()> const & awaiting_processing_size_callback_a) :
 ledger (ledger_a),
 write_database_queue (write_database_queue_a),
+write_batcher (write_batcher_a),
 batch_separate_pending_min_time (batch_separate_pending_min_time_a),
 logger (logger_a),
 stopped (stopped_a),
@@ -135,15 +136,11 @@ void nano::confirmation_height_unbounded::process ()
 
 		if ((max_write_size_reached || should_output) && !pending_writes.empty ())
 		{
-			if (write_database_queue.process (nano::writer::confirmation_height))
+			auto error = cement_blocks (false);
+			// Don't set any more blocks as confirmed from the original hash if an inconsistency is found
+			if (error)
 			{
-				auto scoped_write_guard = write_database_queue.pop ();
-				auto error = cement_blocks ();
-				// Don't set any more blocks as confirmed from the original hash if an inconsistency is found
-				if (error)
-				{
-					break;
-				}
+				break;
 			}
 		}
 
@@ -307,25 +304,72 @@ void nano::confirmation_height_unbounded::prepare_iterated_blocks_for_cementing
 /*
  * Returns true if there was an error in finding one of the blocks to write a confirmation height for, false otherwise
  */
-bool nano::confirmation_height_unbounded::cement_blocks ()
+bool nano::confirmation_height_unbounded::cement_blocks (bool wait_a)
+{
+	auto total_pending_write_block_count = std::accumulate (pending_writes.cbegin (), pending_writes.cend (), uint64_t (0), [](uint64_t total, conf_height_details const & receive_details_a) {
+		return total += receive_details_a.num_blocks_confirmed;
+	});
+
+	auto error (false);
+	auto written (false);
+	// A write lock request left queued by an earlier attempt without waiting is taken up below, the write batcher could be queued behind it
+	if (wait_a && total_pending_write_block_count <= confirmation_height::batch_write_size && !write_database_queue.contains (nano::writer::confirmation_height))
+	{
+		// Blocks until it shares the commit of the writer holding the write lock, or until the write batcher has committed it
+		std::vector<std::vector<std::shared_ptr<nano::block>>> cemented;
+		written = !write_batcher.apply_sync (nano::writer::confirmation_height, [this, &error, &cemented](nano::write_transaction const & transaction_a) {
+			error = write_pending (transaction_a, [&cemented](auto const & cemented_blocks_a) {
+				cemented.push_back (cemented_blocks_a);
+			});
+		});
+		for (auto const & cemented_blocks : cemented)
+		{
+			notify_observers_callback (cemented_blocks);
+		}
+	}
+	if (!written)
+	{
+		auto write = [this, &error]() {
+			auto transaction (ledger.store.tx_begin_write ({}, { nano::tables::confirmation_height }));
+			error = write_pending (transaction, [this, &transaction](auto const & cemented_blocks_a) {
+				transaction.commit ();
+				notify_observers_callback (cemented_blocks_a);
+				transaction.renew ();
+			});
+		};
+		// If nothing is currently using the database write lock then write the cemented pending blocks otherwise continue iterating
+		if (write_database_queue.process (nano::writer::confirmation_height))
+		{
+			auto scoped_write_guard = write_database_queue.pop ();
+			write ();
+		}
+		else if (wait_a)
+		{
+			auto scoped_write_guard = write_database_queue.wait (nano::writer::confirmation_height);
+			write ();
+		}
+	}
+	return error;
+}
+
+bool nano::confirmation_height_unbounded::write_pending (nano::write_transaction const & transaction_a, std::function<void(std::vector<std::shared_ptr<nano::block>> const &)> const & cemented_a)
 {
 	auto total_pending_write_block_count = std::accumulate (pending_writes.cbegin (), pending_writes.cend (), uint64_t (0), [](uint64_t total, conf_height_details const & receive_details_a) {
 		return total += receive_details_a.num_blocks_confirmed;
 	});
 
-	auto transaction (ledger.store.tx_begin_write ({}, { nano::tables::confirmation_height }));
 	while (!pending_writes.empty ())
 	{
 		auto & pending = pending_writes.front ();
 		nano::confirmation_height_info confirmation_height_info;
-		auto error = ledger.store.confirmation_height_get (transaction, pending.account, confirmation_height_info);
+		auto error = ledger.store.confirmation_height_get (transaction_a, pending.account, confirmation_height_info);
 		release_assert (!error);
 		auto confirmation_height = confirmation_height_info.height;
 		if (pending.height > confirmation_height)
 		{
 #ifndef NDEBUG
 			// Do more thorough checking in Debug mode, indicates programming error.
-			auto block = ledger.store.block_get (transaction, pending.hash);
+			auto block = ledger.store.block_get (transaction_a, pending.hash);
 			static nano::network_constants network_constants;
 			debug_assert (network_constants.is_test_network () || block != nullptr);
 			debug_assert (network_constants.is_test_network () || block->sideband ().height == pending.height);
@@ -343,9 +387,8 @@ bool nano::confirmation_height_unbounded::cement_blocks ()
 			debug_assert (pending.num_blocks_confirmed == pending.height - confirmation_height);
 			confirmation_height = pending.height;
 			ledger.cache.cemented_count += pending.num_blocks_confirmed;
-			ledger.store.confirmation_height_put (transaction, pending.account, { confirmation_height, pending.hash });
+			ledger.store.confirmation_height_put (transaction_a, pending.account, { confirmation_height, pending.hash });
 
-			transaction.commit ();
 			// Reverse it so that the callbacks start from the lowest newly cemented block and move upwards
 			std::reverse (pending.block_callback_data.begin (), pending.block_callback_data.end ());
 
@@ -356,8 +399,7 @@ bool nano::confirmation_height_unbounded::cement_blocks ()
 				return block_cache.at (hash_a);
 			});
 
-			notify_observers_callback (callback_data);
-			transaction.renew ();
+			cemented_a (callback_data);
 		}
 		total_pending_write_block_count -= pending.num_blocks_confirmed;
 		pending_writes.erase (pending_writes.begin ());
@@ -12,15 +12,22 @@ class ledger;
 class read_transaction;
 class logger_mt;
 class write_database_queue;
+class write_batcher;
+class write_transaction;
 
 class confirmation_height_unbounded final
 {
 public:
-	confirmation_height_unbounded (nano::ledger &, nano::write_database_queue &, std::chrono::milliseconds, nano::logger_mt &, std::atomic<bool> &, nano::block_hash const &, std::function<void(std::vector<std::shared_ptr<nano::block>> const &)> const &, std::function<void(nano::block_hash const &)> const &, std::function<uint64_t ()> const &);
+	confirmation_height_unbounded (nano::ledger &, nano::write_database_queue &, nano::write_batcher &, std::chrono::milliseconds, nano::logger_mt &, std::atomic<bool> &, nano::block_hash const &, std::function<void(std::vector<std::shared_ptr<nano::block>> const &)> const &, std::function<void(nano::block_hash const &)> const &, std::function<uint64_t ()> const &);
 	bool pending_empty () const;
 	void prepare_new ();
 	void process ();
-	bool cement_blocks ();
+	/**
+	 * Writes the pending confirmation heights, returns true if a block to cement wasn't found. With \p wait_a, writes of up to confirmation_height::batch_write_size blocks
+	 * block until they share a commit through the write batcher and larger ones wait for the write lock. Without \p wait_a nothing blocks: the writes are committed
+	 * in their own transaction if the write lock is free, otherwise they stay pending and iterating continues
+	 */
+	bool cement_blocks (bool wait_a);
 
 private:
 	class confirmed_iterated_pair
@@ -83,9 +90,12 @@ private:
 
 	void collect_unconfirmed_receive_and_sources_for_account (uint64_t, uint64_t, nano::block_hash const &, nano::account const &, nano::read_transaction const &, std::vector<receive_source_pair> &, std::vector<nano::block_hash> &);
 	void prepare_iterated_blocks_for_cementing (preparation_data &);
+	/** Writes the pending confirmation heights in \p transaction_a, calling \p cemented_a with the blocks of each account written */
+	bool write_pending (nano::write_transaction const & transaction_a, std::function<void(std::vector<std::shared_ptr<nano::block>> const &)> const & cemented_a);
 
 	nano::ledger & ledger;
 	nano::write_database_queue & write_database_queue;
+	nano::write_batcher & write_batcher;
 	std::chrono::milliseconds batch_separate_pending_min_time;
 	nano::logger_mt & logger;
 	std::atomic<bool> & stopped;
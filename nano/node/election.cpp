@@ -367,6 +367,7 @@ void nano::election::confirm_if_quorum ()
 		}
 		node.block_processor.force (block_l);
 		status.winner = block_l;
+		++node.active.generation;
 		update_dependent ();
 		node.active.add_adjust_difficulty (winner_hash_l);
 	}
@@ -478,6 +479,7 @@ bool nano::election::publish (std::shared_ptr<nano::block> block_a)
 			if (status.winner->hash () == block_a->hash ())
 			{
 				status.winner = block_a;
+				++node.active.generation;
 			}
 		}
 	}
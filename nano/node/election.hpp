@@ -99,7 +99,7 @@ public:
 	std::unordered_map<nano::block_hash, std::shared_ptr<nano::block>> blocks;
 	std::chrono::steady_clock::time_point election_start = { std::chrono::steady_clock::now () };
 	nano::election_status status;
-	unsigned confirmation_request_count{ 0 };
+	std::atomic<unsigned> confirmation_request_count{ 0 };
 	std::unordered_map<nano::block_hash, nano::uint128_t> last_tally;
 	std::unordered_set<nano::block_hash> dependent_blocks;
 	std::chrono::seconds late_blocks_delay{ 5 };
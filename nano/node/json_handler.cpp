@@ -853,7 +853,7 @@ void nano::json_handler::accounts_pending ()
 		if (!ec)
 		{
 			boost::property_tree::ptree peers_l;
-			for (auto i (node.store.pending_begin (transaction, nano::pending_key (account, 0))), n (node.store.pending_end ()); i != n && nano::pending_key (i->first).account == account && peers_l.size () < count; ++i)
+			for (auto i (node.store.pending_account_begin (transaction, nano::pending_key (account, 0))), n (node.store.pending_end ()); i != n && nano::pending_key (i->first).account == account && peers_l.size () < count; ++i)
 			{
 				nano::pending_key const & key (i->first);
 				if (block_confirmed (node, transaction, key.hash, include_active, include_only_confirmed))
@@ -1227,7 +1227,7 @@ void nano::json_handler::block_account ()
 void nano::json_handler::block_count ()
 {
 	auto transaction (node.store.tx_begin_read ());
-	response_l.put ("count", std::to_string (node.store.block_count (transaction).sum ()));
+	response_l.put ("count", std::to_string (node.store.block_count (transaction)));
 	response_l.put ("unchecked", std::to_string (node.ledger.cache.unchecked_count));
 	response_l.put ("cemented", std::to_string (node.ledger.cache.cemented_count));
 	response_errors ();
@@ -1236,7 +1236,32 @@ void nano::json_handler::block_count ()
 void nano::json_handler::block_count_type ()
 {
 	auto transaction (node.store.tx_begin_read ());
-	nano::block_counts count (node.store.block_count (transaction));
+	// Blocks of all types share a single table, so counting by type requires a full scan
+	nano::block_counts count;
+	for (auto i (node.store.blocks_begin (transaction)), n (node.store.blocks_end ()); i != n; ++i)
+	{
+		switch (i->second.block->type ())
+		{
+			case nano::block_type::send:
+				++count.send;
+				break;
+			case nano::block_type::receive:
+				++count.receive;
+				break;
+			case nano::block_type::open:
+				++count.open;
+				break;
+			case nano::block_type::change:
+				++count.change;
+				break;
+			case nano::block_type::state:
+				++count.state;
+				break;
+			default:
+				debug_assert (false);
+				break;
+		}
+	}
 	response_l.put ("send", std::to_string (count.send));
 	response_l.put ("receive", std::to_string (count.receive));
 	response_l.put ("open", std::to_string (count.open));
@@ -1761,22 +1786,20 @@ void nano::json_handler::confirmation_active ()
 		announcements = strtoul (announcements_text.get ().c_str (), NULL, 10);
 	}
 	boost::property_tree::ptree elections;
+	auto snapshot (node.active.snapshot ());
+	for (auto const & i : snapshot->elections)
 	{
-		nano::lock_guard<std::mutex> lock (node.active.mutex);
-		for (auto i (node.active.roots.begin ()), n (node.active.roots.end ()); i != n; ++i)
+		if (i.election->confirmation_request_count >= announcements)
 		{
-			if (i->election->confirmation_request_count >= announcements)
+			if (!i.election->confirmed ())
 			{
-				if (!i->election->confirmed ())
-				{
-					boost::property_tree::ptree entry;
-					entry.put ("", i->root.to_string ());
-					elections.push_back (std::make_pair ("", entry));
-				}
-				else
-				{
-					++confirmed;
-				}
+				boost::property_tree::ptree entry;
+				entry.put ("", i.root.to_string ());
+				elections.push_back (std::make_pair ("", entry));
+			}
+			else
+			{
+				++confirmed;
 			}
 		}
 	}
@@ -2564,6 +2587,21 @@ void nano::json_handler::account_history ()
 		bool output_raw (request.get_optional<bool> ("raw") == true);
 		response_l.put ("account", account.to_account ());
 		auto block (node.store.block_get (transaction, hash));
+		if (block != nullptr && offset > 0 && node.store.block_height_index_enabled ())
+		{
+			// Seek past the offset with the height index instead of walking the chain
+			auto height (block->sideband ().height);
+			if (reverse)
+			{
+				hash = offset <= std::numeric_limits<uint64_t>::max () - height ? node.store.block_hash_at_height (transaction, account, height + offset) : nano::block_hash (0);
+			}
+			else
+			{
+				hash = offset < height ? node.store.block_hash_at_height (transaction, account, height - offset) : nano::block_hash (0);
+			}
+			block = node.store.block_get (transaction, hash);
+			offset = 0;
+		}
 		while (block != nullptr && count > 0)
 		{
 			if (offset > 0)
@@ -2936,7 +2974,7 @@ void nano::json_handler::pending ()
 	{
 		boost::property_tree::ptree peers_l;
 		auto transaction (node.store.tx_begin_read ());
-		for (auto i (node.store.pending_begin (transaction, nano::pending_key (account, 0))), n (node.store.pending_end ()); i != n && nano::pending_key (i->first).account == account && peers_l.size () < count; ++i)
+		for (auto i (node.store.pending_account_begin (transaction, nano::pending_key (account, 0))), n (node.store.pending_end ()); i != n && nano::pending_key (i->first).account == account && peers_l.size () < count; ++i)
 		{
 			nano::pending_key const & key (i->first);
 			if (block_confirmed (node, transaction, key.hash, include_active, include_only_confirmed))
@@ -4729,7 +4767,7 @@ void nano::json_handler::wallet_pending ()
 		{
 			nano::account const & account (i->first);
 			boost::property_tree::ptree peers_l;
-			for (auto ii (node.store.pending_begin (block_transaction, nano::pending_key (account, 0))), nn (node.store.pending_end ()); ii != nn && nano::pending_key (ii->first).account == account && peers_l.size () < count; ++ii)
+			for (auto ii (node.store.pending_account_begin (block_transaction, nano::pending_key (account, 0))), nn (node.store.pending_end ()); ii != nn && nano::pending_key (ii->first).account == account && peers_l.size () < count; ++ii)
 			{
 				nano::pending_key key (ii->first);
 				if (block_confirmed (node, block_transaction, key.hash, include_active, include_only_confirmed))
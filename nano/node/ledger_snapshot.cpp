@@ -0,0 +1,624 @@
+#include <nano/crypto/blake2/blake2.h>
+#include <nano/lib/blocks.hpp>
+#include <nano/node/ledger_snapshot.hpp>
+#include <nano/node/signatures.hpp>
+#include <nano/secure/blockstore.hpp>
+#include <nano/secure/buffer.hpp>
+#include <nano/secure/ledger.hpp>
+
+#include <boost/format.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <fstream>
+#include <unordered_map>
+
+uint8_t constexpr nano::ledger_snapshot::version;
+std::array<uint8_t, 8> const nano::ledger_snapshot::magic{ { 'n', 'a', 'n', 'o', 's', 'n', 'a', 'p' } };
+
+namespace
+{
+/** Serializes records to the snapshot file while hashing everything written */
+class snapshot_writer final
+{
+public:
+	explicit snapshot_writer (std::ofstream & file_a) :
+	file (file_a)
+	{
+		blake2b_init (&checksum, sizeof (nano::block_hash));
+	}
+	template <typename Action>
+	void write (Action const & action_a)
+	{
+		buffer.clear ();
+		{
+			nano::vectorstream stream (buffer);
+			action_a (stream);
+		}
+		blake2b_update (&checksum, buffer.data (), buffer.size ());
+		file.write (reinterpret_cast<char const *> (buffer.data ()), buffer.size ());
+	}
+	nano::block_hash final_checksum ()
+	{
+		nano::block_hash result;
+		blake2b_final (&checksum, result.bytes.data (), sizeof (result.bytes));
+		return result;
+	}
+
+private:
+	std::ofstream & file;
+	std::vector<uint8_t> buffer;
+	blake2b_state checksum;
+};
+
+/** Blocks are signed by the account of their chain, except epoch blocks which are signed by the epoch signer */
+nano::account block_signer (nano::ledger & ledger_a, nano::block const & block_a, nano::account const & account_a)
+{
+	nano::account result (account_a);
+	if (block_a.type () == nano::block_type::state && block_a.sideband ().details.is_epoch)
+	{
+		result = ledger_a.epoch_signer (block_a.link ());
+	}
+	return result;
+}
+
+/**
+ * Calls \p visitor_a for each record in \p stream_a until the end record or the first error.
+ * Visitors hold the error in their result member and are told about the end record through end ()
+ */
+template <typename Visitor>
+nano::error read_records (nano::stream & stream_a, Visitor & visitor_a)
+{
+	nano::error result;
+	try
+	{
+		auto done (false);
+		while (!done && !visitor_a.result)
+		{
+			nano::snapshot_record type;
+			nano::read (stream_a, type);
+			switch (type)
+			{
+				case nano::snapshot_record::block:
+				{
+					auto block (nano::deserialize_block (stream_a));
+					nano::block_sideband sideband;
+					if (block != nullptr && !sideband.deserialize (stream_a, block->type ()))
+					{
+						block->sideband_set (sideband);
+						visitor_a.block (block);
+					}
+					else
+					{
+						visitor_a.result.set ("Unable to deserialize snapshot block");
+					}
+					break;
+				}
+				case nano::snapshot_record::account:
+				{
+					nano::account account;
+					nano::account_info info;
+					nano::read (stream_a, account);
+					if (!info.deserialize (stream_a))
+					{
+						visitor_a.account (account, info);
+					}
+					else
+					{
+						visitor_a.result.set ("Unable to deserialize snapshot account");
+					}
+					break;
+				}
+				case nano::snapshot_record::pending:
+				{
+					nano::pending_key key;
+					nano::pending_info info;
+					if (!key.deserialize (stream_a) && !info.deserialize (stream_a))
+					{
+						visitor_a.pending (key, info);
+					}
+					else
+					{
+						visitor_a.result.set ("Unable to deserialize snapshot pending entry");
+					}
+					break;
+				}
+				case nano::snapshot_record::confirmation_height:
+				{
+					nano::account account;
+					nano::confirmation_height_info info;
+					nano::read (stream_a, account);
+					if (!info.deserialize (stream_a))
+					{
+						visitor_a.confirmation_height (account, info);
+					}
+					else
+					{
+						visitor_a.result.set ("Unable to deserialize snapshot confirmation height");
+					}
+					break;
+				}
+				case nano::snapshot_record::end:
+				{
+					visitor_a.end ();
+					done = true;
+					break;
+				}
+				default:
+				{
+					visitor_a.result.set ("Unknown snapshot record");
+					break;
+				}
+			}
+		}
+		result = visitor_a.result;
+	}
+	catch (std::runtime_error const &)
+	{
+		result.set ("Snapshot file is truncated");
+	}
+	return result;
+}
+
+/**
+ * Checks every record of a snapshot without writing anything.
+ * Blocks have to form account chains in order, their signatures are verified against the account owning the chain rather than anything taken from the sideband.
+ * Account, pending and confirmation height records are cross checked against those chains.
+ */
+class snapshot_verifier final
+{
+public:
+	snapshot_verifier (nano::ledger & ledger_a, nano::signature_checker * checker_a) :
+	ledger (ledger_a),
+	checker (checker_a)
+	{
+		blocks.reserve (nano::ledger_snapshot::block_batch_size);
+	}
+	void block (std::shared_ptr<nano::block> const & block_a)
+	{
+		auto hash (block_a->hash ());
+		auto const & sideband (block_a->sideband ());
+		if (block_a->previous ().is_zero ())
+		{
+			// Open blocks and state blocks without a previous start the chain of the account they name
+			current = block_a->account ();
+			if (current.is_zero () || sideband.height != 1 || !chains.emplace (current, chain_info{ hash, hash, 1 }).second)
+			{
+				result.set (boost::str (boost::format ("Invalid open block %1%") % hash.to_string ()));
+			}
+		}
+		else
+		{
+			auto existing (chains.find (current));
+			if (existing == chains.end () || block_a->previous () != existing->second.head || sideband.height != existing->second.count + 1)
+			{
+				result.set (boost::str (boost::format ("Block %1% doesn't follow its previous block") % hash.to_string ()));
+			}
+			else if (block_a->account ().is_zero () ? sideband.account != current : block_a->account () != current)
+			{
+				result.set (boost::str (boost::format ("Block %1% doesn't belong to account %2%") % hash.to_string () % current.to_account ()));
+			}
+			else
+			{
+				existing->second.head = hash;
+				existing->second.count = sideband.height;
+			}
+		}
+		if (!result)
+		{
+			if (block_a->type () == nano::block_type::send || (block_a->type () == nano::block_type::state && sideband.details.is_send))
+			{
+				sends.emplace (hash, current);
+			}
+			blocks.push_back (block_a);
+			signers.push_back (block_signer (ledger, *block_a, current));
+			if (blocks.size () >= nano::ledger_snapshot::block_batch_size)
+			{
+				verify_signatures ();
+			}
+		}
+	}
+	void account (nano::account const & account_a, nano::account_info const & info_a)
+	{
+		auto existing (chains.find (account_a));
+		if (existing == chains.end () || existing->second.has_account || existing->second.open != info_a.open_block || existing->second.head != info_a.head || existing->second.count != info_a.block_count)
+		{
+			result.set (boost::str (boost::format ("Account %1% doesn't match its blocks") % account_a.to_account ()));
+		}
+		else
+		{
+			existing->second.has_account = true;
+			++accounts;
+		}
+	}
+	void pending (nano::pending_key const & key_a, nano::pending_info const & info_a)
+	{
+		auto existing (sends.find (key_a.hash));
+		if (existing == sends.end () || existing->second != info_a.source)
+		{
+			result.set (boost::str (boost::format ("Pending entry %1% doesn't match a send block") % key_a.hash.to_string ()));
+		}
+	}
+	void confirmation_height (nano::account const & account_a, nano::confirmation_height_info const & info_a)
+	{
+		auto existing (chains.find (account_a));
+		if (existing == chains.end () || info_a.height > existing->second.count || (info_a.height == 0) != info_a.frontier.is_zero () || (info_a.frontier == existing->second.head && info_a.height != existing->second.count))
+		{
+			result.set (boost::str (boost::format ("Confirmation height of account %1% doesn't match its blocks") % account_a.to_account ()));
+		}
+		else if (info_a.height != 0 && info_a.frontier != existing->second.head)
+		{
+			// Frontiers below the head are looked up with another pass over the blocks
+			if (!frontiers.emplace (info_a.frontier, std::make_pair (account_a, info_a.height)).second)
+			{
+				result.set (boost::str (boost::format ("Confirmation height of account %1% doesn't match its blocks") % account_a.to_account ()));
+			}
+		}
+	}
+	void end ()
+	{
+		verify_signatures ();
+		if (!result && accounts != chains.size ())
+		{
+			result.set ("Snapshot blocks without an account");
+		}
+	}
+	void verify_signatures ()
+	{
+		if (checker != nullptr && !blocks.empty () && !result)
+		{
+			std::vector<nano::block_hash> hashes;
+			std::vector<unsigned char const *> messages;
+			std::vector<size_t> lengths (blocks.size (), sizeof (nano::block_hash));
+			std::vector<unsigned char const *> pub_keys;
+			std::vector<unsigned char const *> signatures;
+			std::vector<int> verifications (blocks.size ());
+			hashes.reserve (blocks.size ());
+			for (size_t i (0); i < blocks.size (); ++i)
+			{
+				hashes.push_back (blocks[i]->hash ());
+				messages.push_back (hashes.back ().bytes.data ());
+				pub_keys.push_back (signers[i].bytes.data ());
+				signatures.push_back (blocks[i]->block_signature ().bytes.data ());
+			}
+			nano::signature_check_set check (blocks.size (), messages.data (), lengths.data (), pub_keys.data (), signatures.data (), verifications.data ());
+			checker->verify (check);
+			auto invalid (std::find (verifications.begin (), verifications.end (), 0));
+			if (invalid != verifications.end ())
+			{
+				result.set (boost::str (boost::format ("Invalid signature for block %1%") % hashes[invalid - verifications.begin ()].to_string ()));
+			}
+		}
+		blocks.clear ();
+		signers.clear ();
+	}
+
+	class chain_info final
+	{
+	public:
+		nano::block_hash open;
+		nano::block_hash head;
+		uint64_t count;
+		bool has_account{ false };
+	};
+	nano::ledger & ledger;
+	nano::signature_checker * checker;
+	nano::error result;
+	nano::account current{ 0 };
+	std::unordered_map<nano::account, chain_info> chains;
+	/** Account of each send block, checked against the source of pending entries */
+	std::unordered_map<nano::block_hash, nano::account> sends;
+	/** Confirmation height frontiers which aren't the head of their account, with the account and height they must have */
+	std::unordered_map<nano::block_hash, std::pair<nano::account, uint64_t>> frontiers;
+	size_t accounts{ 0 };
+	std::vector<std::shared_ptr<nano::block>> blocks;
+	std::vector<nano::account> signers;
+};
+
+/** Finds the confirmation height frontiers the verifier couldn't match with an account head */
+class snapshot_frontier_verifier final
+{
+public:
+	explicit snapshot_frontier_verifier (std::unordered_map<nano::block_hash, std::pair<nano::account, uint64_t>> & frontiers_a) :
+	frontiers (frontiers_a)
+	{
+	}
+	void block (std::shared_ptr<nano::block> const & block_a)
+	{
+		// Chains were verified already, a block without a previous starts the chain of its account
+		if (block_a->previous ().is_zero ())
+		{
+			current = block_a->account ();
+		}
+		auto existing (frontiers.find (block_a->hash ()));
+		if (existing != frontiers.end ())
+		{
+			if (existing->second.first != current || existing->second.second != block_a->sideband ().height)
+			{
+				result.set (boost::str (boost::format ("Confirmation height of account %1% doesn't match its blocks") % existing->second.first.to_account ()));
+			}
+			frontiers.erase (existing);
+		}
+	}
+	void account (nano::account const &, nano::account_info const &)
+	{
+	}
+	void pending (nano::pending_key const &, nano::pending_info const &)
+	{
+	}
+	void confirmation_height (nano::account const &, nano::confirmation_height_info const &)
+	{
+	}
+	void end ()
+	{
+		if (!frontiers.empty ())
+		{
+			result.set (boost::str (boost::format ("Confirmation height of account %1% doesn't match its blocks") % frontiers.begin ()->second.first.to_account ()));
+		}
+	}
+
+	std::unordered_map<nano::block_hash, std::pair<nano::account, uint64_t>> & frontiers;
+	nano::error result;
+	nano::account current{ 0 };
+};
+
+/** Writes verified records to the ledger, committing the transaction every records_per_commit records */
+class snapshot_importer final
+{
+public:
+	explicit snapshot_importer (nano::ledger & ledger_a) :
+	ledger (ledger_a),
+	transaction (ledger_a.store.tx_begin_write ())
+	{
+		// The genesis frontier is replaced by the frontiers from the snapshot accounts
+		for (auto i (ledger.store.latest_begin (transaction)), n (ledger.store.latest_end ()); i != n; ++i)
+		{
+			ledger.store.frontier_del (transaction, i->second.head);
+		}
+	}
+	void block (std::shared_ptr<nano::block> const & block_a)
+	{
+		// Blocks are in account chain order, block_put sets the successor of the previous block again
+		auto sideband (block_a->sideband ());
+		sideband.successor.clear ();
+		block_a->sideband_set (sideband);
+		ledger.store.block_put (transaction, block_a->hash (), *block_a);
+		record_written ();
+	}
+	void account (nano::account const & account_a, nano::account_info const & info_a)
+	{
+		ledger.store.account_put (transaction, account_a, info_a);
+		auto head (ledger.store.block_get (transaction, info_a.head));
+		debug_assert (head != nullptr);
+		if (head->type () != nano::block_type::state)
+		{
+			ledger.store.frontier_put (transaction, info_a.head, account_a);
+		}
+		record_written ();
+	}
+	void pending (nano::pending_key const & key_a, nano::pending_info const & info_a)
+	{
+		ledger.store.pending_put (transaction, key_a, info_a);
+		record_written ();
+	}
+	void confirmation_height (nano::account const & account_a, nano::confirmation_height_info const & info_a)
+	{
+		ledger.store.confirmation_height_put (transaction, account_a, info_a);
+		record_written ();
+	}
+	void end ()
+	{
+	}
+	void record_written ()
+	{
+		if (++records % nano::ledger_snapshot::records_per_commit == 0)
+		{
+			transaction.commit ();
+			transaction.renew ();
+		}
+	}
+
+	nano::ledger & ledger;
+	nano::write_transaction transaction;
+	nano::error result;
+	size_t records{ 0 };
+};
+}
+
+nano::error nano::ledger_snapshot::write (nano::ledger & ledger_a, boost::filesystem::path const & path_a, nano::raw_key const & key_a)
+{
+	nano::error result;
+	std::ofstream file (path_a.string (), std::ios::binary | std::ios::trunc);
+	if (file)
+	{
+		snapshot_writer writer (file);
+		writer.write ([&ledger_a](nano::stream & stream_a) {
+			nano::write (stream_a, magic);
+			nano::write (stream_a, version);
+			nano::write (stream_a, ledger_a.network_params.header_magic_number);
+		});
+		auto transaction (ledger_a.store.tx_begin_read ());
+		// Blocks of each account from the open block to the head, so every block is written after its predecessor
+		for (auto i (ledger_a.store.latest_begin (transaction)), n (ledger_a.store.latest_end ()); i != n && !result; ++i)
+		{
+			auto hash (i->second.open_block);
+			while (!hash.is_zero () && !result)
+			{
+				auto block (ledger_a.store.block_get (transaction, hash));
+				if (block != nullptr)
+				{
+					writer.write ([&block](nano::stream & stream_a) {
+						nano::write (stream_a, nano::snapshot_record::block);
+						nano::serialize_block (stream_a, *block);
+						block->sideband ().serialize (stream_a, block->type ());
+					});
+					hash = block->sideband ().successor;
+				}
+				else
+				{
+					result.set (boost::str (boost::format ("Missing block %1% of account %2%") % hash.to_string () % i->first.to_account ()));
+				}
+			}
+		}
+		for (auto i (ledger_a.store.latest_begin (transaction)), n (ledger_a.store.latest_end ()); i != n && !result; ++i)
+		{
+			writer.write ([&i](nano::stream & stream_a) {
+				nano::account_info const & info (i->second);
+				nano::write (stream_a, nano::snapshot_record::account);
+				nano::write (stream_a, i->first);
+				nano::write (stream_a, info.head);
+				nano::write (stream_a, info.representative);
+				nano::write (stream_a, info.open_block);
+				nano::write (stream_a, info.balance);
+				nano::write (stream_a, info.modified);
+				nano::write (stream_a, info.block_count);
+				nano::write (stream_a, info.epoch_m);
+			});
+		}
+		for (auto i (ledger_a.store.pending_begin (transaction)), n (ledger_a.store.pending_end ()); i != n && !result; ++i)
+		{
+			writer.write ([&i](nano::stream & stream_a) {
+				nano::pending_key const & key (i->first);
+				nano::pending_info const & info (i->second);
+				nano::write (stream_a, nano::snapshot_record::pending);
+				nano::write (stream_a, key.account);
+				nano::write (stream_a, key.hash);
+				nano::write (stream_a, info.source);
+				nano::write (stream_a, info.amount);
+				nano::write (stream_a, info.epoch);
+			});
+		}
+		for (auto i (ledger_a.store.confirmation_height_begin (transaction)), n (ledger_a.store.confirmation_height_end ()); i != n && !result; ++i)
+		{
+			writer.write ([&i](nano::stream & stream_a) {
+				nano::write (stream_a, nano::snapshot_record::confirmation_height);
+				nano::write (stream_a, i->first);
+				i->second.serialize (stream_a);
+			});
+		}
+		if (!result)
+		{
+			writer.write ([](nano::stream & stream_a) {
+				nano::write (stream_a, nano::snapshot_record::end);
+			});
+			auto checksum (writer.final_checksum ());
+			auto signer (nano::pub_key (key_a.as_private_key ()));
+			auto signature (nano::sign_message (key_a, signer, checksum));
+			file.write (reinterpret_cast<char const *> (checksum.bytes.data ()), sizeof (checksum.bytes));
+			file.write (reinterpret_cast<char const *> (signer.bytes.data ()), sizeof (signer.bytes));
+			file.write (reinterpret_cast<char const *> (signature.bytes.data ()), sizeof (signature.bytes));
+			file.flush ();
+			if (!file)
+			{
+				result.set ("Unable to write snapshot file");
+			}
+		}
+	}
+	else
+	{
+		result.set ("Unable to open snapshot file for writing");
+	}
+	return result;
+}
+
+nano::error nano::ledger_snapshot::read (nano::ledger & ledger_a, boost::filesystem::path const & path_a, nano::signature_checker * checker_a, nano::account & signer_a)
+{
+	nano::error result;
+	try
+	{
+		boost::interprocess::file_mapping mapping (path_a.string ().c_str (), boost::interprocess::read_only);
+		boost::interprocess::mapped_region region (mapping, boost::interprocess::read_only);
+		region.advise (boost::interprocess::mapped_region::advice_sequential);
+		result = read (ledger_a, static_cast<uint8_t const *> (region.get_address ()), region.get_size (), checker_a, signer_a);
+	}
+	catch (boost::interprocess::interprocess_exception const & ex)
+	{
+		result.set (boost::str (boost::format ("Unable to map snapshot file: %1%") % ex.what ()));
+	}
+	return result;
+}
+
+nano::error nano::ledger_snapshot::read (nano::ledger & ledger_a, uint8_t const * data_a, size_t size_a, nano::signature_checker * checker_a, nano::account & signer_a)
+{
+	nano::error result;
+	auto header_size (magic.size () + sizeof (version) + ledger_a.network_params.header_magic_number.size ());
+	if (size_a >= header_size + trailer_size)
+	{
+		// Check the whole file before anything is written to the ledger
+		auto body_size (size_a - trailer_size);
+		nano::block_hash checksum;
+		blake2b_state state;
+		blake2b_init (&state, sizeof (checksum.bytes));
+		blake2b_update (&state, data_a, body_size);
+		blake2b_final (&state, checksum.bytes.data (), sizeof (checksum.bytes));
+		nano::block_hash expected;
+		nano::account signer;
+		nano::signature signature;
+		std::copy (data_a + body_size, data_a + body_size + sizeof (expected.bytes), expected.bytes.begin ());
+		std::copy (data_a + body_size + sizeof (expected.bytes), data_a + body_size + sizeof (expected.bytes) + sizeof (signer.bytes), signer.bytes.begin ());
+		std::copy (data_a + size_a - sizeof (signature.bytes), data_a + size_a, signature.bytes.begin ());
+		if (checksum != expected)
+		{
+			result.set ("Snapshot checksum mismatch");
+		}
+		else if (nano::validate_message (signer, checksum, signature))
+		{
+			result.set ("Invalid snapshot signature");
+		}
+		else if (!signer_a.is_zero () && signer != signer_a)
+		{
+			result.set (boost::str (boost::format ("Snapshot is signed by %1%") % signer.to_account ()));
+		}
+		signer_a = signer;
+	}
+	else
+	{
+		result.set ("Snapshot file is too small");
+	}
+	if (!result)
+	{
+		nano::bufferstream header_stream (data_a, header_size);
+		std::array<uint8_t, 8> magic_l;
+		uint8_t version_l;
+		std::array<uint8_t, 2> network_l;
+		nano::read (header_stream, magic_l);
+		nano::read (header_stream, version_l);
+		nano::read (header_stream, network_l);
+		if (magic_l != magic || version_l != version)
+		{
+			result.set ("Not a supported ledger snapshot");
+		}
+		else if (network_l != ledger_a.network_params.header_magic_number)
+		{
+			result.set ("Snapshot is for a different network");
+		}
+		else
+		{
+			auto transaction (ledger_a.store.tx_begin_read ());
+			if (ledger_a.store.block_count (transaction) > 1 || ledger_a.store.account_count (transaction) > 1)
+			{
+				result.set ("Snapshots can only be imported into an empty ledger");
+			}
+		}
+		if (!result)
+		{
+			// Every record is checked before the first write, only the import itself is left to fail after that
+			nano::bufferstream stream (data_a + header_size, size_a - header_size - trailer_size);
+			snapshot_verifier verifier (ledger_a, checker_a);
+			result = read_records (stream, verifier);
+			if (!result && !verifier.frontiers.empty ())
+			{
+				nano::bufferstream frontier_stream (data_a + header_size, size_a - header_size - trailer_size);
+				snapshot_frontier_verifier frontier_verifier (verifier.frontiers);
+				result = read_records (frontier_stream, frontier_verifier);
+			}
+		}
+		if (!result)
+		{
+			nano::bufferstream import_stream (data_a + header_size, size_a - header_size - trailer_size);
+			snapshot_importer importer (ledger_a);
+			result = read_records (import_stream, importer);
+		}
+	}
+	return result;
+}
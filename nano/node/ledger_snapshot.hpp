@@ -0,0 +1,54 @@
+#pragma once
+
+#include <nano/lib/errors.hpp>
+#include <nano/lib/numbers.hpp>
+
+#include <boost/filesystem/path.hpp>
+
+#include <array>
+
+namespace nano
+{
+class ledger;
+class signature_checker;
+
+/** Record types following the snapshot header, the last record is always snapshot_record::end */
+enum class snapshot_record : uint8_t
+{
+	end = 0,
+	block,
+	account,
+	pending,
+	confirmation_height
+};
+
+/**
+ * Sequential snapshot of the ledger tables, used to seed a node without bootstrapping the ledger block by block.
+ * Blocks are written per account from the open block to the head with their sideband, followed by the account, pending and confirmation height tables.
+ * The file ends with a blake2b checksum of the preceding contents, the public key of the exporter and its signature of the checksum.
+ */
+class ledger_snapshot final
+{
+public:
+	/** Writes a snapshot of \p ledger_a to \p path_a, signed with \p key_a */
+	static nano::error write (nano::ledger & ledger_a, boost::filesystem::path const & path_a, nano::raw_key const & key_a);
+	/**
+	 * Memory maps the snapshot at \p path_a and loads it into \p ledger_a, which must not contain more than the genesis block.
+	 * Block signatures are verified with \p checker_a unless it's null. If \p signer_a isn't zero the snapshot must be signed by it, on return it holds the key which signed the snapshot.
+	 * The checksum, signature and every record are checked before anything is written. Blocks are verified against the account of the chain they're imported in, account, pending and confirmation height records against those blocks.
+	 */
+	static nano::error read (nano::ledger & ledger_a, boost::filesystem::path const & path_a, nano::signature_checker * checker_a, nano::account & signer_a);
+
+	static uint8_t constexpr version{ 1 };
+	static std::array<uint8_t, 8> const magic;
+	/** Checksum, signer and signature */
+	static size_t constexpr trailer_size{ sizeof (nano::block_hash) + sizeof (nano::account) + sizeof (nano::signature) };
+	/** Blocks are verified and written in groups of this size */
+	static size_t constexpr block_batch_size{ 4096 };
+	/** Records written before the write transaction is committed and renewed */
+	static size_t constexpr records_per_commit{ 64 * 1024 };
+
+private:
+	static nano::error read (nano::ledger & ledger_a, uint8_t const * data_a, size_t size_a, nano::signature_checker * checker_a, nano::account & signer_a);
+};
+}
@@ -81,6 +81,15 @@ txn_tracking_enabled (txn_tracking_config_a.enable)
 			auto needs_vacuuming = false;
 			{
 				auto transaction (tx_begin_write ());
+				if (is_fresh_db)
+				{
+					// New ledgers start at the latest version, this prevents tables which are only used by upgrades from being created
+					error |= mdb_dbi_open (env.tx (transaction), "meta", MDB_CREATE, &meta) != 0;
+					if (!error)
+					{
+						version_put (transaction, version);
+					}
+				}
 				open_databases (error, transaction, MDB_CREATE);
 				if (!error)
 				{
@@ -176,10 +185,6 @@ nano::mdb_txn_callbacks nano::mdb_store::create_txn_callbacks ()
 void nano::mdb_store::open_databases (bool & error_a, nano::transaction const & transaction_a, unsigned flags)
 {
 	error_a |= mdb_dbi_open (env.tx (transaction_a), "frontiers", flags, &frontiers) != 0;
-	error_a |= mdb_dbi_open (env.tx (transaction_a), "send", flags, &send_blocks) != 0;
-	error_a |= mdb_dbi_open (env.tx (transaction_a), "receive", flags, &receive_blocks) != 0;
-	error_a |= mdb_dbi_open (env.tx (transaction_a), "open", flags, &open_blocks) != 0;
-	error_a |= mdb_dbi_open (env.tx (transaction_a), "change", flags, &change_blocks) != 0;
 	error_a |= mdb_dbi_open (env.tx (transaction_a), "unchecked", flags, &unchecked) != 0;
 	error_a |= mdb_dbi_open (env.tx (transaction_a), "vote", flags, &vote) != 0;
 	error_a |= mdb_dbi_open (env.tx (transaction_a), "online_weight", flags, &online_weight) != 0;
@@ -196,13 +201,31 @@ void nano::mdb_store::open_databases (bool & error_a, nano::transaction const &
 	error_a |= mdb_dbi_open (env.tx (transaction_a), "pending", flags, &pending_v0) != 0;
 	pending = pending_v0;
 
-	if (version_get (transaction_a) < 16)
+	auto version_l (version_get (transaction_a));
+	if (version_l < 16)
 	{
 		// The representation database is no longer used, but needs opening so that it can be deleted during an upgrade
 		error_a |= mdb_dbi_open (env.tx (transaction_a), "representation", flags, &representation) != 0;
 	}
 
-	if (version_get (transaction_a) < 15)
+	if (version_l < 19)
+	{
+		// The per-type block databases are no longer used, but need opening so they can be merged into the blocks database during an upgrade
+		error_a |= mdb_dbi_open (env.tx (transaction_a), "send", flags, &send_blocks) != 0;
+		error_a |= mdb_dbi_open (env.tx (transaction_a), "receive", flags, &receive_blocks) != 0;
+		error_a |= mdb_dbi_open (env.tx (transaction_a), "open", flags, &open_blocks) != 0;
+		error_a |= mdb_dbi_open (env.tx (transaction_a), "change", flags, &change_blocks) != 0;
+	}
+	else
+	{
+		error_a |= mdb_dbi_open (env.tx (transaction_a), "blocks", flags, &blocks) != 0;
+	}
+
+	// The block height index is optional, a read-only store opened without it never uses it
+	auto block_heights_status (mdb_dbi_open (env.tx (transaction_a), "block_heights", flags, &block_heights));
+	error_a |= block_heights_status != 0 && block_heights_status != MDB_NOTFOUND;
+
+	if (version_l < 15)
 	{
 		// These databases are no longer used, but need opening so they can be deleted during an upgrade
 		error_a |= mdb_dbi_open (env.tx (transaction_a), "state", flags, &state_blocks_v0) != 0;
@@ -211,7 +234,7 @@ void nano::mdb_store::open_databases (bool & error_a, nano::transaction const &
 		error_a |= mdb_dbi_open (env.tx (transaction_a), "pending_v1", flags, &pending_v1) != 0;
 		error_a |= mdb_dbi_open (env.tx (transaction_a), "state_v1", flags, &state_blocks_v1) != 0;
 	}
-	else
+	else if (version_l < 19)
 	{
 		error_a |= mdb_dbi_open (env.tx (transaction_a), "state_blocks", flags, &state_blocks) != 0;
 		state_blocks_v0 = state_blocks;
@@ -261,6 +284,9 @@ bool nano::mdb_store::do_upgrades (nano::write_transaction & transaction_a, bool
 			upgrade_v17_to_v18 (transaction_a);
 			needs_vacuuming = true;
 		case 18:
+			upgrade_v18_to_v19 (transaction_a);
+			needs_vacuuming = true;
+		case 19:
 			break;
 		default:
 			logger.always_log (boost::str (boost::format ("The version of the ledger (%1%) is too high for this node") % version_l));
@@ -287,10 +313,10 @@ void nano::mdb_store::upgrade_v1_to_v2 (nano::write_transaction const & transact
 			v2.head = v1.head;
 			v2.modified = v1.modified;
 			v2.rep_block = v1.rep_block;
-			auto block (block_get (transaction_a, v1.head));
+			auto block (block_get_v14 (transaction_a, v1.head));
 			while (!block->previous ().is_zero ())
 			{
-				block = block_get (transaction_a, block->previous ());
+				block = block_get_v14 (transaction_a, block->previous ());
 			}
 			v2.open_block = block->hash ();
 			auto status (mdb_put (env.tx (transaction_a), accounts_v0, nano::mdb_val (account), nano::mdb_val (sizeof (v2), &v2), 0));
@@ -312,10 +338,8 @@ void nano::mdb_store::upgrade_v2_to_v3 (nano::write_transaction const & transact
 	{
 		nano::account account_l ((*i)->first);
 		nano::account_info_v5 info ((*i)->second);
-		representative_visitor visitor (transaction_a, *this);
-		visitor.compute (info.head);
-		debug_assert (!visitor.result.is_zero ());
-		info.rep_block = visitor.result;
+		info.rep_block = block_representative_v14 (transaction_a, info.head);
+		debug_assert (!info.rep_block.is_zero ());
 		auto impl (boost::polymorphic_downcast<nano::mdb_iterator<nano::account, nano::account_info_v5> *> (i.get ()));
 		mdb_cursor_put (impl->cursor, nano::mdb_val (account_l), nano::mdb_val (sizeof (info), &info), MDB_CURRENT);
 	}
@@ -347,11 +371,11 @@ void nano::mdb_store::upgrade_v4_to_v5 (nano::write_transaction const & transact
 	{
 		nano::account_info_v5 const & info (i->second);
 		nano::block_hash successor (0);
-		auto block (block_get (transaction_a, info.head));
+		auto block (block_get_v14 (transaction_a, info.head));
 		while (block != nullptr)
 		{
 			auto hash (block->hash ());
-			if (block_successor (transaction_a, hash).is_zero () && !successor.is_zero ())
+			if (block_successor_v14 (transaction_a, hash).is_zero () && !successor.is_zero ())
 			{
 				std::vector<uint8_t> vector;
 				{
@@ -359,19 +383,14 @@ void nano::mdb_store::upgrade_v4_to_v5 (nano::write_transaction const & transact
 					block->serialize (stream);
 					nano::write (stream, successor.bytes);
 				}
-				block_raw_put (transaction_a, vector, block->type (), hash);
+				block_raw_put_v14 (transaction_a, vector, block->type (), hash);
 				if (!block->previous ().is_zero ())
 				{
-					nano::block_type type;
-					auto value (block_raw_get (transaction_a, block->previous (), type));
-					debug_assert (value.size () != 0);
-					std::vector<uint8_t> data (static_cast<uint8_t *> (value.data ()), static_cast<uint8_t *> (value.data ()) + value.size ());
-					std::copy (hash.bytes.begin (), hash.bytes.end (), data.end () - nano::block_sideband::size (type));
-					block_raw_put (transaction_a, data, type, block->previous ());
+					block_successor_set_v14 (transaction_a, block->previous (), hash);
 				}
 			}
 			successor = hash;
-			block = block_get (transaction_a, block->previous ());
+			block = block_get_v14 (transaction_a, block->previous ());
 		}
 	}
 }
@@ -389,7 +408,7 @@ void nano::mdb_store::upgrade_v5_to_v6 (nano::write_transaction const & transact
 		while (!hash.is_zero ())
 		{
 			++block_count;
-			auto block (block_get (transaction_a, hash));
+			auto block (block_get_v14 (transaction_a, hash));
 			debug_assert (block != nullptr);
 			hash = block->previous ();
 		}
@@ -510,15 +529,13 @@ void nano::mdb_store::upgrade_v12_to_v13 (nano::write_transaction & transaction_
 						sideband.serialize (stream);
 					}
 
-					nano::mdb_val value{ vector.size (), (void *)vector.data () };
-					MDB_dbi database = is_state_block_v1 ? state_blocks_v1 : table_to_dbi (block_database (block->type ()));
+					block_raw_put_v14 (transaction_a, vector, block->type (), hash, is_state_block_v1);
 
-					auto status = mdb_put (env.tx (transaction_a), database, nano::mdb_val (hash), value, 0);
-					release_assert (success (status));
-
-					nano::block_predecessor_set<MDB_val, nano::mdb_store> predecessor (transaction_a, *this);
-					block->visit (predecessor);
-					debug_assert (block->previous ().is_zero () || block_successor (transaction_a, block->previous ()) == hash);
+					if (!block->previous ().is_zero ())
+					{
+						block_successor_set_v14 (transaction_a, block->previous (), hash);
+					}
+					debug_assert (block->previous ().is_zero () || block_successor_v14 (transaction_a, block->previous ()) == hash);
 					cost += 16;
 				}
 				else
@@ -736,13 +753,13 @@ void nano::mdb_store::upgrade_v16_to_v17 (nano::write_transaction const & transa
 			if (account_info_i->second.block_count / 2 >= confirmation_height)
 			{
 				// The confirmation height of the account is closer to the bottom of the chain, so start there and work up
-				auto block = block_get (transaction_a, account_info.open_block);
+				auto block = block_get_v18 (transaction_a, account_info.open_block);
 				debug_assert (block);
 				auto height = 1;
 
 				while (height != confirmation_height)
 				{
-					block = block_get (transaction_a, block->sideband ().successor);
+					block = block_get_v18 (transaction_a, block->sideband ().successor);
 					debug_assert (block);
 					++height;
 				}
@@ -753,11 +770,11 @@ void nano::mdb_store::upgrade_v16_to_v17 (nano::write_transaction const & transa
 			else
 			{
 				// The confirmation height of the account is closer to the top of the chain so start there and work down
-				auto block = block_get (transaction_a, account_info.head);
+				auto block = block_get_v18 (transaction_a, account_info.head);
 				auto height = block->sideband ().height;
 				while (height != confirmation_height)
 				{
-					block = block_get (transaction_a, block->previous ());
+					block = block_get_v18 (transaction_a, block->previous ());
 					debug_assert (block);
 					--height;
 				}
@@ -807,7 +824,7 @@ void nano::mdb_store::upgrade_v17_to_v18 (nano::write_transaction const & transa
 		nano::amount prev_balance (0);
 		if (!block->hashables.previous.is_zero ())
 		{
-			prev_balance = block_balance (transaction_a, block->hashables.previous);
+			prev_balance = block_balance_v18 (transaction_a, block->hashables.previous);
 		}
 		if (block->hashables.balance == prev_balance && network_params.ledger.epochs.is_epoch_link (block->hashables.link))
 		{
@@ -849,6 +866,61 @@ void nano::mdb_store::upgrade_v17_to_v18 (nano::write_transaction const & transa
 	logger.always_log ("Finished upgrading the sideband");
 }
 
+void nano::mdb_store::upgrade_v18_to_v19 (nano::write_transaction const & transaction_a)
+{
+	logger.always_log ("Preparing v18 to v19 database upgrade...");
+
+	auto status (mdb_dbi_open (env.tx (transaction_a), "blocks", MDB_CREATE, &blocks));
+	release_assert (success (status));
+
+	auto count_existing (count (transaction_a, blocks));
+	auto count_pre (count (transaction_a, state_blocks) + count (transaction_a, send_blocks) + count (transaction_a, receive_blocks) + count (transaction_a, open_blocks) + count (transaction_a, change_blocks));
+
+	// Each value is prefixed with its block type so that a single lookup is enough to deserialize any block
+	auto num = 0u;
+	auto move_blocks = [this, &transaction_a, &num, count_pre](MDB_dbi database_a, nano::block_type type_a, unsigned flags_a) {
+		for (nano::mdb_iterator<nano::block_hash, nano::mdb_val> i (transaction_a, database_a), n{}; i != n; ++i, ++num)
+		{
+			auto const & value (i->second);
+			std::vector<uint8_t> data;
+			data.reserve (1 + value.size ());
+			data.push_back (static_cast<uint8_t> (type_a));
+			data.insert (data.end (), static_cast<uint8_t const *> (value.data ()), static_cast<uint8_t const *> (value.data ()) + value.size ());
+			auto s = mdb_put (env.tx (transaction_a), blocks, nano::mdb_val (i->first), nano::mdb_val (data.size (), data.data ()), flags_a);
+			release_assert (success (s));
+
+			// Every so often output to the log to indicate progress
+			constexpr auto output_cutoff = 1000000;
+			if (num > 0 && num % output_cutoff == 0)
+			{
+				logger.always_log (boost::str (boost::format ("Database block table merge %1% million blocks upgraded (out of %2%)") % (num / output_cutoff) % count_pre));
+			}
+		}
+	};
+
+	// State blocks make up the bulk of the ledger and are already in key order, so can be appended when the blocks table starts out empty
+	move_blocks (state_blocks, nano::block_type::state, count_existing == 0 ? MDB_APPEND : 0);
+	move_blocks (send_blocks, nano::block_type::send, 0);
+	move_blocks (receive_blocks, nano::block_type::receive, 0);
+	move_blocks (open_blocks, nano::block_type::open, 0);
+	move_blocks (change_blocks, nano::block_type::change, 0);
+
+	auto count_post (count (transaction_a, blocks));
+	release_assert (count_pre + count_existing == count_post);
+
+	// The per-type block tables are no longer used
+	for (auto database : { &state_blocks, &send_blocks, &receive_blocks, &open_blocks, &change_blocks })
+	{
+		status = mdb_drop (env.tx (transaction_a), *database, 1);
+		release_assert (success (status));
+		*database = 0;
+	}
+	state_blocks_v0 = 0;
+
+	version_put (transaction_a, 19);
+	logger.always_log ("Finished merging the block tables");
+}
+
 /** Takes a filepath, appends '_backup_<timestamp>' to the end (but before any extension) and saves that file in the same directory */
 void nano::mdb_store::create_backup_file (nano::mdb_env & env_a, boost::filesystem::path const & filepath_a, nano::logger_mt & logger_a)
 {
@@ -899,6 +971,20 @@ void nano::mdb_store::version_put (nano::write_transaction const & transaction_a
 	}
 }
 
+void nano::mdb_store::block_height_index_set (nano::write_transaction & transaction_a, bool enable_a)
+{
+	// Fully upgraded ledgers are opened without creating tables, so the index table is created when first enabled
+	if (block_heights == 0 && enable_a)
+	{
+		auto status (mdb_dbi_open (env.tx (transaction_a), "block_heights", MDB_CREATE, &block_heights));
+		release_assert (status == MDB_SUCCESS);
+	}
+	if (block_heights != 0)
+	{
+		block_store_partial::block_height_index_set (transaction_a, enable_a);
+	}
+}
+
 bool nano::mdb_store::block_info_get (nano::transaction const & transaction_a, nano::block_hash const & hash_a, nano::block_info & block_info_a) const
 {
 	debug_assert (!full_sideband (transaction_a));
@@ -975,6 +1061,10 @@ MDB_dbi nano::mdb_store::table_to_dbi (tables table_a) const
 			return frontiers;
 		case tables::accounts:
 			return accounts;
+		case tables::block_heights:
+			return block_heights;
+		case tables::blocks:
+			return blocks;
 		case tables::send_blocks:
 			return send_blocks;
 		case tables::receive_blocks:
@@ -1030,7 +1120,7 @@ bool nano::mdb_store::copy_db (boost::filesystem::path const & destination_file)
 void nano::mdb_store::rebuild_db (nano::write_transaction const & transaction_a)
 {
 	// Tables with uint256_union key
-	std::vector<MDB_dbi> tables = { accounts, send_blocks, receive_blocks, open_blocks, change_blocks, state_blocks, vote, confirmation_height };
+	std::vector<MDB_dbi> tables = { accounts, blocks, vote, confirmation_height };
 	for (auto const & table : tables)
 	{
 		MDB_dbi temp;
@@ -1082,7 +1172,102 @@ bool nano::mdb_store::init_error () const
 	return error;
 }
 
+// All the v18 functions below are only needed during upgrades
+std::shared_ptr<nano::block> nano::mdb_store::block_get_v18 (nano::transaction const & transaction_a, nano::block_hash const & hash_a) const
+{
+	nano::block_type type;
+	auto value (block_raw_get_v18 (transaction_a, hash_a, type));
+	std::shared_ptr<nano::block> result;
+	if (value.size () != 0)
+	{
+		nano::bufferstream stream (reinterpret_cast<uint8_t const *> (value.data ()), value.size ());
+		result = nano::deserialize_block (stream, type);
+		debug_assert (result != nullptr);
+		nano::block_sideband sideband;
+		auto error (sideband.deserialize (stream, type));
+		(void)error;
+		debug_assert (!error);
+		result->sideband_set (sideband);
+	}
+	return result;
+}
+
+nano::mdb_val nano::mdb_store::block_raw_get_v18 (nano::transaction const & transaction_a, nano::block_hash const & hash_a, nano::block_type & type_a) const
+{
+	nano::mdb_val result;
+	// Table lookups are ordered by match probability
+	nano::block_type block_types[]{ nano::block_type::state, nano::block_type::send, nano::block_type::receive, nano::block_type::open, nano::block_type::change };
+	for (auto current_type : block_types)
+	{
+		auto db_val (block_raw_get_by_type_v18 (transaction_a, hash_a, current_type));
+		if (db_val.is_initialized ())
+		{
+			type_a = current_type;
+			result = db_val.get ();
+			break;
+		}
+	}
+
+	return result;
+}
+
+boost::optional<nano::mdb_val> nano::mdb_store::block_raw_get_by_type_v18 (nano::transaction const & transaction_a, nano::block_hash const & hash_a, nano::block_type & type_a) const
+{
+	nano::mdb_val value;
+	nano::mdb_val hash (hash_a);
+	int status = status_code_not_found ();
+	switch (type_a)
+	{
+		case nano::block_type::send:
+		{
+			status = mdb_get (env.tx (transaction_a), send_blocks, hash, value);
+			break;
+		}
+		case nano::block_type::receive:
+		{
+			status = mdb_get (env.tx (transaction_a), receive_blocks, hash, value);
+			break;
+		}
+		case nano::block_type::open:
+		{
+			status = mdb_get (env.tx (transaction_a), open_blocks, hash, value);
+			break;
+		}
+		case nano::block_type::change:
+		{
+			status = mdb_get (env.tx (transaction_a), change_blocks, hash, value);
+			break;
+		}
+		case nano::block_type::state:
+		{
+			status = mdb_get (env.tx (transaction_a), state_blocks, hash, value);
+			break;
+		}
+		case nano::block_type::invalid:
+		case nano::block_type::not_a_block:
+		{
+			break;
+		}
+	}
+
+	release_assert (success (status) || not_found (status));
+	boost::optional<nano::mdb_val> result;
+	if (success (status))
+	{
+		result = value;
+	}
+	return result;
+}
+
+nano::uint128_t nano::mdb_store::block_balance_v18 (nano::transaction const & transaction_a, nano::block_hash const & hash_a) const
+{
+	auto block (block_get_v18 (transaction_a, hash_a));
+	release_assert (block != nullptr);
+	return block_balance_calculated (block);
+}
+
 // All the v14 functions below are only needed during upgrades
+
 bool nano::mdb_store::entry_has_sideband_v14 (size_t entry_size_a, nano::block_type type_a) const
 {
 	return (entry_size_a == nano::block::size (type_a) + nano::block_sideband_v14::size (type_a));
@@ -1295,6 +1480,71 @@ std::shared_ptr<nano::block> nano::mdb_store::block_get_v14 (nano::transaction c
 	return result;
 }
 
+void nano::mdb_store::block_raw_put_v14 (nano::write_transaction const & transaction_a, std::vector<uint8_t> const & data_a, nano::block_type type_a, nano::block_hash const & hash_a, bool is_state_v1)
+{
+	MDB_dbi database{ 0 };
+	switch (type_a)
+	{
+		case nano::block_type::send:
+			database = send_blocks;
+			break;
+		case nano::block_type::receive:
+			database = receive_blocks;
+			break;
+		case nano::block_type::open:
+			database = open_blocks;
+			break;
+		case nano::block_type::change:
+			database = change_blocks;
+			break;
+		case nano::block_type::state:
+			database = is_state_v1 ? state_blocks_v1 : state_blocks_v0;
+			break;
+		case nano::block_type::invalid:
+		case nano::block_type::not_a_block:
+			release_assert (false);
+			break;
+	}
+	nano::mdb_val value{ data_a.size (), (void *)data_a.data () };
+	auto status (mdb_put (env.tx (transaction_a), database, nano::mdb_val (hash_a), value, 0));
+	release_assert (success (status));
+}
+
+void nano::mdb_store::block_successor_set_v14 (nano::write_transaction const & transaction_a, nano::block_hash const & hash_a, nano::block_hash const & successor_a)
+{
+	nano::block_type type;
+	bool is_state_v1 (false);
+	auto value (block_raw_get_v14 (transaction_a, hash_a, type, &is_state_v1));
+	debug_assert (value.size () != 0);
+	std::vector<uint8_t> data (static_cast<uint8_t *> (value.data ()), static_cast<uint8_t *> (value.data ()) + value.size ());
+	std::copy (successor_a.bytes.begin (), successor_a.bytes.end (), data.begin () + block_successor_offset_v14 (transaction_a, value.size (), type));
+	block_raw_put_v14 (transaction_a, data, type, hash_a, is_state_v1);
+}
+
+// Return the latest block in the chain of hash_a which set a representative
+nano::block_hash nano::mdb_store::block_representative_v14 (nano::transaction const & transaction_a, nano::block_hash const & hash_a) const
+{
+	nano::block_hash result (0);
+	auto hash (hash_a);
+	while (result.is_zero () && !hash.is_zero ())
+	{
+		auto block (block_get_v14 (transaction_a, hash));
+		debug_assert (block != nullptr);
+		switch (block->type ())
+		{
+			case nano::block_type::open:
+			case nano::block_type::change:
+			case nano::block_type::state:
+				result = hash;
+				break;
+			default:
+				hash = block->previous ();
+				break;
+		}
+	}
+	return result;
+}
+
 nano::mdb_store::upgrade_counters::upgrade_counters (uint64_t count_before_v0, uint64_t count_before_v1) :
 before_v0 (count_before_v0),
 before_v1 (count_before_v1)
@@ -47,6 +47,8 @@ public:
 
 	void version_put (nano::write_transaction const &, int) override;
 
+	void block_height_index_set (nano::write_transaction &, bool enable_a) override;
+
 	void serialize_mdb_tracker (boost::property_tree::ptree &, std::chrono::milliseconds, std::chrono::milliseconds) override;
 
 	static void create_backup_file (nano::mdb_env &, boost::filesystem::path const &, nano::logger_mt &);
@@ -83,25 +85,25 @@ public:
 	MDB_dbi accounts{ 0 };
 
 	/**
-	 * Maps block hash to send block.
+	 * Maps block hash to send block. (Removed)
 	 * nano::block_hash -> nano::send_block
 	 */
 	MDB_dbi send_blocks{ 0 };
 
 	/**
-	 * Maps block hash to receive block.
+	 * Maps block hash to receive block. (Removed)
 	 * nano::block_hash -> nano::receive_block
 	 */
 	MDB_dbi receive_blocks{ 0 };
 
 	/**
-	 * Maps block hash to open block.
+	 * Maps block hash to open block. (Removed)
 	 * nano::block_hash -> nano::open_block
 	 */
 	MDB_dbi open_blocks{ 0 };
 
 	/**
-	 * Maps block hash to change block.
+	 * Maps block hash to change block. (Removed)
 	 * nano::block_hash -> nano::change_block
 	 */
 	MDB_dbi change_blocks{ 0 };
@@ -119,11 +121,23 @@ public:
 	MDB_dbi state_blocks_v1{ 0 };
 
 	/**
-	 * Maps block hash to state block.
+	 * Maps block hash to state block. (Removed)
 	 * nano::block_hash -> nano::state_block
 	 */
 	MDB_dbi state_blocks{ 0 };
 
+	/**
+	 * Maps block hash to a block of any type and its sideband, prefixed with the block type.
+	 * nano::block_hash -> nano::block_type, nano::block, nano::block_sideband
+	 */
+	MDB_dbi blocks{ 0 };
+
+	/**
+	 * Optional index of each account's blocks by height, only filled while the block height index is enabled.
+	 * nano::account, uint64_t (big endian) -> nano::block_hash
+	 */
+	MDB_dbi block_heights{ 0 };
+
 	/**
 	 * Maps min_version 0 (destination account, pending block) to (source account, amount). (Removed)
 	 * nano::account, nano::block_hash -> nano::account, nano::amount
@@ -211,6 +225,13 @@ public:
 		return nano::store_iterator<Key, Value> (std::make_unique<nano::mdb_iterator<Key, Value>> (transaction_a, table_to_dbi (table_a), key));
 	}
 
+	/** LMDB has no prefix filters, this iterates in key order like make_iterator */
+	template <typename Key, typename Value>
+	nano::store_iterator<Key, Value> make_prefix_iterator (nano::transaction const & transaction_a, tables table_a, nano::mdb_val const & key) const
+	{
+		return make_iterator<Key, Value> (transaction_a, table_a, key);
+	}
+
 	bool init_error () const override;
 
 	size_t count (nano::transaction const &, MDB_dbi) const;
@@ -225,6 +246,13 @@ public:
 	nano::account block_account_computed_v14 (nano::transaction const & transaction_a, nano::block_hash const & hash_a) const;
 	nano::account block_account_v14 (nano::transaction const & transaction_a, nano::block_hash const & hash_a) const;
 	nano::uint128_t block_balance_computed_v14 (nano::transaction const & transaction_a, nano::block_hash const & hash_a) const;
+	void block_raw_put_v14 (nano::write_transaction const & transaction_a, std::vector<uint8_t> const & data_a, nano::block_type type_a, nano::block_hash const & hash_a, bool is_state_v1 = false);
+	void block_successor_set_v14 (nano::write_transaction const & transaction_a, nano::block_hash const & hash_a, nano::block_hash const & successor_a);
+	nano::block_hash block_representative_v14 (nano::transaction const & transaction_a, nano::block_hash const & hash_a) const;
+	std::shared_ptr<nano::block> block_get_v18 (nano::transaction const & transaction_a, nano::block_hash const & hash_a) const;
+	nano::mdb_val block_raw_get_v18 (nano::transaction const & transaction_a, nano::block_hash const & hash_a, nano::block_type & type_a) const;
+	boost::optional<nano::mdb_val> block_raw_get_by_type_v18 (nano::transaction const & transaction_a, nano::block_hash const & hash_a, nano::block_type & type_a) const;
+	nano::uint128_t block_balance_v18 (nano::transaction const & transaction_a, nano::block_hash const & hash_a) const;
 
 private:
 	bool do_upgrades (nano::write_transaction &, bool &, size_t);
@@ -244,6 +272,7 @@ private:
 	void upgrade_v15_to_v16 (nano::write_transaction const &);
 	void upgrade_v16_to_v17 (nano::write_transaction const &);
 	void upgrade_v17_to_v18 (nano::write_transaction const &);
+	void upgrade_v18_to_v19 (nano::write_transaction const &);
 
 	void open_databases (bool &, nano::transaction const &, unsigned);
 
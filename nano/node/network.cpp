@@ -9,11 +9,12 @@
 #include <boost/variant/get.hpp>
 
 #include <numeric>
+#include <thread>
 
 nano::network::network (nano::node & node_a, uint16_t port_a) :
 buffer_container (node_a.stats, nano::network::buffer_size, 4096), // 2Mb receive buffer
 resolver (node_a.io_ctx),
-limiter (node_a.config.bandwidth_limit),
+limiter (node_a.config.bandwidth_limit, { node_a.config.bandwidth_local_vote_share, node_a.config.bandwidth_vote_share, node_a.config.bandwidth_block_share, 0., 0. }, node_a.config.bandwidth_bulk_share),
 node (node_a),
 udp_channels (node_a, port_a),
 tcp_channels (node_a),
@@ -148,9 +149,10 @@ void nano::network::send_node_id_handshake (std::shared_ptr<nano::transport::cha
 
 void nano::network::flood_message (nano::message const & message_a, nano::buffer_drop_policy drop_policy_a)
 {
+	nano::transport::serialized_message serialized (message_a, message_buffers);
 	for (auto & i : list (fanout ()))
 	{
-		i->send (message_a, nullptr, drop_policy_a);
+		i->send (serialized, nullptr, drop_policy_a);
 	}
 }
 
@@ -163,31 +165,34 @@ void nano::network::flood_block (std::shared_ptr<nano::block> const & block_a, n
 void nano::network::flood_block_initial (std::shared_ptr<nano::block> const & block_a)
 {
 	nano::publish message (block_a);
+	nano::transport::serialized_message serialized (message, message_buffers);
 	for (auto const & i : node.rep_crawler.principal_representatives ())
 	{
-		i.channel->send (message, nullptr, nano::buffer_drop_policy::no_limiter_drop);
+		i.channel->send (serialized, nullptr, nano::buffer_drop_policy::no_limiter_drop);
 	}
 	for (auto & i : list_non_pr (fanout (1.0)))
 	{
-		i->send (message, nullptr, nano::buffer_drop_policy::no_limiter_drop);
+		i->send (serialized, nullptr, nano::buffer_drop_policy::no_limiter_drop);
 	}
 }
 
-void nano::network::flood_vote (std::shared_ptr<nano::vote> const & vote_a, float scale)
+void nano::network::flood_vote (std::shared_ptr<nano::vote> const & vote_a, float scale, nano::bandwidth_class class_a)
 {
 	nano::confirm_ack message (vote_a);
+	nano::transport::serialized_message serialized (message, message_buffers, class_a);
 	for (auto & i : list_non_pr (fanout (scale)))
 	{
-		i->send (message, nullptr);
+		i->send (serialized, nullptr);
 	}
 }
 
 void nano::network::flood_vote_pr (std::shared_ptr<nano::vote> const & vote_a)
 {
 	nano::confirm_ack message (vote_a);
+	nano::transport::serialized_message serialized (message, message_buffers, nano::bandwidth_class::local_vote);
 	for (auto const & i : node.rep_crawler.principal_representatives ())
 	{
-		i.channel->send (message, nullptr, nano::buffer_drop_policy::no_limiter_drop);
+		i.channel->send (serialized, nullptr, nano::buffer_drop_policy::no_limiter_drop);
 	}
 }
 
@@ -195,7 +200,12 @@ void nano::network::flood_block_many (std::deque<std::shared_ptr<nano::block>> b
 {
 	auto block_l (blocks_a.front ());
 	blocks_a.pop_front ();
-	flood_block (block_l);
+	nano::publish message (block_l);
+	nano::transport::serialized_message serialized (message, message_buffers, nano::bandwidth_class::bulk);
+	for (auto & i : list (fanout ()))
+	{
+		i->send (serialized);
+	}
 	if (!blocks_a.empty ())
 	{
 		std::weak_ptr<nano::node> node_w (node.shared ());
@@ -732,8 +742,7 @@ stats (stats_a),
 free (count),
 full (count),
 slab (size * count),
-entries (count),
-stopped (false)
+entries (count)
 {
 	debug_assert (count > 0);
 	debug_assert (size > 0);
@@ -742,68 +751,87 @@ stopped (false)
 	for (auto i (0); i < count; ++i, ++entry_data)
 	{
 		*entry_data = { slab_data + i * size, 0, nano::endpoint () };
-		free.push_back (entry_data);
+		free.push (entry_data);
 	}
 }
 
 nano::message_buffer * nano::message_buffer_manager::allocate ()
 {
-	nano::unique_lock<std::mutex> lock (mutex);
-	if (!stopped && free.empty () && full.empty ())
+	auto overflow (false);
+	auto take = [this, &overflow]() {
+		auto result (free.pop ());
+		if (result == nullptr)
+		{
+			result = full.pop ();
+			overflow = result != nullptr;
+		}
+		return result;
+	};
+	auto result (take ());
+	if (result == nullptr && !stopped)
 	{
 		stats.inc (nano::stat::type::udp, nano::stat::detail::blocking, nano::stat::dir::in);
-		condition.wait (lock, [& stopped = stopped, &free = free, &full = full] { return stopped || !free.empty () || !full.empty (); });
-	}
-	nano::message_buffer * result (nullptr);
-	if (!free.empty ())
-	{
-		result = free.front ();
-		free.pop_front ();
+		nano::unique_lock<std::mutex> lock (mutex);
+		++waiting;
+		std::atomic_thread_fence (std::memory_order_seq_cst);
+		condition.wait (lock, [this, &result, &take] { return (result = take ()) != nullptr || stopped; });
+		--waiting;
 	}
-	if (result == nullptr && !full.empty ())
+	if (overflow)
 	{
-		result = full.front ();
-		full.pop_front ();
 		stats.inc (nano::stat::type::udp, nano::stat::detail::overflow, nano::stat::dir::in);
 	}
 	release_assert (result || stopped);
 	return result;
 }
 
+nano::message_buffer * nano::message_buffer_manager::try_allocate ()
+{
+	return stopped ? nullptr : free.pop ();
+}
+
 void nano::message_buffer_manager::enqueue (nano::message_buffer * data_a)
 {
 	debug_assert (data_a != nullptr);
-	{
-		nano::lock_guard<std::mutex> lock (mutex);
-		full.push_back (data_a);
-	}
-	condition.notify_all ();
+	full.push (data_a);
+	notify ();
 }
 
 nano::message_buffer * nano::message_buffer_manager::dequeue ()
 {
-	nano::unique_lock<std::mutex> lock (mutex);
-	while (!stopped && full.empty ())
-	{
-		condition.wait (lock);
-	}
-	nano::message_buffer * result (nullptr);
-	if (!full.empty ())
+	auto result (full.pop ());
+	if (result == nullptr && !stopped)
 	{
-		result = full.front ();
-		full.pop_front ();
+		nano::unique_lock<std::mutex> lock (mutex);
+		++waiting;
+		std::atomic_thread_fence (std::memory_order_seq_cst);
+		condition.wait (lock, [this, &result] { return (result = full.pop ()) != nullptr || stopped; });
+		--waiting;
 	}
 	return result;
 }
 
+nano::message_buffer * nano::message_buffer_manager::try_dequeue ()
+{
+	return full.pop ();
+}
+
 void nano::message_buffer_manager::release (nano::message_buffer * data_a)
 {
 	debug_assert (data_a != nullptr);
+	free.push (data_a);
+	notify ();
+}
+
+void nano::message_buffer_manager::notify ()
+{
+	// Pairs with the fence after a waiter registers, either the waiter sees the pushed buffer or this sees the waiter
+	std::atomic_thread_fence (std::memory_order_seq_cst);
+	if (waiting > 0)
 	{
 		nano::lock_guard<std::mutex> lock (mutex);
-		free.push_back (data_a);
+		condition.notify_all ();
 	}
-	condition.notify_all ();
 }
 
 void nano::message_buffer_manager::stop ()
@@ -815,6 +843,91 @@ void nano::message_buffer_manager::stop ()
 	condition.notify_all ();
 }
 
+nano::message_buffer_manager::ring::ring (size_t count_a) :
+cells (nano::message_buffer_manager::ring::capacity (count_a)),
+mask (cells.size () - 1)
+{
+	for (size_t i (0); i < cells.size (); ++i)
+	{
+		cells[i].sequence.store (i, std::memory_order_relaxed);
+	}
+}
+
+size_t nano::message_buffer_manager::ring::capacity (size_t count_a)
+{
+	size_t result (1);
+	while (result < count_a)
+	{
+		result <<= 1;
+	}
+	return result;
+}
+
+void nano::message_buffer_manager::ring::push (nano::message_buffer * data_a)
+{
+	auto done (false);
+	auto position (push_position.load (std::memory_order_relaxed));
+	while (!done)
+	{
+		auto & cell (cells[position & mask]);
+		auto sequence (cell.sequence.load (std::memory_order_acquire));
+		auto difference (static_cast<intptr_t> (sequence) - static_cast<intptr_t> (position));
+		if (difference == 0)
+		{
+			// The cell is free for this position, claim it
+			if (push_position.compare_exchange_weak (position, position + 1, std::memory_order_relaxed))
+			{
+				cell.data = data_a;
+				cell.sequence.store (position + 1, std::memory_order_release);
+				done = true;
+			}
+		}
+		else if (difference < 0)
+		{
+			// A pop from one lap ago has claimed the cell but not yet released it. The ring holds every buffer so it can never be full, wait for the pop to finish
+			std::this_thread::yield ();
+			position = push_position.load (std::memory_order_relaxed);
+		}
+		else
+		{
+			position = push_position.load (std::memory_order_relaxed);
+		}
+	}
+}
+
+nano::message_buffer * nano::message_buffer_manager::ring::pop ()
+{
+	nano::message_buffer * result (nullptr);
+	auto done (false);
+	auto position (pop_position.load (std::memory_order_relaxed));
+	while (!done)
+	{
+		auto & cell (cells[position & mask]);
+		auto sequence (cell.sequence.load (std::memory_order_acquire));
+		auto difference (static_cast<intptr_t> (sequence) - static_cast<intptr_t> (position + 1));
+		if (difference == 0)
+		{
+			if (pop_position.compare_exchange_weak (position, position + 1, std::memory_order_relaxed))
+			{
+				result = cell.data;
+				// Make the cell available to the push one lap later
+				cell.sequence.store (position + mask + 1, std::memory_order_release);
+				done = true;
+			}
+		}
+		else if (difference < 0)
+		{
+			// Nothing has been pushed at this position yet
+			done = true;
+		}
+		else
+		{
+			position = pop_position.load (std::memory_order_relaxed);
+		}
+	}
+	return result;
+}
+
 boost::optional<nano::uint256_union> nano::syn_cookies::assign (nano::endpoint const & endpoint_a)
 {
 	auto ip_addr (endpoint_a.address ());
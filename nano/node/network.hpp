@@ -29,7 +29,7 @@ public:
   * buffers which are serviced by internal threads.
   * If buffers are not serviced fast enough they're internally dropped.
   * This container has a maximum space to hold N buffers of M size and will allocate them in round-robin order.
-  * All public methods are thread-safe
+  * All public methods are thread-safe. Buffers are passed through lock-free queues, the mutex is only taken to block when there are none available
 */
 class message_buffer_manager final
 {
@@ -44,26 +44,61 @@ public:
 	// Function will block if there are no free or unserviced buffers
 	// Return nullptr if the container has stopped
 	nano::message_buffer * allocate ();
+	// Return a free buffer without blocking or dequeuing unserviced buffers
+	// Return nullptr if there are no free buffers or the container has stopped
+	nano::message_buffer * try_allocate ();
 	// Queue a buffer that has been filled with message data and notify servicing threads
 	void enqueue (nano::message_buffer *);
 	// Return a buffer that has been filled with message data
 	// Function will block until a buffer has been added
 	// Return nullptr if the container has stopped
 	nano::message_buffer * dequeue ();
+	// Return a buffer that has been filled with message data without blocking
+	// Return nullptr if there are no filled buffers
+	nano::message_buffer * try_dequeue ();
 	// Return a buffer to the freelist after is has been serviced
 	void release (nano::message_buffer *);
 	// Stop container and notify waiting threads
 	void stop ();
 
 private:
+	/** Bounded multi-producer multi-consumer FIFO queue of buffers, with a sequence number per cell (Vyukov) */
+	class ring final
+	{
+	public:
+		explicit ring (size_t);
+		/** The ring must have room, which holds as every buffer fits in it */
+		void push (nano::message_buffer *);
+		/** Returns nullptr if the ring is empty */
+		nano::message_buffer * pop ();
+		/** Smallest power of two holding \p count_a buffers */
+		static size_t capacity (size_t count_a);
+
+	private:
+		class cell final
+		{
+		public:
+			std::atomic<size_t> sequence{ 0 };
+			nano::message_buffer * data{ nullptr };
+		};
+		std::vector<cell> cells;
+		size_t const mask;
+		// Producer and consumer positions are kept on separate cache lines
+		std::atomic<size_t> push_position{ 0 };
+		std::array<uint8_t, 64 - sizeof (std::atomic<size_t>)> padding;
+		std::atomic<size_t> pop_position{ 0 };
+	};
+	void notify ();
 	nano::stat & stats;
 	std::mutex mutex;
 	nano::condition_variable condition;
-	boost::circular_buffer<nano::message_buffer *> free;
-	boost::circular_buffer<nano::message_buffer *> full;
+	ring free;
+	ring full;
 	std::vector<uint8_t> slab;
 	std::vector<nano::message_buffer> entries;
-	bool stopped;
+	std::atomic<bool> stopped{ false };
+	/** Number of threads blocked in allocate or dequeue */
+	std::atomic<unsigned> waiting{ 0 };
 };
 /**
   * Node ID cookies for node ID handshakes
@@ -105,7 +140,7 @@ public:
 		random_fill (message.peers);
 		flood_message (message);
 	}
-	void flood_vote (std::shared_ptr<nano::vote> const &, float scale);
+	void flood_vote (std::shared_ptr<nano::vote> const &, float scale, nano::bandwidth_class = nano::bandwidth_class::vote);
 	void flood_vote_pr (std::shared_ptr<nano::vote> const &);
 	// Flood block to all PRs and a random selection of non-PRs
 	void flood_block_initial (std::shared_ptr<nano::block> const &);
@@ -151,6 +186,8 @@ public:
 	boost::asio::ip::udp::resolver resolver;
 	std::vector<boost::thread> packet_processing_threads;
 	nano::bandwidth_limiter limiter;
+	/** Storage for serialized outgoing messages, shared by every channel a message is sent to */
+	nano::buffer_pool message_buffers;
 	nano::node & node;
 	nano::transport::udp_channels udp_channels;
 	nano::transport::tcp_channels tcp_channels;
@@ -101,6 +101,7 @@ std::unique_ptr<nano::container_info_component> nano::collect_container_info (bl
 	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "blocks_filter", blocks_filter_count, sizeof (decltype (block_processor.blocks_filter)::value_type) }));
 	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "forced", forced_count, sizeof (decltype (block_processor.forced)::value_type) }));
 	composite->add_component (collect_container_info (block_processor.generator, "generator"));
+	composite->add_component (collect_container_info (block_processor.post_events_worker, "post_events_worker"));
 	return composite;
 }
 
@@ -125,7 +126,8 @@ wallets_store_impl (std::make_unique<nano::mdb_wallets_store> (application_path_
 wallets_store (*wallets_store_impl),
 gap_cache (*this),
 ledger (store, stats, flags_a.generate_cache),
-checker (config.signature_checker_threads),
+write_batcher (store, write_database_queue, stats, config.write_batch_max_latency, config.write_batch_size),
+checker (config.signature_checker_threads, flags.signature_checker_backend),
 network (*this, config.peering_port),
 telemetry (std::make_shared<nano::telemetry> (network, alarm, worker, flags.disable_ongoing_telemetry_requests)),
 bootstrap_initiator (*this),
@@ -145,7 +147,7 @@ block_processor_thread ([this]() {
 online_reps (ledger, network_params, config.online_weight_minimum.number ()),
 votes_cache (wallets),
 vote_uniquer (block_uniquer),
-confirmation_height_processor (ledger, write_database_queue, config.conf_height_processor_batch_min_time, logger, node_initialized_latch, flags.confirmation_height_processor_mode),
+confirmation_height_processor (ledger, write_database_queue, write_batcher, config.conf_height_processor_batch_min_time, logger, node_initialized_latch, flags.confirmation_height_processor_mode, config.conf_height_processor_prefetch_threads),
 active (*this, confirmation_height_processor),
 aggregator (network_params.network, config, stats, votes_cache, store, wallets),
 payment_observer_processor (observers.blocks),
@@ -345,7 +347,7 @@ startup_time (std::chrono::steady_clock::now ())
 		auto network_label = network_params.network.get_current_network_as_string ();
 		logger.always_log ("Active network: ", network_label);
 
-		logger.always_log (boost::str (boost::format ("Work pool running %1% threads %2%") % work.threads.size () % (work.opencl ? "(1 for OpenCL)" : "")));
+		logger.always_log (boost::str (boost::format ("Work pool running %1% threads %2% using the %3% hashing kernel") % work.threads.size () % (work.opencl ? "(1 for OpenCL)" : "") % nano::work_v1::kernel_name ()));
 		logger.always_log (boost::str (boost::format ("%1% work peers configured") % config.work_peers.size ()));
 		if (!work_generation_enabled ())
 		{
@@ -370,11 +372,42 @@ startup_time (std::chrono::steady_clock::now ())
 		if (!is_initialized)
 		{
 			release_assert (!flags.read_only);
-			auto transaction (store.tx_begin_write ({ tables::accounts, tables::cached_counts, tables::confirmation_height, tables::frontiers, tables::open_blocks }));
+			auto transaction (store.tx_begin_write ({ tables::accounts, tables::blocks, tables::cached_counts, tables::confirmation_height, tables::frontiers }));
 			// Store was empty meaning we just created it, add the genesis block
 			store.initialize (transaction, genesis, ledger.cache);
 		}
 
+		if (config.block_filter_memory_mb > 0 && !flags.inactive_node)
+		{
+			// Filled before any blocks are processed, so lookups for blocks not in the ledger can skip the database from the start
+			nano::timer<std::chrono::milliseconds> timer_l (nano::timer_state::started);
+			auto transaction (store.tx_begin_read ());
+			store.block_filter_build (transaction, static_cast<size_t> (config.block_filter_memory_mb) * 1024 * 1024);
+			logger.always_log (boost::str (boost::format ("Block filter of %1% MiB built from %2% blocks in %3% ms") % config.block_filter_memory_mb % store.get_block_filter ().element_count () % timer_l.stop ().count ()));
+		}
+
+		if (!flags.read_only && !flags.inactive_node)
+		{
+			// Built or dropped before any blocks are processed, a ledger written to without maintaining the index never keeps a stale one
+			nano::timer<std::chrono::milliseconds> timer_l (nano::timer_state::started);
+			auto transaction (store.tx_begin_write ({ tables::block_heights, tables::blocks, tables::meta }));
+			store.block_height_index_set (transaction, config.block_height_index);
+			if (config.block_height_index)
+			{
+				logger.always_log (boost::str (boost::format ("Block height index enabled in %1% ms") % timer_l.stop ().count ()));
+			}
+		}
+		else
+		{
+			// Command line and read only nodes keep using an existing index, they don't apply the daemon's setting
+			auto transaction (store.tx_begin_read ());
+			store.block_height_index_load (transaction);
+		}
+
+		// Only write transactions use the cache, it's filled as accounts are read and written. RocksDB runs write transactions concurrently,
+		// each would see values the others wrote through before committing, so the cache is only used with LMDB
+		store.get_account_cache ().reset (config.rocksdb_config.enable ? 0 : config.account_cache_size, &stats);
+
 		if (!ledger.block_exists (genesis.hash ()))
 		{
 			std::stringstream ss;
@@ -585,6 +618,7 @@ std::unique_ptr<nano::container_info_component> nano::collect_container_info (no
 	composite->add_component (collect_container_info (node.work, "work"));
 	composite->add_component (collect_container_info (node.gap_cache, "gap_cache"));
 	composite->add_component (collect_container_info (node.ledger, "ledger"));
+	composite->add_component (collect_container_info (node.write_batcher, "write_batcher"));
 	composite->add_component (collect_container_info (node.active, "active"));
 	composite->add_component (collect_container_info (node.bootstrap_initiator, "bootstrap_initiator"));
 	composite->add_component (collect_container_info (node.bootstrap, "bootstrap"));
@@ -618,7 +652,7 @@ void nano::node::process_active (std::shared_ptr<nano::block> incoming)
 
 nano::process_return nano::node::process (nano::block & block_a)
 {
-	auto transaction (store.tx_begin_write ({ tables::accounts, tables::cached_counts, tables::change_blocks, tables::frontiers, tables::open_blocks, tables::pending, tables::receive_blocks, tables::representation, tables::send_blocks, tables::state_blocks }, { tables::confirmation_height }));
+	auto transaction (store.tx_begin_write ({ tables::accounts, tables::blocks, tables::cached_counts, tables::frontiers, tables::pending, tables::representation }, { tables::confirmation_height }));
 	auto result (ledger.process (transaction, block_a));
 	return result;
 }
@@ -632,7 +666,7 @@ nano::process_return nano::node::process_local (std::shared_ptr<nano::block> blo
 	// Notify block processor to release write lock
 	block_processor.wait_write ();
 	// Process block
-	auto transaction (store.tx_begin_write ({ tables::accounts, tables::cached_counts, tables::change_blocks, tables::frontiers, tables::open_blocks, tables::pending, tables::receive_blocks, tables::representation, tables::send_blocks, tables::state_blocks }, { tables::confirmation_height }));
+	auto transaction (store.tx_begin_write ({ tables::accounts, tables::blocks, tables::cached_counts, tables::frontiers, tables::pending, tables::representation }, { tables::confirmation_height }));
 	return block_processor.process_one (transaction, info, work_watcher_a, true);
 }
 
@@ -704,6 +738,7 @@ void nano::node::stop ()
 		vote_processor.stop ();
 		active.stop ();
 		confirmation_height_processor.stop ();
+		write_batcher.stop ();
 		network.stop ();
 		if (telemetry)
 		{
@@ -849,10 +884,9 @@ void nano::node::ongoing_bootstrap ()
 
 void nano::node::ongoing_store_flush ()
 {
-	{
-		auto transaction (store.tx_begin_write ({ tables::vote }));
-		store.flush (transaction);
-	}
+	write_batcher.add (nano::writer::vote, [this](nano::write_transaction const & transaction_a) {
+		store.flush (transaction_a);
+	});
 	std::weak_ptr<nano::node> node_w (shared_from_this ());
 	alarm.add (std::chrono::steady_clock::now () + std::chrono::seconds (5), [node_w]() {
 		if (auto node_l = node_w.lock ())
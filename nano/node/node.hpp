@@ -166,6 +166,7 @@ public:
 	nano::wallets_store & wallets_store;
 	nano::gap_cache gap_cache;
 	nano::ledger ledger;
+	nano::write_batcher write_batcher;
 	nano::signature_checker checker;
 	nano::network network;
 	std::shared_ptr<nano::telemetry> telemetry;
@@ -97,11 +97,22 @@ nano::error nano::node_config::serialize_toml (nano::tomlconfig & toml) const
 	toml.put ("active_elections_size", active_elections_size, "Number of active elections. Elections beyond this limit have limited survival time.\nWarning: modifying this value may result in a lower confirmation rate.\ntype:uint64,[250..]");
 	toml.put ("bandwidth_limit", bandwidth_limit, "Outbound traffic limit in bytes/sec after which messages will be dropped.\nNote: changing to unlimited bandwidth is not recommended for limited connections.\ntype:uint64");
 	toml.put ("conf_height_processor_batch_min_time", conf_height_processor_batch_min_time.count (), "Minimum write batching time when there are blocks pending confirmation height.\ntype:milliseconds");
+	toml.put ("conf_height_processor_prefetch_threads", conf_height_processor_prefetch_threads, "Number of threads reading the uncemented dependencies of blocks waiting for confirmation height processing, so that cementing finds them in memory.\n0 disables reading ahead.\ntype:uint32");
 	toml.put ("backup_before_upgrade", backup_before_upgrade, "Backup the ledger database before performing upgrades.\nWarning: uses more disk storage and increases startup time when upgrading.\ntype:bool");
 	toml.put ("work_watcher_period", work_watcher_period.count (), "Time between checks for confirmation and re-generating higher difficulty work if unconfirmed, for blocks in the work watcher.\ntype:seconds");
 	toml.put ("max_work_generate_multiplier", max_work_generate_multiplier, "Maximum allowed difficulty multiplier for work generation.\ntype:double,[1..]");
 	toml.put ("frontiers_confirmation", serialize_frontiers_confirmation (frontiers_confirmation), "Mode controlling frontier confirmation rate.\ntype:string,{auto,always,disabled}");
 	toml.put ("max_queued_requests", max_queued_requests, "Limit for number of queued confirmation requests for one channel, after which new requests are dropped until the queue drops below this value.\ntype:uint32");
+	toml.put ("block_filter_memory_mb", block_filter_memory_mb, "Memory in MiB used by the filter which avoids database reads when looking up blocks which are not in the ledger. It is filled with all blocks at startup, larger filters reject more lookups.\n0 disables the filter.\ntype:uint32");
+	toml.put ("account_cache_size", account_cache_size, "Maximum number of accounts whose account info and confirmation height are cached for ledger writes, such as block processing and cementing. Writes go through to the cache. Only used with LMDB.\n0 disables the cache.\ntype:uint64");
+	toml.put ("write_batch_max_latency", write_batch_max_latency.count (), "Maximum time deferrable writes such as peers and vote flushes wait to share a database commit with other writes before being committed on their own.\ntype:milliseconds");
+	toml.put ("write_batch_size", write_batch_size, "Number of queued deferrable writes which are committed without waiting for write_batch_max_latency.\ntype:uint32");
+	toml.put ("block_height_index", block_height_index, "Maintain an index of each account's blocks by height, used to find blocks at a given height without walking the account chain. The node builds it at startup when enabled and removes it when disabled, command line tools keep maintaining an existing index.\ntype:bool");
+	toml.put ("udp_batch_io", udp_batch_io, "Receive and send multiple UDP datagrams per system call. Only supported on Linux, ignored elsewhere.\ntype:bool");
+	toml.put ("bandwidth_local_vote_share", bandwidth_local_vote_share, "Share of bandwidth_limit reserved for votes from local representatives while they are being sent. Other traffic is limited to the rest.\ntype:double,[0..1]");
+	toml.put ("bandwidth_vote_share", bandwidth_vote_share, "Share of bandwidth_limit reserved for relayed votes and confirmation requests while they are being sent.\ntype:double,[0..1]");
+	toml.put ("bandwidth_block_share", bandwidth_block_share, "Share of bandwidth_limit reserved for published blocks while they are being sent.\ntype:double,[0..1]");
+	toml.put ("bandwidth_bulk_share", bandwidth_bulk_share, "Share of bandwidth_limit which bulk republishing of blocks can use, so that it backs off before other traffic.\ntype:double,[0..1]");
 
 	auto work_peers_l (toml.create_array ("work_peers", "A list of \"address:port\" entries to identify work peers."));
 	for (auto i (work_peers.begin ()), n (work_peers.end ()); i != n; ++i)
@@ -356,12 +367,25 @@ nano::error nano::node_config::deserialize_toml (nano::tomlconfig & toml)
 		auto conf_height_processor_batch_min_time_l (conf_height_processor_batch_min_time.count ());
 		toml.get ("conf_height_processor_batch_min_time", conf_height_processor_batch_min_time_l);
 		conf_height_processor_batch_min_time = std::chrono::milliseconds (conf_height_processor_batch_min_time_l);
+		toml.get<unsigned> ("conf_height_processor_prefetch_threads", conf_height_processor_prefetch_threads);
 
 		nano::network_constants network;
 		toml.get<double> ("max_work_generate_multiplier", max_work_generate_multiplier);
 		max_work_generate_difficulty = nano::difficulty::from_multiplier (max_work_generate_multiplier, network.publish_threshold);
 
 		toml.get<uint32_t> ("max_queued_requests", max_queued_requests);
+		toml.get<uint32_t> ("block_filter_memory_mb", block_filter_memory_mb);
+		toml.get<size_t> ("account_cache_size", account_cache_size);
+		toml.get<bool> ("block_height_index", block_height_index);
+		auto write_batch_max_latency_l (write_batch_max_latency.count ());
+		toml.get ("write_batch_max_latency", write_batch_max_latency_l);
+		write_batch_max_latency = std::chrono::milliseconds (write_batch_max_latency_l);
+		toml.get<uint32_t> ("write_batch_size", write_batch_size);
+		toml.get<bool> ("udp_batch_io", udp_batch_io);
+		toml.get<double> ("bandwidth_local_vote_share", bandwidth_local_vote_share);
+		toml.get<double> ("bandwidth_vote_share", bandwidth_vote_share);
+		toml.get<double> ("bandwidth_block_share", bandwidth_block_share);
+		toml.get<double> ("bandwidth_bulk_share", bandwidth_bulk_share);
 
 		if (toml.has_key ("frontiers_confirmation"))
 		{
@@ -402,6 +426,14 @@ nano::error nano::node_config::deserialize_toml (nano::tomlconfig & toml)
 		{
 			toml.get_error ().set ("bandwidth_limit unbounded = 0, default = 5242880, max = 18446744073709551615");
 		}
+		if (bandwidth_local_vote_share < 0 || bandwidth_vote_share < 0 || bandwidth_block_share < 0 || bandwidth_local_vote_share + bandwidth_vote_share + bandwidth_block_share > 1)
+		{
+			toml.get_error ().set ("bandwidth_local_vote_share, bandwidth_vote_share and bandwidth_block_share must not be negative and must add up to at most 1");
+		}
+		if (bandwidth_bulk_share < 0 || bandwidth_bulk_share > 1)
+		{
+			toml.get_error ().set ("bandwidth_bulk_share must be a number between 0 and 1");
+		}
 		if (vote_generator_threshold < 1 || vote_generator_threshold > 11)
 		{
 			toml.get_error ().set ("vote_generator_threshold must be a number between 1 and 11");
@@ -91,11 +91,29 @@ public:
 	static std::chrono::minutes constexpr wallet_backup_interval = std::chrono::minutes (5);
 	size_t bandwidth_limit{ 5 * 1024 * 1024 }; // 5MB/s
 	std::chrono::milliseconds conf_height_processor_batch_min_time{ 50 };
+	/** Threads reading the dependencies of blocks waiting for confirmation height processing ahead of it, 0 disables read ahead */
+	unsigned conf_height_processor_prefetch_threads{ 2 };
 	bool backup_before_upgrade{ false };
 	std::chrono::seconds work_watcher_period{ std::chrono::seconds (5) };
 	double max_work_generate_multiplier{ 64. };
 	uint64_t max_work_generate_difficulty{ nano::network_constants::publish_full_threshold };
 	uint32_t max_queued_requests{ 512 };
+	/** Memory used by the filter which lets lookups for blocks not in the ledger skip the database, 0 disables it */
+	uint32_t block_filter_memory_mb{ network_params.network.is_test_network () ? 1u : 64u };
+	size_t account_cache_size{ network_params.network.is_test_network () ? 1024u : 64u * 1024 };
+	/** Maintain an index of each account's blocks by height, so blocks at a given height are found without walking the chain */
+	bool block_height_index{ false };
+	/** Writes which can be deferred, such as peers and vote flushes, are committed with other writes or once the oldest has waited this long or write_batch_size are queued */
+	std::chrono::milliseconds write_batch_max_latency{ network_params.network.is_test_network () ? 50 : 1000 };
+	uint32_t write_batch_size{ 64 };
+	/** Receive and send UDP datagrams in batches with recvmmsg/sendmmsg, only supported on Linux */
+	bool udp_batch_io{ false };
+	/** Shares of bandwidth_limit reserved for votes from local representatives, relayed votes and published blocks while each is being sent */
+	double bandwidth_local_vote_share{ 0.2 };
+	double bandwidth_vote_share{ 0.1 };
+	double bandwidth_block_share{ 0.1 };
+	/** Share of bandwidth_limit above which bulk republishing is dropped */
+	double bandwidth_bulk_share{ 0.5 };
 	nano::rocksdb_config rocksdb_config;
 	nano::lmdb_config lmdb_config;
 	nano::frontiers_confirmation_mode frontiers_confirmation{ nano::frontiers_confirmation_mode::automatic };
@@ -141,6 +159,7 @@ public:
 	size_t block_processor_batch_size{ 0 };
 	size_t block_processor_full_size{ 65536 };
 	size_t block_processor_verification_size{ 0 };
+	nano::signature_backend signature_checker_backend{ nano::signature_backend::batch };
 	size_t inactive_votes_cache_size{ 16 * 1024 };
 	size_t vote_processor_capacity{ 144 * 1024 };
 };
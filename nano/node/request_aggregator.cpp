@@ -88,7 +88,7 @@ void nano::request_aggregator::run ()
 				for (auto const & vote : remaining.first)
 				{
 					nano::confirm_ack confirm (vote);
-					channel->send (confirm);
+					channel->send (confirm, nano::bandwidth_class::local_vote);
 				}
 				if (!remaining.second.empty ())
 				{
@@ -221,7 +221,7 @@ void nano::request_aggregator::generate (nano::transaction const & transaction_a
 			auto vote (this->store.vote_generate (transaction_a, pub_a, prv_a, hashes_l));
 			++generated_l;
 			nano::confirm_ack confirm (vote);
-			channel_a->send (confirm);
+			channel_a->send (confirm, nano::bandwidth_class::local_vote);
 			this->votes_cache.add (vote);
 		});
 	}
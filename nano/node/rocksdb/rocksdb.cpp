@@ -10,6 +10,7 @@
 
 #include <rocksdb/merge_operator.h>
 #include <rocksdb/slice.h>
+#include <rocksdb/slice_transform.h>
 #include <rocksdb/utilities/backupable_db.h>
 #include <rocksdb/utilities/transaction.h>
 #include <rocksdb/utilities/transaction_db.h>
@@ -52,8 +53,7 @@ rocksdb_config (rocksdb_config_a)
 
 	if (!error)
 	{
-		auto table_options = get_table_options ();
-		table_factory.reset (rocksdb::NewBlockBasedTableFactory (table_options));
+		construct_table_factories ();
 		if (!open_read_only_a)
 		{
 			construct_column_family_mutexes ();
@@ -74,11 +74,11 @@ nano::rocksdb_store::~rocksdb_store ()
 
 void nano::rocksdb_store::open (bool & error_a, boost::filesystem::path const & path_a, bool open_read_only_a)
 {
-	std::initializer_list<const char *> names{ rocksdb::kDefaultColumnFamilyName.c_str (), "frontiers", "accounts", "send", "receive", "open", "change", "state_blocks", "pending", "representation", "unchecked", "vote", "online_weight", "meta", "peers", "cached_counts", "confirmation_height" };
+	std::initializer_list<const char *> names{ rocksdb::kDefaultColumnFamilyName.c_str (), "frontiers", "accounts", "blocks", "send", "receive", "open", "change", "state_blocks", "pending", "representation", "unchecked", "vote", "online_weight", "meta", "peers", "cached_counts", "confirmation_height", "block_heights" };
 	std::vector<rocksdb::ColumnFamilyDescriptor> column_families;
 	for (const auto & cf_name : names)
 	{
-		column_families.emplace_back (cf_name, get_cf_options ());
+		column_families.emplace_back (cf_name, get_cf_options (cf_name));
 	}
 
 	auto options = get_db_options ();
@@ -86,6 +86,13 @@ void nano::rocksdb_store::open (bool & error_a, boost::filesystem::path const &
 
 	if (open_read_only_a)
 	{
+		// The optional block height index only exists once a node has opened the ledger for writing
+		std::vector<std::string> existing_families;
+		rocksdb::DB::ListColumnFamilies (options, path_a.string (), &existing_families);
+		if (std::find (existing_families.begin (), existing_families.end (), "block_heights") == existing_families.end ())
+		{
+			column_families.pop_back ();
+		}
 		s = rocksdb::DB::OpenForReadOnly (options, path_a.string (), column_families, &handles, &db);
 	}
 	else
@@ -102,14 +109,69 @@ void nano::rocksdb_store::open (bool & error_a, boost::filesystem::path const &
 
 	if (!error_a)
 	{
-		auto transaction = tx_begin_read ();
-		auto version_l = version_get (transaction);
+		auto version_l = version_get (tx_begin_read ());
 		if (version_l > version)
 		{
 			error_a = true;
 			logger.always_log (boost::str (boost::format ("The version of the ledger (%1%) is too high for this node") % version_l));
 		}
+		else if (version_l < version)
+		{
+			if (open_read_only_a)
+			{
+				error_a = true;
+				logger.always_log (boost::str (boost::format ("The version of the ledger (%1%) needs upgrading, which requires it to be opened for writing") % version_l));
+			}
+			else
+			{
+				upgrade_v18_to_v19 ();
+			}
+		}
+	}
+}
+
+/** Blocks used to be stored in a column family per block type, these are merged into a single column family with each value prefixed by its type */
+void nano::rocksdb_store::upgrade_v18_to_v19 ()
+{
+	logger.always_log ("Preparing v18 to v19 database upgrade...");
+	size_t constexpr upgrade_batch_size = 10000;
+	auto transaction (tx_begin_write ());
+	std::pair<nano::tables, nano::block_type> const legacy_tables[]{ { tables::state_blocks, nano::block_type::state }, { tables::send_blocks, nano::block_type::send }, { tables::receive_blocks, nano::block_type::receive }, { tables::open_blocks, nano::block_type::open }, { tables::change_blocks, nano::block_type::change } };
+	for (auto const & legacy : legacy_tables)
+	{
+		// Move the blocks in batches to bound the size of each transaction. Each batch seeks past the last key moved,
+		// so that iteration doesn't have to skip over the tombstones left behind by the previous batches.
+		std::vector<std::pair<nano::block_hash, std::vector<uint8_t>>> batch;
+		nano::block_hash start (0);
+		do
+		{
+			batch.clear ();
+			for (auto i (make_iterator<nano::block_hash, nano::rocksdb_val> (transaction, legacy.first, nano::rocksdb_val (start))), n (nano::store_iterator<nano::block_hash, nano::rocksdb_val> (nullptr)); i != n && batch.size () < upgrade_batch_size; ++i)
+			{
+				auto const & value (i->second);
+				std::vector<uint8_t> data;
+				data.reserve (1 + value.size ());
+				data.push_back (static_cast<uint8_t> (legacy.second));
+				data.insert (data.end (), static_cast<uint8_t const *> (value.data ()), static_cast<uint8_t const *> (value.data ()) + value.size ());
+				batch.emplace_back (i->first, std::move (data));
+			}
+			for (auto const & entry : batch)
+			{
+				auto status (put (transaction, tables::blocks, entry.first, nano::rocksdb_val (entry.second.size (), const_cast<uint8_t *> (entry.second.data ()))));
+				release_assert (success (status));
+				status = del (transaction, legacy.first, entry.first);
+				release_assert (success (status));
+			}
+			if (!batch.empty ())
+			{
+				start = batch.back ().first.number () + 1;
+			}
+			transaction.commit ();
+			transaction.renew ();
+		} while (!batch.empty ());
 	}
+	version_put (transaction, version);
+	logger.always_log ("Finished merging the block tables");
 }
 
 nano::write_transaction nano::rocksdb_store::tx_begin_write (std::vector<nano::tables> const & tables_requiring_locks_a, std::vector<nano::tables> const & tables_no_locks_a)
@@ -123,7 +185,14 @@ nano::write_transaction nano::rocksdb_store::tx_begin_write (std::vector<nano::t
 	}
 	else
 	{
-		txn = std::make_unique<nano::write_rocksdb_txn> (optimistic_db, tables_requiring_locks_a, tables_no_locks_a, write_lock_mutexes);
+		// The block height index is written along with the blocks table, so it's locked whenever that is
+		auto tables_requiring_locks_l (tables_requiring_locks_a);
+		auto blocks_it (std::find (tables_requiring_locks_l.begin (), tables_requiring_locks_l.end (), tables::blocks));
+		if (blocks_it != tables_requiring_locks_l.end () && std::find (tables_requiring_locks_l.begin (), blocks_it, tables::block_heights) == blocks_it)
+		{
+			tables_requiring_locks_l.insert (blocks_it, tables::block_heights);
+		}
+		txn = std::make_unique<nano::write_rocksdb_txn> (optimistic_db, tables_requiring_locks_l, tables_no_locks_a, write_lock_mutexes);
 	}
 
 	// Tables must be kept in alphabetical order. These can be used for mutex locking, so order is important to prevent deadlocking
@@ -159,6 +228,10 @@ rocksdb::ColumnFamilyHandle * nano::rocksdb_store::table_to_column_family (table
 			return get_handle ("frontiers");
 		case tables::accounts:
 			return get_handle ("accounts");
+		case tables::block_heights:
+			return get_handle ("block_heights");
+		case tables::blocks:
+			return get_handle ("blocks");
 		case tables::send_blocks:
 			return get_handle ("send");
 		case tables::receive_blocks:
@@ -278,6 +351,7 @@ bool nano::rocksdb_store::is_caching_counts (nano::tables table_a) const
 {
 	switch (table_a)
 	{
+		case tables::blocks:
 		case tables::send_blocks:
 		case tables::receive_blocks:
 		case tables::open_blocks:
@@ -451,7 +525,7 @@ int nano::rocksdb_store::clear (rocksdb::ColumnFamilyHandle * column_family)
 	// Need to add it back as we just want to clear the contents
 	auto handle_it = std::find (handles.begin (), handles.end (), column_family);
 	debug_assert (handle_it != handles.cend ());
-	status = db->CreateColumnFamily (get_cf_options (), name, &column_family);
+	status = db->CreateColumnFamily (get_cf_options (name), name, &column_family);
 	release_assert (status.ok ());
 	*handle_it = column_family;
 	return status.code ();
@@ -490,18 +564,47 @@ rocksdb::Options nano::rocksdb_store::get_db_options () const
 	return db_options;
 }
 
-rocksdb::BlockBasedTableOptions nano::rocksdb_store::get_table_options () const
+void nano::rocksdb_store::construct_table_factories ()
+{
+	// Block cache for reads, shared by every column family without a cache of its own
+	auto block_cache (rocksdb::NewLRUCache (rocksdb_config.block_cache * 1024 * 1024ULL));
+	table_factory.reset (rocksdb::NewBlockBasedTableFactory (get_table_options (block_cache, rocksdb_config.bloom_filter_bits)));
+
+	// Blocks are only read by hash, a whole key bloom filter saves reading data blocks for hashes which aren't in the ledger
+	if (rocksdb_config.blocks_bloom_filter_bits > 0)
+	{
+		table_factories["blocks"].reset (rocksdb::NewBlockBasedTableFactory (get_table_options (block_cache, rocksdb_config.blocks_bloom_filter_bits)));
+	}
+
+	// Pending and unchecked are searched by the first half of their keys, the filter also holds these prefixes (see get_cf_options)
+	if (rocksdb_config.prefix_bloom_filter_bits > 0)
+	{
+		std::shared_ptr<rocksdb::TableFactory> prefix_table_factory (rocksdb::NewBlockBasedTableFactory (get_table_options (block_cache, rocksdb_config.prefix_bloom_filter_bits)));
+		table_factories["pending"] = prefix_table_factory;
+		table_factories["unchecked"] = prefix_table_factory;
+	}
+
+	// Confirmation height is small and read for most blocks processed, a cache of its own stops block reads evicting it
+	if (rocksdb_config.confirmation_height_cache > 0)
+	{
+		auto table_options (get_table_options (rocksdb::NewLRUCache (rocksdb_config.confirmation_height_cache * 1024 * 1024ULL), rocksdb_config.bloom_filter_bits));
+		table_options.cache_index_and_filter_blocks = true;
+		table_options.pin_l0_filter_and_index_blocks_in_cache = true;
+		table_factories["confirmation_height"].reset (rocksdb::NewBlockBasedTableFactory (table_options));
+	}
+}
+
+rocksdb::BlockBasedTableOptions nano::rocksdb_store::get_table_options (std::shared_ptr<rocksdb::Cache> const & block_cache_a, unsigned bloom_filter_bits_a) const
 {
 	rocksdb::BlockBasedTableOptions table_options;
 
 	// Block cache for reads
-	table_options.block_cache = rocksdb::NewLRUCache (rocksdb_config.block_cache * 1024 * 1024ULL);
+	table_options.block_cache = block_cache_a;
 
 	// Bloom filter to help with point reads
-	auto bloom_filter_bits = rocksdb_config.bloom_filter_bits;
-	if (bloom_filter_bits > 0)
+	if (bloom_filter_bits_a > 0)
 	{
-		table_options.filter_policy.reset (rocksdb::NewBloomFilterPolicy (bloom_filter_bits, false));
+		table_options.filter_policy.reset (rocksdb::NewBloomFilterPolicy (bloom_filter_bits_a, false));
 	}
 
 	// Increasing block_size decreases memory usage and space amplification, but increases read amplification.
@@ -514,10 +617,11 @@ rocksdb::BlockBasedTableOptions nano::rocksdb_store::get_table_options () const
 	return table_options;
 }
 
-rocksdb::ColumnFamilyOptions nano::rocksdb_store::get_cf_options () const
+rocksdb::ColumnFamilyOptions nano::rocksdb_store::get_cf_options (std::string const & cf_name_a) const
 {
 	rocksdb::ColumnFamilyOptions cf_options;
-	cf_options.table_factory = table_factory;
+	auto existing (table_factories.find (cf_name_a));
+	cf_options.table_factory = existing != table_factories.end () ? existing->second : table_factory;
 
 	// Number of files in level which triggers compaction. Size of L0 and L1 should be kept similar as this is the only compaction which is single threaded
 	cf_options.level0_file_num_compaction_trigger = 4;
@@ -543,12 +647,30 @@ rocksdb::ColumnFamilyOptions nano::rocksdb_store::get_cf_options () const
 	// Number of memtables to keep in memory (1 active, rest inactive/immutable)
 	cf_options.max_write_buffer_number = rocksdb_config.num_memtables;
 
+	if (rocksdb_config.prefix_bloom_filter_bits > 0 && (cf_name_a == "pending" || cf_name_a == "unchecked"))
+	{
+		// Pending keys start with the account and unchecked keys with the previous hash. Whole keys stay in the filter for point reads
+		cf_options.prefix_extractor.reset (rocksdb::NewFixedPrefixTransform (sizeof (nano::block_hash)));
+
+		// Prefix bloom filter for memtables, sized as a fraction of write_buffer_size
+		cf_options.memtable_prefix_bloom_size_ratio = 0.1;
+	}
+
+	if (rocksdb_config.unchecked_universal_compaction && cf_name_a == "unchecked")
+	{
+		// Unchecked entries are mostly deleted soon after being added, universal compaction rewrites them fewer times than levels do
+		cf_options.compaction_style = rocksdb::kCompactionStyleUniversal;
+
+		// Periodic compaction by age is only supported with level compaction
+		cf_options.ttl = 0;
+	}
+
 	return cf_options;
 }
 
 std::vector<nano::tables> nano::rocksdb_store::all_tables () const
 {
-	return std::vector<nano::tables>{ tables::accounts, tables::cached_counts, tables::change_blocks, tables::confirmation_height, tables::frontiers, tables::meta, tables::online_weight, tables::open_blocks, tables::peers, tables::pending, tables::receive_blocks, tables::representation, tables::send_blocks, tables::state_blocks, tables::unchecked, tables::vote };
+	return std::vector<nano::tables>{ tables::accounts, tables::block_heights, tables::blocks, tables::cached_counts, tables::change_blocks, tables::confirmation_height, tables::frontiers, tables::meta, tables::online_weight, tables::open_blocks, tables::peers, tables::pending, tables::receive_blocks, tables::representation, tables::send_blocks, tables::state_blocks, tables::unchecked, tables::vote };
 }
 
 bool nano::rocksdb_store::copy_db (boost::filesystem::path const & destination_path)
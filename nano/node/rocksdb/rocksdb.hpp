@@ -69,6 +69,13 @@ public:
 		return nano::store_iterator<Key, Value> (std::make_unique<nano::rocksdb_iterator<Key, Value>> (db, transaction_a, table_to_column_family (table_a), key));
 	}
 
+	/** Seeks through the prefix bloom filter of tables with a prefix extractor, the iterator ends after the entries sharing \p key's prefix */
+	template <typename Key, typename Value>
+	nano::store_iterator<Key, Value> make_prefix_iterator (nano::transaction const & transaction_a, tables table_a, nano::rocksdb_val const & key) const
+	{
+		return nano::store_iterator<Key, Value> (std::make_unique<nano::rocksdb_iterator<Key, Value>> (db, transaction_a, table_to_column_family (table_a), key, true));
+	}
+
 	bool init_error () const override;
 
 private:
@@ -79,6 +86,8 @@ private:
 	rocksdb::OptimisticTransactionDB * optimistic_db = nullptr;
 	rocksdb::DB * db = nullptr;
 	std::shared_ptr<rocksdb::TableFactory> table_factory;
+	/** Table factories of column families with an option profile of their own, keyed by column family name */
+	std::unordered_map<std::string, std::shared_ptr<rocksdb::TableFactory>> table_factories;
 	std::unordered_map<nano::tables, std::mutex> write_lock_mutexes;
 
 	rocksdb::Transaction * tx (nano::transaction const & transaction_a) const;
@@ -93,15 +102,17 @@ private:
 	int clear (rocksdb::ColumnFamilyHandle * column_family);
 
 	void open (bool & error_a, boost::filesystem::path const & path_a, bool open_read_only_a);
+	void upgrade_v18_to_v19 ();
 	uint64_t count (nano::transaction const & transaction_a, rocksdb::ColumnFamilyHandle * handle) const;
 	bool is_caching_counts (nano::tables table_a) const;
 
 	int increment (nano::write_transaction const & transaction_a, tables table_a, nano::rocksdb_val const & key_a, uint64_t amount_a);
 	int decrement (nano::write_transaction const & transaction_a, tables table_a, nano::rocksdb_val const & key_a, uint64_t amount_a);
-	rocksdb::ColumnFamilyOptions get_cf_options () const;
+	rocksdb::ColumnFamilyOptions get_cf_options (std::string const & cf_name_a) const;
 	void construct_column_family_mutexes ();
+	void construct_table_factories ();
 	rocksdb::Options get_db_options () const;
-	rocksdb::BlockBasedTableOptions get_table_options () const;
+	rocksdb::BlockBasedTableOptions get_table_options (std::shared_ptr<rocksdb::Cache> const & block_cache_a, unsigned bloom_filter_bits_a) const;
 	nano::rocksdb_config rocksdb_config;
 };
 
@@ -21,6 +21,25 @@ inline rocksdb::ReadOptions const & snapshot_options (nano::transaction const &
 	debug_assert (is_read (transaction_a));
 	return *static_cast<const rocksdb::ReadOptions *> (transaction_a.get_handle ());
 }
+
+/**
+ * Iterators carry on past the prefix they were seeked to, such as from one account's pending entries to the next.
+ * Column families with a prefix extractor only guarantee that when seeking in total order, which skips the prefix bloom filter.
+ * Iterators which only need the entries sharing the seek key's prefix seek through the filter instead and end after them.
+ */
+inline rocksdb::ReadOptions iterator_options (rocksdb::ReadOptions const & options_a, bool prefix_a = false)
+{
+	auto result (options_a);
+	if (prefix_a)
+	{
+		result.prefix_same_as_start = true;
+	}
+	else
+	{
+		result.total_order_seek = true;
+	}
+	return result;
+}
 }
 
 namespace nano
@@ -36,13 +55,13 @@ public:
 		rocksdb::Iterator * iter;
 		if (is_read (transaction_a))
 		{
-			iter = db->NewIterator (snapshot_options (transaction_a), handle_a);
+			iter = db->NewIterator (iterator_options (snapshot_options (transaction_a)), handle_a);
 		}
 		else
 		{
 			rocksdb::ReadOptions ropts;
 			ropts.fill_cache = false;
-			iter = tx (transaction_a)->GetIterator (ropts, handle_a);
+			iter = tx (transaction_a)->GetIterator (iterator_options (ropts), handle_a);
 		}
 
 		cursor.reset (iter);
@@ -61,16 +80,16 @@ public:
 
 	rocksdb_iterator () = default;
 
-	rocksdb_iterator (rocksdb::DB * db, nano::transaction const & transaction_a, rocksdb::ColumnFamilyHandle * handle_a, rocksdb_val const & val_a)
+	rocksdb_iterator (rocksdb::DB * db, nano::transaction const & transaction_a, rocksdb::ColumnFamilyHandle * handle_a, rocksdb_val const & val_a, bool prefix_a = false)
 	{
 		rocksdb::Iterator * iter;
 		if (is_read (transaction_a))
 		{
-			iter = db->NewIterator (snapshot_options (transaction_a), handle_a);
+			iter = db->NewIterator (iterator_options (snapshot_options (transaction_a), prefix_a), handle_a);
 		}
 		else
 		{
-			iter = tx (transaction_a)->GetIterator (rocksdb::ReadOptions (), handle_a);
+			iter = tx (transaction_a)->GetIterator (iterator_options (rocksdb::ReadOptions (), prefix_a), handle_a);
 		}
 
 		cursor.reset (iter);
@@ -4,7 +4,8 @@
 #include <nano/lib/threading.hpp>
 #include <nano/node/signatures.hpp>
 
-nano::signature_checker::signature_checker (unsigned num_threads) :
+nano::signature_checker::signature_checker (unsigned num_threads, nano::signature_backend backend_a) :
+backend (backend_a),
 thread_pool (num_threads),
 single_threaded (num_threads == 0),
 num_threads (num_threads)
@@ -94,7 +95,7 @@ void nano::signature_checker::flush ()
 bool nano::signature_checker::verify_batch (const nano::signature_check_set & check_a, size_t start_index, size_t size)
 {
 	/* Returns false if there are at least 1 invalid signature */
-	auto code (nano::validate_message_batch (check_a.messages + start_index, check_a.message_lengths + start_index, check_a.pub_keys + start_index, check_a.signatures + start_index, size, check_a.verifications + start_index));
+	auto code (nano::validate_message_batch (check_a.messages + start_index, check_a.message_lengths + start_index, check_a.pub_keys + start_index, check_a.signatures + start_index, size, check_a.verifications + start_index, backend));
 	(void)code;
 
 	return std::all_of (check_a.verifications + start_index, check_a.verifications + start_index + size, [](int verification) { return verification == 0 || verification == 1; });
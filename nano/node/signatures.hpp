@@ -1,6 +1,7 @@
 #pragma once
 
 #include <nano/boost/asio/thread_pool.hpp>
+#include <nano/lib/numbers.hpp>
 #include <nano/lib/utility.hpp>
 
 #include <atomic>
@@ -29,11 +30,15 @@ public:
 class signature_checker final
 {
 public:
-	signature_checker (unsigned num_threads);
+	signature_checker (unsigned num_threads, nano::signature_backend = nano::signature_backend::batch);
 	~signature_checker ();
 	void verify (signature_check_set &);
 	void stop ();
 	void flush ();
+	/** minimum signature_check_set size eligible to be multithreaded */
+	static constexpr size_t multithreaded_cutoff = 513;
+	static constexpr size_t batch_size = 256;
+	nano::signature_backend const backend;
 
 private:
 	struct Task final
@@ -55,9 +60,6 @@ private:
 	void set_thread_names (unsigned num_threads);
 	boost::asio::thread_pool thread_pool;
 	std::atomic<int> tasks_remaining{ 0 };
-	/** minimum signature_check_set size eligible to be multithreaded */
-	static constexpr size_t multithreaded_cutoff = 513;
-	static constexpr size_t batch_size = 256;
 	const bool single_threaded;
 	unsigned num_threads;
 	std::mutex mutex;
@@ -6,6 +6,7 @@
 
 #include <boost/format.hpp>
 
+#include <iterator>
 #include <limits>
 
 nano::socket::socket (std::shared_ptr<nano::node> node_a, boost::optional<std::chrono::seconds> io_timeout_a, nano::socket::concurrency concurrency_a) :
@@ -72,6 +73,36 @@ void nano::socket::async_read (std::shared_ptr<std::vector<uint8_t>> buffer_a, s
 	}
 }
 
+void nano::socket::async_read_some (std::shared_ptr<std::vector<uint8_t>> buffer_a, size_t offset_a, size_t size_a, std::function<void(boost::system::error_code const &, size_t)> callback_a)
+{
+	if (size_a > 0 && offset_a + size_a <= buffer_a->size ())
+	{
+		auto this_l (shared_from_this ());
+		if (!closed)
+		{
+			start_timer ();
+			boost::asio::post (strand, boost::asio::bind_executor (strand, [buffer_a, callback_a, offset_a, size_a, this_l]() {
+				this_l->tcp_socket.async_read_some (boost::asio::buffer (buffer_a->data () + offset_a, size_a),
+				boost::asio::bind_executor (this_l->strand,
+				[this_l, buffer_a, callback_a](boost::system::error_code const & ec, size_t size_a) {
+					if (auto node = this_l->node.lock ())
+					{
+						node->stats.add (nano::stat::type::traffic_tcp, nano::stat::dir::in, size_a);
+						this_l->stop_timer ();
+						callback_a (ec, size_a);
+					}
+				}));
+			}));
+		}
+	}
+	else
+	{
+		debug_assert (false && "nano::socket::async_read_some called with incorrect buffer size");
+		boost::system::error_code ec_buffer = boost::system::errc::make_error_code (boost::system::errc::no_buffer_space);
+		callback_a (ec_buffer, 0);
+	}
+}
+
 void nano::socket::async_write (nano::shared_const_buffer const & buffer_a, std::function<void(boost::system::error_code const &, size_t)> callback_a, nano::buffer_drop_policy drop_policy_a)
 {
 	auto this_l (shared_from_this ());
@@ -121,27 +152,52 @@ void nano::socket::write_queued_messages ()
 	if (!closed)
 	{
 		std::weak_ptr<nano::socket> this_w (shared_from_this ());
-		auto msg (send_queue.front ());
+		// Gather queued buffers into a single write, they stay in the queue until it completes. The handler holds its own references
+		// to the buffers being written as close_internal () can clear the queue while the write is in flight
+		std::vector<boost::asio::const_buffer> buffers;
+		std::vector<nano::shared_const_buffer> held;
+		size_t bytes (0);
+		for (auto i (send_queue.begin ()), n (send_queue.end ()); i != n; ++i)
+		{
+			auto buffer_count (static_cast<size_t> (std::distance (i->buffer.begin (), i->buffer.end ())));
+			if (!held.empty () && (buffers.size () + buffer_count > write_batch_buffers_max || bytes + i->buffer.size () > write_batch_bytes_max))
+			{
+				break;
+			}
+			buffers.insert (buffers.end (), i->buffer.begin (), i->buffer.end ());
+			bytes += i->buffer.size ();
+			held.push_back (i->buffer);
+		}
+		auto count (held.size ());
 		start_timer ();
-		nano::async_write (tcp_socket, msg.buffer,
+		nano::unsafe_async_write (tcp_socket, buffers,
 		boost::asio::bind_executor (strand,
-		[msg, this_w](boost::system::error_code ec, std::size_t size_a) {
+		[count, held = std::move (held), this_w](boost::system::error_code ec, std::size_t size_a) {
 			if (auto this_l = this_w.lock ())
 			{
 				if (auto node = this_l->node.lock ())
 				{
 					node->stats.add (nano::stat::type::traffic_tcp, nano::stat::dir::out, size_a);
+					node->stats.inc (nano::stat::type::tcp, nano::stat::detail::tcp_write_batch, nano::stat::dir::out);
+					node->stats.add (nano::stat::type::tcp, nano::stat::detail::tcp_write_batch_messages, nano::stat::dir::out, count);
 
 					this_l->stop_timer ();
 
 					if (!this_l->closed)
 					{
-						if (msg.callback)
+						// Each callback is passed the part of its own buffer that was written
+						auto remaining (size_a);
+						for (size_t i (0); i < count; ++i)
 						{
-							msg.callback (ec, size_a);
+							auto msg (std::move (this_l->send_queue.front ()));
+							this_l->send_queue.pop_front ();
+							auto written (std::min (remaining, msg.buffer.size ()));
+							remaining -= written;
+							if (msg.callback)
+							{
+								msg.callback (ec, written);
+							}
 						}
-
-						this_l->send_queue.pop_front ();
 						if (!ec && !this_l->send_queue.empty ())
 						{
 							this_l->write_queued_messages ();
@@ -55,6 +55,8 @@ public:
 	virtual ~socket ();
 	void async_connect (boost::asio::ip::tcp::endpoint const &, std::function<void(boost::system::error_code const &)>);
 	void async_read (std::shared_ptr<std::vector<uint8_t>>, size_t, std::function<void(boost::system::error_code const &, size_t)>);
+	/** Reads whatever is available, up to \p size_a bytes, into the buffer starting at \p offset_a */
+	void async_read_some (std::shared_ptr<std::vector<uint8_t>>, size_t offset_a, size_t size_a, std::function<void(boost::system::error_code const &, size_t)>);
 	void async_write (nano::shared_const_buffer const &, std::function<void(boost::system::error_code const &, size_t)> = nullptr, nano::buffer_drop_policy = nano::buffer_drop_policy::limiter);
 
 	void close ();
@@ -93,6 +95,9 @@ protected:
 	std::atomic<bool> timed_out{ false };
 	boost::optional<std::chrono::seconds> io_timeout;
 	size_t const queue_size_max = 128;
+	/** Limits on the number of const_buffers and bytes gathered into a single write. A message is never split across writes */
+	static size_t constexpr write_batch_buffers_max{ 64 };
+	static size_t constexpr write_batch_bytes_max{ 64 * 1024 };
 
 	/** Set by close() - completion handlers must check this. This is more reliable than checking
 	 error codes as the OS may have already completed the async operation. */
@@ -208,17 +208,18 @@ bool nano::transport::tcp_channels::store_all (bool clear_peers)
 	bool result (false);
 	if (!endpoints.empty ())
 	{
-		// Clear all peers then refresh with the current list of peers
-		auto transaction (node.store.tx_begin_write ({ tables::peers }));
-		if (clear_peers)
-		{
-			node.store.peer_clear (transaction);
-		}
-		for (auto endpoint : endpoints)
-		{
-			nano::endpoint_key endpoint_key (endpoint.address ().to_v6 ().to_bytes (), endpoint.port ());
-			node.store.peer_put (transaction, std::move (endpoint_key));
-		}
+		// Clear all peers then refresh with the current list of peers, committed along with other writes
+		node.write_batcher.add (nano::writer::peers, [& store = node.store, clear_peers, endpoints = std::move (endpoints)](nano::write_transaction const & transaction_a) {
+			if (clear_peers)
+			{
+				store.peer_clear (transaction_a);
+			}
+			for (auto endpoint : endpoints)
+			{
+				nano::endpoint_key endpoint_key (endpoint.address ().to_v6 ().to_bytes (), endpoint.port ());
+				store.peer_put (transaction_a, std::move (endpoint_key));
+			}
+		});
 		result = true;
 	}
 	return result;
@@ -85,22 +85,47 @@ node (node_a)
 	set_network_version (node_a.network_params.protocol.protocol_version);
 }
 
-void nano::transport::channel::send (nano::message const & message_a, std::function<void(boost::system::error_code const &, size_t)> const & callback_a, nano::buffer_drop_policy drop_policy_a)
+nano::transport::serialized_message::serialized_message (nano::message const & message_a, nano::buffer_pool & pool_a) :
+buffer (message_a.to_shared_const_buffer (pool_a))
 {
 	callback_visitor visitor;
 	message_a.visit (visitor);
-	auto buffer (message_a.to_shared_const_buffer ());
-	auto detail (visitor.result);
+	detail = visitor.result;
+	bandwidth = nano::to_bandwidth_class (detail);
+}
+
+nano::transport::serialized_message::serialized_message (nano::message const & message_a, nano::buffer_pool & pool_a, nano::bandwidth_class class_a) :
+serialized_message (message_a, pool_a)
+{
+	bandwidth = class_a;
+}
+
+void nano::transport::channel::send (nano::message const & message_a, std::function<void(boost::system::error_code const &, size_t)> const & callback_a, nano::buffer_drop_policy drop_policy_a)
+{
+	send (nano::transport::serialized_message (message_a, node.network.message_buffers), callback_a, drop_policy_a);
+}
+
+void nano::transport::channel::send (nano::message const & message_a, nano::bandwidth_class class_a, std::function<void(boost::system::error_code const &, size_t)> const & callback_a, nano::buffer_drop_policy drop_policy_a)
+{
+	send (nano::transport::serialized_message (message_a, node.network.message_buffers, class_a), callback_a, drop_policy_a);
+}
+
+void nano::transport::channel::send (nano::transport::serialized_message const & message_a, std::function<void(boost::system::error_code const &, size_t)> const & callback_a, nano::buffer_drop_policy drop_policy_a)
+{
+	auto const & buffer (message_a.buffer);
+	auto detail (message_a.detail);
 	auto is_droppable_by_limiter = drop_policy_a == nano::buffer_drop_policy::limiter;
-	node.network.limiter.add (buffer.size (), !is_droppable_by_limiter);
-	if (!is_droppable_by_limiter || !node.network.limiter.should_drop (buffer.size ()))
+	node.network.limiter.add (buffer.size (), message_a.bandwidth, !is_droppable_by_limiter);
+	if (!is_droppable_by_limiter || !node.network.limiter.should_drop (buffer.size (), message_a.bandwidth))
 	{
 		send_buffer (buffer, detail, callback_a, drop_policy_a);
 		node.stats.inc (nano::stat::type::message, detail, nano::stat::dir::out);
+		node.stats.add (nano::stat::type::bandwidth, nano::to_stat_detail (message_a.bandwidth), nano::stat::dir::out, buffer.size ());
 	}
 	else
 	{
 		node.stats.inc (nano::stat::type::drop, detail, nano::stat::dir::out);
+		node.stats.inc (nano::stat::type::bandwidth_drop, nano::to_stat_detail (message_a.bandwidth), nano::stat::dir::out);
 		if (node.config.logging.network_packet_logging ())
 		{
 			auto key = static_cast<uint8_t> (detail) << 8;
@@ -218,13 +243,57 @@ bool nano::transport::reserved_address (nano::endpoint const & endpoint_a, bool
 
 using namespace std::chrono_literals;
 
-nano::bandwidth_limiter::bandwidth_limiter (const size_t limit_a) :
+nano::bandwidth_class nano::to_bandwidth_class (nano::stat::detail detail_a)
+{
+	switch (detail_a)
+	{
+		case nano::stat::detail::confirm_ack:
+		case nano::stat::detail::confirm_req:
+			return nano::bandwidth_class::vote;
+		case nano::stat::detail::publish:
+			return nano::bandwidth_class::block;
+		default:
+			return nano::bandwidth_class::control;
+	}
+}
+
+nano::stat::detail nano::to_stat_detail (nano::bandwidth_class class_a)
+{
+	switch (class_a)
+	{
+		case nano::bandwidth_class::local_vote:
+			return nano::stat::detail::bandwidth_local_vote;
+		case nano::bandwidth_class::vote:
+			return nano::stat::detail::bandwidth_vote;
+		case nano::bandwidth_class::block:
+			return nano::stat::detail::bandwidth_block;
+		case nano::bandwidth_class::control:
+			return nano::stat::detail::bandwidth_control;
+		case nano::bandwidth_class::bulk:
+			return nano::stat::detail::bandwidth_bulk;
+	}
+	debug_assert (false);
+	return nano::stat::detail::all;
+}
+
+nano::bandwidth_limiter::bandwidth_limiter (const size_t limit_a, std::array<double, nano::bandwidth_class_count> const & reserved_a, double bulk_fraction_a) :
 next_trend (std::chrono::steady_clock::now () + 50ms),
-limit (limit_a)
+limit (limit_a),
+bulk_limit (static_cast<size_t> (limit_a * bulk_fraction_a))
 {
+	for (size_t i (0); i < nano::bandwidth_class_count; ++i)
+	{
+		class_rate_buffers[i].set_capacity (buffer_size);
+		reserved[i] = static_cast<size_t> (limit_a * reserved_a[i]);
+	}
 }
 
 void nano::bandwidth_limiter::add (const size_t & message_size_a, bool force_a)
+{
+	add (message_size_a, nano::bandwidth_class::control, force_a);
+}
+
+void nano::bandwidth_limiter::add (const size_t & message_size_a, nano::bandwidth_class class_a, bool force_a)
 {
 	if (limit == 0)
 	{
@@ -239,31 +308,63 @@ void nano::bandwidth_limiter::add (const size_t & message_size_a, bool force_a)
 		{
 			next_trend = now;
 			rate_buffer.clear ();
+			for (auto & buffer : class_rate_buffers)
+			{
+				buffer.clear ();
+			}
 		}
-		rate_buffer.push_back (rate);
-		rate = 0;
-		trended_rate = std::accumulate (rate_buffer.begin (), rate_buffer.end (), size_t{ 0 });
+		trend ();
 		// Increment rather than setting to now + period, to account for fluctuations in sampling
 		next_trend += period;
 	}
 	// Unless forced, only add to the current rate if it will not go beyond the trended limit
-	if (force_a || !should_drop (message_size_a))
+	if (force_a || !should_drop (message_size_a, class_a))
 	{
 		rate += message_size_a;
+		class_rates[static_cast<size_t> (class_a)] += message_size_a;
 	}
 }
 
-bool nano::bandwidth_limiter::should_drop (const size_t & message_size_a)
+void nano::bandwidth_limiter::trend ()
 {
-	// Never drop if limit is 0
-	if (limit == 0)
+	debug_assert (!mutex.try_lock ());
+	rate_buffer.push_back (rate);
+	rate = 0;
+	trended_rate = std::accumulate (rate_buffer.begin (), rate_buffer.end (), size_t{ 0 });
+	for (size_t i (0); i < nano::bandwidth_class_count; ++i)
 	{
-		return false;
+		class_rate_buffers[i].push_back (class_rates[i]);
+		class_rates[i] = 0;
+		class_trended_rates[i] = std::accumulate (class_rate_buffers[i].begin (), class_rate_buffers[i].end (), size_t{ 0 });
 	}
-	else
+}
+
+bool nano::bandwidth_limiter::should_drop (const size_t & message_size_a)
+{
+	return should_drop (message_size_a, nano::bandwidth_class::control);
+}
+
+bool nano::bandwidth_limiter::should_drop (const size_t & message_size_a, nano::bandwidth_class class_a)
+{
+	auto result (false);
+	auto index (static_cast<size_t> (class_a));
+	// Never drop if limit is 0, or if the class is within its reserved share
+	if (limit != 0 && class_trended_rates[index] + message_size_a > reserved[index])
 	{
-		return (trended_rate + message_size_a > limit);
+		// Bandwidth reserved by other active classes and not used by them is unavailable to this class
+		size_t unavailable (0);
+		for (size_t i (0); i < nano::bandwidth_class_count; ++i)
+		{
+			size_t trended (class_trended_rates[i]);
+			if (i != index && trended > 0 && trended < reserved[i])
+			{
+				unavailable += reserved[i] - trended;
+			}
+		}
+		auto class_limit (class_a == nano::bandwidth_class::bulk ? bulk_limit : limit);
+		result = trended_rate + message_size_a + unavailable > class_limit;
 	}
+	return result;
 }
 
 size_t nano::bandwidth_limiter::get_rate ()
@@ -272,6 +373,12 @@ size_t nano::bandwidth_limiter::get_rate ()
 	return trended_rate;
 }
 
+size_t nano::bandwidth_limiter::get_rate (nano::bandwidth_class class_a)
+{
+	nano::lock_guard<std::mutex> lock (mutex);
+	return class_trended_rates[static_cast<size_t> (class_a)];
+}
+
 size_t nano::bandwidth_limiter::get_limit () const
 {
 	return limit;
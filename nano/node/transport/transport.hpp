@@ -5,33 +5,69 @@
 #include <nano/node/common.hpp>
 #include <nano/node/socket.hpp>
 
+#include <array>
+
 namespace nano
 {
+/** Classes of outbound traffic which the bandwidth limiter accounts separately */
+enum class bandwidth_class : uint8_t
+{
+	/** Votes generated by local representatives */
+	local_vote,
+	/** Relayed votes and confirmation requests */
+	vote,
+	/** Published blocks */
+	block,
+	/** Keepalives, handshakes and telemetry */
+	control,
+	/** Bulk republishing, the first to back off when bandwidth is scarce */
+	bulk
+};
+static size_t constexpr bandwidth_class_count{ 5 };
+nano::bandwidth_class to_bandwidth_class (nano::stat::detail);
+nano::stat::detail to_stat_detail (nano::bandwidth_class);
+
+/**
+ * Limits outbound traffic to a trended rate, accounting each traffic class separately.
+ * A class which sent anything in the trend period keeps its reserved share of the limit available to itself, other classes are limited to what remains.
+ * Bulk traffic is further limited to a fraction of the limit.
+ */
 class bandwidth_limiter final
 {
 public:
 	// initialize with limit 0 = unbounded
-	bandwidth_limiter (const size_t);
+	bandwidth_limiter (const size_t, std::array<double, nano::bandwidth_class_count> const & = {}, double = 1.0);
 	// force_a should be set for non-droppable packets
 	void add (const size_t &, bool const force_a = false);
+	void add (const size_t &, nano::bandwidth_class, bool const force_a = false);
 	bool should_drop (const size_t &);
+	bool should_drop (const size_t &, nano::bandwidth_class);
 	size_t get_rate ();
+	size_t get_rate (nano::bandwidth_class);
 	size_t get_limit () const;
 
 	std::chrono::milliseconds const period{ 50 };
 	static constexpr unsigned buffer_size{ 20 };
 
 private:
+	void trend ();
 	//last time rate was adjusted
 	std::chrono::steady_clock::time_point next_trend;
 	//trend rate over 20 poll periods
 	boost::circular_buffer<size_t> rate_buffer{ buffer_size };
+	std::array<boost::circular_buffer<size_t>, nano::bandwidth_class_count> class_rate_buffers;
 	//limit bandwidth to
 	const size_t limit;
+	//bytes reserved for each class while it's active
+	std::array<size_t, nano::bandwidth_class_count> reserved;
+	//limit for bulk traffic
+	const size_t bulk_limit;
 	//rate, increment if message_size + rate < rate
 	size_t rate{ 0 };
+	std::array<size_t, nano::bandwidth_class_count> class_rates{};
 	//trended rate to even out spikes in traffic
 	std::atomic<size_t> trended_rate{ 0 };
+	std::array<std::atomic<size_t>, nano::bandwidth_class_count> class_trended_rates{};
 	std::mutex mutex;
 };
 
@@ -52,6 +88,16 @@ namespace transport
 		udp = 1,
 		tcp = 2
 	};
+	/** A message serialized once so the same buffer can be sent to several channels */
+	class serialized_message final
+	{
+	public:
+		serialized_message (nano::message const &, nano::buffer_pool &);
+		serialized_message (nano::message const &, nano::buffer_pool &, nano::bandwidth_class);
+		nano::shared_const_buffer buffer;
+		nano::stat::detail detail;
+		nano::bandwidth_class bandwidth;
+	};
 	class channel
 	{
 	public:
@@ -60,6 +106,9 @@ namespace transport
 		virtual size_t hash_code () const = 0;
 		virtual bool operator== (nano::transport::channel const &) const = 0;
 		void send (nano::message const &, std::function<void(boost::system::error_code const &, size_t)> const & = nullptr, nano::buffer_drop_policy = nano::buffer_drop_policy::limiter);
+		/** Sends \p message_a accounted as \p class_a by the bandwidth limiter, rather than by its message type */
+		void send (nano::message const &, nano::bandwidth_class, std::function<void(boost::system::error_code const &, size_t)> const & = nullptr, nano::buffer_drop_policy = nano::buffer_drop_policy::limiter);
+		void send (nano::transport::serialized_message const &, std::function<void(boost::system::error_code const &, size_t)> const & = nullptr, nano::buffer_drop_policy = nano::buffer_drop_policy::limiter);
 		virtual void send_buffer (nano::shared_const_buffer const &, nano::stat::detail, std::function<void(boost::system::error_code const &, size_t)> const & = nullptr, nano::buffer_drop_policy = nano::buffer_drop_policy::limiter) = 0;
 		virtual std::function<void(boost::system::error_code const &, size_t)> callback (nano::stat::detail, std::function<void(boost::system::error_code const &, size_t)> const & = nullptr) const = 0;
 		virtual std::string to_string () const = 0;
@@ -7,6 +7,19 @@
 
 #include <boost/format.hpp>
 
+#ifdef __linux__
+#include <sys/socket.h>
+#endif
+
+namespace
+{
+#ifdef __linux__
+bool constexpr batch_io_supported = true;
+#else
+bool constexpr batch_io_supported = false;
+#endif
+}
+
 nano::transport::channel_udp::channel_udp (nano::transport::udp_channels & channels_a, nano::endpoint const & endpoint_a, uint8_t protocol_version_a) :
 channel (channels_a.node),
 endpoint (endpoint_a),
@@ -68,7 +81,8 @@ std::string nano::transport::channel_udp::to_string () const
 
 nano::transport::udp_channels::udp_channels (nano::node & node_a, uint16_t port_a) :
 node (node_a),
-strand (node_a.io_ctx.get_executor ())
+strand (node_a.io_ctx.get_executor ()),
+batch_io (node_a.config.udp_batch_io && batch_io_supported)
 {
 	if (!node.flags.disable_udp)
 	{
@@ -94,12 +108,70 @@ void nano::transport::udp_channels::send (nano::shared_const_buffer const & buff
 	[this, buffer_a, endpoint_a, callback_a]() {
 		if (!this->stopped)
 		{
-			this->socket->async_send_to (buffer_a, endpoint_a,
-			boost::asio::bind_executor (strand, callback_a));
+			if (this->batch_io)
+			{
+				this->send_queue.push_back (pending_send{ buffer_a, endpoint_a, callback_a });
+				if (this->send_queue.size () == 1)
+				{
+					// Sends posted in the meantime are written by the same sendmmsg call
+					boost::asio::post (this->strand, [this]() {
+						this->send_batch ();
+					});
+				}
+			}
+			else
+			{
+				this->socket->async_send_to (buffer_a, endpoint_a,
+				boost::asio::bind_executor (strand, callback_a));
+			}
 		}
 	});
 }
 
+void nano::transport::udp_channels::send_batch ()
+{
+	decltype (send_queue) queue;
+	queue.swap (send_queue);
+	size_t offset (0);
+#ifdef __linux__
+	std::array<mmsghdr, batch_size> headers;
+	std::array<iovec, batch_size> iovecs;
+	auto error (false);
+	while (!error && !stopped && offset < queue.size ())
+	{
+		auto count (std::min (batch_size, queue.size () - offset));
+		for (size_t i (0); i < count; ++i)
+		{
+			auto & item (queue[offset + i]);
+			iovecs[i].iov_base = const_cast<void *> (item.buffer.begin ()->data ());
+			iovecs[i].iov_len = item.buffer.size ();
+			headers[i] = mmsghdr{};
+			headers[i].msg_hdr.msg_name = const_cast<sockaddr *> (item.endpoint.data ());
+			headers[i].msg_hdr.msg_namelen = item.endpoint.size ();
+			headers[i].msg_hdr.msg_iov = &iovecs[i];
+			headers[i].msg_hdr.msg_iovlen = 1;
+		}
+		auto sent (::sendmmsg (socket->native_handle (), headers.data (), count, MSG_DONTWAIT));
+		error = sent <= 0;
+		for (auto i (0); i < sent; ++i)
+		{
+			auto & item (queue[offset + i]);
+			if (item.callback)
+			{
+				item.callback (boost::system::error_code (), headers[i].msg_len);
+			}
+		}
+		offset += std::max<decltype (sent)> (sent, 0);
+	}
+#endif
+	// Whatever sendmmsg could not send without blocking is sent one datagram at a time
+	for (; !stopped && offset < queue.size (); ++offset)
+	{
+		auto & item (queue[offset]);
+		socket->async_send_to (item.buffer, item.endpoint, boost::asio::bind_executor (strand, item.callback));
+	}
+}
+
 std::shared_ptr<nano::transport::channel_udp> nano::transport::udp_channels::insert (nano::endpoint const & endpoint_a, unsigned network_version_a)
 {
 	debug_assert (endpoint_a.address ().is_v6 ());
@@ -202,17 +274,18 @@ bool nano::transport::udp_channels::store_all (bool clear_peers)
 	bool result (false);
 	if (!endpoints.empty ())
 	{
-		// Clear all peers then refresh with the current list of peers
-		auto transaction (node.store.tx_begin_write ({ tables::peers }));
-		if (clear_peers)
-		{
-			node.store.peer_clear (transaction);
-		}
-		for (auto endpoint : endpoints)
-		{
-			nano::endpoint_key endpoint_key (endpoint.address ().to_v6 ().to_bytes (), endpoint.port ());
-			node.store.peer_put (transaction, std::move (endpoint_key));
-		}
+		// Clear all peers then refresh with the current list of peers, committed along with other writes
+		node.write_batcher.add (nano::writer::peers, [& store = node.store, clear_peers, endpoints = std::move (endpoints)](nano::write_transaction const & transaction_a) {
+			if (clear_peers)
+			{
+				store.peer_clear (transaction_a);
+			}
+			for (auto endpoint : endpoints)
+			{
+				nano::endpoint_key endpoint_key (endpoint.address ().to_v6 ().to_bytes (), endpoint.port ());
+				store.peer_put (transaction_a, std::move (endpoint_key));
+			}
+		});
 		result = true;
 	}
 	return result;
@@ -283,34 +356,110 @@ void nano::transport::udp_channels::receive ()
 			node.logger.try_log ("Receiving packet");
 		}
 
-		auto data (node.network.buffer_container.allocate ());
+		if (batch_io)
+		{
+			receive_batch ();
+		}
+		else
+		{
+			auto data (node.network.buffer_container.allocate ());
 
-		socket->async_receive_from (boost::asio::buffer (data->buffer, nano::network::buffer_size), data->endpoint,
-		boost::asio::bind_executor (strand,
-		[this, data](boost::system::error_code const & error, std::size_t size_a) {
-			if (!error && !this->stopped)
-			{
-				data->size = size_a;
-				this->node.network.buffer_container.enqueue (data);
-				this->receive ();
-			}
-			else
-			{
-				this->node.network.buffer_container.release (data);
-				if (error)
+			socket->async_receive_from (boost::asio::buffer (data->buffer, nano::network::buffer_size), data->endpoint,
+			boost::asio::bind_executor (strand,
+			[this, data](boost::system::error_code const & error, std::size_t size_a) {
+				if (!error && !this->stopped)
 				{
-					if (this->node.config.logging.network_logging ())
+					data->size = size_a;
+					this->node.network.buffer_container.enqueue (data);
+					this->receive ();
+				}
+				else
+				{
+					this->node.network.buffer_container.release (data);
+					if (error)
+					{
+						if (this->node.config.logging.network_logging ())
+						{
+							this->node.logger.try_log (boost::str (boost::format ("UDP Receive error: %1%") % error.message ()));
+						}
+					}
+					if (!this->stopped)
 					{
-						this->node.logger.try_log (boost::str (boost::format ("UDP Receive error: %1%") % error.message ()));
+						this->node.alarm.add (std::chrono::steady_clock::now () + std::chrono::seconds (5), [this]() { this->receive (); });
 					}
 				}
-				if (!this->stopped)
+			}));
+		}
+	}
+}
+
+void nano::transport::udp_channels::receive_batch ()
+{
+	socket->async_wait (boost::asio::ip::udp::socket::wait_read,
+	boost::asio::bind_executor (strand,
+	[this](boost::system::error_code const & error) {
+		if (!error && !this->stopped)
+		{
+			this->read_batch ();
+			this->receive ();
+		}
+		else
+		{
+			if (error)
+			{
+				if (this->node.config.logging.network_logging ())
 				{
-					this->node.alarm.add (std::chrono::steady_clock::now () + std::chrono::seconds (5), [this]() { this->receive (); });
+					this->node.logger.try_log (boost::str (boost::format ("UDP Receive error: %1%") % error.message ()));
 				}
 			}
-		}));
+			if (!this->stopped)
+			{
+				this->node.alarm.add (std::chrono::steady_clock::now () + std::chrono::seconds (5), [this]() { this->receive (); });
+			}
+		}
+	}));
+}
+
+void nano::transport::udp_channels::read_batch ()
+{
+#ifdef __linux__
+	std::array<nano::message_buffer *, batch_size> buffers;
+	std::array<mmsghdr, batch_size> headers;
+	std::array<iovec, batch_size> iovecs;
+	size_t count (0);
+	auto data (node.network.buffer_container.allocate ());
+	while (data != nullptr)
+	{
+		buffers[count] = data;
+		iovecs[count].iov_base = data->buffer;
+		iovecs[count].iov_len = nano::network::buffer_size;
+		headers[count] = mmsghdr{};
+		headers[count].msg_hdr.msg_name = data->endpoint.data ();
+		headers[count].msg_hdr.msg_namelen = data->endpoint.capacity ();
+		headers[count].msg_hdr.msg_iov = &iovecs[count];
+		headers[count].msg_hdr.msg_iovlen = 1;
+		++count;
+		// Only the first buffer may replace an unserviced one, the others must be free so queued packets are not dropped
+		data = count < batch_size ? node.network.buffer_container.try_allocate () : nullptr;
+	}
+	auto received (count > 0 ? ::recvmmsg (socket->native_handle (), headers.data (), count, MSG_DONTWAIT, nullptr) : 0);
+	for (size_t i (0); i < count; ++i)
+	{
+		data = buffers[i];
+		if (static_cast<int> (i) < received && (headers[i].msg_hdr.msg_flags & MSG_TRUNC) == 0)
+		{
+			data->endpoint.resize (headers[i].msg_hdr.msg_namelen);
+			data->size = headers[i].msg_len;
+			node.network.buffer_container.enqueue (data);
+		}
+		else
+		{
+			node.network.buffer_container.release (data);
+		}
 	}
+#else
+	debug_assert (false);
+#endif
 }
 
 void nano::transport::udp_channels::start ()
@@ -525,95 +674,141 @@ public:
 };
 }
 
-void nano::transport::udp_channels::receive_action (nano::message_buffer * data_a)
+bool nano::transport::udp_channels::allowed_sender (nano::endpoint const & endpoint_a)
 {
-	auto allowed_sender (true);
-	if (data_a->endpoint == get_local_endpoint ())
+	auto result (true);
+	if (endpoint_a == get_local_endpoint ())
+	{
+		result = false;
+	}
+	else if (endpoint_a.address ().to_v6 ().is_unspecified ())
 	{
-		allowed_sender = false;
+		result = false;
 	}
-	else if (data_a->endpoint.address ().to_v6 ().is_unspecified ())
+	else if (nano::transport::reserved_address (endpoint_a, node.config.allow_local_peers))
 	{
-		allowed_sender = false;
+		result = false;
 	}
-	else if (nano::transport::reserved_address (data_a->endpoint, node.config.allow_local_peers))
+	if (!result)
+	{
+		if (node.config.logging.network_packet_logging ())
+		{
+			node.logger.try_log (boost::str (boost::format ("Reserved sender %1%") % endpoint_a));
+		}
+
+		node.stats.inc_detail_only (nano::stat::type::error, nano::stat::detail::bad_sender);
+	}
+	return result;
+}
+
+void nano::transport::udp_channels::parse_error (nano::message_parser::parse_status status_a)
+{
+	node.stats.inc (nano::stat::type::error);
+
+	switch (status_a)
 	{
-		allowed_sender = false;
+		case nano::message_parser::parse_status::insufficient_work:
+			// We've already increment error count, update detail only
+			node.stats.inc_detail_only (nano::stat::type::error, nano::stat::detail::insufficient_work);
+			break;
+		case nano::message_parser::parse_status::invalid_magic:
+			node.stats.inc (nano::stat::type::udp, nano::stat::detail::invalid_magic);
+			break;
+		case nano::message_parser::parse_status::invalid_network:
+			node.stats.inc (nano::stat::type::udp, nano::stat::detail::invalid_network);
+			break;
+		case nano::message_parser::parse_status::invalid_header:
+			node.stats.inc (nano::stat::type::udp, nano::stat::detail::invalid_header);
+			break;
+		case nano::message_parser::parse_status::invalid_message_type:
+			node.stats.inc (nano::stat::type::udp, nano::stat::detail::invalid_message_type);
+			break;
+		case nano::message_parser::parse_status::invalid_keepalive_message:
+			node.stats.inc (nano::stat::type::udp, nano::stat::detail::invalid_keepalive_message);
+			break;
+		case nano::message_parser::parse_status::invalid_publish_message:
+			node.stats.inc (nano::stat::type::udp, nano::stat::detail::invalid_publish_message);
+			break;
+		case nano::message_parser::parse_status::invalid_confirm_req_message:
+			node.stats.inc (nano::stat::type::udp, nano::stat::detail::invalid_confirm_req_message);
+			break;
+		case nano::message_parser::parse_status::invalid_confirm_ack_message:
+			node.stats.inc (nano::stat::type::udp, nano::stat::detail::invalid_confirm_ack_message);
+			break;
+		case nano::message_parser::parse_status::invalid_node_id_handshake_message:
+			node.stats.inc (nano::stat::type::udp, nano::stat::detail::invalid_node_id_handshake_message);
+			break;
+		case nano::message_parser::parse_status::invalid_telemetry_req_message:
+			node.stats.inc (nano::stat::type::udp, nano::stat::detail::invalid_telemetry_req_message);
+			break;
+		case nano::message_parser::parse_status::invalid_telemetry_ack_message:
+			node.stats.inc (nano::stat::type::udp, nano::stat::detail::invalid_telemetry_ack_message);
+			break;
+		case nano::message_parser::parse_status::outdated_version:
+			node.stats.inc (nano::stat::type::udp, nano::stat::detail::outdated_version);
+			break;
+		case nano::message_parser::parse_status::success:
+			/* Already checked, unreachable */
+			break;
 	}
-	if (allowed_sender)
+}
+
+void nano::transport::udp_channels::receive_action (nano::message_buffer * data_a)
+{
+	if (allowed_sender (data_a->endpoint))
 	{
 		udp_message_visitor visitor (node, data_a->endpoint);
 		nano::message_parser parser (node.block_uniquer, node.vote_uniquer, visitor, node.work);
 		parser.deserialize_buffer (data_a->buffer, data_a->size);
 		if (parser.status != nano::message_parser::parse_status::success)
 		{
-			node.stats.inc (nano::stat::type::error);
-
-			switch (parser.status)
-			{
-				case nano::message_parser::parse_status::insufficient_work:
-					// We've already increment error count, update detail only
-					node.stats.inc_detail_only (nano::stat::type::error, nano::stat::detail::insufficient_work);
-					break;
-				case nano::message_parser::parse_status::invalid_magic:
-					node.stats.inc (nano::stat::type::udp, nano::stat::detail::invalid_magic);
-					break;
-				case nano::message_parser::parse_status::invalid_network:
-					node.stats.inc (nano::stat::type::udp, nano::stat::detail::invalid_network);
-					break;
-				case nano::message_parser::parse_status::invalid_header:
-					node.stats.inc (nano::stat::type::udp, nano::stat::detail::invalid_header);
-					break;
-				case nano::message_parser::parse_status::invalid_message_type:
-					node.stats.inc (nano::stat::type::udp, nano::stat::detail::invalid_message_type);
-					break;
-				case nano::message_parser::parse_status::invalid_keepalive_message:
-					node.stats.inc (nano::stat::type::udp, nano::stat::detail::invalid_keepalive_message);
-					break;
-				case nano::message_parser::parse_status::invalid_publish_message:
-					node.stats.inc (nano::stat::type::udp, nano::stat::detail::invalid_publish_message);
-					break;
-				case nano::message_parser::parse_status::invalid_confirm_req_message:
-					node.stats.inc (nano::stat::type::udp, nano::stat::detail::invalid_confirm_req_message);
-					break;
-				case nano::message_parser::parse_status::invalid_confirm_ack_message:
-					node.stats.inc (nano::stat::type::udp, nano::stat::detail::invalid_confirm_ack_message);
-					break;
-				case nano::message_parser::parse_status::invalid_node_id_handshake_message:
-					node.stats.inc (nano::stat::type::udp, nano::stat::detail::invalid_node_id_handshake_message);
-					break;
-				case nano::message_parser::parse_status::invalid_telemetry_req_message:
-					node.stats.inc (nano::stat::type::udp, nano::stat::detail::invalid_telemetry_req_message);
-					break;
-				case nano::message_parser::parse_status::invalid_telemetry_ack_message:
-					node.stats.inc (nano::stat::type::udp, nano::stat::detail::invalid_telemetry_ack_message);
-					break;
-				case nano::message_parser::parse_status::outdated_version:
-					node.stats.inc (nano::stat::type::udp, nano::stat::detail::outdated_version);
-					break;
-				case nano::message_parser::parse_status::success:
-					/* Already checked, unreachable */
-					break;
-			}
+			parse_error (parser.status);
 		}
 		else
 		{
 			node.stats.add (nano::stat::type::traffic_udp, nano::stat::dir::in, data_a->size);
 		}
 	}
-	else
+}
+
+void nano::transport::udp_channels::receive_action (std::vector<nano::message_buffer *> const & data_a)
+{
+	std::vector<nano::message_buffer *> allowed;
+	allowed.reserve (data_a.size ());
+	std::vector<std::pair<uint8_t const *, size_t>> buffers;
+	buffers.reserve (data_a.size ());
+	for (auto data : data_a)
 	{
-		if (node.config.logging.network_packet_logging ())
+		if (allowed_sender (data->endpoint))
 		{
-			node.logger.try_log (boost::str (boost::format ("Reserved sender %1%") % data_a->endpoint));
+			allowed.push_back (data);
+			buffers.emplace_back (data->buffer, data->size);
+		}
+	}
+	auto parsed (nano::message_parser::deserialize_buffers (buffers, node.block_uniquer, node.vote_uniquer));
+	for (size_t i (0), n (parsed.size ()); i < n; ++i)
+	{
+		auto const & result (parsed[i]);
+		if (result.status != nano::message_parser::parse_status::success)
+		{
+			parse_error (result.status);
+		}
+		else
+		{
+			if (result.message != nullptr)
+			{
+				udp_message_visitor visitor (node, allowed[i]->endpoint);
+				result.message->visit (visitor);
+			}
+			node.stats.add (nano::stat::type::traffic_udp, nano::stat::dir::in, allowed[i]->size);
 		}
-
-		node.stats.inc_detail_only (nano::stat::type::error, nano::stat::detail::bad_sender);
 	}
 }
 
 void nano::transport::udp_channels::process_packets ()
 {
+	std::vector<nano::message_buffer *> batch;
+	batch.reserve (process_batch_max);
 	while (!stopped)
 	{
 		auto data (node.network.buffer_container.dequeue ());
@@ -621,8 +816,18 @@ void nano::transport::udp_channels::process_packets ()
 		{
 			break;
 		}
-		receive_action (data);
-		node.network.buffer_container.release (data);
+		// Parse whatever else was queued by the time this thread woke up along with the first packet
+		batch.push_back (data);
+		while (batch.size () < process_batch_max && (data = node.network.buffer_container.try_dequeue ()) != nullptr)
+		{
+			batch.push_back (data);
+		}
+		receive_action (batch);
+		for (auto buffer : batch)
+		{
+			node.network.buffer_container.release (buffer);
+		}
+		batch.clear ();
 	}
 }
 
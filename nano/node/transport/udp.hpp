@@ -95,6 +95,8 @@ namespace transport
 		void send (nano::shared_const_buffer const & buffer_a, nano::endpoint endpoint_a, std::function<void(boost::system::error_code const &, size_t)> const & callback_a);
 		nano::endpoint get_local_endpoint () const;
 		void receive_action (nano::message_buffer *);
+		/** Parses a batch of received packets together, see message_parser::deserialize_buffers */
+		void receive_action (std::vector<nano::message_buffer *> const &);
 		void process_packets ();
 		std::shared_ptr<nano::transport::channel> create (nano::endpoint const &);
 		bool max_ip_connections (nano::endpoint const &);
@@ -107,8 +109,25 @@ namespace transport
 		void modify (std::shared_ptr<nano::transport::channel_udp>, std::function<void(std::shared_ptr<nano::transport::channel_udp>)>);
 		nano::node & node;
 
+		/** Maximum number of datagrams per recvmmsg/sendmmsg call */
+		static size_t constexpr batch_size{ 32 };
+		/** Maximum number of queued packets parsed together by a processing thread */
+		static size_t constexpr process_batch_max{ 64 };
+
 	private:
+		bool allowed_sender (nano::endpoint const &);
+		void parse_error (nano::message_parser::parse_status);
 		void close_socket ();
+		void receive_batch ();
+		void read_batch ();
+		void send_batch ();
+		class pending_send final
+		{
+		public:
+			nano::shared_const_buffer buffer;
+			nano::endpoint endpoint;
+			std::function<void(boost::system::error_code const &, size_t)> callback;
+		};
 		class endpoint_tag
 		{
 		};
@@ -201,6 +220,10 @@ namespace transport
 		std::unique_ptr<boost::asio::ip::udp::socket> socket;
 		nano::endpoint local_endpoint;
 		std::atomic<bool> stopped{ false };
+		/** Set if node_config::udp_batch_io is enabled and supported by the platform */
+		bool const batch_io;
+		/** Sends waiting for the next sendmmsg call, accessed in the strand */
+		std::vector<pending_send> send_queue;
 	};
 } // namespace transport
 } // namespace nano
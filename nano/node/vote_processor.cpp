@@ -1,3 +1,4 @@
+#include <nano/crypto/blake2/blake2.h>
 #include <nano/lib/logger_mt.hpp>
 #include <nano/lib/stats.hpp>
 #include <nano/lib/threading.hpp>
@@ -15,6 +16,11 @@
 
 #include <boost/format.hpp>
 
+std::chrono::seconds constexpr nano::vote_processor::replay_cutoff;
+size_t constexpr nano::vote_processor::replay_max;
+std::chrono::seconds constexpr nano::vote_processor::verified_cutoff;
+size_t constexpr nano::vote_processor::verified_max;
+
 nano::vote_processor::vote_processor (nano::signature_checker & checker_a, nano::active_transactions & active_a, nano::node_observers & observers_a, nano::stat & stats_a, nano::node_config & config_a, nano::node_flags & flags_a, nano::logger_mt & logger_a, nano::online_reps & online_reps_a, nano::ledger & ledger_a, nano::network_params & network_params_a) :
 checker (checker_a),
 active (active_a),
@@ -132,39 +138,239 @@ bool nano::vote_processor::vote (std::shared_ptr<nano::vote> vote_a, std::shared
 
 void nano::vote_processor::verify_votes (decltype (votes) const & votes_a)
 {
-	auto size (votes_a.size ());
-	std::vector<unsigned char const *> messages;
-	messages.reserve (size);
+	// Replays of votes already seen by an election skip the elections. They're still reported to the vote observers as replays once their signature is known to be valid
+	std::vector<std::pair<std::shared_ptr<nano::vote>, std::shared_ptr<nano::transport::channel>>> votes_l;
+	std::vector<std::pair<std::shared_ptr<nano::vote>, std::shared_ptr<nano::transport::channel>>> replays_l;
+	votes_l.reserve (votes_a.size ());
+	{
+		nano::lock_guard<std::mutex> guard (replays_mutex);
+		auto cutoff (std::chrono::steady_clock::now () - replay_cutoff);
+		auto & sequenced (replays.get<tag_sequence> ());
+		while (!sequenced.empty () && (sequenced.front ().time < cutoff || sequenced.size () > replay_max))
+		{
+			sequenced.pop_front ();
+		}
+		for (auto const & vote : votes_a)
+		{
+			if (!replay_filter (*vote.first))
+			{
+				votes_l.push_back (vote);
+			}
+			else
+			{
+				replays_l.push_back (vote);
+				stats.inc (nano::stat::type::vote, nano::stat::detail::vote_replay_filtered);
+			}
+		}
+	}
+	// Filtered replays are verified along with the other votes, after them
+	auto replays_begin (votes_l.size ());
+	votes_l.insert (votes_l.end (), replays_l.begin (), replays_l.end ());
+	replays_l.clear ();
+	// Copies of votes whose signature was already verified, commonly the same vote relayed by several peers, skip the signature check
+	std::vector<std::pair<std::shared_ptr<nano::vote>, std::shared_ptr<nano::transport::channel>>> cached;
+	{
+		std::vector<nano::block_hash> digests;
+		digests.reserve (votes_l.size ());
+		for (auto const & vote : votes_l)
+		{
+			digests.push_back (verified_digest (*vote.first));
+		}
+		size_t unverified (0);
+		nano::lock_guard<std::mutex> guard (verified_mutex);
+		auto cutoff (std::chrono::steady_clock::now () - verified_cutoff);
+		auto & sequenced (verified.get<tag_sequence> ());
+		while (!sequenced.empty () && (sequenced.front ().time < cutoff || sequenced.size () > verified_max))
+		{
+			sequenced.pop_front ();
+		}
+		auto & keyed (verified.get<tag_key> ());
+		size_t unverified_votes (0);
+		for (size_t i (0), n (votes_l.size ()); i < n; ++i)
+		{
+			auto replay (i >= replays_begin);
+			if (keyed.find (digests[i]) != keyed.end ())
+			{
+				(replay ? replays_l : cached).push_back (votes_l[i]);
+				stats.inc (nano::stat::type::vote, nano::stat::detail::vote_verified_hit);
+			}
+			else
+			{
+				votes_l[unverified++] = votes_l[i];
+				unverified_votes += replay ? 0 : 1;
+				stats.inc (nano::stat::type::vote, nano::stat::detail::vote_verified_miss);
+			}
+		}
+		replays_begin = unverified_votes;
+		votes_l.resize (unverified);
+	}
+	apply_votes (cached);
+	replay_votes (replays_l);
+	// Verify in fixed size batches large enough to be spread over the signature checker threads, applying each batch before verifying the next
+	size_t const multithreaded_cutoff (nano::signature_checker::multithreaded_cutoff);
+	size_t const batch_size (std::max (multithreaded_cutoff, nano::signature_checker::batch_size * (config.signature_checker_threads + 1)));
 	std::vector<nano::block_hash> hashes;
-	hashes.reserve (size);
-	std::vector<size_t> lengths (size, sizeof (nano::block_hash));
+	std::vector<unsigned char const *> messages;
+	std::vector<size_t> lengths;
 	std::vector<unsigned char const *> pub_keys;
-	pub_keys.reserve (size);
 	std::vector<unsigned char const *> signatures;
-	signatures.reserve (size);
 	std::vector<int> verifications;
-	verifications.resize (size);
-	for (auto const & vote : votes_a)
+	std::vector<std::pair<std::shared_ptr<nano::vote>, std::shared_ptr<nano::transport::channel>>> verified_l;
+	for (size_t begin (0); begin < votes_l.size (); begin += batch_size)
 	{
-		hashes.push_back (vote.first->hash ());
-		messages.push_back (hashes.back ().bytes.data ());
-		pub_keys.push_back (vote.first->account.bytes.data ());
-		signatures.push_back (vote.first->signature.bytes.data ());
+		auto size (std::min (batch_size, votes_l.size () - begin));
+		hashes.clear ();
+		hashes.reserve (size);
+		messages.clear ();
+		pub_keys.clear ();
+		signatures.clear ();
+		lengths.assign (size, sizeof (nano::block_hash));
+		verifications.assign (size, 0);
+		for (auto i (begin), n (begin + size); i < n; ++i)
+		{
+			auto const & vote (votes_l[i].first);
+			hashes.push_back (vote->hash ());
+			messages.push_back (hashes.back ().bytes.data ());
+			pub_keys.push_back (vote->account.bytes.data ());
+			signatures.push_back (vote->signature.bytes.data ());
+		}
+		nano::signature_check_set check = { size, messages.data (), lengths.data (), pub_keys.data (), signatures.data (), verifications.data () };
+		checker.verify (check);
+		verified_l.clear ();
+		replays_l.clear ();
+		for (size_t i (0); i < size; ++i)
+		{
+			debug_assert (verifications[i] == 1 || verifications[i] == 0);
+			if (verifications[i] == 1)
+			{
+				(begin + i < replays_begin ? verified_l : replays_l).push_back (votes_l[begin + i]);
+			}
+		}
+		{
+			nano::lock_guard<std::mutex> guard (verified_mutex);
+			auto now (std::chrono::steady_clock::now ());
+			for (auto const & vote : verified_l)
+			{
+				verified.get<tag_sequence> ().push_back (nano::vote_verified_entry{ verified_digest (*vote.first), now });
+			}
+			for (auto const & vote : replays_l)
+			{
+				verified.get<tag_sequence> ().push_back (nano::vote_verified_entry{ verified_digest (*vote.first), now });
+			}
+		}
+		apply_votes (verified_l);
+		replay_votes (replays_l);
 	}
-	nano::signature_check_set check = { size, messages.data (), lengths.data (), pub_keys.data (), signatures.data (), verifications.data () };
-	checker.verify (check);
-	auto i (0);
+}
+
+void nano::vote_processor::replay_votes (std::vector<std::pair<std::shared_ptr<nano::vote>, std::shared_ptr<nano::transport::channel>>> const & votes_a)
+{
 	for (auto const & vote : votes_a)
 	{
-		debug_assert (verifications[i] == 1 || verifications[i] == 0);
-		if (verifications[i] == 1)
+		vote_result (vote.first, vote.second, nano::vote_code::replay);
+	}
+}
+
+void nano::vote_processor::apply_votes (std::vector<std::pair<std::shared_ptr<nano::vote>, std::shared_ptr<nano::transport::channel>>> & votes_a)
+{
+	// Votes for the same block are kept together and each group is applied taking active.mutex once
+	// Groups hold up to group_max votes but are only cut between votes for different blocks
+	std::vector<nano::block_hash> keys;
+	keys.reserve (votes_a.size ());
+	std::vector<size_t> order (votes_a.size ());
+	for (size_t i (0); i < votes_a.size (); ++i)
+	{
+		debug_assert (!votes_a[i].first->blocks.empty ());
+		keys.push_back (*votes_a[i].first->begin ());
+		order[i] = i;
+	}
+	std::stable_sort (order.begin (), order.end (), [&keys](size_t lhs, size_t rhs) {
+		return keys[lhs] < keys[rhs];
+	});
+	std::vector<std::shared_ptr<nano::vote>> group;
+	std::vector<std::vector<nano::block_hash>> replays_l;
+	size_t constexpr group_max (64);
+	for (size_t begin (0), end (0); begin < order.size (); begin = end)
+	{
+		end = std::min (order.size (), begin + group_max);
+		while (end < order.size () && keys[order[end]] == keys[order[end - 1]])
+		{
+			++end;
+		}
+		group.clear ();
+		for (auto i (begin); i < end; ++i)
+		{
+			group.push_back (votes_a[order[i]].first);
+		}
+		auto codes (active.vote (group, &replays_l));
+		{
+			nano::lock_guard<std::mutex> guard (replays_mutex);
+			for (size_t i (0); i < group.size (); ++i)
+			{
+				if (!replays_l[i].empty ())
+				{
+					replay_insert (*group[i], replays_l[i]);
+				}
+			}
+		}
+		for (size_t i (0); i < group.size (); ++i)
+		{
+			vote_result (group[i], votes_a[order[begin + i]].second, codes[i]);
+		}
+	}
+}
+
+bool nano::vote_processor::replay_filter (nano::vote const & vote_a)
+{
+	debug_assert (!replays_mutex.try_lock ());
+	auto result (!vote_a.blocks.empty ());
+	auto & keyed (replays.get<tag_key> ());
+	for (auto i (vote_a.begin ()), n (vote_a.end ()); i != n && result; ++i)
+	{
+		auto existing (keyed.find (std::make_tuple (vote_a.account, *i)));
+		result = existing != keyed.end () && existing->sequence >= vote_a.sequence;
+	}
+	return result;
+}
+
+void nano::vote_processor::replay_insert (nano::vote const & vote_a, std::vector<nano::block_hash> const & hashes_a)
+{
+	debug_assert (!replays_mutex.try_lock ());
+	auto now (std::chrono::steady_clock::now ());
+	auto & keyed (replays.get<tag_key> ());
+	for (auto const & hash : hashes_a)
+	{
+		auto existing (keyed.find (std::make_tuple (vote_a.account, hash)));
+		if (existing == keyed.end ())
 		{
-			vote_blocking (vote.first, vote.second, true);
+			replays.get<tag_sequence> ().push_back (nano::vote_replay_entry{ vote_a.account, hash, vote_a.sequence, now });
+		}
+		else
+		{
+			keyed.modify (existing, [&vote_a, now](nano::vote_replay_entry & entry_a) {
+				entry_a.sequence = std::max (entry_a.sequence, vote_a.sequence);
+				entry_a.time = now;
+			});
+			// Refreshed entries move to the back so that pruning stays in age order
+			auto & sequenced (replays.get<tag_sequence> ());
+			sequenced.relocate (sequenced.end (), replays.project<tag_sequence> (existing));
 		}
-		++i;
 	}
 }
 
+nano::block_hash nano::vote_processor::verified_digest (nano::vote const & vote_a)
+{
+	nano::block_hash result;
+	auto hash (vote_a.hash ());
+	blake2b_state state;
+	blake2b_init (&state, sizeof (result.bytes));
+	blake2b_update (&state, hash.bytes.data (), sizeof (hash.bytes));
+	blake2b_update (&state, vote_a.account.bytes.data (), sizeof (vote_a.account.bytes));
+	blake2b_update (&state, vote_a.signature.bytes.data (), sizeof (vote_a.signature.bytes));
+	blake2b_final (&state, result.bytes.data (), sizeof (result.bytes));
+	return result;
+}
+
 // node.active.mutex lock required
 nano::vote_code nano::vote_processor::vote_blocking (std::shared_ptr<nano::vote> vote_a, std::shared_ptr<nano::transport::channel> channel_a, bool validated)
 {
@@ -172,10 +378,19 @@ nano::vote_code nano::vote_processor::vote_blocking (std::shared_ptr<nano::vote>
 	if (validated || !vote_a->validate ())
 	{
 		result = active.vote (vote_a);
-		observers.vote.notify (vote_a, channel_a, result);
+	}
+	vote_result (vote_a, channel_a, result);
+	return result;
+}
+
+void nano::vote_processor::vote_result (std::shared_ptr<nano::vote> const & vote_a, std::shared_ptr<nano::transport::channel> const & channel_a, nano::vote_code code_a)
+{
+	if (code_a != nano::vote_code::invalid)
+	{
+		observers.vote.notify (vote_a, channel_a, code_a);
 	}
 	std::string status;
-	switch (result)
+	switch (code_a)
 	{
 		case nano::vote_code::invalid:
 			status = "Invalid";
@@ -198,7 +413,6 @@ nano::vote_code nano::vote_processor::vote_blocking (std::shared_ptr<nano::vote>
 	{
 		logger.try_log (boost::str (boost::format ("Vote from: %1% sequence: %2% block(s): %3%status: %4%") % vote_a->account.to_account () % std::to_string (vote_a->sequence) % vote_a->hashes_string () % status));
 	}
-	return result;
 }
 
 void nano::vote_processor::stop ()
@@ -271,6 +485,8 @@ std::unique_ptr<nano::container_info_component> nano::collect_container_info (vo
 	size_t representatives_1_count;
 	size_t representatives_2_count;
 	size_t representatives_3_count;
+	size_t replays_count;
+	size_t verified_count;
 
 	{
 		nano::lock_guard<std::mutex> guard (vote_processor.mutex);
@@ -279,11 +495,21 @@ std::unique_ptr<nano::container_info_component> nano::collect_container_info (vo
 		representatives_2_count = vote_processor.representatives_2.size ();
 		representatives_3_count = vote_processor.representatives_3.size ();
 	}
+	{
+		nano::lock_guard<std::mutex> guard (vote_processor.replays_mutex);
+		replays_count = vote_processor.replays.size ();
+	}
+	{
+		nano::lock_guard<std::mutex> guard (vote_processor.verified_mutex);
+		verified_count = vote_processor.verified.size ();
+	}
 
 	auto composite = std::make_unique<container_info_composite> (name);
 	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "votes", votes_count, sizeof (decltype (vote_processor.votes)::value_type) }));
 	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "representatives_1", representatives_1_count, sizeof (decltype (vote_processor.representatives_1)::value_type) }));
 	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "representatives_2", representatives_2_count, sizeof (decltype (vote_processor.representatives_2)::value_type) }));
 	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "representatives_3", representatives_3_count, sizeof (decltype (vote_processor.representatives_3)::value_type) }));
+	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "replays", replays_count, sizeof (decltype (vote_processor.replays)::value_type) }));
+	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "verified", verified_count, sizeof (decltype (vote_processor.verified)::value_type) }));
 	return composite;
 }
@@ -4,12 +4,22 @@
 #include <nano/lib/utility.hpp>
 #include <nano/secure/common.hpp>
 
+#include <boost/multi_index/composite_key.hpp>
+#include <boost/multi_index/hashed_index.hpp>
+#include <boost/multi_index/member.hpp>
+#include <boost/multi_index/ordered_index.hpp>
+#include <boost/multi_index/sequenced_index.hpp>
+#include <boost/multi_index_container.hpp>
+
+#include <chrono>
 #include <deque>
 #include <memory>
 #include <mutex>
 #include <thread>
 #include <unordered_set>
 
+namespace mi = boost::multi_index;
+
 namespace nano
 {
 class signature_checker;
@@ -29,6 +39,27 @@ namespace transport
 	class channel;
 }
 
+/**
+ * Highest sequence an election has reported as a replay for a representative and block hash.
+ * Entries are only added from verified votes, a vote with a lower or equal sequence for the same hash would be a replay again.
+ */
+class vote_replay_entry final
+{
+public:
+	nano::account representative;
+	nano::block_hash hash;
+	uint64_t sequence;
+	std::chrono::steady_clock::time_point time;
+};
+
+/** Digest of a vote whose signature has been verified, covering the signed hash, the account and the signature */
+class vote_verified_entry final
+{
+public:
+	nano::block_hash digest;
+	std::chrono::steady_clock::time_point time;
+};
+
 class vote_processor final
 {
 public:
@@ -44,8 +75,23 @@ public:
 	void calculate_weights ();
 	void stop ();
 
+	/** Maximum age of replay entries, elections for the hashes may have ended since */
+	static std::chrono::seconds constexpr replay_cutoff{ 30 };
+	static size_t constexpr replay_max{ 32 * 1024 };
+	/** Maximum age of verified vote digests, copies of a vote relayed by other peers usually arrive well within this */
+	static std::chrono::seconds constexpr verified_cutoff{ 60 };
+	static size_t constexpr verified_max{ 64 * 1024 };
+
 private:
 	void process_loop ();
+	/** Returns true if every hash in the vote has a replay entry with at least the vote's sequence */
+	bool replay_filter (nano::vote const &);
+	void replay_insert (nano::vote const &, std::vector<nano::block_hash> const &);
+	static nano::block_hash verified_digest (nano::vote const &);
+	void apply_votes (std::vector<std::pair<std::shared_ptr<nano::vote>, std::shared_ptr<nano::transport::channel>>> &);
+	/** Reports verified votes dropped by the replay filter to the vote observers as replays, without passing them to the elections */
+	void replay_votes (std::vector<std::pair<std::shared_ptr<nano::vote>, std::shared_ptr<nano::transport::channel>>> const &);
+	void vote_result (std::shared_ptr<nano::vote> const &, std::shared_ptr<nano::transport::channel> const &, nano::vote_code);
 
 	nano::signature_checker & checker;
 	nano::active_transactions & active;
@@ -64,6 +110,26 @@ private:
 	std::unordered_set<nano::account> representatives_1;
 	std::unordered_set<nano::account> representatives_2;
 	std::unordered_set<nano::account> representatives_3;
+	// clang-format off
+	class tag_key {};
+	class tag_sequence {};
+	boost::multi_index_container<nano::vote_replay_entry,
+	mi::indexed_by<
+		mi::ordered_unique<mi::tag<tag_key>,
+			mi::composite_key<nano::vote_replay_entry,
+				mi::member<nano::vote_replay_entry, nano::account, &nano::vote_replay_entry::representative>,
+				mi::member<nano::vote_replay_entry, nano::block_hash, &nano::vote_replay_entry::hash>>>,
+		mi::sequenced<mi::tag<tag_sequence>>>>
+	replays;
+	std::mutex replays_mutex;
+	boost::multi_index_container<nano::vote_verified_entry,
+	mi::indexed_by<
+		mi::hashed_unique<mi::tag<tag_key>,
+			mi::member<nano::vote_verified_entry, nano::block_hash, &nano::vote_verified_entry::digest>>,
+		mi::sequenced<mi::tag<tag_sequence>>>>
+	verified;
+	// clang-format on
+	std::mutex verified_mutex;
 	nano::condition_variable condition;
 	std::mutex mutex;
 	bool started;
@@ -66,7 +66,7 @@ void nano::vote_generator::send (nano::unique_lock<std::mutex> & lock_a)
 			auto vote (this->store.vote_generate (transaction, pub_a, prv_a, hashes_l));
 			this->votes_cache.add (vote);
 			this->network.flood_vote_pr (vote);
-			this->network.flood_vote (vote, 2.0f);
+			this->network.flood_vote (vote, 2.0f, nano::bandwidth_class::local_vote);
 			this->vote_processor.vote (vote, std::make_shared<nano::transport::channel_udp> (this->network.udp_channels, this->network.endpoint (), this->network_params.protocol.protocol_version));
 		});
 	}
@@ -1,5 +1,8 @@
+#include <nano/lib/stats.hpp>
+#include <nano/lib/threading.hpp>
 #include <nano/lib/utility.hpp>
 #include <nano/node/write_database_queue.hpp>
+#include <nano/secure/blockstore.hpp>
 
 #include <algorithm>
 
@@ -83,3 +86,257 @@ void nano::write_database_queue::stop ()
 	}
 	cv.notify_all ();
 }
+
+nano::write_batcher::write_batcher (nano::block_store & store_a, nano::write_database_queue & write_database_queue_a, nano::stat & stats_a, std::chrono::milliseconds max_latency_a, size_t batch_size_a) :
+store (store_a),
+write_database_queue (write_database_queue_a),
+stats (stats_a),
+max_latency (max_latency_a),
+batch_size (std::max<size_t> (batch_size_a, 1)),
+thread ([this]() {
+	nano::thread_role::set (nano::thread_role::name::write_batch);
+	run ();
+})
+{
+}
+
+nano::write_batcher::~write_batcher ()
+{
+	stop ();
+}
+
+void nano::write_batcher::add (nano::writer writer_a, std::function<void(nano::write_transaction const &)> const & mutation_a)
+{
+	auto notify (false);
+	{
+		nano::lock_guard<std::mutex> guard (mutex);
+		if (!stopped)
+		{
+			auto now (std::chrono::steady_clock::now ());
+			queues[writer_a].push_back ({ mutation_a, now, now + max_latency, nullptr });
+			++queued;
+			// The batching thread only needs waking to start waiting for the first mutation or to commit a full batch
+			notify = queued == 1 || queued >= batch_size;
+		}
+	}
+	if (notify)
+	{
+		condition.notify_all ();
+	}
+}
+
+bool nano::write_batcher::apply_sync (nano::writer writer_a, std::function<void(nano::write_transaction const &)> const & mutation_a)
+{
+	auto committed (std::make_shared<std::promise<void>> ());
+	auto future (committed->get_future ());
+	auto result (false);
+	{
+		nano::lock_guard<std::mutex> guard (mutex);
+		result = stopped;
+		if (!stopped)
+		{
+			auto now (std::chrono::steady_clock::now ());
+			queues[writer_a].push_back ({ mutation_a, now, now, committed });
+			++queued;
+		}
+	}
+	if (!result)
+	{
+		condition.notify_all ();
+		future.wait ();
+	}
+	return result;
+}
+
+void nano::write_batcher::apply (nano::write_transaction const & transaction_a, std::deque<std::function<void()>> & committed_a)
+{
+	std::deque<std::function<void()>> released;
+	apply (transaction_a, released, committed_a);
+	committed_a.insert (committed_a.begin (), released.begin (), released.end ());
+}
+
+void nano::write_batcher::apply (nano::write_transaction const & transaction_a, std::deque<std::function<void()>> & released_a, std::deque<std::function<void()>> & committed_a)
+{
+	auto batch (take ());
+	apply (transaction_a, batch, released_a, committed_a);
+}
+
+std::vector<nano::write_batcher::entry> nano::write_batcher::take ()
+{
+	std::vector<entry> result;
+	nano::lock_guard<std::mutex> guard (mutex);
+	while (queued > 0 && result.size () < batch_size)
+	{
+		for (auto i (queues.begin ()), n (queues.end ()); i != n && result.size () < batch_size; ++i)
+		{
+			if (!i->second.empty ())
+			{
+				result.push_back (std::move (i->second.front ()));
+				i->second.pop_front ();
+				--queued;
+			}
+		}
+	}
+	return result;
+}
+
+void nano::write_batcher::apply (nano::write_transaction const & transaction_a, std::vector<entry> & batch_a, std::deque<std::function<void()>> & released_a, std::deque<std::function<void()>> & committed_a)
+{
+	if (!batch_a.empty ())
+	{
+		std::vector<std::chrono::steady_clock::time_point> added;
+		added.reserve (batch_a.size ());
+		for (auto const & item : batch_a)
+		{
+			item.mutation (transaction_a);
+			added.push_back (item.added);
+			if (item.committed != nullptr)
+			{
+				released_a.push_back ([committed = item.committed]() {
+					committed->set_value ();
+				});
+			}
+		}
+		committed_a.push_back ([& stats = stats, added = std::move (added)]() {
+			auto now (std::chrono::steady_clock::now ());
+			for (auto const & time : added)
+			{
+				auto latency (now - time);
+				auto detail (nano::stat::detail::write_batch_latency_max);
+				if (latency <= std::chrono::milliseconds (1))
+				{
+					detail = nano::stat::detail::write_batch_latency_1ms;
+				}
+				else if (latency <= std::chrono::milliseconds (10))
+				{
+					detail = nano::stat::detail::write_batch_latency_10ms;
+				}
+				else if (latency <= std::chrono::milliseconds (100))
+				{
+					detail = nano::stat::detail::write_batch_latency_100ms;
+				}
+				else if (latency <= std::chrono::seconds (1))
+				{
+					detail = nano::stat::detail::write_batch_latency_1s;
+				}
+				stats.inc (nano::stat::type::write_batch, detail);
+			}
+		});
+		stats.add (nano::stat::type::write_batch, nano::stat::detail::write_batch_merged, nano::stat::dir::in, batch_a.size ());
+	}
+}
+
+void nano::write_batcher::stop ()
+{
+	{
+		nano::lock_guard<std::mutex> guard (mutex);
+		stopped = true;
+	}
+	condition.notify_all ();
+	if (thread.joinable ())
+	{
+		thread.join ();
+	}
+}
+
+size_t nano::write_batcher::size ()
+{
+	nano::lock_guard<std::mutex> guard (mutex);
+	return queued;
+}
+
+void nano::write_batcher::run ()
+{
+	nano::unique_lock<std::mutex> lock (mutex);
+	// Anything still queued when stopping is committed before returning
+	while (!stopped || queued > 0)
+	{
+		if (queued == 0)
+		{
+			condition.wait (lock);
+		}
+		else if (!stopped && queued < batch_size && std::chrono::steady_clock::now () < deadline ())
+		{
+			condition.wait_until (lock, deadline ());
+		}
+		else
+		{
+			lock.unlock ();
+			commit ();
+			lock.lock ();
+		}
+	}
+}
+
+void nano::write_batcher::commit ()
+{
+	nano::writer writer_l;
+	{
+		nano::lock_guard<std::mutex> guard (mutex);
+		writer_l = commit_writer ();
+	}
+	std::deque<std::function<void()>> released;
+	std::deque<std::function<void()>> committed;
+	auto batch_committed (false);
+	{
+		auto scoped_write_guard = write_database_queue.wait (writer_l);
+		// The writer holding the write lock before may have applied everything meanwhile, an empty transaction isn't opened
+		auto batch (take ());
+		if (!batch.empty ())
+		{
+			auto transaction (store.tx_begin_write ({ tables::peers, tables::vote }, { tables::confirmation_height }));
+			apply (transaction, batch, released, committed);
+			batch_committed = true;
+		}
+	}
+	if (batch_committed)
+	{
+		stats.inc (nano::stat::type::write_batch, nano::stat::detail::write_batch_commit);
+	}
+	for (auto & callback : released)
+	{
+		callback ();
+	}
+	for (auto & callback : committed)
+	{
+		callback ();
+	}
+}
+
+std::chrono::steady_clock::time_point nano::write_batcher::deadline () const
+{
+	auto result (std::chrono::steady_clock::time_point::max ());
+	for (auto const & queue : queues)
+	{
+		for (auto const & item : queue.second)
+		{
+			result = std::min (result, item.deadline);
+		}
+	}
+	return result;
+}
+
+nano::writer nano::write_batcher::commit_writer () const
+{
+	auto result (nano::writer::write_batch);
+	for (auto i (queues.begin ()), n (queues.end ()); i != n && result == nano::writer::write_batch; ++i)
+	{
+		if (!i->second.empty () && i->second.front ().committed != nullptr)
+		{
+			result = i->first;
+		}
+	}
+	return result;
+}
+
+std::unique_ptr<nano::container_info_component> nano::collect_container_info (write_batcher & write_batcher, const std::string & name)
+{
+	size_t queued_count;
+	{
+		nano::lock_guard<std::mutex> guard (write_batcher.mutex);
+		queued_count = write_batcher.queued;
+	}
+	auto composite = std::make_unique<container_info_composite> (name);
+	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "queued", queued_count, sizeof (decltype (write_batcher.queues)::mapped_type::value_type) }));
+	return composite;
+}
@@ -2,10 +2,17 @@
 
 #include <nano/lib/locks.hpp>
 
+#include <chrono>
 #include <condition_variable>
 #include <deque>
 #include <functional>
+#include <future>
+#include <map>
+#include <memory>
 #include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
 
 namespace nano
 {
@@ -14,6 +21,9 @@ enum class writer
 {
 	confirmation_height,
 	process_batch,
+	write_batch,
+	peers,
+	vote,
 	testing // Used in tests to emulate a write lock
 };
 
@@ -54,4 +64,72 @@ private:
 	std::function<void()> guard_finish_callback;
 	bool stopped{ false };
 };
+
+class block_store;
+class container_info_component;
+class stat;
+class write_transaction;
+
+/**
+ * Groups writes so they share commits with other writes. Queued mutations are applied in the next write transaction of a writer calling apply,
+ * such as at the end of each block processor batch, or otherwise in a transaction of the batching thread.
+ * Deferrable mutations, such as peers and vote flushes, are committed by the batching thread once one has waited for max_latency or batch_size of them are queued.
+ * Mutations added through apply_sync, such as cementing, are committed straight away unless a writer holding the write lock applies them first.
+ * Mutations may only write to the peers, vote and confirmation_height tables, which writers calling apply must include.
+ */
+class write_batcher final
+{
+public:
+	write_batcher (nano::block_store &, nano::write_database_queue &, nano::stat &, std::chrono::milliseconds max_latency_a, size_t batch_size_a);
+	~write_batcher ();
+	/** Queues \p mutation_a from \p writer_a. Mutations from one writer are applied in order */
+	void add (nano::writer writer_a, std::function<void(nano::write_transaction const &)> const & mutation_a);
+	/**
+	 * Queues \p mutation_a from \p writer_a and blocks until it has been committed. The batching thread waits for the write lock as \p writer_a to commit it.
+	 * Returns true without applying it if the batcher has stopped
+	 */
+	bool apply_sync (nano::writer writer_a, std::function<void(nano::write_transaction const &)> const & mutation_a);
+	/** Applies queued mutations inside \p transaction_a. Callbacks which need to run once it has been committed are added to \p committed_a, releasing apply_sync callers first */
+	void apply (nano::write_transaction const & transaction_a, std::deque<std::function<void()>> & committed_a);
+	/** As above, callbacks releasing apply_sync callers are added to \p released_a so the committing thread can run them straight away and defer the rest */
+	void apply (nano::write_transaction const & transaction_a, std::deque<std::function<void()>> & released_a, std::deque<std::function<void()>> & committed_a);
+	/** Commits everything still queued and stops the batching thread */
+	void stop ();
+	size_t size ();
+
+private:
+	class entry final
+	{
+	public:
+		std::function<void(nano::write_transaction const &)> mutation;
+		std::chrono::steady_clock::time_point added;
+		/** When the batching thread commits it if no other writer has */
+		std::chrono::steady_clock::time_point deadline;
+		/** Set once committed for mutations added through apply_sync */
+		std::shared_ptr<std::promise<void>> committed;
+	};
+	void run ();
+	void commit ();
+	std::vector<entry> take ();
+	void apply (nano::write_transaction const & transaction_a, std::vector<entry> & batch_a, std::deque<std::function<void()>> & released_a, std::deque<std::function<void()>> & committed_a);
+	std::chrono::steady_clock::time_point deadline () const;
+	/** The writer the batching thread waits for the write lock as, the first with a mutation waiting through apply_sync */
+	nano::writer commit_writer () const;
+	nano::block_store & store;
+	nano::write_database_queue & write_database_queue;
+	nano::stat & stats;
+	std::chrono::milliseconds const max_latency;
+	size_t const batch_size;
+	/** Queued mutations per writer, taken in turn so one writer can't hold back the others */
+	std::map<nano::writer, std::deque<entry>> queues;
+	size_t queued{ 0 };
+	bool stopped{ false };
+	std::mutex mutex;
+	nano::condition_variable condition;
+	std::thread thread;
+
+	friend std::unique_ptr<container_info_component> collect_container_info (write_batcher &, const std::string &);
+};
+
+std::unique_ptr<container_info_component> collect_container_info (write_batcher & write_batcher, const std::string & name);
 }
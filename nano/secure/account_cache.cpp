@@ -0,0 +1,156 @@
+#include <nano/lib/stats.hpp>
+#include <nano/lib/utility.hpp>
+#include <nano/secure/account_cache.hpp>
+
+template <typename Value>
+bool nano::account_cache::table<Value>::find (nano::account const & account_a, boost::optional<Value> & value_a)
+{
+	nano::lock_guard<std::mutex> guard (mutex);
+	auto & by_account (entries.template get<tag_account> ());
+	auto existing (by_account.find (account_a));
+	auto result (existing != by_account.end ());
+	if (result)
+	{
+		value_a = existing->value;
+		// Move to the back of the eviction order
+		entries.template get<tag_sequence> ().relocate (entries.template get<tag_sequence> ().end (), entries.template project<tag_sequence> (existing));
+	}
+	return result;
+}
+
+template <typename Value>
+void nano::account_cache::table<Value>::insert (nano::account const & account_a, boost::optional<Value> const & value_a, bool overwrite_a, size_t max_size_a)
+{
+	if (max_size_a > 0)
+	{
+		nano::lock_guard<std::mutex> guard (mutex);
+		auto & by_account (entries.template get<tag_account> ());
+		auto existing (by_account.find (account_a));
+		if (existing == by_account.end ())
+		{
+			entries.template get<tag_sequence> ().push_back ({ account_a, value_a });
+			while (entries.size () > max_size_a)
+			{
+				entries.template get<tag_sequence> ().pop_front ();
+			}
+		}
+		else if (overwrite_a)
+		{
+			by_account.modify (existing, [&value_a](entry & entry_a) {
+				entry_a.value = value_a;
+			});
+			entries.template get<tag_sequence> ().relocate (entries.template get<tag_sequence> ().end (), entries.template project<tag_sequence> (existing));
+		}
+	}
+}
+
+template <typename Value>
+void nano::account_cache::table<Value>::clear ()
+{
+	nano::lock_guard<std::mutex> guard (mutex);
+	entries.clear ();
+}
+
+template <typename Value>
+size_t nano::account_cache::table<Value>::size ()
+{
+	nano::lock_guard<std::mutex> guard (mutex);
+	return entries.size ();
+}
+
+void nano::account_cache::reset (size_t max_size_a, nano::stat * stats_a)
+{
+	max_size_m = 0;
+	accounts.clear ();
+	confirmation_heights.clear ();
+	stats = stats_a;
+	max_size_m = max_size_a;
+}
+
+bool nano::account_cache::enabled () const
+{
+	return max_size_m.load () > 0;
+}
+
+bool nano::account_cache::account_find (nano::account const & account_a, boost::optional<nano::account_info> & info_a)
+{
+	auto result (enabled () && accounts.find (account_a, info_a));
+	count (result, true);
+	return result;
+}
+
+void nano::account_cache::account_insert (nano::account const & account_a, boost::optional<nano::account_info> const & info_a)
+{
+	accounts.insert (account_a, info_a, false, max_size_m);
+}
+
+void nano::account_cache::account_put (nano::account const & account_a, boost::optional<nano::account_info> const & info_a)
+{
+	accounts.insert (account_a, info_a, true, max_size_m);
+}
+
+bool nano::account_cache::confirmation_height_find (nano::account const & account_a, boost::optional<nano::confirmation_height_info> & info_a)
+{
+	auto result (enabled () && confirmation_heights.find (account_a, info_a));
+	count (result, false);
+	return result;
+}
+
+void nano::account_cache::confirmation_height_insert (nano::account const & account_a, boost::optional<nano::confirmation_height_info> const & info_a)
+{
+	confirmation_heights.insert (account_a, info_a, false, max_size_m);
+}
+
+void nano::account_cache::confirmation_height_put (nano::account const & account_a, boost::optional<nano::confirmation_height_info> const & info_a)
+{
+	confirmation_heights.insert (account_a, info_a, true, max_size_m);
+}
+
+size_t nano::account_cache::max_size () const
+{
+	return max_size_m;
+}
+
+size_t nano::account_cache::account_size ()
+{
+	return accounts.size ();
+}
+
+size_t nano::account_cache::confirmation_height_size ()
+{
+	return confirmation_heights.size ();
+}
+
+uint64_t nano::account_cache::hit_count () const
+{
+	return hits;
+}
+
+uint64_t nano::account_cache::miss_count () const
+{
+	return misses;
+}
+
+void nano::account_cache::count (bool hit_a, bool account_a)
+{
+	if (enabled ())
+	{
+		++(hit_a ? hits : misses);
+		auto stats_l (stats.load ());
+		if (stats_l != nullptr)
+		{
+			auto detail (account_a ? (hit_a ? nano::stat::detail::account_info_hit : nano::stat::detail::account_info_miss) : (hit_a ? nano::stat::detail::confirmation_height_hit : nano::stat::detail::confirmation_height_miss));
+			stats_l->inc (nano::stat::type::account_cache, detail);
+		}
+	}
+}
+
+std::unique_ptr<nano::container_info_component> nano::collect_container_info (account_cache & account_cache, const std::string & name)
+{
+	auto composite = std::make_unique<container_info_composite> (name);
+	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "accounts", account_cache.account_size (), sizeof (nano::account) + sizeof (nano::account_info) }));
+	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "confirmation_heights", account_cache.confirmation_height_size (), sizeof (nano::account) + sizeof (nano::confirmation_height_info) }));
+	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "hits", account_cache.hit_count (), 0 }));
+	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "misses", account_cache.miss_count (), 0 }));
+	return composite;
+}
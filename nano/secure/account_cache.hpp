@@ -0,0 +1,94 @@
+#pragma once
+
+#include <nano/secure/common.hpp>
+
+#include <boost/multi_index/hashed_index.hpp>
+#include <boost/multi_index/member.hpp>
+#include <boost/multi_index/sequenced_index.hpp>
+#include <boost/multi_index_container.hpp>
+#include <boost/optional.hpp>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+namespace nano
+{
+class container_info_component;
+class stat;
+
+/**
+ * Bounded cache of decoded account_info and confirmation_height_info by account, each table evicting its least recently used accounts once full.
+ * Accounts known not to be stored are cached as well. Values are written through by the store on put and delete, before the writing transaction
+ * commits. This is only consistent when write transactions are serialized and always commit, as with LMDB, so the node doesn't enable it with RocksDB.
+ * Only write transactions may use it, read transactions can be on a snapshot older than what is cached.
+ * @note This class is thread-safe
+ */
+class account_cache final
+{
+public:
+	/** Clears the cache and bounds each table to \p max_size_a accounts, 0 disables it. Hits and misses are also counted in \p stats_a if it isn't null */
+	void reset (size_t max_size_a, nano::stat * stats_a = nullptr);
+	bool enabled () const;
+
+	/** Returns false on a miss, otherwise \p info_a holds the cached value or is empty if the account isn't stored */
+	bool account_find (nano::account const & account_a, boost::optional<nano::account_info> & info_a);
+	/** Caches the value read from the store after a miss, unless a write has cached a value for the account meanwhile */
+	void account_insert (nano::account const & account_a, boost::optional<nano::account_info> const & info_a);
+	/** Writes through \p info_a, empty if the account was deleted */
+	void account_put (nano::account const & account_a, boost::optional<nano::account_info> const & info_a);
+
+	bool confirmation_height_find (nano::account const & account_a, boost::optional<nano::confirmation_height_info> & info_a);
+	void confirmation_height_insert (nano::account const & account_a, boost::optional<nano::confirmation_height_info> const & info_a);
+	void confirmation_height_put (nano::account const & account_a, boost::optional<nano::confirmation_height_info> const & info_a);
+
+	size_t max_size () const;
+	size_t account_size ();
+	size_t confirmation_height_size ();
+	uint64_t hit_count () const;
+	uint64_t miss_count () const;
+
+private:
+	template <typename Value>
+	class table final
+	{
+	public:
+		class entry final
+		{
+		public:
+			nano::account account;
+			boost::optional<Value> value;
+		};
+		class tag_sequence
+		{
+		};
+		class tag_account
+		{
+		};
+		bool find (nano::account const & account_a, boost::optional<Value> & value_a);
+		void insert (nano::account const & account_a, boost::optional<Value> const & value_a, bool overwrite_a, size_t max_size_a);
+		void clear ();
+		size_t size ();
+
+	private:
+		std::mutex mutex;
+		boost::multi_index_container<entry,
+		boost::multi_index::indexed_by<
+		boost::multi_index::sequenced<boost::multi_index::tag<tag_sequence>>,
+		boost::multi_index::hashed_unique<boost::multi_index::tag<tag_account>,
+		boost::multi_index::member<entry, nano::account, &entry::account>>>>
+		entries;
+	};
+
+	void count (bool hit_a, bool account_a);
+
+	table<nano::account_info> accounts;
+	table<nano::confirmation_height_info> confirmation_heights;
+	std::atomic<size_t> max_size_m{ 0 };
+	std::atomic<nano::stat *> stats{ nullptr };
+	std::atomic<uint64_t> hits{ 0 };
+	std::atomic<uint64_t> misses{ 0 };
+};
+
+std::unique_ptr<container_info_component> collect_container_info (account_cache & account_cache, const std::string & name);
+}
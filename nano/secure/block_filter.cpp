@@ -0,0 +1,126 @@
+#include <nano/crypto_lib/random_pool.hpp>
+#include <nano/lib/utility.hpp>
+#include <nano/secure/block_filter.hpp>
+
+void nano::block_filter::reset (size_t size_bytes_a)
+{
+	enabled_m = false;
+	line_count = size_bytes_a / (words_per_line * sizeof (uint64_t));
+	words.reset (line_count > 0 ? new std::atomic<uint64_t>[line_count * words_per_line] : nullptr);
+	for (size_t i (0), n (line_count * words_per_line); i < n; ++i)
+	{
+		words[i].store (0, std::memory_order_relaxed);
+	}
+	nano::random_pool::generate_block (reinterpret_cast<uint8_t *> (salt.data ()), sizeof (salt));
+	elements = 0;
+	negatives = 0;
+	false_positives = 0;
+}
+
+void nano::block_filter::enable ()
+{
+	enabled_m = line_count > 0;
+}
+
+template <typename Action>
+bool nano::block_filter::for_each_bit (nano::block_hash const & hash_a, Action const & action_a) const
+{
+	debug_assert (line_count > 0);
+	// Block hashes are uniformly distributed, so parts of them can be used directly as the hash functions. The salt stops crafted hashes targeting a single line.
+	auto line (words.get () + ((hash_a.qwords[0] ^ salt[0]) % line_count) * words_per_line);
+	auto bits (hash_a.qwords[1] ^ salt[1]);
+	auto result (true);
+	for (unsigned i (0); i < hash_count && result; ++i, bits >>= 9)
+	{
+		auto position (bits % bits_per_line);
+		result = action_a (line[position / 64], uint64_t{ 1 } << (position % 64));
+	}
+	return result;
+}
+
+void nano::block_filter::insert (nano::block_hash const & hash_a)
+{
+	if (line_count > 0)
+	{
+		for_each_bit (hash_a, [](std::atomic<uint64_t> & word_a, uint64_t mask_a) {
+			word_a.fetch_or (mask_a, std::memory_order_relaxed);
+			return true;
+		});
+		elements.fetch_add (1, std::memory_order_relaxed);
+	}
+}
+
+void nano::block_filter::erase (nano::block_hash const &)
+{
+	if (line_count > 0)
+	{
+		elements.fetch_sub (1, std::memory_order_relaxed);
+	}
+}
+
+bool nano::block_filter::may_contain (nano::block_hash const & hash_a)
+{
+	auto result (true);
+	if (enabled_m.load (std::memory_order_relaxed))
+	{
+		result = for_each_bit (hash_a, [](std::atomic<uint64_t> const & word_a, uint64_t mask_a) {
+			return (word_a.load (std::memory_order_relaxed) & mask_a) != 0;
+		});
+		if (!result)
+		{
+			negatives.fetch_add (1, std::memory_order_relaxed);
+		}
+	}
+	return result;
+}
+
+void nano::block_filter::false_positive ()
+{
+	if (enabled_m.load (std::memory_order_relaxed))
+	{
+		false_positives.fetch_add (1, std::memory_order_relaxed);
+	}
+}
+
+bool nano::block_filter::enabled () const
+{
+	return enabled_m;
+}
+
+size_t nano::block_filter::size_bytes () const
+{
+	return line_count * words_per_line * sizeof (uint64_t);
+}
+
+uint64_t nano::block_filter::element_count () const
+{
+	return elements;
+}
+
+uint64_t nano::block_filter::negative_count () const
+{
+	return negatives;
+}
+
+uint64_t nano::block_filter::false_positive_count () const
+{
+	return false_positives;
+}
+
+double nano::block_filter::false_positive_rate () const
+{
+	uint64_t false_positives_l (false_positives);
+	uint64_t absent_l (false_positives_l + negatives);
+	return absent_l > 0 ? static_cast<double> (false_positives_l) / absent_l : 0.;
+}
+
+std::unique_ptr<nano::container_info_component> nano::collect_container_info (block_filter & block_filter, const std::string & name)
+{
+	auto composite = std::make_unique<container_info_composite> (name);
+	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "elements", block_filter.element_count (), 0 }));
+	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "bytes", block_filter.size_bytes (), 1 }));
+	// The false positive rate is false_positives / (false_positives + negatives)
+	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "negatives", block_filter.negative_count (), 0 }));
+	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "false_positives", block_filter.false_positive_count (), 0 }));
+	return composite;
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <nano/lib/numbers.hpp>
+
+#include <array>
+#include <atomic>
+#include <memory>
+
+namespace nano
+{
+class container_info_component;
+
+/**
+ * A blocked Bloom filter over the hashes of all blocks in the ledger, used to answer lookups for blocks which are not stored without touching the database.
+ * There are no false negatives, a negative result means the block is definitely not in the ledger. All bits for an element are within a single cache line.
+ * Bloom filters do not support removal, bits for deleted blocks stay set and only add to the false positive rate until the filter is rebuilt.
+ * @note This class is thread-safe and lock-free, except for reset () which must not be called concurrently with any other member.
+ */
+class block_filter final
+{
+public:
+	/**
+	 * Allocates \p size_bytes_a of memory for the filter and clears it, leaving it disabled until enable () is called.
+	 * A size of 0 leaves the filter permanently disabled.
+	 */
+	void reset (size_t size_bytes_a);
+
+	/** Starts answering lookups, all stored blocks must have been inserted beforehand */
+	void enable ();
+
+	/** Insertions are accepted while disabled so that blocks added during a rebuild are not missed */
+	void insert (nano::block_hash const & hash_a);
+
+	/** Records that a block was removed from the ledger, its bits are left set */
+	void erase (nano::block_hash const & hash_a);
+
+	/**
+	 * @return false if the block is definitely not stored, true if it may be or the filter is disabled.
+	 * Negative results are counted towards the filter statistics.
+	 */
+	bool may_contain (nano::block_hash const & hash_a);
+
+	/** Records that a positive result from may_contain () was not found in the database */
+	void false_positive ();
+
+	bool enabled () const;
+	size_t size_bytes () const;
+	uint64_t element_count () const;
+	/** Number of lookups answered without a database read */
+	uint64_t negative_count () const;
+	uint64_t false_positive_count () const;
+	/** Fraction of lookups for blocks not in the ledger which the filter failed to reject */
+	double false_positive_rate () const;
+
+	static unsigned constexpr hash_count{ 4 };
+
+private:
+	static size_t constexpr words_per_line{ 8 };
+	static size_t constexpr bits_per_line{ words_per_line * 64 };
+
+	/** Calls \p action_a with the word and mask for each of the hash_count bits belonging to \p hash_a */
+	template <typename Action>
+	bool for_each_bit (nano::block_hash const & hash_a, Action const & action_a) const;
+
+	std::unique_ptr<std::atomic<uint64_t>[]> words;
+	size_t line_count{ 0 };
+	std::array<uint64_t, 2> salt{ { 0, 0 } };
+	std::atomic<bool> enabled_m{ false };
+	std::atomic<uint64_t> elements{ 0 };
+	std::atomic<uint64_t> negatives{ 0 };
+	std::atomic<uint64_t> false_positives{ 0 };
+};
+
+std::unique_ptr<container_info_component> collect_container_info (block_filter & block_filter, const std::string & name);
+}
@@ -6,6 +6,8 @@
 #include <nano/lib/logger_mt.hpp>
 #include <nano/lib/memory.hpp>
 #include <nano/lib/rocksdbconfig.hpp>
+#include <nano/secure/account_cache.hpp>
+#include <nano/secure/block_filter.hpp>
 #include <nano/secure/buffer.hpp>
 #include <nano/secure/common.hpp>
 #include <nano/secure/versioning.hpp>
@@ -25,6 +27,16 @@ public:
 	nano::block_sideband sideband;
 };
 
+/**
+ * A block of any type along with its sideband, as stored in the blocks table
+ */
+class block_w_sideband
+{
+public:
+	std::shared_ptr<nano::block> block;
+	nano::block_sideband sideband;
+};
+
 /**
  * Encapsulates database specific container
  */
@@ -123,6 +135,12 @@ public:
 		static_assert (std::is_standard_layout<nano::endpoint_key>::value, "Standard layout is required");
 	}
 
+	db_val (nano::height_key const & val_a) :
+	db_val (sizeof (val_a), const_cast<nano::height_key *> (&val_a))
+	{
+		static_assert (std::is_standard_layout<nano::height_key>::value, "Standard layout is required");
+	}
+
 	db_val (std::shared_ptr<nano::block> const & val_a) :
 	buffer (std::make_shared<std::vector<uint8_t>> ())
 	{
@@ -273,6 +291,15 @@ public:
 		return result;
 	}
 
+	explicit operator nano::height_key () const
+	{
+		nano::height_key result;
+		debug_assert (size () == sizeof (result));
+		static_assert (sizeof (nano::account) + sizeof (uint64_t) == sizeof (result), "Packed class");
+		std::copy (reinterpret_cast<uint8_t const *> (data ()), reinterpret_cast<uint8_t const *> (data ()) + sizeof (result), reinterpret_cast<uint8_t *> (&result));
+		return result;
+	}
+
 	explicit operator state_block_w_sideband () const
 	{
 		nano::bufferstream stream (reinterpret_cast<uint8_t const *> (data ()), size ());
@@ -287,6 +314,21 @@ public:
 		return block_w_sideband;
 	}
 
+	explicit operator block_w_sideband () const
+	{
+		nano::bufferstream stream (reinterpret_cast<uint8_t const *> (data ()), size ());
+		nano::block_w_sideband block_w_sideband;
+		block_w_sideband.block = nano::deserialize_block (stream);
+		debug_assert (block_w_sideband.block != nullptr);
+
+		auto error (block_w_sideband.sideband.deserialize (stream, block_w_sideband.block->type ()));
+		(void)error;
+		debug_assert (!error);
+		block_w_sideband.block->sideband_set (block_w_sideband.sideband);
+
+		return block_w_sideband;
+	}
+
 	explicit operator state_block_w_sideband_v14 () const
 	{
 		nano::bufferstream stream (reinterpret_cast<uint8_t const *> (data ()), size ());
@@ -572,20 +614,22 @@ private:
 enum class tables
 {
 	accounts,
+	block_heights,
+	blocks,
 	blocks_info, // LMDB only
 	cached_counts, // RocksDB only
-	change_blocks,
+	change_blocks, // Only used during upgrade
 	confirmation_height,
 	frontiers,
 	meta,
 	online_weight,
-	open_blocks,
+	open_blocks, // Only used during upgrade
 	peers,
 	pending,
-	receive_blocks,
+	receive_blocks, // Only used during upgrade
 	representation,
-	send_blocks,
-	state_blocks,
+	send_blocks, // Only used during upgrade
+	state_blocks, // Only used during upgrade
 	unchecked,
 	vote
 };
@@ -670,18 +714,33 @@ public:
 	virtual std::shared_ptr<nano::block> block_get_no_sideband (nano::transaction const &, nano::block_hash const &) const = 0;
 	virtual std::shared_ptr<nano::block> block_get_v14 (nano::transaction const &, nano::block_hash const &, nano::block_sideband_v14 * = nullptr, bool * = nullptr) const = 0;
 	virtual std::shared_ptr<nano::block> block_random (nano::transaction const &) = 0;
-	virtual void block_del (nano::write_transaction const &, nano::block_hash const &, nano::block_type) = 0;
+	virtual void block_del (nano::write_transaction const &, nano::block_hash const &) = 0;
 	virtual bool block_exists (nano::transaction const &, nano::block_hash const &) = 0;
 	virtual bool block_exists (nano::transaction const &, nano::block_type, nano::block_hash const &) = 0;
-	virtual nano::block_counts block_count (nano::transaction const &) = 0;
+	virtual uint64_t block_count (nano::transaction const &) = 0;
 	virtual bool root_exists (nano::transaction const &, nano::root const &) = 0;
+	/** Fills the filter in front of block_exists with all stored blocks, using \p size_bytes_a of memory. A size of 0 disables the filter. Must be called before the store is used concurrently */
+	virtual void block_filter_build (nano::transaction const &, size_t size_bytes_a) = 0;
+	virtual nano::block_filter & get_block_filter () = 0;
+	/** Enables the (account, height) -> hash index, filling it from the blocks table unless a previous fill completed. The fill commits in batches. Disabling drops the index so a stale one is never read. Must be called before the store is used concurrently */
+	virtual void block_height_index_set (nano::write_transaction &, bool enable_a) = 0;
+	/** Maintains and reads an existing complete index without building or dropping it */
+	virtual void block_height_index_load (nano::transaction const &) = 0;
+	virtual bool block_height_index_enabled () const = 0;
+	/** Returns the hash of the block at \p height_a in \p account_a's chain from the height index, or zero if the index is disabled or there's no such block */
+	virtual nano::block_hash block_hash_at_height (nano::transaction const &, nano::account const & account_a, uint64_t height_a) const = 0;
 	virtual bool source_exists (nano::transaction const &, nano::block_hash const &) = 0;
 	virtual nano::account block_account (nano::transaction const &, nano::block_hash const &) const = 0;
+	virtual nano::store_iterator<nano::block_hash, nano::block_w_sideband> blocks_begin (nano::transaction const &, nano::block_hash const &) const = 0;
+	virtual nano::store_iterator<nano::block_hash, nano::block_w_sideband> blocks_begin (nano::transaction const &) const = 0;
+	virtual nano::store_iterator<nano::block_hash, nano::block_w_sideband> blocks_end () const = 0;
 
 	virtual void frontier_put (nano::write_transaction const &, nano::block_hash const &, nano::account const &) = 0;
 	virtual nano::account frontier_get (nano::transaction const &, nano::block_hash const &) const = 0;
 	virtual void frontier_del (nano::write_transaction const &, nano::block_hash const &) = 0;
 
+	/** Cache of account_info and confirmation_height_info used by write transactions, disabled until it's reset to a non-zero size. Must be reset before the store is used concurrently */
+	virtual nano::account_cache & get_account_cache () = 0;
 	virtual void account_put (nano::write_transaction const &, nano::account const &, nano::account_info const &) = 0;
 	virtual bool account_get (nano::transaction const &, nano::account const &, nano::account_info &) = 0;
 	virtual void account_del (nano::write_transaction const &, nano::account const &) = 0;
@@ -699,6 +758,8 @@ public:
 	virtual bool pending_exists (nano::transaction const &, nano::pending_key const &) = 0;
 	virtual nano::store_iterator<nano::pending_key, nano::pending_info> pending_begin (nano::transaction const &, nano::pending_key const &) = 0;
 	virtual nano::store_iterator<nano::pending_key, nano::pending_info> pending_begin (nano::transaction const &) = 0;
+	/** Iterates from \p key_a through at least the rest of its account's entries, and may end after them. Faster than pending_begin for seeks within one account */
+	virtual nano::store_iterator<nano::pending_key, nano::pending_info> pending_account_begin (nano::transaction const &, nano::pending_key const & key_a) = 0;
 	virtual nano::store_iterator<nano::pending_key, nano::pending_info> pending_end () = 0;
 
 	virtual bool block_info_get (nano::transaction const &, nano::block_hash const &, nano::block_info &) const = 0;
@@ -4,8 +4,6 @@
 #include <nano/secure/blockstore.hpp>
 #include <nano/secure/buffer.hpp>
 
-#include <crypto/cryptopp/words.h>
-
 namespace nano
 {
 template <typename Val, typename Derived_Store>
@@ -73,7 +71,7 @@ public:
 
 	bool pending_exists (nano::transaction const & transaction_a, nano::pending_key const & key_a) override
 	{
-		auto iterator (pending_begin (transaction_a, key_a));
+		auto iterator (pending_account_begin (transaction_a, key_a));
 		return iterator != pending_end () && nano::pending_key (iterator->first) == key_a;
 	}
 
@@ -88,7 +86,7 @@ public:
 	std::vector<nano::unchecked_info> unchecked_get (nano::transaction const & transaction_a, nano::block_hash const & hash_a) override
 	{
 		std::vector<nano::unchecked_info> result;
-		for (auto i (unchecked_begin (transaction_a, nano::unchecked_key (hash_a, 0))), n (unchecked_end ()); i != n && i->first.key () == hash_a; ++i)
+		for (auto i (make_prefix_iterator<nano::unchecked_key, nano::unchecked_info> (transaction_a, tables::unchecked, nano::db_val<Val> (nano::unchecked_key (hash_a, 0)))), n (unchecked_end ()); i != n && i->first.key () == hash_a; ++i)
 		{
 			nano::unchecked_info const & unchecked_info (i->second);
 			result.push_back (unchecked_info);
@@ -102,10 +100,16 @@ public:
 		std::vector<uint8_t> vector;
 		{
 			nano::vectorstream stream (vector);
-			block_a.serialize (stream);
+			nano::serialize_block (stream, block_a);
 			block_a.sideband ().serialize (stream, block_a.type ());
 		}
-		block_raw_put (transaction_a, vector, block_a.type (), hash_a);
+		block_raw_put (transaction_a, vector, hash_a);
+		block_hash_filter.insert (hash_a);
+		if (block_height_index)
+		{
+			auto status (put (transaction_a, tables::block_heights, nano::db_val<Val> (block_height_key (block_a)), nano::db_val<Val> (hash_a)));
+			release_assert (success (status));
+		}
 		nano::block_predecessor_set<Val, Derived_Store> predecessor (transaction_a, *this);
 		block_a.visit (predecessor);
 		debug_assert (block_a.previous ().is_zero () || block_successor (transaction_a, block_a.previous ()) == hash_a);
@@ -121,30 +125,17 @@ public:
 
 	std::shared_ptr<nano::block> block_get (nano::transaction const & transaction_a, nano::block_hash const & hash_a) const override
 	{
-		nano::block_type type;
-		auto value (block_raw_get (transaction_a, hash_a, type));
+		auto value (block_raw_get (transaction_a, hash_a));
 		std::shared_ptr<nano::block> result;
 		if (value.size () != 0)
 		{
 			nano::bufferstream stream (reinterpret_cast<uint8_t const *> (value.data ()), value.size ());
-			result = nano::deserialize_block (stream, type);
+			result = nano::deserialize_block (stream);
 			debug_assert (result != nullptr);
 			nano::block_sideband sideband;
-			if (full_sideband (transaction_a) || entry_has_sideband (value.size (), type))
-			{
-				auto error (sideband.deserialize (stream, type));
-				(void)error;
-				debug_assert (!error);
-			}
-			else
-			{
-				// Reconstruct sideband data for block.
-				sideband.account = block_account_computed (transaction_a, hash_a);
-				sideband.balance = block_balance_computed (transaction_a, hash_a);
-				sideband.successor = block_successor (transaction_a, hash_a);
-				sideband.height = 0;
-				sideband.timestamp = 0;
-			}
+			auto error (sideband.deserialize (stream, result->type ()));
+			(void)error;
+			debug_assert (!error);
 			result->sideband_set (sideband);
 		}
 		return result;
@@ -152,13 +143,12 @@ public:
 
 	std::shared_ptr<nano::block> block_get_no_sideband (nano::transaction const & transaction_a, nano::block_hash const & hash_a) const override
 	{
-		nano::block_type type;
-		auto value (block_raw_get (transaction_a, hash_a, type));
+		auto value (block_raw_get (transaction_a, hash_a));
 		std::shared_ptr<nano::block> result;
 		if (value.size () != 0)
 		{
 			nano::bufferstream stream (reinterpret_cast<uint8_t const *> (value.data ()), value.size ());
-			result = nano::deserialize_block (stream, type);
+			result = nano::deserialize_block (stream);
 			debug_assert (result != nullptr);
 		}
 		return result;
@@ -166,21 +156,126 @@ public:
 
 	bool block_exists (nano::transaction const & transaction_a, nano::block_type type, nano::block_hash const & hash_a) override
 	{
-		auto junk = block_raw_get_by_type (transaction_a, hash_a, type);
-		return junk.is_initialized ();
+		auto result (false);
+		if (block_hash_filter.may_contain (hash_a))
+		{
+			auto value (block_raw_get (transaction_a, hash_a));
+			if (value.size () != 0)
+			{
+				result = block_type_from_raw (value.data ()) == type;
+			}
+			else
+			{
+				block_hash_filter.false_positive ();
+			}
+		}
+		return result;
 	}
 
 	bool block_exists (nano::transaction const & tx_a, nano::block_hash const & hash_a) override
 	{
-		// Table lookups are ordered by match probability
-		// clang-format off
-		return
-			block_exists (tx_a, nano::block_type::state, hash_a) ||
-			block_exists (tx_a, nano::block_type::send, hash_a) ||
-			block_exists (tx_a, nano::block_type::receive, hash_a) ||
-			block_exists (tx_a, nano::block_type::open, hash_a) ||
-			block_exists (tx_a, nano::block_type::change, hash_a);
-		// clang-format on
+		auto result (false);
+		if (block_hash_filter.may_contain (hash_a))
+		{
+			result = exists (tx_a, tables::blocks, nano::db_val<Val> (hash_a));
+			if (!result)
+			{
+				block_hash_filter.false_positive ();
+			}
+		}
+		return result;
+	}
+
+	void block_filter_build (nano::transaction const & transaction_a, size_t size_bytes_a) override
+	{
+		block_hash_filter.reset (size_bytes_a);
+		if (size_bytes_a > 0)
+		{
+			for (auto i (make_iterator<nano::block_hash, nano::no_value> (transaction_a, tables::blocks)), n (nano::store_iterator<nano::block_hash, nano::no_value> (nullptr)); i != n; ++i)
+			{
+				block_hash_filter.insert (i->first);
+			}
+			block_hash_filter.enable ();
+		}
+	}
+
+	nano::block_filter & get_block_filter () override
+	{
+		return block_hash_filter;
+	}
+
+	void block_height_index_set (nano::write_transaction & transaction_a, bool enable_a) override
+	{
+		nano::uint256_union complete_key (block_height_index_complete_key);
+		auto complete (block_height_index_complete (transaction_a));
+		block_height_index = false;
+		if (enable_a && !complete)
+		{
+			// An interrupted fill leaves part of the index without the marker, so it's started over
+			auto status (drop (transaction_a, tables::block_heights));
+			release_assert (success (status));
+			nano::block_hash next (0);
+			for (auto done (false); !done;)
+			{
+				{
+					size_t count (0);
+					auto i (blocks_begin (transaction_a, next));
+					auto n (blocks_end ());
+					for (; i != n && count < block_height_index_batch_size; ++i, ++count)
+					{
+						auto status (put (transaction_a, tables::block_heights, nano::db_val<Val> (block_height_key (*i->second.block)), nano::db_val<Val> (i->first)));
+						release_assert (success (status));
+					}
+					done = i == n;
+					if (!done)
+					{
+						next = i->first;
+					}
+				}
+				if (!done)
+				{
+					// Committed in batches so the pending writes of a large ledger aren't all held by one transaction
+					transaction_a.commit ();
+					transaction_a.renew ();
+				}
+			}
+			status = put (transaction_a, tables::meta, nano::db_val<Val> (complete_key), nano::db_val<Val> (nano::uint256_union (1)));
+			release_assert (success (status));
+		}
+		else if (!enable_a)
+		{
+			auto status (drop (transaction_a, tables::block_heights));
+			release_assert (success (status));
+			status = del (transaction_a, tables::meta, nano::db_val<Val> (complete_key));
+			release_assert (success (status) || not_found (status));
+		}
+		block_height_index = enable_a;
+	}
+
+	void block_height_index_load (nano::transaction const & transaction_a) override
+	{
+		block_height_index = block_height_index_complete (transaction_a);
+	}
+
+	bool block_height_index_enabled () const override
+	{
+		return block_height_index;
+	}
+
+	nano::block_hash block_hash_at_height (nano::transaction const & transaction_a, nano::account const & account_a, uint64_t height_a) const override
+	{
+		nano::block_hash result (0);
+		if (block_height_index)
+		{
+			nano::db_val<Val> value;
+			auto status (get (transaction_a, tables::block_heights, nano::db_val<Val> (nano::height_key (account_a, height_a)), value));
+			release_assert (success (status) || not_found (status));
+			if (success (status))
+			{
+				result = static_cast<nano::block_hash> (value);
+			}
+		}
+		return result;
 	}
 
 	bool root_exists (nano::transaction const & transaction_a, nano::root const & root_a) override
@@ -190,7 +285,14 @@ public:
 
 	bool source_exists (nano::transaction const & transaction_a, nano::block_hash const & source_a) override
 	{
-		return block_exists (transaction_a, nano::block_type::state, source_a) || block_exists (transaction_a, nano::block_type::send, source_a);
+		auto value (block_raw_get (transaction_a, source_a));
+		auto result (false);
+		if (value.size () != 0)
+		{
+			auto type (block_type_from_raw (value.data ()));
+			result = type == nano::block_type::state || type == nano::block_type::send;
+		}
+		return result;
 	}
 
 	nano::account block_account (nano::transaction const & transaction_a, nano::block_hash const & hash_a) const override
@@ -231,13 +333,13 @@ public:
 
 	nano::block_hash block_successor (nano::transaction const & transaction_a, nano::block_hash const & hash_a) const override
 	{
-		nano::block_type type;
-		auto value (block_raw_get (transaction_a, hash_a, type));
+		auto value (block_raw_get (transaction_a, hash_a));
 		nano::block_hash result;
 		if (value.size () != 0)
 		{
 			debug_assert (value.size () >= result.bytes.size ());
-			nano::bufferstream stream (reinterpret_cast<uint8_t const *> (value.data ()) + block_successor_offset (transaction_a, value.size (), type), result.bytes.size ());
+			auto type (block_type_from_raw (value.data ()));
+			nano::bufferstream stream (reinterpret_cast<uint8_t const *> (value.data ()) + block_successor_offset (value.size (), type), result.bytes.size ());
 			auto error (nano::try_read (stream, result.bytes));
 			(void)error;
 			debug_assert (!error);
@@ -256,12 +358,12 @@ public:
 
 	void block_successor_clear (nano::write_transaction const & transaction_a, nano::block_hash const & hash_a) override
 	{
-		nano::block_type type;
-		auto value (block_raw_get (transaction_a, hash_a, type));
+		auto value (block_raw_get (transaction_a, hash_a));
 		debug_assert (value.size () != 0);
+		auto type (block_type_from_raw (value.data ()));
 		std::vector<uint8_t> data (static_cast<uint8_t *> (value.data ()), static_cast<uint8_t *> (value.data ()) + value.size ());
-		std::fill_n (data.begin () + block_successor_offset (transaction_a, value.size (), type), sizeof (nano::block_hash), uint8_t{ 0 });
-		block_raw_put (transaction_a, data, type, hash_a);
+		std::fill_n (data.begin () + block_successor_offset (value.size (), type), sizeof (nano::block_hash), uint8_t{ 0 });
+		block_raw_put (transaction_a, data, hash_a);
 	}
 
 	void unchecked_put (nano::write_transaction const & transaction_a, nano::block_hash const & hash_a, std::shared_ptr<nano::block> const & block_a) override
@@ -354,6 +456,11 @@ public:
 		return nano::store_iterator<uint64_t, nano::amount> (nullptr);
 	}
 
+	nano::store_iterator<nano::block_hash, nano::block_w_sideband> blocks_end () const override
+	{
+		return nano::store_iterator<nano::block_hash, nano::block_w_sideband> (nullptr);
+	}
+
 	nano::store_iterator<nano::account, nano::account_info> latest_end () const override
 	{
 		return nano::store_iterator<nano::account, nano::account_info> (nullptr);
@@ -369,32 +476,21 @@ public:
 		return cache_mutex;
 	}
 
-	void block_del (nano::write_transaction const & transaction_a, nano::block_hash const & hash_a, nano::block_type block_type_a) override
+	void block_del (nano::write_transaction const & transaction_a, nano::block_hash const & hash_a) override
 	{
-		auto table = tables::state_blocks;
-		switch (block_type_a)
+		if (block_height_index)
 		{
-			case nano::block_type::open:
-				table = tables::open_blocks;
-				break;
-			case nano::block_type::receive:
-				table = tables::receive_blocks;
-				break;
-			case nano::block_type::send:
-				table = tables::send_blocks;
-				break;
-			case nano::block_type::change:
-				table = tables::change_blocks;
-				break;
-			case nano::block_type::state:
-				table = tables::state_blocks;
-				break;
-			default:
-				debug_assert (false);
+			auto block (block_get (transaction_a, hash_a));
+			debug_assert (block != nullptr);
+			if (block != nullptr)
+			{
+				auto status (del (transaction_a, tables::block_heights, nano::db_val<Val> (block_height_key (*block))));
+				release_assert (success (status) || not_found (status));
+			}
 		}
-
-		auto status = del (transaction_a, table, hash_a);
+		auto status = del (transaction_a, tables::blocks, hash_a);
 		release_assert (success (status));
+		block_hash_filter.erase (hash_a);
 	}
 
 	int version_get (nano::transaction const & transaction_a) const override
@@ -424,11 +520,10 @@ public:
 		return nano::epoch::epoch_0;
 	}
 
-	void block_raw_put (nano::write_transaction const & transaction_a, std::vector<uint8_t> const & data, nano::block_type block_type_a, nano::block_hash const & hash_a)
+	void block_raw_put (nano::write_transaction const & transaction_a, std::vector<uint8_t> const & data, nano::block_hash const & hash_a)
 	{
-		auto database_a = block_database (block_type_a);
 		nano::db_val<Val> value{ data.size (), (void *)data.data () };
-		auto status = put (transaction_a, database_a, hash_a, value);
+		auto status = put (transaction_a, tables::blocks, hash_a, value);
 		release_assert (success (status));
 	}
 
@@ -546,6 +641,11 @@ public:
 		release_assert (success (status));
 	}
 
+	nano::account_cache & get_account_cache () override
+	{
+		return account_cache;
+	}
+
 	void account_put (nano::write_transaction const & transaction_a, nano::account const & account_a, nano::account_info const & info_a) override
 	{
 		// Check we are still in sync with other tables
@@ -553,25 +653,44 @@ public:
 		nano::db_val<Val> info (info_a);
 		auto status = put (transaction_a, tables::accounts, account_a, info);
 		release_assert (success (status));
+		account_cache.account_put (account_a, info_a);
 	}
 
 	void account_del (nano::write_transaction const & transaction_a, nano::account const & account_a) override
 	{
 		auto status = del (transaction_a, tables::accounts, account_a);
 		release_assert (success (status));
+		account_cache.account_put (account_a, boost::none);
 	}
 
 	bool account_get (nano::transaction const & transaction_a, nano::account const & account_a, nano::account_info & info_a) override
 	{
-		nano::db_val<Val> value;
-		nano::db_val<Val> account (account_a);
-		auto status1 (get (transaction_a, tables::accounts, account, value));
-		release_assert (success (status1) || not_found (status1));
 		bool result (true);
-		if (success (status1))
+		auto cached (uses_account_cache (transaction_a));
+		boost::optional<nano::account_info> existing;
+		if (cached && account_cache.account_find (account_a, existing))
 		{
-			nano::bufferstream stream (reinterpret_cast<uint8_t const *> (value.data ()), value.size ());
-			result = info_a.deserialize (stream);
+			if (existing)
+			{
+				info_a = *existing;
+				result = false;
+			}
+		}
+		else
+		{
+			nano::db_val<Val> value;
+			nano::db_val<Val> account (account_a);
+			auto status1 (get (transaction_a, tables::accounts, account, value));
+			release_assert (success (status1) || not_found (status1));
+			if (success (status1))
+			{
+				nano::bufferstream stream (reinterpret_cast<uint8_t const *> (value.data ()), value.size ());
+				result = info_a.deserialize (stream);
+			}
+			if (cached)
+			{
+				account_cache.account_insert (account_a, result ? boost::none : boost::make_optional (info_a));
+			}
 		}
 		return result;
 	}
@@ -627,15 +746,9 @@ public:
 		return static_cast<const Derived_Store &> (*this).exists (transaction_a, table_a, key_a);
 	}
 
-	nano::block_counts block_count (nano::transaction const & transaction_a) override
+	uint64_t block_count (nano::transaction const & transaction_a) override
 	{
-		nano::block_counts result;
-		result.send = count (transaction_a, tables::send_blocks);
-		result.receive = count (transaction_a, tables::receive_blocks);
-		result.open = count (transaction_a, tables::open_blocks);
-		result.change = count (transaction_a, tables::change_blocks);
-		result.state = count (transaction_a, tables::state_blocks);
-		return result;
+		return count (transaction_a, tables::blocks);
 	}
 
 	size_t account_count (nano::transaction const & transaction_a) override
@@ -645,45 +758,17 @@ public:
 
 	std::shared_ptr<nano::block> block_random (nano::transaction const & transaction_a) override
 	{
-		auto count (block_count (transaction_a));
-		release_assert (std::numeric_limits<CryptoPP::word32>::max () > count.sum ());
-		auto region = static_cast<size_t> (nano::random_pool::generate_word32 (0, static_cast<CryptoPP::word32> (count.sum () - 1)));
-		std::shared_ptr<nano::block> result;
-		auto & derived_store = static_cast<Derived_Store &> (*this);
-		if (region < count.send)
-		{
-			result = derived_store.template block_random<nano::send_block> (transaction_a, tables::send_blocks);
-		}
-		else
+		nano::block_hash hash;
+		nano::random_pool::generate_block (hash.bytes.data (), hash.bytes.size ());
+		// Only the key is needed, avoid deserializing the block twice
+		auto existing = make_iterator<nano::block_hash, nano::no_value> (transaction_a, tables::blocks, nano::db_val<Val> (hash));
+		auto end (nano::store_iterator<nano::block_hash, nano::no_value> (nullptr));
+		if (existing == end)
 		{
-			region -= count.send;
-			if (region < count.receive)
-			{
-				result = derived_store.template block_random<nano::receive_block> (transaction_a, tables::receive_blocks);
-			}
-			else
-			{
-				region -= count.receive;
-				if (region < count.open)
-				{
-					result = derived_store.template block_random<nano::open_block> (transaction_a, tables::open_blocks);
-				}
-				else
-				{
-					region -= count.open;
-					if (region < count.change)
-					{
-						result = derived_store.template block_random<nano::change_block> (transaction_a, tables::change_blocks);
-					}
-					else
-					{
-						result = derived_store.template block_random<nano::state_block> (transaction_a, tables::state_blocks);
-					}
-				}
-			}
+			existing = make_iterator<nano::block_hash, nano::no_value> (transaction_a, tables::blocks);
 		}
-		debug_assert (result != nullptr);
-		return result;
+		debug_assert (existing != end);
+		return block_get (transaction_a, nano::block_hash (existing->first));
 	}
 
 	uint64_t confirmation_height_count (nano::transaction const & transaction_a) override
@@ -696,18 +781,36 @@ public:
 		nano::db_val<Val> confirmation_height_info (confirmation_height_info_a);
 		auto status = put (transaction_a, tables::confirmation_height, account_a, confirmation_height_info);
 		release_assert (success (status));
+		account_cache.confirmation_height_put (account_a, confirmation_height_info_a);
 	}
 
 	bool confirmation_height_get (nano::transaction const & transaction_a, nano::account const & account_a, nano::confirmation_height_info & confirmation_height_info_a) override
 	{
-		nano::db_val<Val> value;
-		auto status = get (transaction_a, tables::confirmation_height, nano::db_val<Val> (account_a), value);
-		release_assert (success (status) || not_found (status));
 		bool result (true);
-		if (success (status))
+		auto cached (uses_account_cache (transaction_a));
+		boost::optional<nano::confirmation_height_info> existing;
+		if (cached && account_cache.confirmation_height_find (account_a, existing))
 		{
-			nano::bufferstream stream (reinterpret_cast<uint8_t const *> (value.data ()), value.size ());
-			result = confirmation_height_info_a.deserialize (stream);
+			if (existing)
+			{
+				confirmation_height_info_a = *existing;
+				result = false;
+			}
+		}
+		else
+		{
+			nano::db_val<Val> value;
+			auto status = get (transaction_a, tables::confirmation_height, nano::db_val<Val> (account_a), value);
+			release_assert (success (status) || not_found (status));
+			if (success (status))
+			{
+				nano::bufferstream stream (reinterpret_cast<uint8_t const *> (value.data ()), value.size ());
+				result = confirmation_height_info_a.deserialize (stream);
+			}
+			if (cached)
+			{
+				account_cache.confirmation_height_insert (account_a, result ? boost::none : boost::make_optional (confirmation_height_info_a));
+			}
 		}
 		return result;
 	}
@@ -716,6 +819,7 @@ public:
 	{
 		auto status (del (transaction_a, tables::confirmation_height, nano::db_val<Val> (account_a)));
 		release_assert (success (status));
+		account_cache.confirmation_height_put (account_a, boost::none);
 	}
 
 	bool confirmation_height_exists (nano::transaction const & transaction_a, nano::account const & account_a) const override
@@ -723,6 +827,16 @@ public:
 		return exists (transaction_a, tables::confirmation_height, nano::db_val<Val> (account_a));
 	}
 
+	nano::store_iterator<nano::block_hash, nano::block_w_sideband> blocks_begin (nano::transaction const & transaction_a, nano::block_hash const & hash_a) const override
+	{
+		return make_iterator<nano::block_hash, nano::block_w_sideband> (transaction_a, tables::blocks, nano::db_val<Val> (hash_a));
+	}
+
+	nano::store_iterator<nano::block_hash, nano::block_w_sideband> blocks_begin (nano::transaction const & transaction_a) const override
+	{
+		return make_iterator<nano::block_hash, nano::block_w_sideband> (transaction_a, tables::blocks);
+	}
+
 	nano::store_iterator<nano::account, nano::account_info> latest_begin (nano::transaction const & transaction_a, nano::account const & account_a) const override
 	{
 		return make_iterator<nano::account, nano::account_info> (transaction_a, tables::accounts, nano::db_val<Val> (account_a));
@@ -738,6 +852,11 @@ public:
 		return make_iterator<nano::pending_key, nano::pending_info> (transaction_a, tables::pending, nano::db_val<Val> (key_a));
 	}
 
+	nano::store_iterator<nano::pending_key, nano::pending_info> pending_account_begin (nano::transaction const & transaction_a, nano::pending_key const & key_a) override
+	{
+		return make_prefix_iterator<nano::pending_key, nano::pending_info> (transaction_a, tables::pending, nano::db_val<Val> (key_a));
+	}
+
 	nano::store_iterator<nano::pending_key, nano::pending_info> pending_begin (nano::transaction const & transaction_a) override
 	{
 		return make_iterator<nano::pending_key, nano::pending_info> (transaction_a, tables::pending);
@@ -787,22 +906,13 @@ protected:
 	nano::network_params network_params;
 	std::unordered_map<nano::account, std::shared_ptr<nano::vote>> vote_cache_l1;
 	std::unordered_map<nano::account, std::shared_ptr<nano::vote>> vote_cache_l2;
-	static int constexpr version{ 18 };
-
-	template <typename T>
-	std::shared_ptr<nano::block> block_random (nano::transaction const & transaction_a, tables table_a)
-	{
-		nano::block_hash hash;
-		nano::random_pool::generate_block (hash.bytes.data (), hash.bytes.size ());
-		auto existing = make_iterator<nano::block_hash, std::shared_ptr<T>> (transaction_a, table_a, nano::db_val<Val> (hash));
-		if (existing == nano::store_iterator<nano::block_hash, std::shared_ptr<T>> (nullptr))
-		{
-			existing = make_iterator<nano::block_hash, std::shared_ptr<T>> (transaction_a, table_a);
-		}
-		auto end (nano::store_iterator<nano::block_hash, std::shared_ptr<T>> (nullptr));
-		debug_assert (existing != end);
-		return block_get (transaction_a, nano::block_hash (existing->first));
-	}
+	nano::block_filter block_hash_filter;
+	nano::account_cache account_cache;
+	bool block_height_index{ false };
+	/** Meta key marking a completely filled block height index */
+	static uint64_t constexpr block_height_index_complete_key{ 2 };
+	static size_t constexpr block_height_index_batch_size{ 16 * 1024 };
+	static int constexpr version{ 19 };
 
 	template <typename Key, typename Value>
 	nano::store_iterator<Key, Value> make_iterator (nano::transaction const & transaction_a, tables table_a) const
@@ -816,169 +926,50 @@ protected:
 		return static_cast<Derived_Store const &> (*this).template make_iterator<Key, Value> (transaction_a, table_a, key);
 	}
 
-	bool entry_has_sideband (size_t entry_size_a, nano::block_type type_a) const
+	template <typename Key, typename Value>
+	nano::store_iterator<Key, Value> make_prefix_iterator (nano::transaction const & transaction_a, tables table_a, nano::db_val<Val> const & key) const
 	{
-		return entry_size_a == nano::block::size (type_a) + nano::block_sideband::size (type_a);
+		return static_cast<Derived_Store const &> (*this).template make_prefix_iterator<Key, Value> (transaction_a, table_a, key);
 	}
 
-	nano::db_val<Val> block_raw_get (nano::transaction const & transaction_a, nano::block_hash const & hash_a, nano::block_type & type_a) const
+	nano::db_val<Val> block_raw_get (nano::transaction const & transaction_a, nano::block_hash const & hash_a) const
 	{
 		nano::db_val<Val> result;
-		// Table lookups are ordered by match probability
-		nano::block_type block_types[]{ nano::block_type::state, nano::block_type::send, nano::block_type::receive, nano::block_type::open, nano::block_type::change };
-		for (auto current_type : block_types)
-		{
-			auto db_val (block_raw_get_by_type (transaction_a, hash_a, current_type));
-			if (db_val.is_initialized ())
-			{
-				type_a = current_type;
-				result = db_val.get ();
-				break;
-			}
-		}
-
+		auto status = get (transaction_a, tables::blocks, hash_a, result);
+		release_assert (success (status) || not_found (status));
 		return result;
 	}
 
-	// Return account containing hash
-	nano::account block_account_computed (nano::transaction const & transaction_a, nano::block_hash const & hash_a) const
+	bool block_height_index_complete (nano::transaction const & transaction_a) const
 	{
-		debug_assert (!full_sideband (transaction_a));
-		nano::account result (0);
-		auto hash (hash_a);
-		while (result.is_zero ())
-		{
-			auto block (block_get_no_sideband (transaction_a, hash));
-			debug_assert (block);
-			result = block->account ();
-			if (result.is_zero ())
-			{
-				auto type (nano::block_type::invalid);
-				auto value (block_raw_get (transaction_a, block->previous (), type));
-				if (entry_has_sideband (value.size (), type))
-				{
-					result = block_account (transaction_a, block->previous ());
-				}
-				else
-				{
-					nano::block_info block_info;
-					if (!block_info_get (transaction_a, hash, block_info))
-					{
-						result = block_info.account;
-					}
-					else
-					{
-						result = frontier_get (transaction_a, hash);
-						if (result.is_zero ())
-						{
-							auto successor (block_successor (transaction_a, hash));
-							debug_assert (!successor.is_zero ());
-							hash = successor;
-						}
-					}
-				}
-			}
-		}
-		debug_assert (!result.is_zero ());
-		return result;
+		nano::db_val<Val> value;
+		auto status (get (transaction_a, tables::meta, nano::db_val<Val> (nano::uint256_union (block_height_index_complete_key)), value));
+		release_assert (success (status) || not_found (status));
+		return success (status);
 	}
 
-	nano::uint128_t block_balance_computed (nano::transaction const & transaction_a, nano::block_hash const & hash_a) const
+	/** The account of send, receive and change blocks is only stored in their sideband */
+	static nano::height_key block_height_key (nano::block const & block_a)
 	{
-		debug_assert (!full_sideband (transaction_a));
-		summation_visitor visitor (transaction_a, *this);
-		return visitor.compute_balance (hash_a);
+		auto account (block_a.account ().is_zero () ? block_a.sideband ().account : block_a.account ());
+		return nano::height_key (account, block_a.sideband ().height);
 	}
 
-	size_t block_successor_offset (nano::transaction const & transaction_a, size_t entry_size_a, nano::block_type type_a) const
+	/** Read transactions can be on a snapshot older than values written through to the cache, so only write transactions use it */
+	bool uses_account_cache (nano::transaction const & transaction_a) const
 	{
-		size_t result;
-		if (full_sideband (transaction_a) || entry_has_sideband (entry_size_a, type_a))
-		{
-			result = entry_size_a - nano::block_sideband::size (type_a);
-		}
-		else
-		{
-			// Read old successor-only sideband
-			debug_assert (entry_size_a == nano::block::size (type_a) + sizeof (nano::block_hash));
-			result = entry_size_a - sizeof (nano::block_hash);
-		}
-		return result;
+		return account_cache.enabled () && dynamic_cast<nano::write_transaction const *> (&transaction_a) != nullptr;
 	}
 
-	boost::optional<nano::db_val<Val>> block_raw_get_by_type (nano::transaction const & transaction_a, nano::block_hash const & hash_a, nano::block_type & type_a) const
+	/** Each entry in the blocks table is prefixed with its block type */
+	static nano::block_type block_type_from_raw (void * data_a)
 	{
-		nano::db_val<Val> value;
-		nano::db_val<Val> hash (hash_a);
-		int status = status_code_not_found ();
-		switch (type_a)
-		{
-			case nano::block_type::send:
-			{
-				status = get (transaction_a, tables::send_blocks, hash, value);
-				break;
-			}
-			case nano::block_type::receive:
-			{
-				status = get (transaction_a, tables::receive_blocks, hash, value);
-				break;
-			}
-			case nano::block_type::open:
-			{
-				status = get (transaction_a, tables::open_blocks, hash, value);
-				break;
-			}
-			case nano::block_type::change:
-			{
-				status = get (transaction_a, tables::change_blocks, hash, value);
-				break;
-			}
-			case nano::block_type::state:
-			{
-				status = get (transaction_a, tables::state_blocks, hash, value);
-				break;
-			}
-			case nano::block_type::invalid:
-			case nano::block_type::not_a_block:
-			{
-				break;
-			}
-		}
-
-		release_assert (success (status) || not_found (status));
-		boost::optional<nano::db_val<Val>> result;
-		if (success (status))
-		{
-			result = value;
-		}
-		return result;
+		return static_cast<nano::block_type> (static_cast<uint8_t const *> (data_a)[0]);
 	}
 
-	tables block_database (nano::block_type type_a)
+	size_t block_successor_offset (size_t entry_size_a, nano::block_type type_a) const
 	{
-		tables result = tables::frontiers;
-		switch (type_a)
-		{
-			case nano::block_type::send:
-				result = tables::send_blocks;
-				break;
-			case nano::block_type::receive:
-				result = tables::receive_blocks;
-				break;
-			case nano::block_type::open:
-				result = tables::open_blocks;
-				break;
-			case nano::block_type::change:
-				result = tables::change_blocks;
-				break;
-			case nano::block_type::state:
-				result = tables::state_blocks;
-				break;
-			default:
-				debug_assert (false);
-				break;
-		}
-		return result;
+		return entry_size_a - nano::block_sideband::size (type_a);
 	}
 
 	size_t count (nano::transaction const & transaction_a, std::initializer_list<tables> dbs_a) const
@@ -1029,12 +1020,12 @@ public:
 	void fill_value (nano::block const & block_a)
 	{
 		auto hash (block_a.hash ());
-		nano::block_type type;
-		auto value (store.block_raw_get (transaction, block_a.previous (), type));
+		auto value (store.block_raw_get (transaction, block_a.previous ()));
 		debug_assert (value.size () != 0);
+		auto type (store.block_type_from_raw (value.data ()));
 		std::vector<uint8_t> data (static_cast<uint8_t *> (value.data ()), static_cast<uint8_t *> (value.data ()) + value.size ());
-		std::copy (hash.bytes.begin (), hash.bytes.end (), data.begin () + store.block_successor_offset (transaction, value.size (), type));
-		store.block_raw_put (transaction, data, type, block_a.previous ());
+		std::copy (hash.bytes.begin (), hash.bytes.end (), data.begin () + store.block_successor_offset (value.size (), type));
+		store.block_raw_put (transaction, data, block_a.previous ());
 	}
 	void send_block (nano::send_block const & block_a) override
 	{
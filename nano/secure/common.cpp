@@ -387,6 +387,26 @@ uint16_t nano::endpoint_key::port () const
 	return boost::endian::big_to_native (network_port);
 }
 
+nano::height_key::height_key (nano::account const & account_a, uint64_t height_a) :
+account_m (account_a), height_m (boost::endian::native_to_big (height_a))
+{
+}
+
+bool nano::height_key::operator== (nano::height_key const & other_a) const
+{
+	return account_m == other_a.account_m && height_m == other_a.height_m;
+}
+
+nano::account const & nano::height_key::account () const
+{
+	return account_m;
+}
+
+uint64_t nano::height_key::height () const
+{
+	return boost::endian::big_to_native (height_m);
+}
+
 nano::confirmation_height_info::confirmation_height_info (uint64_t confirmation_height_a, nano::block_hash const & confirmed_frontier_a) :
 height (confirmation_height_a),
 frontier (confirmed_frontier_a)
@@ -154,6 +154,24 @@ private:
 	uint16_t network_port{ 0 };
 };
 
+/**
+ * Key of the block height index, ordered by account and then height
+ */
+class height_key final
+{
+public:
+	height_key () = default;
+	height_key (nano::account const &, uint64_t);
+	bool operator== (nano::height_key const &) const;
+	nano::account const & account () const;
+	uint64_t height () const;
+
+private:
+	nano::account account_m{ 0 };
+	// Stored in network byte order so that keys sort by height
+	uint64_t height_m{ 0 };
+};
+
 enum class no_value
 {
 	dummy
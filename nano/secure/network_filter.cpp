@@ -5,38 +5,70 @@
 #include <nano/secure/network_filter.hpp>
 
 nano::network_filter::network_filter (size_t size_a) :
-items (size_a, nano::uint128_t{ 0 })
+items (size_a)
 {
 	nano::random_pool::generate_block (key, key.size ());
 }
 
 bool nano::network_filter::apply (uint8_t const * bytes_a, size_t count_a, nano::uint128_t * digest_a)
 {
-	// Get hash before locking
 	auto digest (hash (bytes_a, count_a));
+	if (digest_a)
+	{
+		*digest_a = digest;
+	}
+	return insert (digest);
+}
 
-	nano::lock_guard<std::mutex> lock (mutex);
-	auto & element (get_element (digest));
-	bool existed (element == digest);
-	if (!existed)
+std::vector<bool> nano::network_filter::apply_many (std::vector<std::pair<uint8_t const *, size_t>> const & buffers_a, std::vector<nano::uint128_t> * digests_a)
+{
+	std::vector<nano::uint128_t> digests;
+	digests.reserve (buffers_a.size ());
+	for (auto const & buffer : buffers_a)
 	{
-		// Replace likely old element with a new one
-		element = digest;
+		digests.push_back (hash (buffer.first, buffer.second));
 	}
-	if (digest_a)
+	std::vector<bool> result;
+	result.reserve (digests.size ());
+	for (auto const & digest : digests)
 	{
-		*digest_a = digest;
+		result.push_back (insert (digest));
+	}
+	if (digests_a)
+	{
+		*digests_a = std::move (digests);
+	}
+	return result;
+}
+
+bool nano::network_filter::insert (nano::uint128_t const & digest_a)
+{
+	auto high (static_cast<uint64_t> (digest_a >> 64));
+	auto low (static_cast<uint64_t> (digest_a));
+	auto & element (get_element (digest_a));
+	auto current (element.high.load (std::memory_order_acquire));
+	bool existed (current == high && element.low.load (std::memory_order_relaxed) == low);
+	while (!existed)
+	{
+		// Replace likely old element with a new one, whoever swaps the high half in first inserted the digest
+		element.low.store (low, std::memory_order_relaxed);
+		if (element.high.compare_exchange_weak (current, high, std::memory_order_release, std::memory_order_acquire))
+		{
+			break;
+		}
+		existed = current == high;
 	}
 	return existed;
 }
 
 void nano::network_filter::clear (nano::uint128_t const & digest_a)
 {
-	nano::lock_guard<std::mutex> lock (mutex);
+	auto high (static_cast<uint64_t> (digest_a >> 64));
 	auto & element (get_element (digest_a));
-	if (element == digest_a)
+	if (element.low.load (std::memory_order_relaxed) == static_cast<uint64_t> (digest_a))
 	{
-		element = nano::uint128_t{ 0 };
+		// Only the high half is reset, which is enough for the element to stop matching the digest
+		element.high.compare_exchange_strong (high, 0, std::memory_order_release, std::memory_order_relaxed);
 	}
 }
 
@@ -58,13 +90,15 @@ void nano::network_filter::clear (OBJECT const & object_a)
 
 void nano::network_filter::clear ()
 {
-	nano::lock_guard<std::mutex> lock (mutex);
-	items.assign (items.size (), nano::uint128_t{ 0 });
+	for (auto & element : items)
+	{
+		element.high.store (0, std::memory_order_relaxed);
+		element.low.store (0, std::memory_order_relaxed);
+	}
 }
 
-nano::uint128_t & nano::network_filter::get_element (nano::uint128_t const & hash_a)
+nano::network_filter::element & nano::network_filter::get_element (nano::uint128_t const & hash_a)
 {
-	debug_assert (!mutex.try_lock ());
 	debug_assert (items.size () > 0);
 	size_t index (hash_a % items.size ());
 	return items[index];
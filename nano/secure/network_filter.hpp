@@ -6,7 +6,8 @@
 #include <crypto/cryptopp/seckey.h>
 #include <crypto/cryptopp/siphash.h>
 
-#include <mutex>
+#include <atomic>
+#include <vector>
 
 namespace nano
 {
@@ -14,7 +15,9 @@ namespace nano
  * A probabilistic duplicate filter based on directed map caches, using SipHash 2/4/128
  * The probability of false negatives (unique packet marked as duplicate) is the probability of a 128-bit SipHash collision.
  * The probability of false positives (duplicate packet marked as unique) shrinks with a larger filter.
- * @note This class is thread-safe.
+ * Each element is stored as two 64-bit atomics, the high half is only replaced with compare-and-swap after the low half is written.
+ * Concurrent inserts of different digests into the same element can leave it matching neither, which can only cause false positives.
+ * @note This class is thread-safe and lock-free.
  */
 class network_filter final
 {
@@ -29,6 +32,13 @@ public:
 	 **/
 	bool apply (uint8_t const * bytes_a, size_t count_a, nano::uint128_t * digest_a = nullptr);
 
+	/**
+	 * Applies every range in \p buffers_a, digesting all of them before touching the filter.
+	 * @param \p digests_a if given, will be set to the resulting siphash digests
+	 * @return the previous existence of each hash in the filter, in the same order as \p buffers_a
+	 **/
+	std::vector<bool> apply_many (std::vector<std::pair<uint8_t const *, size_t>> const & buffers_a, std::vector<nano::uint128_t> * digests_a = nullptr);
+
 	/**
 	 * Sets the corresponding element in the filter to zero, if it matches \p digest_a exactly.
 	 **/
@@ -54,12 +64,21 @@ public:
 private:
 	using siphash_t = CryptoPP::SipHash<2, 4, true>;
 
+	class element final
+	{
+	public:
+		std::atomic<uint64_t> high{ 0 };
+		std::atomic<uint64_t> low{ 0 };
+	};
+
 	/**
 	 * Get element from digest.
-	 * @note must have a lock on mutex
 	 * @return a reference to the element with key \p hash_a
 	 **/
-	nano::uint128_t & get_element (nano::uint128_t const & hash_a);
+	element & get_element (nano::uint128_t const & hash_a);
+
+	/** Inserts \p digest_a, @return a boolean representing the previous existence of the digest in the filter */
+	bool insert (nano::uint128_t const & digest_a);
 
 	/**
 	 * Hashes \p count_a bytes starting from \p bytes_a .
@@ -67,8 +86,7 @@ private:
 	 **/
 	nano::uint128_t hash (uint8_t const * bytes_a, size_t count_a) const;
 
-	std::vector<nano::uint128_t> items;
+	std::vector<element> items;
 	CryptoPP::SecByteBlock key{ siphash_t::KEYLENGTH };
-	std::mutex mutex;
 };
 }
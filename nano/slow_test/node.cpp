@@ -1,13 +1,19 @@
 #include <nano/core_test/testutil.hpp>
 #include <nano/crypto_lib/random_pool.hpp>
+#include <nano/lib/locks.hpp>
 #include <nano/lib/threading.hpp>
 #include <nano/node/election.hpp>
 #include <nano/node/testing.hpp>
 #include <nano/node/transport/udp.hpp>
+#include <nano/secure/network_filter.hpp>
 
 #include <gtest/gtest.h>
 
+#include <boost/circular_buffer.hpp>
+#include <boost/format.hpp>
+
 #include <numeric>
+#include <thread>
 
 using namespace std::chrono_literals;
 
@@ -984,3 +990,217 @@ namespace transport
 	}
 }
 }
+
+namespace
+{
+/** The filter as it was before it became lock-free, used as a baseline for the benchmark */
+class locked_network_filter final
+{
+public:
+	locked_network_filter (size_t size_a) :
+	items (size_a, nano::uint128_t{ 0 })
+	{
+		nano::random_pool::generate_block (key, key.size ());
+	}
+	bool apply (uint8_t const * bytes_a, size_t count_a)
+	{
+		nano::uint128_union digest{ 0 };
+		CryptoPP::SipHash<2, 4, true> siphash (key, static_cast<unsigned int> (key.size ()));
+		siphash.CalculateDigest (digest.bytes.data (), bytes_a, count_a);
+		size_t index (digest.number () % items.size ());
+		nano::lock_guard<std::mutex> lock (mutex);
+		auto & element (items[index]);
+		bool existed (element == digest.number ());
+		if (!existed)
+		{
+			element = digest.number ();
+		}
+		return existed;
+	}
+
+private:
+	std::vector<nano::uint128_t> items;
+	CryptoPP::SecByteBlock key{ CryptoPP::SipHash<2, 4, true>::KEYLENGTH };
+	std::mutex mutex;
+};
+
+/** Applies \p per_thread_a distinct 64 byte messages from each of \p threads_a threads and returns the number of applies per second */
+template <typename T>
+double network_filter_throughput (T & filter_a, unsigned threads_a, size_t per_thread_a)
+{
+	std::vector<boost::thread> threads;
+	auto begin (std::chrono::steady_clock::now ());
+	for (auto i (0u); i < threads_a; ++i)
+	{
+		threads.push_back (boost::thread ([&filter_a, i, per_thread_a]() {
+			std::array<uint64_t, 8> message{ i };
+			for (size_t j (0); j < per_thread_a; ++j)
+			{
+				message[1] = j;
+				filter_a.apply (reinterpret_cast<uint8_t const *> (message.data ()), sizeof (message));
+			}
+		}));
+	}
+	for (auto & i : threads)
+	{
+		i.join ();
+	}
+	auto seconds (std::chrono::duration_cast<std::chrono::duration<double>> (std::chrono::steady_clock::now () - begin).count ());
+	return (threads_a * per_thread_a) / std::max (seconds, 1e-9);
+}
+}
+
+TEST (network_filter, contention_benchmark)
+{
+	auto threads (std::max (8u, std::thread::hardware_concurrency ()));
+	size_t const per_thread (100000);
+	size_t const size (256 * 1024);
+	nano::network_filter lock_free (size);
+	auto lock_free_rate (network_filter_throughput (lock_free, threads, per_thread));
+	locked_network_filter locked (size);
+	auto locked_rate (network_filter_throughput (locked, threads, per_thread));
+	std::cerr << boost::str (boost::format ("%1% threads: lock-free %2% applies/s, locked %3% applies/s\n") % threads % static_cast<uint64_t> (lock_free_rate) % static_cast<uint64_t> (locked_rate));
+	ASSERT_GT (lock_free_rate, 0);
+	ASSERT_GT (locked_rate, 0);
+}
+
+namespace
+{
+/** The mutex and condition variable based buffer manager message_buffer_manager replaced, kept as a baseline for the contention benchmark */
+class locked_buffer_manager final
+{
+public:
+	explicit locked_buffer_manager (size_t count_a) :
+	free (count_a),
+	full (count_a),
+	entries (count_a)
+	{
+		for (auto & entry : entries)
+		{
+			free.push_back (&entry);
+		}
+	}
+	nano::message_buffer * allocate ()
+	{
+		nano::unique_lock<std::mutex> lock (mutex);
+		condition.wait (lock, [this] { return stopped || !free.empty () || !full.empty (); });
+		nano::message_buffer * result (nullptr);
+		if (!free.empty ())
+		{
+			result = free.front ();
+			free.pop_front ();
+		}
+		else if (!full.empty ())
+		{
+			result = full.front ();
+			full.pop_front ();
+		}
+		return result;
+	}
+	void enqueue (nano::message_buffer * data_a)
+	{
+		{
+			nano::lock_guard<std::mutex> lock (mutex);
+			full.push_back (data_a);
+		}
+		condition.notify_all ();
+	}
+	nano::message_buffer * dequeue ()
+	{
+		nano::unique_lock<std::mutex> lock (mutex);
+		condition.wait (lock, [this] { return stopped || !full.empty (); });
+		nano::message_buffer * result (nullptr);
+		if (!full.empty ())
+		{
+			result = full.front ();
+			full.pop_front ();
+		}
+		return result;
+	}
+	void release (nano::message_buffer * data_a)
+	{
+		{
+			nano::lock_guard<std::mutex> lock (mutex);
+			free.push_back (data_a);
+		}
+		condition.notify_all ();
+	}
+	void stop ()
+	{
+		{
+			nano::lock_guard<std::mutex> lock (mutex);
+			stopped = true;
+		}
+		condition.notify_all ();
+	}
+
+private:
+	std::mutex mutex;
+	nano::condition_variable condition;
+	boost::circular_buffer<nano::message_buffer *> free;
+	boost::circular_buffer<nano::message_buffer *> full;
+	std::vector<nano::message_buffer> entries;
+	bool stopped{ false };
+};
+
+/** Runs receive and packet processing style threads against \p buffer_a and returns the number of buffers passed through per second */
+template <typename T>
+double buffer_manager_throughput (T & buffer_a, unsigned producers_a, unsigned consumers_a, size_t per_producer_a)
+{
+	std::atomic<size_t> processed (0);
+	std::vector<boost::thread> consumers;
+	for (auto i (0); i < consumers_a; ++i)
+	{
+		consumers.push_back (boost::thread ([&buffer_a, &processed]() {
+			for (auto item (buffer_a.dequeue ()); item != nullptr; item = buffer_a.dequeue ())
+			{
+				++processed;
+				buffer_a.release (item);
+			}
+		}));
+	}
+	auto begin (std::chrono::steady_clock::now ());
+	std::vector<boost::thread> producers;
+	for (auto i (0); i < producers_a; ++i)
+	{
+		producers.push_back (boost::thread ([&buffer_a, per_producer_a]() {
+			for (size_t i (0); i < per_producer_a; ++i)
+			{
+				auto item (buffer_a.allocate ());
+				if (item != nullptr)
+				{
+					buffer_a.enqueue (item);
+				}
+			}
+		}));
+	}
+	for (auto & i : producers)
+	{
+		i.join ();
+	}
+	auto end (std::chrono::steady_clock::now ());
+	buffer_a.stop ();
+	for (auto & i : consumers)
+	{
+		i.join ();
+	}
+	auto seconds (std::chrono::duration_cast<std::chrono::duration<double>> (end - begin).count ());
+	return (producers_a * per_producer_a) / std::max (seconds, 1e-9);
+}
+}
+
+TEST (message_buffer_manager, contention_benchmark)
+{
+	auto producers (4u);
+	auto consumers (std::max (4u, std::thread::hardware_concurrency ()));
+	size_t const per_producer (100000);
+	size_t const count (4096);
+	nano::stat stats;
+	nano::message_buffer_manager lock_free (stats, 512, count);
+	auto lock_free_rate (buffer_manager_throughput (lock_free, producers, consumers, per_producer));
+	locked_buffer_manager locked (count);
+	auto locked_rate (buffer_manager_throughput (locked, producers, consumers, per_producer));
+	std::cerr << boost::str (boost::format ("%1% producers, %2% consumers: lock-free %3% buffers/s, locked %4% buffers/s\n") % producers % consumers % static_cast<uint64_t> (lock_free_rate) % static_cast<uint64_t> (locked_rate));
+	ASSERT_GT (lock_free_rate, 0);
+	ASSERT_GT (locked_rate, 0);
+}